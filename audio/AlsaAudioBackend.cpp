@@ -0,0 +1,212 @@
+#include "AlsaAudioBackend.h"
+#include "../core/Logger.h"
+#include "../core/RealtimeSetup.h"
+#include <algorithm>
+
+#ifdef SYNTH_HAVE_ALSA
+#include <alsa/asoundlib.h>
+#include <cerrno>
+
+namespace {
+
+snd_pcm_t* handle(void* pcm) {
+    return static_cast<snd_pcm_t*>(pcm);
+}
+
+// Tried in order: float passes the render through unconverted
+struct FormatChoice {
+    snd_pcm_format_t format;
+    SampleType type;
+};
+const FormatChoice PreferredFormats[] = {
+    {SND_PCM_FORMAT_FLOAT_LE, SampleType::Float32},
+    {SND_PCM_FORMAT_S32_LE, SampleType::Int32},
+    {SND_PCM_FORMAT_S16_LE, SampleType::Int16},
+};
+
+bool check(int result, const char* what) {
+    if (result < 0) {
+        LOG_ERROR("❌ ALSA %s: %s", what, snd_strerror(result));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool AlsaAudioBackend::isAvailable() {
+    return true;
+}
+
+bool AlsaAudioBackend::start(const Config& config, RenderCallback renderCallback, void* renderContext) {
+    stop();
+    const char* device = config.device.empty() ? "default" : config.device.c_str();
+    snd_pcm_t* pcmHandle = nullptr;
+    if (!check(snd_pcm_open(&pcmHandle, device, SND_PCM_STREAM_PLAYBACK, 0), "open")) return false;
+    pcm = pcmHandle;
+    if (!configure(config)) {
+        snd_pcm_close(pcmHandle);
+        pcm = nullptr;
+        return false;
+    }
+
+    output.configure(renderCallback, renderContext, config.engineRateFor(sampleRate), sampleRate, channelCount,
+                     prepareCallback);
+    xruns.store(0);
+    stopping.store(false);
+    running.store(true);
+    thread = std::thread(&AlsaAudioBackend::run, this);
+    LOG_INFO("🔊 ALSA '%s': %.0f Hz, %d ch, period %d frames x %d (%.2f ms latency)", device, sampleRate,
+             channelCount, periodFrames, bufferFrames / std::max(1, periodFrames), 1000.0 * bufferFrames / sampleRate);
+    return true;
+}
+
+bool AlsaAudioBackend::configure(const Config& config) {
+    snd_pcm_t* pcmHandle = handle(pcm);
+    snd_pcm_hw_params_t* hw;
+    snd_pcm_hw_params_alloca(&hw);
+    if (!check(snd_pcm_hw_params_any(pcmHandle, hw), "hw params")) return false;
+    if (snd_pcm_hw_params_set_access(pcmHandle, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0) {
+        // Sound-server plugins behind "default" often refuse mmap
+        LOG_ERROR("❌ ALSA: device has no mmap access - try --audio-device=hw:0 or plughw:0");
+        return false;
+    }
+
+    const FormatChoice* chosen = nullptr;
+    for (const FormatChoice& choice : PreferredFormats) {
+        if (snd_pcm_hw_params_test_format(pcmHandle, hw, choice.format) == 0) {
+            chosen = &choice;
+            break;
+        }
+    }
+    if (!chosen) {
+        LOG_ERROR("❌ ALSA: device supports none of float, S32 or S16");
+        return false;
+    }
+    if (!check(snd_pcm_hw_params_set_format(pcmHandle, hw, chosen->format), "format")) return false;
+
+    // The engine renders as many channels as the device grants
+    unsigned int channelsGranted = static_cast<unsigned int>(std::clamp(config.channels, 1, MaxChannels));
+    if (!check(snd_pcm_hw_params_set_channels_near(pcmHandle, hw, &channelsGranted), "channels")) return false;
+    if (channelsGranted > static_cast<unsigned int>(MaxChannels)) {
+        LOG_ERROR("❌ ALSA: device needs %u channels, the engine renders at most %d", channelsGranted, MaxChannels);
+        return false;
+    }
+    // The engine follows the granted rate unless Config::engineRate pins it
+    unsigned int rate = static_cast<unsigned int>(config.sampleRate);
+    if (!check(snd_pcm_hw_params_set_rate_near(pcmHandle, hw, &rate, nullptr), "rate")) return false;
+    snd_pcm_uframes_t periodSize = static_cast<snd_pcm_uframes_t>(std::max(16, config.periodFrames));
+    int direction = 0;
+    if (!check(snd_pcm_hw_params_set_period_size_near(pcmHandle, hw, &periodSize, &direction), "period size")) {
+        return false;
+    }
+    unsigned int periodCount = static_cast<unsigned int>(std::max(2, config.periods));
+    if (!check(snd_pcm_hw_params_set_periods_near(pcmHandle, hw, &periodCount, &direction), "periods")) return false;
+    if (!check(snd_pcm_hw_params(pcmHandle, hw), "apply hw params")) return false;
+
+    snd_pcm_uframes_t bufferSize = 0;
+    snd_pcm_hw_params_get_period_size(hw, &periodSize, &direction);
+    snd_pcm_hw_params_get_buffer_size(hw, &bufferSize);
+
+    // Wake per period; playback starts once the first full buffer is queued
+    snd_pcm_sw_params_t* sw;
+    snd_pcm_sw_params_alloca(&sw);
+    snd_pcm_sw_params_current(pcmHandle, sw);
+    snd_pcm_sw_params_set_avail_min(pcmHandle, sw, periodSize);
+    snd_pcm_sw_params_set_start_threshold(pcmHandle, sw, bufferSize);
+    if (!check(snd_pcm_sw_params(pcmHandle, sw), "sw params")) return false;
+
+    sampleRate = rate;
+    periodFrames = static_cast<int>(periodSize);
+    bufferFrames = static_cast<int>(bufferSize);
+    sampleType = chosen->type;
+    channelCount = static_cast<int>(channelsGranted);
+    return true;
+}
+
+void AlsaAudioBackend::stop() {
+    if (!thread.joinable()) return;
+    stopping.store(true);
+    thread.join();
+    running.store(false);
+
+    snd_pcm_drop(handle(pcm));
+    snd_pcm_close(handle(pcm));
+    pcm = nullptr;
+    if (long count = xruns.load()) LOG_WARNING("⚠️ ALSA: %ld underruns", count);
+}
+
+bool AlsaAudioBackend::recover(int error) {
+    // -EPIPE is an underrun; suspends and lost devices are not counted
+    if (error == -EPIPE) xruns.fetch_add(1, std::memory_order_relaxed);
+    int result = snd_pcm_recover(handle(pcm), error, 1);
+    if (result < 0) {
+        LOG_ERROR("❌ ALSA: cannot recover from '%s' - stopping playback", snd_strerror(error));
+        return false;
+    }
+    return true;
+}
+
+void AlsaAudioBackend::run() {
+    RealtimeSetup::prepareCurrentThread("ALSA");
+    RealtimeSetup::report();
+
+    snd_pcm_t* pcmHandle = handle(pcm);
+    const snd_pcm_uframes_t periodSize = static_cast<snd_pcm_uframes_t>(periodFrames);
+    while (!stopping.load(std::memory_order_relaxed)) {
+        snd_pcm_sframes_t available = snd_pcm_avail_update(pcmHandle);
+        if (available < 0) {
+            if (!recover(static_cast<int>(available))) break;
+            continue;
+        }
+
+        if (static_cast<snd_pcm_uframes_t>(available) < periodSize) {
+            // A buffer that is not a whole number of periods never reaches
+            // the start threshold by itself
+            if (snd_pcm_state(pcmHandle) == SND_PCM_STATE_PREPARED) {
+                int result = snd_pcm_start(pcmHandle);
+                if (result < 0 && !recover(result)) break;
+                continue;
+            }
+            int result = snd_pcm_wait(pcmHandle, 100);
+            if (result < 0 && !recover(result)) break;
+            continue;
+        }
+
+        // One period written in place into the device ring
+        const snd_pcm_channel_area_t* areas = nullptr;
+        snd_pcm_uframes_t offset = 0;
+        snd_pcm_uframes_t frames = periodSize;
+        int result = snd_pcm_mmap_begin(pcmHandle, &areas, &offset, &frames);
+        if (result < 0) {
+            if (!recover(result)) break;
+            continue;
+        }
+
+        // Interleaved: one area, frames areas[0].step bits apart
+        auto* destination = static_cast<unsigned char*>(areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+        output.write(destination, static_cast<int>(frames), sampleType);
+
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pcmHandle, offset, frames);
+        if (committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames) {
+            if (!recover(committed < 0 ? static_cast<int>(committed) : -EPIPE)) break;
+        }
+    }
+    if (!stopping.load()) running.store(false);  // A failed recovery ends playback for good
+}
+
+#else // SYNTH_HAVE_ALSA
+
+bool AlsaAudioBackend::isAvailable() {
+    return false;
+}
+
+bool AlsaAudioBackend::start(const Config&, RenderCallback, void*) {
+    LOG_ERROR("❌ ALSA backend not built in - install the ALSA development headers and rebuild");
+    return false;
+}
+
+void AlsaAudioBackend::stop() {
+}
+
+#endif // SYNTH_HAVE_ALSA
@@ -0,0 +1,45 @@
+#ifndef ALSAAUDIOBACKEND_H
+#define ALSAAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+#include "OutputStage.h"
+#include "SampleConversion.h"
+#include <atomic>
+#include <thread>
+
+// Direct ALSA playback without Qt's extra buffering. The PCM is opened for
+// mmap interleaved access with the requested period size and count (the
+// driver picks the nearest it supports), and the backend's own thread
+// renders each period straight into the device ring: wait for a period of
+// space, mmap_begin, render, convert, mmap_commit. Underruns are counted
+// and recovered in place.
+//
+// Built when the ALSA headers are found (SYNTH_HAVE_ALSA, see the makefile);
+// otherwise start() logs that it is unavailable and fails.
+class AlsaAudioBackend : public AudioBackend {
+public:
+    ~AlsaAudioBackend() override { stop(); }
+
+    bool start(const Config& config, RenderCallback render, void* context) override;
+    void stop() override;
+    bool isRunning() const override { return running.load(); }
+    const char* getName() const override { return "alsa"; }
+
+    static bool isAvailable();
+    long getXrunCount() const { return xruns.load(); }
+
+private:
+    void* pcm = nullptr;  // snd_pcm_t, opaque so this header needs no ALSA
+    SampleType sampleType = SampleType::Float32;
+    OutputStage output;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<long> xruns{0};
+
+    bool configure(const Config& config);
+    bool recover(int error);
+    void run();
+};
+
+#endif // ALSAAUDIOBACKEND_H
@@ -0,0 +1,71 @@
+#ifndef AUDIOBACKEND_H
+#define AUDIOBACKEND_H
+
+#include <string>
+
+// Output device seen by AudioEngine. A backend owns the audio thread (or is
+// driven by the platform's) and calls the render callback once per period
+// for interleaved float frames at the engine's rate, with as many channels
+// as the device granted. The engine follows the rate
+// the device settles on unless Config::engineRate pins it, in which case
+// the backend's OutputStage resamples; either way the stage converts to the
+// device's sample format.
+//
+// Implementations: "qt" (QAudioSink, the default), "alsa" (direct PCM with
+// mmap transfers, Linux builds with ALSA headers), "null" (paced by a clock,
+// output discarded), "file" (like null, written to a WAV file) and
+// "virtual" (a simulated sound card that records xruns, jitter and fill).
+class AudioBackend {
+public:
+    // Most channels the engine renders (Sound::MaxChannels)
+    static constexpr int MaxChannels = 8;
+
+    // Called on the audio thread; must be real-time safe
+    using RenderCallback = void (*)(void* context, float* output, int numFrames, int channels);
+    // Called from start() once the device is negotiated and before the first
+    // render, with the rate the engine renders at
+    using PrepareCallback = void (*)(void* context, double engineRate);
+
+    struct Config {
+        std::string backend = "qt";
+        double sampleRate = 44100.0;  // Rate asked of the device; it may settle on another
+        double engineRate = 0.0;    // Rate the engine renders at; 0 follows the device
+        int periodFrames = 256;     // Frames per callback, negotiated by the device
+        int periods = 2;            // Device buffer = periods * periodFrames
+        int channels = 2;           // Asked of the device; the engine renders what it grants
+        std::string device;         // ALSA PCM name; empty means "default"
+        std::string path;           // Output of the file backend
+        double clockSpeed = 1.0;    // Virtual backend: device clock vs. wall clock, 0 = simulated
+        double deviceRate = 0.0;    // Null, file and virtual backends: rate to emulate, 0 = sampleRate
+        std::string recordPath;     // AudioEngine: record the output from start(); ".raw" for raw float
+        bool recordDirect = false;  // Record with O_DIRECT
+
+        double engineRateFor(double grantedRate) const { return engineRate > 0.0 ? engineRate : grantedRate; }
+    };
+
+    virtual ~AudioBackend() = default;
+
+    // Opens the device and starts calling render; false (with a log) on failure
+    virtual bool start(const Config& config, RenderCallback render, void* context) = 0;
+    virtual void stop() = 0;
+    virtual bool isRunning() const = 0;
+    virtual const char* getName() const = 0;
+
+    // Optional; set before start()
+    void setPrepareCallback(PrepareCallback callback) { prepareCallback = callback; }
+
+    // What the device granted; valid after a successful start()
+    double getSampleRate() const { return sampleRate; }
+    int getChannelCount() const { return channelCount; }
+    int getPeriodFrames() const { return periodFrames; }
+    int getBufferFrames() const { return bufferFrames; }
+
+protected:
+    PrepareCallback prepareCallback = nullptr;
+    double sampleRate = 0.0;
+    int channelCount = 0;
+    int periodFrames = 0;
+    int bufferFrames = 0;
+};
+
+#endif // AUDIOBACKEND_H
@@ -1,116 +1,143 @@
 #include "AudioEngine.h"
-#include <QAudioFormat>
-#include <QAudioSink>
-#include <QMediaDevices>
-#include <QTimer>
-#include <QDebug>
-
-class AudioIODevice : public QIODevice {
-public:
-    explicit AudioIODevice(Sound* soundSystem, QObject* parent = nullptr) 
-        : QIODevice(parent), sound(soundSystem), sampleCount(0) {
-    }
+#include "QtAudioBackend.h"
+#include "AlsaAudioBackend.h"
+#include "NullAudioBackend.h"
+#include "VirtualAudioBackend.h"
+#include "../core/RealtimeSetup.h"
+#include "../core/Logger.h"
+#include <algorithm>
 
-    qint64 readData(char* data, qint64 maxlen) override {
-        qint64 samples = maxlen / sizeof(float);
-        float* buffer = reinterpret_cast<float*>(data);
+namespace {
 
-        for (qint64 i = 0; i < samples; ++i) {
-            double sample = sound->nextSample();
-            buffer[i] = static_cast<float>(sample);
-            sampleCount++;
-        }
+AudioBackend::Config backendConfig;
 
-        return maxlen;
-    }
-
-    qint64 writeData(const char*, qint64) override { 
-        return 0;
-    }
+} // namespace
 
-    bool isSequential() const override {
-        return true;
-    }
-
-    qint64 bytesAvailable() const override {
-        return QIODevice::bytesAvailable() + 1000000;
-    }
+void AudioEngine::setBackendConfig(const AudioBackend::Config& config) {
+    backendConfig = config;
+}
 
-    bool atEnd() const override {
-        return false;
-    }
+const AudioBackend::Config& AudioEngine::getBackendConfig() {
+    return backendConfig;
+}
 
-private:
-    Sound* sound;
-    int sampleCount;
-};
+std::unique_ptr<AudioBackend> AudioEngine::createBackend(const std::string& name) {
+    if (name == "qt") return std::make_unique<QtAudioBackend>();
+    if (name == "alsa") return std::make_unique<AlsaAudioBackend>();
+    if (name == "null") return std::make_unique<NullAudioBackend>(false);
+    if (name == "file") return std::make_unique<NullAudioBackend>(true);
+    if (name == "virtual") return std::make_unique<VirtualAudioBackend>();
+    return nullptr;
+}
 
 AudioEngine::AudioEngine(QObject* parent)
-    : QObject(parent), audioOutput(nullptr), ioDevice(nullptr) {
+    : QObject(parent) {
     // Create Sound system
-    sound = std::make_unique<Sound>(44100.0);
+    std::unique_ptr<Sound>& sound = parts[0].sound;
+    sound = std::make_unique<Sound>(backendConfig.engineRateFor(backendConfig.sampleRate));
+    sound->setChannelCount(getChannelCount());
+
+    // Pin the working set before the first graph is touched; later graphs
+    // are prefaulted as they are published
+    RealtimeSetup::MemoryLock memory = RealtimeSetup::lockMemory();
+    LOG_INFO("🔒 Memory lock: %s", RealtimeSetup::getName(memory));
+
+    // Worker threads are created once here, never on the audio thread
+    renderPool = std::make_unique<WorkerPool>(WorkerPool::defaultThreadCount(), [](int) {
+        RealtimeSetup::prepareCurrentThread("render worker");
+    });
+    sound->setWorkerPool(renderPool.get());
+    sound->prepareMemory();
+    parts[0].exchange.publish(sound.get());
+    renderer.setRecorder(&recorder);
+    sendReverb.setMix(100.0);  // The dry signal already goes out through the parts
+    renderer.setSendEffect(&sendReverb);
+    LOG_INFO("🧵 Render pool threads: %d", renderPool->getThreadCount());
+}
+
+Sound* AudioEngine::getSound(int part) {
+    if (part < 0 || part >= MaxParts) return nullptr;
+    return parts[part].sound.get();
+}
+
+void AudioEngine::publishSound(int index, std::unique_ptr<Sound> next) {
+    if (!next || index < 0 || index >= MaxParts) return;
+    next->setWorkerPool(renderPool.get());
+    next->prepareMemory();  // Its first block must not page-fault on the audio thread
+
+    Part& part = parts[index];
+    if (part.sound) part.retiring.push_back(std::move(part.sound));
+    part.sound = std::move(next);
+    release(part, part.exchange.publish(part.sound.get()));  // A Sound published but never picked up
+    renderer.setPartExchange(index, &part.exchange);  // First Sound of the part: start rendering it
+    reclaimRetired();
+}
+
+void AudioEngine::reclaimRetired() {
+    for (Part& part : parts) {
+        while (Sound* finished = part.exchange.collectRetired()) {
+            release(part, finished);
+        }
+    }
+}
+
+void AudioEngine::release(Part& part, Sound* finished) {
+    if (!finished) return;
+    auto found = std::find_if(part.retiring.begin(), part.retiring.end(),
+                              [finished](const std::unique_ptr<Sound>& s) { return s.get() == finished; });
+    if (found != part.retiring.end()) part.retiring.erase(found);
 }
 
 void AudioEngine::start() {
-    // Set up audio format
-    QAudioFormat format;
-    format.setSampleRate(44100);
-    format.setChannelCount(1);
-    format.setSampleFormat(QAudioFormat::Float);
-    
-    // Get default audio device
-    QAudioDevice audioDevice = QMediaDevices::defaultAudioOutput();
-    
-    // Check if we have a valid audio device
-    if (!audioDevice.isNull()) {
-        // Check format support
-        if (!audioDevice.isFormatSupported(format)) {
-            qWarning() << "Warning: Default format not supported - trying to use nearest";
-            format = audioDevice.preferredFormat();
+    if (isRunning()) return;
+    const AudioBackend::Config& config = backendConfig;
+
+    // The backend sets the renderer's rate once the device is negotiated and
+    // before its first callback, so published Sounds switch to it at their
+    // first block
+    backend = createBackend(config.backend);
+    if (!backend) LOG_WARNING("⚠️ Unknown audio backend '%s'", config.backend.c_str());
+    if (backend) backend->setPrepareCallback(SoundRenderer::prepareCallback);
+    if (!backend || !backend->start(config, SoundRenderer::renderCallback, &renderer)) {
+        backend.reset();
+        if (config.backend == "qt") return;
+        LOG_WARNING("⚠️ Falling back to the Qt audio backend");
+        backend = createBackend("qt");
+        backend->setPrepareCallback(SoundRenderer::prepareCallback);
+        if (!backend->start(config, SoundRenderer::renderCallback, &renderer)) {
+            backend.reset();
+            return;
         }
-        
-        // Create audio sink
-        audioOutput = new QAudioSink(audioDevice, format, this);
-        audioOutput->setVolume(1.0);
-        
-        // Create audio device
-        ioDevice = new AudioIODevice(sound.get(), this);
-        ioDevice->open(QIODevice::ReadOnly);
-        
-        // Start audio
-        audioOutput->start(ioDevice);
-        
-        // Monitor state
-        connect(audioOutput, &QAudioSink::stateChanged, this, [this](QAudio::State state) {
-            switch (state) {
-                case QAudio::IdleState:
-                    qDebug() << "Audio system idle";
-                    break;
-                case QAudio::StoppedState:
-                    // Check for errors
-                    if (audioOutput->error() != QAudio::NoError) {
-                        qWarning() << "Audio output error:" << audioOutput->error();
-                    }
-                    break;
-                default:
-                    break;
-            }
-        });
-    } else {
-        qWarning() << "No audio output device found!";
     }
+
+    double rate = config.engineRateFor(backend->getSampleRate());
+    LOG_INFO("🎚️ Engine rate %.0f Hz (device %.0f Hz), %d channels", rate, backend->getSampleRate(),
+             backend->getChannelCount());
+    if (!config.recordPath.empty()) startRecording(config.recordPath, config.recordDirect);
+}
+
+bool AudioEngine::startRecording(const std::string& path, bool direct) {
+    DiskRecorder::Options options;
+    bool raw = path.size() >= 4 && path.compare(path.size() - 4, 4, ".raw") == 0;
+    options.format = raw ? DiskRecorder::Format::Raw : DiskRecorder::Format::Wav;
+    options.direct = direct;
+    return recorder.start(path, getSampleRate(), getChannelCount(), options);
+}
+
+double AudioEngine::getSampleRate() const {
+    double rate = renderer.getSampleRate();
+    return rate > 0.0 ? rate : parts[0].sound->getSampleRate();
+}
+
+int AudioEngine::getChannelCount() const {
+    if (backend) return backend->getChannelCount();
+    return std::clamp(backendConfig.channels, 1, AudioBackend::MaxChannels);
 }
 
 void AudioEngine::stop() {
-    if (audioOutput) {
-        audioOutput->stop();
-        audioOutput->deleteLater();
-        audioOutput = nullptr;
+    recorder.stop();
+    if (backend) {
+        backend->stop();
+        backend.reset();
     }
-    
-    if (ioDevice) {
-        ioDevice->close();
-        ioDevice->deleteLater();
-        ioDevice = nullptr;
-    }
-}
\ No newline at end of file
+}
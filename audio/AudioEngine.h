@@ -1,26 +1,96 @@
 #pragma once
 
 #include <QObject>
-#include <QAudioSink>
-#include <QIODevice>
+#include "AudioBackend.h"
+#include "SoundRenderer.h"
+#include "DiskRecorder.h"
+#include "../filters/FDNReverb.h"
 #include "../core/Sound.h"
+#include "../core/WorkerPool.h"
+#include "../core/SoundExchange.h"
 #include <memory>
+#include <string>
+#include <vector>
 
 class AudioEngine : public QObject {
     Q_OBJECT
     
 public:
     explicit AudioEngine(QObject* parent = nullptr);
-    ~AudioEngine() = default;
-    
+    ~AudioEngine() { stop(); }
+
+    // Backend and device settings chosen at startup (see main.cpp); used by
+    // every engine started afterwards
+    static void setBackendConfig(const AudioBackend::Config& config);
+    static const AudioBackend::Config& getBackendConfig();
+    // "qt", "alsa", "null", "file" or "virtual"; nullptr for an unknown name
+    static std::unique_ptr<AudioBackend> createBackend(const std::string& name);
+
+    // Opens the configured backend, falling back to Qt if it cannot start
     void start();
     void stop();
+
+    // The rate Sounds render at: the device's, unless Config::engineRate pins
+    // it. Build Sounds for it (see PresetCache::setSampleRate); others are
+    // converted on the audio thread when they are first rendered.
+    double getSampleRate() const;
+    // Channels the device granted (Config::channels until it starts). Build
+    // Sounds with it too; the renderer maps any other count onto the device.
+    int getChannelCount() const;
     
-    Sound* getSound() { return sound.get(); }
-    bool isRunning() const { return audioOutput != nullptr; }
+    // Multi-timbral parts: each plays its own Sound, mixed with its own
+    // volume and pan. Part 0 starts with an empty Sound; the others stay
+    // silent, and cost nothing, until a Sound is published to them.
+    static constexpr int MaxParts = SoundRenderer::MaxParts;
+
+    // The most recently published Sound of a part (the audio thread picks it
+    // up at its next block); nullptr for a part that has none
+    Sound* getSound(int part = 0);
+    // Hands a fully built Sound to the audio thread without stopping it
+    void publishSound(std::unique_ptr<Sound> next) { publishSound(0, std::move(next)); }
+    void publishSound(int part, std::unique_ptr<Sound> next);
+    // Frees the Sounds the audio thread has switched away from, in every part
+    void reclaimRetired();
+
+    // Part mix, applied from the next period on
+    void setPartVolume(int part, double volume) { renderer.setPartVolume(part, volume); }
+    void setPartPan(int part, double pan) { renderer.setPartPan(part, pan); }
+    // A bypassed part keeps its Sound but is not rendered
+    void setPartBypassed(int part, bool bypassed) { renderer.setPartBypassed(part, bypassed); }
+    double getPartVolume(int part) const { return renderer.getPartVolume(part); }
+    double getPartPan(int part) const { return renderer.getPartPan(part); }
+    bool isPartBypassed(int part) const { return renderer.isPartBypassed(part); }
+    // Level into the shared reverb on the send bus, 0 to 1
+    void setPartSend(int part, double level) { renderer.setPartSend(part, level); }
+    double getPartSend(int part) const { return renderer.getPartSend(part); }
+    // The send reverb's settings (set them from the GUI thread, like any
+    // Filter parameter)
+    FDNReverb& getSendReverb() { return sendReverb; }
+    // Records everything the engine renders, at the engine rate, from the
+    // next period on; a path ending in ".raw" records raw float, anything
+    // else a float WAV. The audio thread only queues blocks (see DiskRecorder).
+    bool startRecording(const std::string& path, bool direct = false);
+    void stopRecording() { recorder.stop(); }
+    bool isRecording() const { return recorder.isRecording(); }
+    const DiskRecorder& getRecorder() const { return recorder; }
+
+    WorkerPool* getWorkerPool() { return renderPool.get(); }
+    bool isRunning() const { return backend && backend->isRunning(); }
+    AudioBackend* getBackend() { return backend.get(); }
 
 private:
-    QAudioSink* audioOutput;
-    QIODevice* ioDevice;
-    std::unique_ptr<Sound> sound;
+    struct Part {
+        SoundExchange exchange;
+        std::unique_ptr<Sound> sound;
+        std::vector<std::unique_ptr<Sound>> retiring;  // Published earlier, possibly still rendering
+    };
+
+    std::unique_ptr<WorkerPool> renderPool;  // Renders Sound layers in parallel
+    Part parts[MaxParts];
+    DiskRecorder recorder;
+    FDNReverb sendReverb{44100.0, FDNReverb::MaxLines};  // Switched to the engine rate by the renderer
+    SoundRenderer renderer{&parts[0].exchange};
+    std::unique_ptr<AudioBackend> backend;
+
+    void release(Part& part, Sound* finished);
 };
\ No newline at end of file
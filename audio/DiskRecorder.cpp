@@ -0,0 +1,246 @@
+#include "DiskRecorder.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+void putLittleEndian(char* out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+}
+
+// WriteAlignment bytes: RIFF and fmt chunks, a JUNK chunk padding the rest,
+// and the data chunk header ending exactly at the alignment
+void buildWavHeader(char* out, uint32_t sampleRate, uint32_t channels, uint32_t dataBytes) {
+    const uint32_t headerBytes = DiskRecorder::WriteAlignment;
+    const uint32_t frameBytes = channels * sizeof(float);
+    const uint32_t junkBytes = headerBytes - 12 - 24 - 8 - 8;
+    std::memset(out, 0, headerBytes);
+    std::memcpy(out, "RIFF", 4);
+    putLittleEndian(out + 4, headerBytes - 8 + dataBytes, 4);
+    std::memcpy(out + 8, "WAVEfmt ", 8);
+    putLittleEndian(out + 16, 16, 4);                  // fmt chunk size
+    putLittleEndian(out + 20, 3, 2);                   // IEEE float
+    putLittleEndian(out + 22, channels, 2);
+    putLittleEndian(out + 24, sampleRate, 4);
+    putLittleEndian(out + 28, sampleRate * frameBytes, 4);
+    putLittleEndian(out + 32, frameBytes, 2);          // Block align
+    putLittleEndian(out + 34, 32, 2);                  // Bits per sample
+    std::memcpy(out + 36, "JUNK", 4);
+    putLittleEndian(out + 40, junkBytes, 4);
+    std::memcpy(out + headerBytes - 8, "data", 4);
+    putLittleEndian(out + headerBytes - 4, dataBytes, 4);
+}
+
+size_t nextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) power <<= 1;
+    return power;
+}
+
+} // namespace
+
+bool DiskRecorder::start(const std::string& file, double sampleRate, int channels, const Options& options) {
+    stop();
+    path = file;
+    format = options.format;
+    rate = sampleRate;
+    channelCount = std::clamp(channels, 1, 8);
+
+    const size_t writeBytes = std::max<size_t>(WriteAlignment, options.writeBytes / WriteAlignment * WriteAlignment);
+    writeSamples = writeBytes / sizeof(float);
+    size_t ringSamples = static_cast<size_t>(std::max(0.0, options.ringSeconds) * rate) * channelCount;
+    ringSamples = nextPowerOfTwo(std::max(ringSamples, 2 * writeSamples));
+    ring = std::make_unique<float[]>(ringSamples);
+    ringMask = ringSamples - 1;
+    staging = static_cast<float*>(std::aligned_alloc(WriteAlignment, writeBytes));
+
+    direct = false;
+    fd = -1;
+#ifdef O_DIRECT
+    if (options.direct) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        direct = fd >= 0;
+        if (!direct) LOG_WARNING("⚠️ Recorder: O_DIRECT refused for '%s' (%s), using buffered writes", path.c_str(),
+                                 std::strerror(errno));
+    }
+#endif
+    if (fd < 0) fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("❌ Recorder: cannot write '%s' (%s)", path.c_str(), std::strerror(errno));
+        std::free(staging);
+        staging = nullptr;
+        ring.reset();
+        return false;
+    }
+    if (format == Format::Wav) {
+        // Sizes are patched in stop()
+        buildWavHeader(reinterpret_cast<char*>(staging), static_cast<uint32_t>(rate), channelCount, 0);
+        writeAll(staging, WriteAlignment);
+    }
+
+    writePosition.store(0);
+    readPosition.store(0);
+    droppedBlocks.store(0);
+    droppedFrames.store(0);
+    samplesWritten.store(0);
+    writes.store(0);
+    maxWriteMs.store(0.0);
+    peakFill.store(0.0);
+    fileBytes = 0;
+    failed = false;
+    stopping.store(false);
+    writer = std::thread(&DiskRecorder::writerLoop, this);
+    armed.store(true);
+    LOG_INFO("⏺️ Recording %s: %.0f Hz, %d ch, %s, %zu KiB writes, %.1f s ring%s", path.c_str(), rate, channelCount,
+             format == Format::Wav ? "float WAV" : "raw float", writeBytes / 1024,
+             static_cast<double>(ringSamples) / channelCount / rate, direct ? ", O_DIRECT" : "");
+    return true;
+}
+
+void DiskRecorder::stop() {
+    if (!writer.joinable()) return;
+    // No block is queued once armed is down and no push is in flight
+    armed.store(false);
+    while (pushing.load()) std::this_thread::yield();
+    stopping.store(true);
+    writer.join();
+    finishFile();
+    std::free(staging);
+    staging = nullptr;
+    ring.reset();
+
+    Stats stats = getStats();
+    LOG_INFO("⏹️ Recorded %lld frames (%.1f s) to %s: %lld blocks dropped (%lld frames), %lld writes, "
+             "max write %.1f ms, ring peak %.0f%%",
+             stats.framesWritten, stats.framesWritten / rate, path.c_str(), stats.droppedBlocks, stats.droppedFrames,
+             stats.writes, stats.maxWriteMs, stats.peakFill * 100.0);
+}
+
+void DiskRecorder::push(const float* interleaved, int frames, int channels) {
+    // stop() waits while pushing is up, so the ring cannot go away under us
+    pushing.store(true);
+    if (!armed.load()) {
+        pushing.store(false, std::memory_order_release);
+        return;
+    }
+    const size_t samples = static_cast<size_t>(frames) * channels;
+    const size_t write = writePosition.load(std::memory_order_relaxed);
+    const size_t read = readPosition.load(std::memory_order_acquire);
+    if (channels != channelCount || samples > ringMask + 1 - (write - read)) {
+        droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+        droppedFrames.fetch_add(frames, std::memory_order_relaxed);
+        pushing.store(false, std::memory_order_release);
+        return;
+    }
+    // Up to two copies around the end of the ring
+    const size_t start = write & ringMask;
+    const size_t first = std::min(samples, ringMask + 1 - start);
+    std::memcpy(ring.get() + start, interleaved, first * sizeof(float));
+    std::memcpy(ring.get(), interleaved + first, (samples - first) * sizeof(float));
+    writePosition.store(write + samples, std::memory_order_release);
+    pushing.store(false, std::memory_order_release);
+}
+
+DiskRecorder::Stats DiskRecorder::getStats() const {
+    Stats stats;
+    stats.framesWritten = channelCount > 0 ? samplesWritten.load(std::memory_order_relaxed) / channelCount : 0;
+    stats.droppedBlocks = droppedBlocks.load(std::memory_order_relaxed);
+    stats.droppedFrames = droppedFrames.load(std::memory_order_relaxed);
+    stats.writes = writes.load(std::memory_order_relaxed);
+    stats.maxWriteMs = maxWriteMs.load(std::memory_order_relaxed);
+    stats.peakFill = peakFill.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+// Writer thread
+// -----------------------------------------------------------------------------
+void DiskRecorder::writerLoop() {
+    // Wake a few times per chunk so the ring never holds much more than one
+    const double chunkMs = 1000.0 * writeSamples / channelCount / rate;
+    const auto idle = std::chrono::microseconds(static_cast<long>(std::clamp(chunkMs / 4.0, 1.0, 20.0) * 1000.0));
+    const double capacity = static_cast<double>(ringMask + 1);
+    while (!stopping.load(std::memory_order_acquire)) {
+        size_t available = writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed);
+        peakFill.store(std::max(peakFill.load(std::memory_order_relaxed), available / capacity),
+                       std::memory_order_relaxed);
+        if (available >= writeSamples) {
+            writeChunk(writeSamples);
+        } else {
+            std::this_thread::sleep_for(idle);
+        }
+    }
+
+    // Drain: whole chunks first, then the tail, which O_DIRECT cannot take
+    size_t available = writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed);
+    for (; available >= writeSamples; available -= writeSamples) writeChunk(writeSamples);
+#ifdef O_DIRECT
+    if (direct) ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+#endif
+    if (available > 0) writeChunk(available);
+}
+
+bool DiskRecorder::writeChunk(size_t count) {
+    const size_t read = readPosition.load(std::memory_order_relaxed);
+    const size_t start = read & ringMask;
+    const size_t first = std::min(count, ringMask + 1 - start);
+    std::memcpy(staging, ring.get() + start, first * sizeof(float));
+    std::memcpy(staging + first, ring.get(), (count - first) * sizeof(float));
+    readPosition.store(read + count, std::memory_order_release);  // The audio thread may reuse the space now
+
+    if (failed) {
+        // The file is gone; keep the ring moving and account for the loss
+        droppedFrames.fetch_add(static_cast<long long>(count / channelCount), std::memory_order_relaxed);
+        return false;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    if (!writeAll(staging, count * sizeof(float))) {
+        LOG_ERROR("❌ Recorder: writing '%s' failed (%s), the rest is dropped", path.c_str(), std::strerror(errno));
+        failed = true;
+        droppedFrames.fetch_add(static_cast<long long>(count / channelCount), std::memory_order_relaxed);
+        return false;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    maxWriteMs.store(std::max(maxWriteMs.load(std::memory_order_relaxed), ms), std::memory_order_relaxed);
+    writes.fetch_add(1, std::memory_order_relaxed);
+    samplesWritten.fetch_add(static_cast<long long>(count), std::memory_order_relaxed);
+    fileBytes += static_cast<long long>(count * sizeof(float));
+    return true;
+}
+
+bool DiskRecorder::writeAll(const void* data, size_t bytes) {
+    const char* bytesLeft = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, bytesLeft, bytes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytesLeft += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void DiskRecorder::finishFile() {
+    if (fd < 0) return;
+    if (format == Format::Wav) {
+        // RIFF sizes are 32-bit; a longer take keeps its data but the header saturates
+        const long long limit = 0xffffffffLL - WriteAlignment;
+        if (fileBytes > limit) LOG_WARNING("⚠️ Recorder: '%s' exceeds the WAV size limit, use raw for longer takes",
+                                           path.c_str());
+        uint32_t dataBytes = static_cast<uint32_t>(std::min(fileBytes, limit));
+        buildWavHeader(reinterpret_cast<char*>(staging), static_cast<uint32_t>(rate), channelCount, dataBytes);
+        if (::pwrite(fd, staging, WriteAlignment, 0) != WriteAlignment) {
+            LOG_ERROR("❌ Recorder: cannot finish the header of '%s'", path.c_str());
+        }
+    }
+    ::close(fd);
+    fd = -1;
+}
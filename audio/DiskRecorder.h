@@ -0,0 +1,105 @@
+#ifndef DISKRECORDER_H
+#define DISKRECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Records the engine's output to disk without the audio thread ever
+// touching the file.
+//
+// push() copies each rendered block into a lock-free single-producer ring
+// and returns; a writer thread streams the ring to disk in large aligned
+// writes. When the ring is full the whole block is dropped and counted,
+// never waited for, so a disk stall shows up as a gap in the recording and
+// in the drop counters instead of an xrun.
+//
+// Files are 32-bit float WAV or headerless raw float, interleaved. The WAV
+// header is padded with a JUNK chunk to WriteAlignment bytes so every data
+// write lands on an aligned offset, which lets Options::direct open the file
+// with O_DIRECT and bypass the page cache (falling back to buffered writes
+// where the filesystem refuses it).
+class DiskRecorder {
+public:
+    enum class Format { Wav, Raw };
+
+    static constexpr int WriteAlignment = 4096;  // Bytes; O_DIRECT offsets and sizes
+
+    struct Options {
+        Format format = Format::Wav;
+        double ringSeconds = 2.0;     // Disk stall the ring absorbs before dropping
+        int writeBytes = 1 << 20;     // Bytes per write, a multiple of WriteAlignment
+        bool direct = false;          // O_DIRECT, where supported
+    };
+
+    struct Stats {
+        long long framesWritten = 0;
+        long long droppedBlocks = 0;
+        long long droppedFrames = 0;
+        long long writes = 0;
+        double maxWriteMs = 0.0;
+        double peakFill = 0.0;        // Highest ring fill seen by the writer, 0 to 1
+    };
+
+    DiskRecorder() = default;
+    ~DiskRecorder() { stop(); }
+    DiskRecorder(const DiskRecorder&) = delete;
+    DiskRecorder& operator=(const DiskRecorder&) = delete;
+
+    // Not real-time safe: opens the file, allocates the ring and starts the
+    // writer. False (with a log) if the file cannot be created.
+    bool start(const std::string& path, double sampleRate, int channels, const Options& options);
+    bool start(const std::string& path, double sampleRate, int channels) { return start(path, sampleRate, channels, Options()); }
+    // Drains the ring, finishes the file and logs the counters
+    void stop();
+    bool isRecording() const { return armed.load(std::memory_order_acquire); }
+
+    // Audio thread: queues frames interleaved frames; a block with another
+    // channel count than the recording's is dropped
+    void push(const float* interleaved, int frames, int channels);
+
+    // Snapshot; the counters settle after stop()
+    Stats getStats() const;
+    const std::string& getPath() const { return path; }
+    bool isDirect() const { return direct; }
+
+private:
+    // Ring of interleaved samples; positions count samples and only grow
+    std::unique_ptr<float[]> ring;
+    size_t ringMask = 0;
+    alignas(64) std::atomic<size_t> writePosition{0};   // Audio thread
+    alignas(64) std::atomic<size_t> readPosition{0};    // Writer thread
+    alignas(64) std::atomic<bool> armed{false};
+    std::atomic<bool> pushing{false};
+    std::atomic<long long> droppedBlocks{0};
+    std::atomic<long long> droppedFrames{0};
+
+    // Writer thread
+    std::thread writer;
+    std::atomic<bool> stopping{false};
+    float* staging = nullptr;                   // WriteAlignment-aligned, writeBytes long
+    int fd = -1;
+    bool direct = false;
+    std::string path;
+    Format format = Format::Wav;
+    double rate = 0.0;
+    int channelCount = 0;
+    size_t writeSamples = 0;
+    bool failed = false;                        // A write failed; the rest is dropped
+    std::atomic<long long> samplesWritten{0};
+    std::atomic<long long> writes{0};
+    std::atomic<double> maxWriteMs{0.0};
+    std::atomic<double> peakFill{0.0};
+    long long fileBytes = 0;                    // Data bytes on disk
+
+    void writerLoop();
+    // Copies count samples from the ring into staging and writes them
+    bool writeChunk(size_t count);
+    bool writeAll(const void* data, size_t bytes);
+    void finishFile();
+};
+
+#endif // DISKRECORDER_H
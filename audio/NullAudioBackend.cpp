@@ -0,0 +1,93 @@
+#include "NullAudioBackend.h"
+#include "../core/Logger.h"
+#include "../core/RealtimeSetup.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace {
+
+void putLittleEndian(std::FILE* file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) std::fputc(static_cast<int>((value >> (8 * i)) & 0xff), file);
+}
+
+// 44-byte header of a 32-bit float WAV holding frames interleaved frames
+void writeWavHeader(std::FILE* file, uint32_t sampleRate, uint32_t channels, uint32_t frames) {
+    const uint32_t frameBytes = channels * sizeof(float);
+    const uint32_t dataBytes = frames * frameBytes;
+    std::fputs("RIFF", file);
+    putLittleEndian(file, 36 + dataBytes, 4);
+    std::fputs("WAVEfmt ", file);
+    putLittleEndian(file, 16, 4);                    // fmt chunk size
+    putLittleEndian(file, 3, 2);                     // IEEE float
+    putLittleEndian(file, channels, 2);
+    putLittleEndian(file, sampleRate, 4);
+    putLittleEndian(file, sampleRate * frameBytes, 4);
+    putLittleEndian(file, frameBytes, 2);            // Block align
+    putLittleEndian(file, 32, 2);                    // Bits per sample
+    std::fputs("data", file);
+    putLittleEndian(file, dataBytes, 4);
+}
+
+} // namespace
+
+bool NullAudioBackend::start(const Config& config, RenderCallback renderCallback, void* renderContext) {
+    stop();
+    sampleRate = config.deviceRate > 0.0 ? config.deviceRate : config.sampleRate;
+    channelCount = std::clamp(config.channels, 1, MaxChannels);
+    periodFrames = std::max(1, config.periodFrames);
+    bufferFrames = periodFrames * std::max(1, config.periods);
+
+    if (writeFile) {
+        file = std::fopen(config.path.c_str(), "wb");
+        if (!file) {
+            LOG_ERROR("❌ File backend: cannot write '%s'", config.path.c_str());
+            return false;
+        }
+        writeWavHeader(file, static_cast<uint32_t>(sampleRate), channelCount, 0);  // Sizes are patched in stop()
+    }
+
+    output.configure(renderCallback, renderContext, config.engineRateFor(sampleRate), sampleRate, channelCount,
+                     prepareCallback);
+    period.assign(static_cast<size_t>(periodFrames) * channelCount, 0.0f);
+    framesRendered.store(0);
+    stopping.store(false);
+    running.store(true);
+    thread = std::thread(&NullAudioBackend::run, this);
+    LOG_INFO("🔇 %s backend: %.0f Hz, %d ch, %d frames per period", getName(), sampleRate, channelCount, periodFrames);
+    return true;
+}
+
+void NullAudioBackend::stop() {
+    if (!thread.joinable()) return;
+    stopping.store(true);
+    thread.join();
+    running.store(false);
+
+    if (file) {
+        std::fseek(file, 0, SEEK_SET);
+        writeWavHeader(file, static_cast<uint32_t>(sampleRate), channelCount,
+                       static_cast<uint32_t>(framesRendered.load()));
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void NullAudioBackend::run() {
+    RealtimeSetup::prepareCurrentThread(getName());
+    RealtimeSetup::report();
+
+    // Deadlines come from the period count, so rounding does not accumulate
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    long long periodsDone = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        output.render(period.data(), periodFrames);
+        if (file) std::fwrite(period.data(), sizeof(float), period.size(), file);
+        framesRendered.fetch_add(periodFrames, std::memory_order_relaxed);
+
+        ++periodsDone;
+        std::chrono::duration<double> due(periodsDone * periodFrames / sampleRate);
+        std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(due));
+    }
+}
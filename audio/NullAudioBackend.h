@@ -0,0 +1,41 @@
+#ifndef NULLAUDIOBACKEND_H
+#define NULLAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+#include "OutputStage.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Backend without a device: a thread calls render once per period on the
+// steady clock, as a sound card would. The "null" flavour drops the output;
+// the "file" flavour writes it to Config::path as a 32-bit float WAV with
+// Config::channels channels.
+// Meant for headless runs and tests.
+class NullAudioBackend : public AudioBackend {
+public:
+    explicit NullAudioBackend(bool writeFile = false) : writeFile(writeFile) {}
+    ~NullAudioBackend() override { stop(); }
+
+    bool start(const Config& config, RenderCallback render, void* context) override;
+    void stop() override;
+    bool isRunning() const override { return running.load(); }
+    const char* getName() const override { return writeFile ? "file" : "null"; }
+
+    long long getFramesRendered() const { return framesRendered.load(); }
+
+private:
+    bool writeFile;
+    std::FILE* file = nullptr;
+    OutputStage output;
+    std::vector<float> period;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<long long> framesRendered{0};
+
+    void run();
+};
+
+#endif // NULLAUDIOBACKEND_H
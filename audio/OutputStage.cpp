@@ -0,0 +1,53 @@
+#include "OutputStage.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+void OutputStage::configure(AudioBackend::RenderCallback render, void* renderContext, double engineRate,
+                            double deviceRate, int channelCount, AudioBackend::PrepareCallback prepare) {
+    renderCallback = render;
+    context = renderContext;
+    channels = std::max(1, channelCount);
+    chunk.assign(static_cast<size_t>(ChunkFrames) * channels, 0.0f);
+    engineFrames.clear();
+    resampler.reset();
+    if (std::llround(engineRate) != std::llround(deviceRate)) {
+        resampler = std::make_unique<Resampler>(engineRate, deviceRate, channels);
+        engineFrames.assign(static_cast<size_t>(Resampler::MaxInputFrames) * channels, 0.0f);
+        LOG_INFO("🔁 Device runs at %.0f Hz, the engine at %.0f Hz - resampling %d/%d", deviceRate, engineRate,
+                 resampler->getUpFactor(), resampler->getDownFactor());
+    }
+    if (prepare) prepare(renderContext, engineRate);
+}
+
+void OutputStage::render(float* output, int frames) {
+    if (!resampler) {
+        renderCallback(context, output, frames, channels);
+        return;
+    }
+
+    // Pull as many engine frames as each stretch of device frames needs
+    const int maxCount = resampler->maxOutputFrames();
+    for (int done = 0; done < frames;) {
+        int count = std::min(frames - done, maxCount);
+        int needed = resampler->inputFramesNeeded(count);
+        if (needed > 0) renderCallback(context, engineFrames.data(), needed, channels);
+        resampler->process(engineFrames.data(), needed, output + static_cast<long>(done) * channels, count);
+        done += count;
+    }
+}
+
+void OutputStage::write(void* output, int frames, SampleType type) {
+    // The common case needs no conversion
+    if (type == SampleType::Float32) {
+        render(static_cast<float*>(output), frames);
+        return;
+    }
+    const int frameBytes = bytesPerSample(type) * channels;
+    for (int done = 0; done < frames;) {
+        int count = std::min(frames - done, ChunkFrames);
+        render(chunk.data(), count);
+        convertSamples(chunk.data(), count * channels, type, static_cast<char*>(output) + static_cast<long>(done) * frameBytes);
+        done += count;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef OUTPUTSTAGE_H
+#define OUTPUTSTAGE_H
+
+#include "AudioBackend.h"
+#include "SampleConversion.h"
+#include "../dsp/Resampler.h"
+#include <memory>
+#include <vector>
+
+// Everything between the engine's render and the device buffer. When the
+// device settles on another rate than the engine renders at, a Resampler
+// converts between them; write() then produces the device's sample format.
+// Frames are interleaved with the channel count given to configure(), which
+// the engine renders directly. Every backend renders through one.
+class OutputStage {
+public:
+    static constexpr int ChunkFrames = 1024;
+
+    // Not real-time safe: call before the audio thread starts. prepare, if
+    // given, is told the engine rate before configure() returns.
+    void configure(AudioBackend::RenderCallback render, void* context, double engineRate, double deviceRate,
+                   int channels, AudioBackend::PrepareCallback prepare = nullptr);
+
+    // Interleaved float frames at the device rate
+    void render(float* output, int frames);
+
+    // Interleaved frames in the device's format; float renders in place
+    void write(void* output, int frames, SampleType type);
+
+    int getChannelCount() const { return channels; }
+    bool isResampling() const { return resampler != nullptr; }
+    const Resampler* getResampler() const { return resampler.get(); }
+
+private:
+    AudioBackend::RenderCallback renderCallback = nullptr;
+    void* context = nullptr;
+    int channels = 1;
+    std::unique_ptr<Resampler> resampler;
+    std::vector<float> engineFrames;  // Resampler input, MaxInputFrames frames
+    std::vector<float> chunk;         // Conversion input, ChunkFrames frames
+};
+
+#endif // OUTPUTSTAGE_H
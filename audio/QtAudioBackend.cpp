@@ -0,0 +1,146 @@
+#include "QtAudioBackend.h"
+#include "OutputStage.h"
+#include "../core/Logger.h"
+#include "../core/RealtimeSetup.h"
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QIODevice>
+#include <QMediaDevices>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+// Pull-mode source: every read renders the requested frames
+class AudioIODevice : public QIODevice {
+public:
+    AudioIODevice(OutputStage* output, SampleType type, QObject* parent = nullptr)
+        : QIODevice(parent), output(output), type(type) {
+    }
+
+    qint64 readData(char* data, qint64 maxlen) override {
+        if (!threadPrepared) prepareThread();
+        const int frameBytes = bytesPerSample(type) * output->getChannelCount();
+        const int frames = static_cast<int>(maxlen / frameBytes);
+        output->write(data, frames, type);
+        return static_cast<qint64>(frames) * frameBytes;
+    }
+
+    qint64 writeData(const char*, qint64) override {
+        return 0;
+    }
+
+    bool isSequential() const override {
+        return true;
+    }
+
+    qint64 bytesAvailable() const override {
+        return QIODevice::bytesAvailable() + 1000000;
+    }
+
+    bool atEnd() const override {
+        return false;
+    }
+
+private:
+    OutputStage* output;
+    SampleType type;
+    bool threadPrepared = false;
+
+    // First read: the backend's audio thread is only known once it calls us
+    void prepareThread() {
+        threadPrepared = true;
+        if (QThread::currentThread() == thread()) {
+            // Pull mode on some backends reads from the GUI thread; never make that one FIFO
+            RealtimeSetup::prefaultStack();
+            LOG_INFO("🎧 Audio callback runs on the GUI thread - priority left unchanged");
+        } else {
+            RealtimeSetup::prepareCurrentThread("audio callback");
+        }
+        RealtimeSetup::report();
+    }
+};
+
+} // namespace
+
+bool QtAudioBackend::start(const Config& config, RenderCallback render, void* context) {
+    stop();
+
+    QAudioFormat format;
+    format.setSampleRate(static_cast<int>(config.sampleRate));
+    format.setChannelCount(std::clamp(config.channels, 1, MaxChannels));
+    format.setSampleFormat(QAudioFormat::Float);
+
+    QAudioDevice audioDevice = QMediaDevices::defaultAudioOutput();
+    if (audioDevice.isNull()) {
+        LOG_WARNING("No audio output device found!");
+        return false;
+    }
+    if (!audioDevice.isFormatSupported(format)) {
+        LOG_WARNING("Warning: Default format not supported - trying to use nearest");
+        format = audioDevice.preferredFormat();
+    }
+
+    SampleType type;
+    switch (format.sampleFormat()) {
+    case QAudioFormat::Float: type = SampleType::Float32; break;
+    case QAudioFormat::Int32: type = SampleType::Int32; break;
+    case QAudioFormat::Int16: type = SampleType::Int16; break;
+    default:
+        LOG_ERROR("❌ Qt audio: unsupported device sample format %d", static_cast<int>(format.sampleFormat()));
+        return false;
+    }
+
+    // The preferred format may have another rate and channel count too
+    if (format.channelCount() > MaxChannels) {
+        LOG_ERROR("❌ Qt audio: device needs %d channels, the engine renders at most %d", format.channelCount(), MaxChannels);
+        return false;
+    }
+    output.configure(render, context, config.engineRateFor(format.sampleRate()), format.sampleRate(),
+                     format.channelCount(), prepareCallback);
+    sink = new QAudioSink(audioDevice, format);
+    sink->setBufferSize(static_cast<qsizetype>(config.periods) * config.periodFrames * format.bytesPerFrame());
+    sink->setVolume(1.0);
+    device = new AudioIODevice(&output, type);
+    device->open(QIODevice::ReadOnly);
+    sink->start(device);
+
+    QAudioSink* audioSink = sink;
+    QObject::connect(sink, &QAudioSink::stateChanged, sink, [audioSink](QAudio::State state) {
+        switch (state) {
+            case QAudio::IdleState:
+                LOG_DEBUG("Audio system idle");
+                break;
+            case QAudio::StoppedState:
+                // Check for errors
+                if (audioSink->error() != QAudio::NoError) {
+                    LOG_WARNING("Audio output error: %d", static_cast<int>(audioSink->error()));
+                }
+                break;
+            default:
+                break;
+        }
+    });
+
+    // Qt exposes no period; report its buffer split the way it was requested
+    sampleRate = format.sampleRate();
+    channelCount = format.channelCount();
+    bufferFrames = static_cast<int>(sink->bufferSize() / format.bytesPerFrame());
+    periodFrames = bufferFrames / std::max(1, config.periods);
+    LOG_INFO("🔊 Qt audio: %.0f Hz, %d ch, buffer %d frames", sampleRate, format.channelCount(), bufferFrames);
+    return true;
+}
+
+void QtAudioBackend::stop() {
+    if (sink) {
+        sink->stop();
+        sink->deleteLater();
+        sink = nullptr;
+    }
+
+    if (device) {
+        device->close();
+        device->deleteLater();
+        device = nullptr;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef QTAUDIOBACKEND_H
+#define QTAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+#include "OutputStage.h"
+
+class QAudioSink;
+class QIODevice;
+
+// QAudioSink in pull mode: the sink reads from a QIODevice whose readData
+// renders. Qt keeps its own buffer on top of the device's, sized here from
+// the requested periods; use "alsa" on Linux for the lowest latency.
+class QtAudioBackend : public AudioBackend {
+public:
+    ~QtAudioBackend() override { stop(); }
+
+    bool start(const Config& config, RenderCallback render, void* context) override;
+    void stop() override;
+    bool isRunning() const override { return sink != nullptr; }
+    const char* getName() const override { return "qt"; }
+
+private:
+    QAudioSink* sink = nullptr;
+    QIODevice* device = nullptr;
+    OutputStage output;
+};
+
+#endif // QTAUDIOBACKEND_H
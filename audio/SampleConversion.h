@@ -0,0 +1,41 @@
+#ifndef SAMPLECONVERSION_H
+#define SAMPLECONVERSION_H
+
+#include <algorithm>
+#include <cstdint>
+
+// Device sample layouts the backends can write. Integer formats are
+// little-endian like every host we build for.
+enum class SampleType { Float32, Int32, Int16 };
+
+inline int bytesPerSample(SampleType type) {
+    return type == SampleType::Int16 ? 2 : 4;
+}
+
+// Converts count float samples (interleaved frames keep their layout);
+// integer samples are clipped to full scale
+inline void convertSamples(const float* input, int count, SampleType type, void* output) {
+    switch (type) {
+    case SampleType::Float32:
+        std::copy(input, input + count, static_cast<float*>(output));
+        break;
+    case SampleType::Int32: {
+        int32_t* out = static_cast<int32_t*>(output);
+        for (int i = 0; i < count; ++i) {
+            double clipped = std::clamp(static_cast<double>(input[i]), -1.0, 1.0);
+            out[i] = static_cast<int32_t>(clipped * 2147483647.0);
+        }
+        break;
+    }
+    case SampleType::Int16: {
+        int16_t* out = static_cast<int16_t*>(output);
+        for (int i = 0; i < count; ++i) {
+            float clipped = std::clamp(input[i], -1.0f, 1.0f);
+            out[i] = static_cast<int16_t>(clipped * 32767.0f);
+        }
+        break;
+    }
+    }
+}
+
+#endif // SAMPLECONVERSION_H
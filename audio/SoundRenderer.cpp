@@ -0,0 +1,172 @@
+#include "SoundRenderer.h"
+#include "../core/RealtimeCheck.h"
+#include "../dsp/ChannelKernels.h"
+#include <algorithm>
+
+SoundRenderer::SoundRenderer(SoundExchange* exchange) {
+    parts[0].exchange.store(exchange, std::memory_order_relaxed);
+}
+
+void SoundRenderer::render(float* output, int numFrames, int channelCount) {
+    RealtimeCheck::Scope realtime;  // Everything below must be real-time safe
+
+    // Preset switches land here, between two device periods. Bypassed and
+    // empty parts are not touched at all.
+    ActivePart active[MaxParts];
+    int activeCount = 0;
+    const double rate = sampleRate.load(std::memory_order_acquire);
+    for (Part& part : parts) {
+        SoundExchange* exchange = part.exchange.load(std::memory_order_acquire);
+        if (!exchange || part.bypassed.load(std::memory_order_relaxed)) continue;
+        Sound* sound = exchange->acquire();
+        if (!sound) continue;
+        if (rate > 0.0 && sound->getSampleRate() != rate) sound->setSampleRate(rate);
+        active[activeCount++] = {sound, part.volume.load(std::memory_order_relaxed),
+                                 part.pan.load(std::memory_order_relaxed), part.send.load(std::memory_order_relaxed)};
+    }
+    activePartCount.store(activeCount, std::memory_order_relaxed);
+
+    // The send effect runs while anything feeds it and until its tail has rung out
+    Filter* effect = sendEffect.load(std::memory_order_acquire);
+    if (effect) {
+        if (rate > 0.0 && effect->getSampleRate() != rate) effect->setSampleRate(rate);
+        for (int p = 0; p < activeCount; ++p) {
+            if (active[p].send > 0.0) sendTailFrames = static_cast<long long>(SendTailSeconds * effect->getSampleRate());
+        }
+        if (sendTailFrames <= 0) effect = nullptr;
+        sendTailFrames -= numFrames;
+    }
+
+    DiskRecorder* record = recorder.load(std::memory_order_acquire);
+    if (activeCount == 0 && !effect) {
+        std::fill(output, output + static_cast<long>(numFrames) * channelCount, 0.0f);
+        framesRendered.fetch_add(numFrames, std::memory_order_relaxed);  // Silence is part of the timeline
+        if (record) record->push(output, numFrames, channelCount);
+        return;
+    }
+
+    // One part at unity gain needs no mix buffer
+    const bool direct = !effect && activeCount == 1 && active[0].volume == 1.0 && active[0].pan == 0.0;
+
+    // Each part's gains: its volume times the balance at each channel
+    double gains[MaxParts][Sound::MaxChannels];
+    for (int p = 0; p < activeCount; ++p) {
+        channels::balanceGains(active[p].pan, channelCount, gains[p]);
+        for (int c = 0; c < channelCount; ++c) gains[p][c] *= active[p].volume;
+    }
+
+    // Render in blocks so each Sound can spread its layers over the worker pool
+    const double* planar[Sound::MaxChannels];
+    for (int offset = 0; offset < numFrames; offset += Sound::MaxBlockSize) {
+        int count = std::min(Sound::MaxBlockSize, numFrames - offset);
+        float* out = output + static_cast<long>(offset) * channelCount;
+        if (direct) {
+            renderPart(active[0].sound, count, channelCount, planar);
+            channels::interleave(planar, channelCount, out, count);
+            continue;
+        }
+
+        double* mixed[Sound::MaxChannels];
+        for (int c = 0; c < channelCount; ++c) {
+            mixed[c] = mix[c];
+            std::fill(mix[c], mix[c] + count, 0.0);
+        }
+        if (effect) std::fill(sendBus, sendBus + count, 0.0);
+        for (int p = 0; p < activeCount; ++p) {
+            renderPart(active[p].sound, count, channelCount, planar);
+            for (int c = 0; c < channelCount; ++c) {
+                channels::mixPanned(planar[c], &gains[p][c], &mixed[c], 1, count);
+            }
+            if (effect && active[p].send > 0.0) {
+                // The part's channels, averaged, at its send level
+                double* bus = sendBus;
+                const double sendGain = active[p].send * active[p].volume / channelCount;
+                for (int c = 0; c < channelCount; ++c) channels::mixPanned(planar[c], &sendGain, &bus, 1, count);
+            }
+        }
+        if (effect) {
+            effect->processBuffer(sendBus, count);
+            const double unity = 1.0;
+            for (int c = 0; c < channelCount; ++c) channels::mixPanned(sendBus, &unity, &mixed[c], 1, count);
+        }
+        channels::interleave(mixed, channelCount, out, count);
+    }
+    framesRendered.fetch_add(numFrames, std::memory_order_relaxed);
+    if (record) record->push(output, numFrames, channelCount);  // Never blocks; a full ring drops the block
+}
+
+void SoundRenderer::renderPart(Sound* sound, int count, int channelCount, const double** planar) {
+    const int soundChannels = sound->getChannelCount();
+    if (soundChannels == 1 || channelCount == 1) {
+        sound->generateSamples(blocks[0], count);  // A multichannel Sound averages its channels
+        for (int c = 0; c < channelCount; ++c) planar[c] = blocks[0];
+        return;
+    }
+    double* rendered[Sound::MaxChannels] = {};
+    for (int c = 0; c < soundChannels; ++c) rendered[c] = blocks[c];
+    sound->generateChannels(rendered, count);
+    if (soundChannels > channelCount) {
+        // Fold down: each Sound channel is a source at its place on the arc,
+        // panned onto the output's arc like a layer
+        double* outputs[Sound::MaxChannels];
+        for (int c = 0; c < channelCount; ++c) {
+            outputs[c] = folded[c];
+            std::fill(folded[c], folded[c] + count, 0.0);
+        }
+        for (int s = 0; s < soundChannels; ++s) {
+            double gains[Sound::MaxChannels];
+            channels::constantPowerGains(-1.0 + 2.0 * s / (soundChannels - 1), channelCount, gains);
+            channels::mixPanned(blocks[s], gains, outputs, channelCount, count);
+        }
+        for (int c = 0; c < channelCount; ++c) planar[c] = folded[c];
+        return;
+    }
+    for (int c = 0; c < channelCount; ++c) planar[c] = c < soundChannels ? blocks[c] : silence;
+}
+
+void SoundRenderer::renderCallback(void* context, float* output, int numFrames, int channelCount) {
+    static_cast<SoundRenderer*>(context)->render(output, numFrames, channelCount);
+}
+
+void SoundRenderer::prepareCallback(void* context, double engineRate) {
+    static_cast<SoundRenderer*>(context)->setSampleRate(engineRate);
+}
+
+// -----------------------------------------------------------------------------
+// Parts
+// -----------------------------------------------------------------------------
+void SoundRenderer::setPartExchange(int part, SoundExchange* exchange) {
+    if (part >= 0 && part < MaxParts) parts[part].exchange.store(exchange, std::memory_order_release);
+}
+
+void SoundRenderer::setPartVolume(int part, double volume) {
+    if (part >= 0 && part < MaxParts) parts[part].volume.store(std::clamp(volume, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+void SoundRenderer::setPartPan(int part, double pan) {
+    if (part >= 0 && part < MaxParts) parts[part].pan.store(std::clamp(pan, -1.0, 1.0), std::memory_order_relaxed);
+}
+
+void SoundRenderer::setPartBypassed(int part, bool bypassed) {
+    if (part >= 0 && part < MaxParts) parts[part].bypassed.store(bypassed, std::memory_order_relaxed);
+}
+
+void SoundRenderer::setPartSend(int part, double level) {
+    if (part >= 0 && part < MaxParts) parts[part].send.store(std::clamp(level, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+double SoundRenderer::getPartSend(int part) const {
+    return (part >= 0 && part < MaxParts) ? parts[part].send.load(std::memory_order_relaxed) : 0.0;
+}
+
+double SoundRenderer::getPartVolume(int part) const {
+    return (part >= 0 && part < MaxParts) ? parts[part].volume.load(std::memory_order_relaxed) : 0.0;
+}
+
+double SoundRenderer::getPartPan(int part) const {
+    return (part >= 0 && part < MaxParts) ? parts[part].pan.load(std::memory_order_relaxed) : 0.0;
+}
+
+bool SoundRenderer::isPartBypassed(int part) const {
+    return (part >= 0 && part < MaxParts) && parts[part].bypassed.load(std::memory_order_relaxed);
+}
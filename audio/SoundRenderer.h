@@ -0,0 +1,120 @@
+#ifndef SOUNDRENDERER_H
+#define SOUNDRENDERER_H
+
+#include "../core/Sound.h"
+#include "../core/SoundExchange.h"
+#include "DiskRecorder.h"
+#include <atomic>
+
+// The engine side of every audio backend: picks up the Sounds published
+// through the part exchanges and renders them in graph-sized blocks.
+// Qt-free, so the offline bench drives the same path as the live backends.
+//
+// Up to MaxParts parts play at once, each an independent Sound with its
+// own exchange, volume, pan and bypass. Parts are mixed in planar doubles
+// and interleaved once. A part without a Sound, or bypassed, is skipped
+// before its exchange is even read, so idle parts cost nothing; a single
+// part at unity gain renders straight to the output as if there were no
+// mixer.
+//
+// Output is interleaved float with the channel count the backend asks for.
+// A Sound built with that many channels is interleaved as is; a mono Sound
+// is copied to every channel, and missing channels are left silent. A Sound
+// with more channels is folded down: into a mono output by averaging, into
+// more than one by panning each of its channels from its place on the arc
+// with the constant-power gains of a layer (a channel that falls on an
+// output channel goes there whole).
+//
+// A send effect (a Filter, typically FDNReverb at 100 % wet) can sit on a
+// mono send bus: each part feeds it at its send level and its output
+// returns to every channel. It keeps running for SendTailSeconds after the
+// last send so its tail rings out, and costs nothing otherwise.
+//
+// Every period it renders, silence included, is also handed to the
+// attached DiskRecorder, which queues it without blocking.
+//
+// The renderer also owns the engine's sample rate. A Sound picked up at
+// another rate (built before the device settled, or before a rate change)
+// is switched over at the start of its first period here, on the audio
+// thread and between two blocks.
+class SoundRenderer {
+public:
+    static constexpr int MaxParts = 16;
+    static constexpr double SendTailSeconds = 20.0;
+
+    // exchange becomes part 0
+    explicit SoundRenderer(SoundExchange* exchange = nullptr);
+
+    // Fills output with numFrames interleaved frames; silence until a Sound is published
+    void render(float* output, int numFrames, int channelCount = 1);
+
+    // AudioBackend::RenderCallback with a SoundRenderer as context
+    static void renderCallback(void* context, float* output, int numFrames, int channelCount);
+    // AudioBackend::PrepareCallback: the engine rate, set before the first render
+    static void prepareCallback(void* context, double engineRate);
+
+    // Any thread: every frame handed to the device, silent ones included
+    long long getFramesRendered() const { return framesRendered.load(std::memory_order_relaxed); }
+
+    // Any thread; takes effect at the next period. 0 leaves every Sound at
+    // the rate it was built for.
+    void setSampleRate(double rate) { sampleRate.store(rate, std::memory_order_release); }
+    double getSampleRate() const { return sampleRate.load(std::memory_order_acquire); }
+
+    // Parts, any thread; changes take effect at the next period. The
+    // exchange must outlive the renderer or be detached (nullptr) while the
+    // audio thread is stopped.
+    void setPartExchange(int part, SoundExchange* exchange);
+    void setPartVolume(int part, double volume);   // 0 to 1
+    void setPartPan(int part, double pan);         // Balance, -1 to +1
+    void setPartBypassed(int part, bool bypassed);
+    double getPartVolume(int part) const;
+    double getPartPan(int part) const;
+    bool isPartBypassed(int part) const;
+    void setPartSend(int part, double level);     // 0 to 1
+    double getPartSend(int part) const;
+    // The effect on the send bus, nullptr for none. It runs on the audio
+    // thread at the renderer's rate; it must outlive the renderer or be
+    // detached while the audio thread is stopped.
+    void setSendEffect(Filter* effect) { sendEffect.store(effect, std::memory_order_release); }
+    // Receives every rendered period; the recorder must outlive the renderer
+    // or be detached while the audio thread is stopped
+    void setRecorder(DiskRecorder* diskRecorder) { recorder.store(diskRecorder, std::memory_order_release); }
+
+    // Parts rendered in the last period
+    int getActivePartCount() const { return activePartCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Part {
+        std::atomic<SoundExchange*> exchange{nullptr};
+        std::atomic<double> volume{1.0};
+        std::atomic<double> pan{0.0};
+        std::atomic<bool> bypassed{false};
+        std::atomic<double> send{0.0};
+    };
+    struct ActivePart {
+        Sound* sound;
+        double volume;
+        double pan;
+        double send;
+    };
+
+    Part parts[MaxParts];
+    std::atomic<double> sampleRate{0.0};
+    std::atomic<int> activePartCount{0};
+    std::atomic<DiskRecorder*> recorder{nullptr};
+    std::atomic<Filter*> sendEffect{nullptr};
+    std::atomic<long long> framesRendered{0};
+    long long sendTailFrames = 0;  // Frames the send effect still runs without input
+    double blocks[Sound::MaxChannels][Sound::MaxBlockSize];
+    double mix[Sound::MaxChannels][Sound::MaxBlockSize];
+    double folded[Sound::MaxChannels][Sound::MaxBlockSize];  // A part with more channels than the output
+    double silence[Sound::MaxBlockSize] = {};
+    double sendBus[Sound::MaxBlockSize];
+
+    // Renders count frames of the Sound into blocks, mapped onto channelCount
+    // channels; planar receives the channel pointers
+    void renderPart(Sound* sound, int count, int channelCount, const double** planar);
+};
+
+#endif // SOUNDRENDERER_H
@@ -0,0 +1,149 @@
+#include "VirtualAudioBackend.h"
+#include "../core/Logger.h"
+#include "../core/RealtimeSetup.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+double secondsSince(SteadyClock::time_point origin) {
+    return std::chrono::duration<double>(SteadyClock::now() - origin).count();
+}
+
+} // namespace
+
+bool VirtualAudioBackend::start(const Config& config, RenderCallback renderCallback, void* renderContext) {
+    stop();
+    sampleRate = config.deviceRate > 0.0 ? config.deviceRate : config.sampleRate;
+    channelCount = std::clamp(config.channels, 1, MaxChannels);
+    periodFrames = std::max(1, config.periodFrames);
+    bufferFrames = periodFrames * std::max(2, config.periods);
+    clockSpeed = std::max(0.0, config.clockSpeed);
+
+    output.configure(renderCallback, renderContext, config.engineRateFor(sampleRate), sampleRate, channelCount,
+                     prepareCallback);
+    period.assign(static_cast<size_t>(periodFrames) * channelCount, 0.0f);
+    stats = Stats();
+    stopping.store(false);
+    running.store(true);
+    thread = std::thread(&VirtualAudioBackend::run, this);
+    LOG_INFO("🧪 Virtual device: %.0f Hz, %d ch, period %d x %d, clock %s", sampleRate, channelCount, periodFrames,
+             bufferFrames / periodFrames, clockSpeed > 0.0 ? "paced" : "simulated");
+    return true;
+}
+
+void VirtualAudioBackend::stop() {
+    if (!thread.joinable()) return;
+    stopping.store(true);
+    thread.join();
+    running.store(false);
+    logStats();
+}
+
+void VirtualAudioBackend::finish() {
+    if (!thread.joinable()) return;
+    thread.join();
+    running.store(false);
+    logStats();
+}
+
+void VirtualAudioBackend::run() {
+    RealtimeSetup::prepareCurrentThread("virtual device");
+
+    const bool paced = clockSpeed > 0.0;
+    const double framesPerSecond = sampleRate * (paced ? clockSpeed : 1.0);
+    const double periodSeconds = periodFrames / framesPerSecond;
+    const auto wallOrigin = SteadyClock::now();
+
+    // Time in seconds: the steady clock when paced, simulated otherwise
+    double now = 0.0;
+    auto renderPeriod = [&]() {
+        auto renderStart = SteadyClock::now();
+        output.render(period.data(), periodFrames);
+        double renderSeconds = secondsSince(renderStart);
+        now = paced ? secondsSince(wallOrigin) : now + renderSeconds;
+        return renderSeconds;
+    };
+
+    // The DAC has consumed startFrame + (t - clockOrigin) * framesPerSecond
+    // frames at time t. It starts once the ring is full.
+    long long written = 0;
+    double clockOrigin = 0.0;
+    double startFrame = 0.0;
+    auto refill = [&]() {
+        for (int p = 0; p < bufferFrames / periodFrames; ++p) {
+            renderPeriod();
+            written += periodFrames;
+        }
+        clockOrigin = now;
+        startFrame = static_cast<double>(written - bufferFrames);
+    };
+    auto consumedAt = [&](double t) { return startFrame + (t - clockOrigin) * framesPerSecond; };
+
+    double jitterSum = 0.0, jitterSquares = 0.0, renderSum = 0.0, fillSum = 0.0;
+    refill();
+    while (!stopping.load(std::memory_order_relaxed) && (runFrames == 0 || written < runFrames)) {
+        // Deadline: the DAC has freed one period
+        double wakeFrame = static_cast<double>(written - bufferFrames + periodFrames);
+        double target = clockOrigin + (wakeFrame - startFrame) / framesPerSecond;
+        if (paced) {
+            auto due = wallOrigin + std::chrono::duration_cast<SteadyClock::duration>(std::chrono::duration<double>(target));
+            std::this_thread::sleep_until(due);
+            now = secondsSince(wallOrigin);
+        } else {
+            now = std::max(now, target);  // Idle time is skipped
+        }
+
+        double lateUs = std::max(0.0, now - target) * 1e6;
+        double fill = (written - consumedAt(now)) / bufferFrames;
+        if (fill <= 0.0) {
+            // Woke up after the ring ran dry
+            ++stats.xruns;
+            refill();
+            continue;
+        }
+
+        double renderSeconds = renderPeriod();
+        if (consumedAt(now) > static_cast<double>(written)) {
+            // The DAC ran dry while this period was rendering
+            ++stats.xruns;
+            refill();
+            continue;
+        }
+        written += periodFrames;
+
+        ++stats.periods;
+        jitterSum += lateUs;
+        jitterSquares += lateUs * lateUs;
+        stats.maxJitterUs = std::max(stats.maxJitterUs, lateUs);
+        renderSum += renderSeconds;
+        stats.maxRenderUs = std::max(stats.maxRenderUs, renderSeconds * 1e6);
+        stats.peakLoad = std::max(stats.peakLoad, renderSeconds / periodSeconds);
+        fillSum += fill;
+        stats.minFill = std::min(stats.minFill, fill);
+        int bin = std::min(Stats::FillBins - 1, static_cast<int>(fill * Stats::FillBins));
+        ++stats.fillHistogram[bin];
+    }
+
+    stats.frames = written;
+    if (stats.periods > 0) {
+        double count = static_cast<double>(stats.periods);
+        stats.meanJitterUs = jitterSum / count;
+        stats.jitterDeviationUs = std::sqrt(std::max(0.0, jitterSquares / count - stats.meanJitterUs * stats.meanJitterUs));
+        stats.meanRenderUs = renderSum / count * 1e6;
+        stats.meanLoad = renderSum / count / periodSeconds;
+        stats.meanFill = fillSum / count;
+    }
+    if (!stopping.load()) running.store(false);
+}
+
+void VirtualAudioBackend::logStats() const {
+    LOG_INFO("🧪 Virtual device: %lld periods, %ld xruns, jitter %.1f/%.1f us (mean/max), "
+             "render %.1f/%.1f us, load %.0f%%/%.0f%%, fill min %.0f%% mean %.0f%%",
+             stats.periods, stats.xruns, stats.meanJitterUs, stats.maxJitterUs,
+             stats.meanRenderUs, stats.maxRenderUs, stats.meanLoad * 100.0, stats.peakLoad * 100.0,
+             stats.minFill * 100.0, stats.meanFill * 100.0);
+}
@@ -0,0 +1,74 @@
+#ifndef VIRTUALAUDIOBACKEND_H
+#define VIRTUALAUDIOBACKEND_H
+
+#include "AudioBackend.h"
+#include "OutputStage.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Simulated sound card for load and dropout testing without hardware.
+//
+// The device has a ring of periods * periodFrames frames that a virtual DAC
+// drains at the sample rate. Like an ALSA driver, the backend's thread
+// wakes whenever a period of space is free, renders one period and commits
+// it. If the DAC catches up with the last committed frame first, that is an
+// xrun: it is counted, the ring is refilled and the clock restarts, as
+// snd_pcm_recover() would.
+//
+// Config::clockSpeed sets the DAC clock. At 1 it follows the steady clock,
+// and above 1 it drains faster than real time, so each period has less time.
+// At 0 the clock is simulated: the thread never sleeps and time advances by
+// the measured render cost, jumping over idle gaps. That gives the outcome
+// of a perfectly scheduled real-time run as fast as the CPU allows, with
+// zero wake-up jitter.
+class VirtualAudioBackend : public AudioBackend {
+public:
+    struct Stats {
+        static constexpr int FillBins = 8;
+
+        long long periods = 0;
+        long long frames = 0;
+        long xruns = 0;
+        double meanJitterUs = 0.0;    // Wake-up lateness against the period deadline
+        double maxJitterUs = 0.0;
+        double jitterDeviationUs = 0.0;
+        double meanRenderUs = 0.0;
+        double maxRenderUs = 0.0;
+        double meanLoad = 0.0;        // Render time / period duration
+        double peakLoad = 0.0;
+        double minFill = 1.0;         // Ring fill at wake-up, as a fraction of the ring
+        double meanFill = 0.0;
+        long long fillHistogram[FillBins] = {};
+    };
+
+    ~VirtualAudioBackend() override { stop(); }
+
+    bool start(const Config& config, RenderCallback render, void* context) override;
+    void stop() override;
+    bool isRunning() const override { return running.load(); }
+    const char* getName() const override { return "virtual"; }
+
+    // Ends the run by itself after this many frames; 0 runs until stop()
+    void setRunLength(long long frames) { runFrames = frames; }
+    // Waits for a run with a length to end
+    void finish();
+
+    // Complete once the run has ended (after stop() or finish())
+    const Stats& getStats() const { return stats; }
+    void logStats() const;
+
+private:
+    OutputStage output;
+    double clockSpeed = 1.0;
+    long long runFrames = 0;
+    std::vector<float> period;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    Stats stats;
+
+    void run();
+};
+
+#endif // VIRTUALAUDIOBACKEND_H
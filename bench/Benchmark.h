@@ -0,0 +1,64 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal offline benchmark helpers - no Qt, no audio device.
+namespace bench {
+
+constexpr double BenchSampleRate = 44100.0;
+constexpr int BenchBlockSize = 512;
+
+// Keeps the optimizer from discarding rendered samples
+extern volatile double sink;
+
+// Calls renderBlock(buffer, BenchBlockSize) until totalSamples have been produced
+// and returns the average cost in nanoseconds per sample.
+inline double measureNsPerSample(const std::function<void(double*, int)>& renderBlock,
+                                 int totalSamples = static_cast<int>(BenchSampleRate) * 2) {
+    std::vector<double> buffer(BenchBlockSize, 0.0);
+
+    // Warm-up block so first-touch costs do not skew the result
+    renderBlock(buffer.data(), BenchBlockSize);
+
+    auto start = std::chrono::steady_clock::now();
+    int rendered = 0;
+    while (rendered < totalSamples) {
+        renderBlock(buffer.data(), BenchBlockSize);
+        sink = sink + buffer[0];
+        rendered += BenchBlockSize;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / rendered;
+}
+
+// Formats a ratio like "x2.40 vs 1x"
+inline std::string ratioNote(double ratio, const std::string& suffix) {
+    std::ostringstream note;
+    note << "x" << std::fixed << std::setprecision(2) << ratio << " " << suffix;
+    return note.str();
+}
+
+inline void printHeader(const std::string& title) {
+    std::cout << "\n=== " << title << " ===" << std::endl;
+}
+
+inline void printResult(const std::string& name, double nsPerSample, const std::string& note = "") {
+    // Real-time load at 44.1 kHz: 1e9 / 44100 ns are available per sample
+    double load = nsPerSample * BenchSampleRate / 1e9 * 100.0;
+    std::cout << "  " << std::left << std::setw(36) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1) << nsPerSample << " ns/sample"
+              << std::setw(9) << std::setprecision(2) << load << " % RT";
+    if (!note.empty()) std::cout << "  " << note;
+    std::cout << std::endl;
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_H
@@ -0,0 +1,3327 @@
+// Offline benchmark harness for the synthesis graph.
+// Build with `make bench` and run `./synth_bench [section ...]`.
+#include "Benchmark.h"
+#include "../core/Sound.h"
+#include "../core/Oversampler.h"
+#include "../core/WorkerPool.h"
+#include "../core/Logger.h"
+#include "../dsp/FastMath.h"
+#include "../dsp/Resampler.h"
+#include "../interface/LiveController.h"
+#include "../presets/PresetManager.h"
+#include "../presets/PatchFormat.h"
+#include "../presets/CompiledPatch.h"
+#include "../presets/PresetCache.h"
+#include "../core/SoundExchange.h"
+#include "../core/RealtimeCheck.h"
+#include "../core/RealtimeSetup.h"
+#include "../audio/SoundRenderer.h"
+#include "../audio/OutputStage.h"
+#include "../audio/DiskRecorder.h"
+#include "../audio/NullAudioBackend.h"
+#include "../audio/AlsaAudioBackend.h"
+#include "../audio/VirtualAudioBackend.h"
+#include "../oscillators/SineOscillator.h"
+#include "../oscillators/SawOscillator.h"
+#include "../oscillators/OversampledOscillator.h"
+#include "../oscillators/SampleOscillator.h"
+#include "../oscillators/GranularOscillator.h"
+#include "../synthesizers/FMSynthesizer.h"
+#include "../synthesizers/AdditiveSynthesizer.h"
+#include "../synthesizers/VoiceLaneSynthesizer.h"
+#include "../envelopes/Envelope.h"
+#include "../filters/LowPassFilter.h"
+#include "../filters/OversampledFilter.h"
+#include "../filters/ConvolutionFilter.h"
+#include "../filters/FDNReverb.h"
+#include "../filters/TempoDelay.h"
+#include "../dsp/FFT.h"
+#include "../dsp/ChannelKernels.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <set>
+#include <thread>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+volatile double bench::sink = 0.0;
+
+// Every heap allocation in the harness is counted (see the arena section).
+// GCC pairs the inlined new/delete by name and flags malloc/free as mismatched.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+static std::atomic<long> heapAllocations{0};
+static std::atomic<long> heapFrees{0};
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory) heapFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept { operator delete(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { operator delete(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { operator delete(memory); }
+
+using namespace bench;
+
+// --update: the golden and budgets sections rewrite their reference files
+// instead of checking against them
+static bool updateReferences = false;
+// --budget-tolerance=PCT: allowed slowdown against bench/budgets.txt, relative
+// to the machine's speed on the reference workload
+static double budgetTolerance = 0.40;
+
+// -----------------------------------------------------------------------------
+// Presets: full Sound graph cost for every registered preset
+// -----------------------------------------------------------------------------
+static bool benchPresets() {
+    printHeader("Presets");
+    PresetManager presetManager;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        Sound sound(BenchSampleRate);
+        LiveController controller;
+        presetManager.loadPreset(i, &sound, controller);
+        sound.noteOn();
+
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            sound.generateSamples(buffer, n);
+        });
+        printResult(presetManager.getPresets()[i].name, ns);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Oversampling: cost per factor for the nodes that typically need it
+// -----------------------------------------------------------------------------
+static std::unique_ptr<Oscillator> makeDeepFM() {
+    auto fm = std::make_unique<FMSynthesizer>(BenchSampleRate);
+    fm->setCarrierOscillator(std::make_unique<SawOscillator>(BenchSampleRate));
+    fm->setModulatorOscillator(std::make_unique<SineOscillator>(BenchSampleRate));
+    fm->setCarrierFrequency(440.0);
+    fm->setModulatorFrequency(660.0);
+    fm->setModulationDepth(1000.0);
+    return fm;
+}
+
+static bool checkBound(const std::string& name, double measured, double bound);
+
+static bool benchOversampling() {
+    printHeader("Oversampling");
+
+    const int factors[] = {1, 2, 4, 8};
+    double baseline = 0.0;
+    for (int factor : factors) {
+        OversampledOscillator osc(makeDeepFM(), factor, BenchSampleRate);
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            for (int i = 0; i < n; ++i) buffer[i] = osc.nextSample();
+        });
+        if (factor == 1) baseline = ns;
+        printResult("FM (saw carrier) " + std::to_string(factor) + "x", ns, ratioNote(ns / baseline, "vs 1x"));
+    }
+
+    for (int factor : factors) {
+        auto lowpass = std::make_unique<LowPassFilter>(BenchSampleRate);
+        lowpass->setCutoffFrequency(6000.0);
+        lowpass->setResonance(4.0);
+        OversampledFilter filter(std::move(lowpass), factor, BenchSampleRate);
+        SawOscillator saw(BenchSampleRate);
+        saw.setFrequency(110.0);
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            for (int i = 0; i < n; ++i) buffer[i] = filter.processSample(saw.nextSample());
+        });
+        if (factor == 1) baseline = ns;
+        printResult("Saw -> LowPass " + std::to_string(factor) + "x", ns, ratioNote(ns / baseline, "vs 1x"));
+    }
+
+    for (int factor : {2, 4, 8}) {
+        Oversampler oversampler(factor);
+        std::cout << "  " << factor << "x round-trip latency: " << std::setprecision(2)
+                  << oversampler.getLatency() << " samples" << std::endl;
+    }
+
+    // The Oversampling parameter is set from the GUI thread while the audio
+    // thread renders: the switch happens at the next block, without allocating
+    OversampledOscillator osc(makeDeepFM(), 2, BenchSampleRate);
+    auto lowpass = std::make_unique<LowPassFilter>(BenchSampleRate);
+    lowpass->setCutoffFrequency(6000.0);
+    OversampledFilter filter(std::move(lowpass), 2, BenchSampleRate);
+    std::atomic<bool> running{true};
+    std::thread gui([&] {
+        const int cycle[] = {1, 8, 2, 4};
+        for (int i = 0; running.load(); ++i) {
+            osc.setOversamplingFactor(cycle[i % 4]);
+            filter.setOversamplingFactor(cycle[(i + 1) % 4]);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    });
+    std::vector<double> block(BenchBlockSize);
+    double peak = 0.0;
+    int factorsSeen = 0;  // Bit per factor the oscillator rendered at
+    long allocations = heapAllocations.load();
+    long violations = RealtimeCheck::getViolationCount();
+    {
+        RealtimeCheck::Scope realtime;  // Counted in RT_CHECK builds
+        for (int b = 0; b < 2000; ++b) {
+            osc.generateBlock(block.data(), BenchBlockSize);
+            filter.processBuffer(block.data(), BenchBlockSize);
+            for (double v : block) peak = std::max(peak, std::isfinite(v) ? std::fabs(v) : HUGE_VAL);
+            factorsSeen |= osc.getOversamplingFactor();
+        }
+    }
+    allocations = heapAllocations.load() - allocations;
+    violations = RealtimeCheck::getViolationCount() - violations;
+    running = false;
+    gui.join();
+    osc.setOversamplingFactor(4);
+    osc.generateBlock(block.data(), 1);
+
+    bool ok = checkBound("factor switched from another thread, peak", peak, 8.0);
+    bool switched = factorsSeen == (1 | 2 | 4 | 8) && osc.getOversamplingFactor() == 4 && allocations == 0 &&
+                    violations == 0;
+    std::cout << "  switching: every factor rendered " << (factorsSeen == 15 ? "yes" : "no") << ", "
+              << allocations << " allocations, " << violations << " real-time violations"
+              << (switched ? "  ok" : "  FAIL") << std::endl;
+    return ok && switched;
+}
+
+// -----------------------------------------------------------------------------
+// FastMath: error bounds against libm and throughput of the batch kernels
+// -----------------------------------------------------------------------------
+static bool checkBound(const std::string& name, double measured, double bound) {
+    bool ok = measured < bound;
+    std::cout << "  " << std::left << std::setw(36) << name << std::right
+              << std::scientific << std::setprecision(2) << std::setw(10) << measured
+              << " (bound " << bound << ")" << (ok ? "  ok" : "  FAIL") << std::fixed << std::endl;
+    return ok;
+}
+
+static bool benchFastMath() {
+    printHeader("FastMath accuracy");
+
+    // Deterministic sweep: dense near zero, sparse far out
+    auto sweep = [](double lo, double hi, int count, auto&& check) {
+        for (int i = 0; i <= count; ++i) {
+            check(lo + (hi - lo) * i / count);
+        }
+    };
+
+    double sinErr = 0.0, cosErr = 0.0, tanErr = 0.0;
+    sweep(-1e6, 1e6, 2000000, [&](double x) {
+        sinErr = std::max(sinErr, std::fabs(fastmath::sin(x) - std::sin(x)));
+        cosErr = std::max(cosErr, std::fabs(fastmath::cos(x) - std::cos(x)));
+    });
+    double sin2piErr = 0.0;
+    sweep(-8.0, 8.0, 1000000, [&](double x) {
+        sin2piErr = std::max(sin2piErr, std::fabs(fastmath::sin2pi(x) - std::sin(2.0 * M_PI * x)));
+        sin2piErr = std::max(sin2piErr, std::fabs(fastmath::cos2pi(x) - std::cos(2.0 * M_PI * x)));
+    });
+    sweep(-20.0, 20.0, 1000000, [&](double x) {
+        if (std::fabs(std::cos(x)) > 1e-3) {
+            double ref = std::tan(x);
+            tanErr = std::max(tanErr, std::fabs(fastmath::tan(x) - ref) / std::max(1.0, std::fabs(ref)));
+        }
+    });
+
+    double expErr = 0.0;
+    sweep(-700.0, 700.0, 1000000, [&](double x) {
+        double ref = std::exp(x);
+        expErr = std::max(expErr, std::fabs(fastmath::exp(x) - ref) / ref);
+    });
+
+    double logErr = 0.0;
+    sweep(1e-6, 1e6, 1000000, [&](double x) {
+        logErr = std::max(logErr, std::fabs(fastmath::log(x) - std::log(x)));
+    });
+    sweep(1e-300, 1e-290, 10000, [&](double x) {
+        logErr = std::max(logErr, std::fabs(fastmath::log(x) - std::log(x)));
+    });
+
+    double powErr = 0.0;
+    sweep(0.01, 100.0, 2000, [&](double a) {
+        for (double b = -20.0; b <= 20.0; b += 0.37) {
+            double ref = std::pow(a, b);
+            powErr = std::max(powErr, std::fabs(fastmath::pow(a, b) - ref) / ref);
+        }
+    });
+
+    bool ok = true;
+    ok = checkBound("sin2pi/cos2pi abs error", sin2piErr, fastmath::SinMaxError) && ok;
+    ok = checkBound("sin abs error, |x| < 1e6", sinErr, fastmath::SinMaxError) && ok;
+    ok = checkBound("cos abs error, |x| < 1e6", cosErr, fastmath::SinMaxError) && ok;
+    ok = checkBound("tan rel error", tanErr, fastmath::TanMaxRelError) && ok;
+    ok = checkBound("exp rel error, [-700, 700]", expErr, fastmath::ExpMaxRelError) && ok;
+    ok = checkBound("log abs error", logErr, fastmath::LogMaxError) && ok;
+    ok = checkBound("pow rel error", powErr, fastmath::PowMaxRelError) && ok;
+
+    printHeader("FastMath throughput");
+    std::vector<double> input(BenchBlockSize);
+    for (int i = 0; i < BenchBlockSize; ++i) input[i] = (i * 0.618034) - 150.0;
+
+    double libmSin = measureNsPerSample([&](double* buffer, int n) {
+        for (int i = 0; i < n; ++i) buffer[i] = std::sin(input[i]);
+    });
+    double fastSin = measureNsPerSample([&](double* buffer, int n) {
+        fastmath::sinBatch(input.data(), buffer, n);
+    });
+    double libmExp = measureNsPerSample([&](double* buffer, int n) {
+        for (int i = 0; i < n; ++i) buffer[i] = std::exp(input[i]);
+    });
+    double fastExp = measureNsPerSample([&](double* buffer, int n) {
+        fastmath::expBatch(input.data(), buffer, n);
+    });
+    printResult("libm sin", libmSin);
+    printResult("fastmath sinBatch", fastSin, ratioNote(libmSin / fastSin, "faster"));
+    printResult("libm exp", libmExp);
+    printResult("fastmath expBatch", fastExp, ratioNote(libmExp / fastExp, "faster"));
+
+    SineOscillator sine(BenchSampleRate);
+    sine.setFrequency(440.0);
+    printResult("SineOscillator::nextSample", measureNsPerSample([&](double* buffer, int n) {
+        for (int i = 0; i < n; ++i) buffer[i] = sine.nextSample();
+    }));
+    LowPassFilter lowpass(BenchSampleRate);
+    double cutoff = 100.0;
+    printResult("LowPass coefficient update", measureNsPerSample([&](double* buffer, int n) {
+        for (int i = 0; i < n; ++i) {
+            cutoff = (cutoff > 8000.0) ? 100.0 : cutoff + 1.0;
+            lowpass.setCutoffFrequency(cutoff);
+            buffer[i] = lowpass.getCutoffFrequency();
+        }
+    }), "per update");
+
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Voice lanes: N scalar saw -> lowpass -> envelope chains vs one lane-packed patch
+// -----------------------------------------------------------------------------
+struct ScalarVoice {
+    SawOscillator saw{BenchSampleRate};
+    LowPassFilter filter{BenchSampleRate};
+    Envelope envelope{BenchSampleRate};
+
+    double nextSample() {
+        return filter.processSample(saw.nextSample()) * envelope.nextSample();
+    }
+};
+
+static bool benchVoiceLanes() {
+    printHeader("Voice lanes");
+
+    // Equivalence: one lane must match the scalar building blocks
+    ScalarVoice reference;
+    reference.saw.setFrequency(220.0);
+    reference.filter.setCutoffFrequency(1800.0);
+    reference.filter.setResonance(0.9);
+    reference.envelope.setADSR(5.0, 20.0, 60.0, 30.0);
+    VoiceLaneSynthesizer lanes(VoiceLaneSynthesizer::Waveform::Saw,
+                               VoiceLaneSynthesizer::FilterType::LowPass, BenchSampleRate);
+    lanes.setVoiceCount(1);
+    lanes.setFrequency(220.0);
+    lanes.setFilter(1800.0, 0.9);
+    lanes.setADSR(5.0, 20.0, 60.0, 30.0);
+
+    reference.envelope.noteOn();
+    lanes.noteOn();
+    double maxError = 0.0;
+    for (int i = 0; i < 8000; ++i) {
+        if (i == 160 * voicelanes::ChunkSize) {  // Lane gates are chunk-quantized
+            reference.envelope.noteOff();
+            lanes.noteOff();
+        }
+        maxError = std::max(maxError, std::fabs(reference.nextSample() - lanes.nextSample()));
+    }
+    bool ok = checkBound("lane vs scalar max difference", maxError, 1e-9);
+
+    for (int voices : {1, 2, 4, 8}) {
+        std::vector<ScalarVoice> scalarVoices(voices);
+        for (auto& voice : scalarVoices) {
+            voice.saw.setFrequency(220.0);
+            voice.filter.setCutoffFrequency(1800.0);
+            voice.envelope.noteOn();
+        }
+        double scalarNs = measureNsPerSample([&](double* buffer, int n) {
+            for (int i = 0; i < n; ++i) {
+                double sum = 0.0;
+                for (auto& voice : scalarVoices) sum += voice.nextSample();
+                buffer[i] = sum / voices;
+            }
+        });
+
+        VoiceLaneSynthesizer unison(VoiceLaneSynthesizer::Waveform::Saw,
+                                    VoiceLaneSynthesizer::FilterType::LowPass, BenchSampleRate);
+        unison.setVoiceCount(voices);
+        unison.setFrequency(220.0);
+        unison.noteOn();
+        double laneNs = measureNsPerSample([&](double* buffer, int n) {
+            for (int i = 0; i < n; ++i) buffer[i] = unison.nextSample();
+        });
+
+        printResult(std::to_string(voices) + " scalar voices", scalarNs);
+        printResult(std::to_string(voices) + " voices in lanes", laneNs, ratioNote(scalarNs / laneNs, "faster"));
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Parallel: Sound render graph spread over the worker pool
+// -----------------------------------------------------------------------------
+static std::unique_ptr<Oscillator> makeHeavyBranch(int index) {
+    // Uneven branches: every third one is oversampled 4x
+    int factor = (index % 3 == 0) ? 4 : 2;
+    return std::make_unique<OversampledOscillator>(makeDeepFM(), factor, BenchSampleRate);
+}
+
+static std::unique_ptr<Sound> makeLayeredSound(int layers) {
+    auto sound = std::make_unique<Sound>(BenchSampleRate);
+    for (int i = 0; i < layers; ++i) {
+        sound->addOscillator(makeHeavyBranch(i));
+    }
+    auto lowpass = std::make_unique<LowPassFilter>(BenchSampleRate);
+    lowpass->setCutoffFrequency(3000.0);
+    sound->addFilter(std::move(lowpass));
+    sound->noteOn();
+    return sound;
+}
+
+// One monophonic patch: a single additive layer whose partials are FM
+// chains with nested FM modulators - only the graph can split it
+static std::unique_ptr<Sound> makeSinglePatchSound(int partials) {
+    auto additive = std::make_unique<AdditiveSynthesizer>(BenchSampleRate);
+    for (int i = 0; i < partials; ++i) {
+        auto fm = std::make_unique<FMSynthesizer>(BenchSampleRate);
+        fm->setCarrierOscillator(std::make_unique<SawOscillator>(BenchSampleRate));
+        fm->setModulatorOscillator(makeHeavyBranch(i));
+        fm->setCarrierFrequency(110.0 * (i + 1));
+        fm->setModulatorFrequency(220.0);
+        fm->setModulationDepth(50.0);
+        additive->addOscillator(std::move(fm));
+    }
+    auto sound = std::make_unique<Sound>(BenchSampleRate);
+    sound->addOscillator(std::move(additive));
+    sound->noteOn();
+    return sound;
+}
+
+// Max difference between pooled block rendering and the per-sample path
+static double pooledVsPerSample(Sound& perSample, Sound& pooled) {
+    std::vector<double> actual(BenchBlockSize);
+    double maxError = 0.0;
+    for (int block = 0; block < 50; ++block) {
+        pooled.generateSamples(actual.data(), BenchBlockSize);
+        for (int i = 0; i < BenchBlockSize; ++i) {
+            maxError = std::max(maxError, std::fabs(perSample.nextSample() - actual[i]));
+        }
+    }
+    return maxError;
+}
+
+static bool benchParallel() {
+    printHeader("Parallel render graph");
+    const int branches = 8;
+
+    // Equivalence: the pool must not change a single bit of the output
+    WorkerPool checkPool(4);
+    auto layeredReference = makeLayeredSound(branches);
+    auto layered = makeLayeredSound(branches);
+    layered->setWorkerPool(&checkPool);
+    bool ok = checkBound("layers: pooled vs per-sample", pooledVsPerSample(*layeredReference, *layered), 1e-300);
+
+    auto patchReference = makeSinglePatchSound(branches);
+    auto patch = makeSinglePatchSound(branches);
+    patch->setWorkerPool(&checkPool);
+    ok = checkBound("single patch: pooled vs per-sample", pooledVsPerSample(*patchReference, *patch), 1e-300) && ok;
+    std::cout << "  single patch graph: " << patch->getRenderGraph().getNodeCount() << " nodes" << std::endl;
+
+    struct Case {
+        const char* name;
+        std::unique_ptr<Sound> (*make)(int);
+    };
+    const Case cases[] = {
+        {"layers", makeLayeredSound},
+        {"single patch", makeSinglePatchSound},
+    };
+
+    int maxThreads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+    for (const auto& c : cases) {
+        double baseline = 0.0;
+        for (int threads = 1; threads <= std::min(maxThreads, 8); threads *= 2) {
+            WorkerPool pool(threads);
+            auto sound = c.make(branches);
+            sound->setWorkerPool(&pool);
+            double ns = measureNsPerSample([&](double* buffer, int n) {
+                sound->generateSamples(buffer, n);
+            });
+            if (threads == 1) baseline = ns;
+            printResult(std::string(c.name) + ", " + std::to_string(threads) + " threads", ns,
+                        ratioNote(baseline / ns, "faster"));
+
+            for (int w = 0; w < pool.getThreadCount() && threads > 1; ++w) {
+                WorkerPool::WorkerStats stats = pool.getWorkerStats(w);
+                std::cout << "      worker " << w << ": load " << std::setprecision(2) << stats.load
+                          << ", tasks " << stats.tasksExecuted << ", stolen " << stats.tasksStolen << std::endl;
+            }
+        }
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Parameters: registry build, lookup and tree walk cost for large patches
+// -----------------------------------------------------------------------------
+template <typename Fn>
+static double elapsedUs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int countTree(const LiveController& controller, int group) {
+    // Same walk as a fully expanded ParameterTreeModel
+    const ParameterGroup& node = controller.getGroup(group);
+    int visited = static_cast<int>(node.parameters.size());
+    for (int child : node.children) visited += countTree(controller, child);
+    return visited;
+}
+
+static bool benchParameters() {
+    printHeader("Parameters");
+    bool ok = true;
+
+    for (int count : {10, 1000, 10000}) {
+        // Nested additive/FM prefixes, registered outer-first like the synthesizers do
+        std::vector<double> values(count, 0.0);
+        std::vector<std::string> paths;
+        LiveController controller;
+        double buildUs = elapsedUs([&]() {
+            for (int i = 0; i < count; ++i) {
+                std::string partial = "Additive Osc " + std::to_string(i / 4 + 1);
+                std::string prefix = (i % 4 < 2) ? partial : partial + " FM Carrier";
+                std::string name = (i % 2 == 0) ? "Frequency" : "Mod Depth";
+                controller.addParameterInGroup(prefix, name, &values[i], 0.0, 1000.0, 1.0, {"Hz"});
+            }
+        });
+        for (int i = 0; i < count; ++i) paths.push_back(std::string(controller.getParameter(i).name));
+
+        int found = 0;
+        double lookupUs = elapsedUs([&]() {
+            for (const auto& path : paths) {
+                ParameterId id = controller.findParameter(path);
+                if (id != InvalidParameterId) {
+                    *controller.getParameter(id).valuePtr = 1.0;
+                    ++found;
+                }
+            }
+        });
+
+        int visited = 0;
+        double walkUs = elapsedUs([&]() { visited = countTree(controller, LiveController::RootGroup); });
+
+        std::cout << "  " << std::left << std::setw(8) << count << std::right << std::fixed << std::setprecision(1)
+                  << " params: build " << std::setw(8) << buildUs << " us (" << std::setprecision(3)
+                  << buildUs / count << " us/param), lookup " << std::setprecision(1)
+                  << lookupUs * 1000.0 / count << " ns, tree walk " << std::setw(7) << walkUs
+                  << " us, " << controller.getGroupCount() << " groups" << std::endl;
+        ok = (found == count && visited == count) && ok;
+    }
+
+    // The tree must follow the registration prefixes
+    LiveController controller;
+    double value = 0.0;
+    controller.addParameterInGroup("FM", "Mod Depth", &value, 0.0, 1.0);
+    ParameterId carrier = controller.addParameterInGroup("FM Carrier", "Frequency", &value, 0.0, 1.0);
+    const ParameterGroup& group = controller.getGroup(controller.getParameter(carrier).group);
+    bool treeOk = group.displayName == "Carrier" && controller.getGroup(group.parent).path == "FM"
+               && controller.findParameter("FM Carrier Frequency") == carrier;
+    std::cout << "  tree structure" << (treeOk ? "  ok" : "  FAIL") << std::endl;
+    return ok && treeOk;
+}
+
+// -----------------------------------------------------------------------------
+// Patches: data presets - equivalence with the built-ins and load time
+// -----------------------------------------------------------------------------
+// The built-in presets written as data, in PresetManager order
+static const char* const BuiltInPatches[] = {
+    "patch \"Simple Sine Wave\"\n"
+    "sine register\n"
+    "envelope register\n"
+    "volume register\n",
+
+    "patch \"Simple Saw Wave\"\n"
+    "saw register\n"
+    "bandpass bandwidth=300 register\n"
+    "volume register\n",
+
+    "patch \"FM Synthesizer\"\n"
+    "oversampled register\n"
+    "  fm\n"
+    "    saw\n"
+    "    saw\n"
+    "volume register\n",
+
+    "patch \"Nested FM\"\n"
+    "oversampled register\n"
+    "  fm depth=30\n"
+    "    sine\n"
+    "    fm depth=50\n"
+    "      sine\n"
+    "      sine\n"
+    "volume register\n",
+
+    "patch \"Triple Bandpass Additive\"\n"
+    "additive register\n"
+    "  filtered\n"
+    "    saw\n"
+    "    bandpass frequency=600 bandwidth=200\n"
+    "  filtered\n"
+    "    saw\n"
+    "    bandpass frequency=1200 bandwidth=300\n"
+    "  filtered\n"
+    "    saw\n"
+    "    bandpass frequency=2400 bandwidth=400\n"
+    "volume register\n",
+
+    "patch \"Soft Sound\"\n"
+    "filtered\n"
+    "  additive\n"
+    "    sine frequency=220 amplitude=0.7\n"
+    "    saw frequency=220 amplitude=0.3\n"
+    "  lowpass cutoff=2000 resonance=0.3 prefix=\"Lowpass\"\n"
+    "envelope register\n",
+
+    "patch \"Unison Saw Pad\"\n"
+    "unison frequency=220 voices=8 detune=15 cutoff=1800 shape=0.9 attack=250 decay=400 sustain=80 release=600 register\n"
+    "volume register\n",
+};
+constexpr int BuiltInPatchCount = sizeof(BuiltInPatches) / sizeof(BuiltInPatches[0]);
+
+static bool compilePatch(const std::string& text, CompiledPatch& compiled) {
+    Patch patch;
+    std::string error;
+    if (!PatchFormat::parse(text, patch, error)) {
+        std::cout << "  parse error: " << error << std::endl;
+        return false;
+    }
+    return compiled.load(CompiledPatch::compile(patch));
+}
+
+static std::vector<double> renderSound(Sound& sound, int numSamples) {
+    std::vector<double> output(numSamples);
+    sound.noteOn();
+    sound.generateSamples(output.data(), numSamples / 2);
+    sound.noteOff();
+    sound.generateSamples(output.data() + numSamples / 2, numSamples - numSamples / 2);
+    return output;
+}
+
+static bool benchPatches() {
+    printHeader("Patches");
+    bool ok = true;
+    PresetManager presetManager;
+    constexpr int RenderLength = 8192;
+
+    // Same graph from data and from C++: the audio must match bit for bit
+    for (int i = 0; i < BuiltInPatchCount && i < presetManager.getPresetCount(); ++i) {
+        CompiledPatch compiled;
+        bool loaded = compilePatch(BuiltInPatches[i], compiled);
+
+        Sound builtIn(BenchSampleRate), fromData(BenchSampleRate);
+        LiveController builtInController, dataController;
+        presetManager.getPresets()[i].setupFunction(&builtIn, builtInController);
+        compiled.instantiate(&fromData, dataController);
+
+        bool same = loaded && renderSound(builtIn, RenderLength) == renderSound(fromData, RenderLength);
+        std::cout << "  " << std::left << std::setw(28) << presetManager.getPresets()[i].name << std::right
+                  << std::setw(5) << compiled.getSize() << " bytes, " << std::setw(2)
+                  << dataController.getParameterCount() << " params (C++ " << std::setw(2)
+                  << builtInController.getParameterCount() << ")" << (same ? "  same audio" : "  FAIL") << std::endl;
+        ok = same && ok;
+    }
+
+    // Load cost per stage over a bank of patches (the built-ins, repeated)
+    constexpr int BankSize = 280;
+    std::vector<std::string> texts(BankSize);
+    for (int i = 0; i < BankSize; ++i) texts[i] = BuiltInPatches[i % BuiltInPatchCount];
+
+    std::vector<Patch> parsed(BankSize);
+    std::string error;
+    double parseUs = elapsedUs([&]() {
+        for (int i = 0; i < BankSize; ++i) PatchFormat::parse(texts[i], parsed[i], error);
+    });
+    std::vector<std::vector<uint8_t>> binaries(BankSize);
+    double compileUs = elapsedUs([&]() {
+        for (int i = 0; i < BankSize; ++i) binaries[i] = CompiledPatch::compile(parsed[i]);
+    });
+
+    std::vector<std::string> paths(BankSize);
+    for (int i = 0; i < BankSize; ++i) {
+        paths[i] = "/tmp/synth_bench_patch_" + std::to_string(i) + ".patchbin";
+        CompiledPatch::writeFile(paths[i], binaries[i]);
+    }
+    std::vector<CompiledPatch> bank(BankSize);
+    int opened = 0;
+    double openUs = elapsedUs([&]() {
+        for (int i = 0; i < BankSize; ++i) opened += bank[i].open(paths[i]) ? 1 : 0;
+    });
+
+    // Instantiation into fresh Sounds, against the hand-written C++ setups
+    std::vector<std::unique_ptr<Sound>> sounds(BankSize);
+    std::vector<LiveController> controllers(BankSize);
+    for (auto& sound : sounds) sound = std::make_unique<Sound>(BenchSampleRate);
+    // The first pass also pays the page faults of the freshly mapped files
+    double coldUs = elapsedUs([&]() {
+        for (int i = 0; i < BankSize; ++i) bank[i].instantiate(sounds[i].get(), controllers[i]);
+    });
+    // Then in short passes, in turns with the C++ setups that build the same
+    // objects. Each keeps its best pass, so preemption on a busy machine does
+    // not decide the ratio.
+    constexpr int PassSize = 4 * BuiltInPatchCount;
+    double instantiateUs = 0.0, cppUs = 0.0;
+    for (int pass = 0; pass < 20; ++pass) {
+        const int first = (pass * PassSize) % BankSize;
+        for (int i = first; i < first + PassSize; ++i) sounds[i] = std::make_unique<Sound>(BenchSampleRate);
+        std::vector<LiveController> passControllers(PassSize);
+        double us = elapsedUs([&]() {
+            for (int i = 0; i < PassSize; ++i) bank[first + i].instantiate(sounds[first + i].get(), passControllers[i]);
+        }) / PassSize;
+        instantiateUs = pass == 0 ? us : std::min(instantiateUs, us);
+
+        for (int i = first; i < first + PassSize; ++i) sounds[i] = std::make_unique<Sound>(BenchSampleRate);
+        std::vector<LiveController> cppControllers(PassSize);
+        us = elapsedUs([&]() {
+            for (int i = 0; i < PassSize; ++i) {
+                presetManager.getPresets()[(first + i) % BuiltInPatchCount].setupFunction(sounds[first + i].get(),
+                                                                                           cppControllers[i]);
+            }
+        }) / PassSize;
+        cppUs = pass == 0 ? us : std::min(cppUs, us);
+    }
+    for (const auto& path : paths) std::remove(path.c_str());
+
+    std::cout << "  " << BankSize << " patches, per patch:" << std::fixed << std::setprecision(2)
+              << " parse " << parseUs / BankSize << " us, compile " << compileUs / BankSize
+              << " us, mmap " << openUs / BankSize << " us, instantiate " << instantiateUs
+              << " us (first " << coldUs / BankSize << " us, C++ setup " << cppUs << " us), " << opened << " mapped" << std::endl;
+    ok = (opened == BankSize) && ok;
+    ok = checkBound("instantiate / C++ setup", instantiateUs / cppUs, 2.0) && ok;
+
+    // A user's parameter state survives save -> text -> compile -> load
+    CompiledPatch original;
+    compilePatch(BuiltInPatches[5], original);
+    Sound edited(BenchSampleRate);
+    LiveController editedController;
+    original.instantiate(&edited, editedController);
+    ParameterId cutoff = editedController.findParameter("Lowpass Cutoff Freq");
+    editedController.setParameterRange(cutoff, 100.0, 5000.0);
+    editedController.setParameter(cutoff, 1234.5);
+
+    Patch state = original.decompile();
+    PatchFormat::captureParameters(state, editedController);
+    CompiledPatch restored;
+    bool restoredOk = compilePatch(PatchFormat::write(state), restored);
+    Sound reloaded(BenchSampleRate);
+    LiveController reloadedController;
+    restored.instantiate(&reloaded, reloadedController);
+    ParameterId reloadedCutoff = reloadedController.findParameter("Lowpass Cutoff Freq");
+    restoredOk = restoredOk && reloadedCutoff != InvalidParameterId
+              && *reloadedController.getParameter(reloadedCutoff).valuePtr == 1234.5
+              && reloadedController.getParameter(reloadedCutoff).maxValue == 5000.0
+              && renderSound(edited, RenderLength) == renderSound(reloaded, RenderLength);
+    std::cout << "  parameter state round trip" << (restoredOk ? "  ok" : "  FAIL") << std::endl;
+
+    // Damaged files are rejected up front instead of crashing instantiate()
+    std::vector<uint8_t> damaged = CompiledPatch::compile(parsed[3]);
+    auto* header = reinterpret_cast<PatchFileHeader*>(damaged.data());
+    reinterpret_cast<PatchNodeRecord*>(damaged.data() + header->nodeOffset)[0].firstChild = 0;
+    CompiledPatch rejected;
+    bool rejectOk = !rejected.load(damaged) && !rejected.load(std::vector<uint8_t>(binaries[3].begin(), binaries[3].end() - 1));
+    std::cout << "  damaged binaries rejected" << (rejectOk ? "  ok" : "  FAIL") << std::endl;
+
+    return ok && restoredOk && rejectOk;
+}
+
+// -----------------------------------------------------------------------------
+// Preset cache: switch latency with and without prepared graphs
+// -----------------------------------------------------------------------------
+// A deliberately expensive patch: 48 filtered partials and four oversampled FM layers
+static std::string makeHeavyPatchText() {
+    std::string text = "patch \"Heavy Bank\"\nadditive register\n";
+    for (int i = 0; i < 48; ++i) {
+        text += "  filtered\n    saw frequency=" + std::to_string(55 * (i + 1)) + "\n";
+        text += "    lowpass cutoff=" + std::to_string(400 + 150 * i) + "\n";
+    }
+    for (int i = 0; i < 4; ++i) {
+        text += "oversampled factor=4 prefix=\"FM " + std::to_string(i + 1) + "\"\n  fm depth=200\n"
+                "    sine\n    fm depth=80\n      sine\n      sine\n";
+    }
+    return text + "envelope register\nvolume register\n";
+}
+
+static bool benchPresetCache() {
+    printHeader("Preset Cache");
+    bool ok = true;
+
+    PresetManager presetManager;
+    auto heavy = std::make_shared<CompiledPatch>();
+    ok = compilePatch(makeHeavyPatchText(), *heavy) && ok;
+    presetManager.registerPatch(heavy);
+    int count = presetManager.getPresetCount();
+
+    // Misses: nothing prepared yet, every switch builds on the calling thread
+    PresetCache cache(presetManager, BenchSampleRate);
+    std::vector<double> missUs(count), hitUs(count);
+    for (int i = 0; i < count; ++i) {
+        missUs[i] = elapsedUs([&]() { cache.acquire(i); });
+    }
+    // Hits: after the background warm-up
+    cache.start();
+    cache.waitUntilIdle();
+    for (int i = 0; i < count; ++i) {
+        std::unique_ptr<PreparedPreset> prepared;
+        hitUs[i] = elapsedUs([&]() { prepared = cache.acquire(i); });
+        ok = (prepared && prepared->presetIndex == i) && ok;
+    }
+    for (int i = 0; i < count; ++i) {
+        std::cout << "  " << std::left << std::setw(28) << presetManager.getPresets()[i].name << std::right
+                  << std::fixed << std::setprecision(1) << " miss " << std::setw(8) << missUs[i]
+                  << " us   hit " << std::setw(6) << hitUs[i] << " us" << std::endl;
+    }
+    cache.waitUntilIdle();
+    PresetCache::Stats stats = cache.getStats();
+    std::cout << "  " << stats.hits << " hits, " << stats.misses << " misses, " << stats.readyCount
+              << " ready again after the switches, " << std::setprecision(2) << stats.memoryUsed / 1024.0
+              << " KB" << std::endl;
+    ok = (stats.readyCount == count) && ok;
+    ok = checkBound("max hit latency us", stats.maxHitUs, 100.0) && ok;
+
+    // Budget: only what fits is warmed; a requested preset evicts the least recently used
+    size_t budget = 300 * 1024;
+    PresetCache small(presetManager, BenchSampleRate, budget);
+    small.start();
+    small.waitUntilIdle();
+    int warmed = small.getStats().readyCount;
+    int coldIndex = count - 1;
+    while (coldIndex > 0 && small.isReady(coldIndex)) --coldIndex;
+    small.acquire(coldIndex);
+    small.waitUntilIdle();
+    PresetCache::Stats smallStats = small.getStats();
+    bool budgetOk = smallStats.memoryUsed <= budget && warmed < count && small.isReady(coldIndex);
+    std::cout << "  300 KB budget: " << warmed << " of " << count << " warmed, " << smallStats.readyCount
+              << " ready and " << smallStats.memoryUsed / 1024.0
+              << " KB used after requesting a cold preset" << (budgetOk ? "  ok" : "  FAIL") << std::endl;
+
+    // Hand-over to a running audio thread: every published Sound is either
+    // never picked up or retired, and the audio thread ends on the last one
+    SoundExchange exchange;
+    std::vector<std::unique_ptr<Sound>> published;
+    std::set<Sound*> returned;
+    std::atomic<bool> running{true};
+    Sound* lastRendered = nullptr;
+    std::thread audio([&]() {
+        double block[Sound::MaxBlockSize];
+        while (running.load()) {
+            if (Sound* sound = exchange.acquire()) {
+                sound->generateSamples(block, 64);
+                lastRendered = sound;
+            }
+            std::this_thread::yield();
+        }
+        lastRendered = exchange.acquire();
+    });
+    for (int i = 0; i < 200; ++i) {
+        published.push_back(std::move(PresetCache::build(presetManager, i % (count - 1), BenchSampleRate)->sound));
+        if (Sound* displaced = exchange.publish(published.back().get())) returned.insert(displaced);
+        while (Sound* retired = exchange.collectRetired()) returned.insert(retired);
+        if (i % 8 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    while (Sound* retired = exchange.collectRetired()) returned.insert(retired);
+    running.store(false);
+    audio.join();
+    while (Sound* retired = exchange.collectRetired()) returned.insert(retired);
+
+    bool exchangeOk = lastRendered == published.back().get() && returned.size() == published.size() - 1
+                   && !returned.count(published.back().get());
+    std::cout << "  exchange: " << published.size() << " publishes, " << returned.size()
+              << " returned to the publisher" << (exchangeOk ? "  ok" : "  FAIL") << std::endl;
+
+    return ok && budgetOk && exchangeOk;
+}
+
+// -----------------------------------------------------------------------------
+// Arena: allocation counts, teardown and cold graph walks, heap vs patch arena
+// -----------------------------------------------------------------------------
+// Hardware cache misses of the calling thread. Often unavailable in
+// containers and VMs; the cold walk time is reported either way.
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+    bool isAvailable() const { return fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    long long stop() {
+        long long count = 0;
+#ifdef __linux__
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+// A heap that has been in use for a while: small blocks of mixed sizes with
+// every other one freed, so new heap objects land in scattered holes
+struct FragmentedHeap {
+    std::vector<std::unique_ptr<char[]>> blocks;
+    FragmentedHeap() {
+        std::mt19937 random(7);
+        for (int i = 0; i < 40000; ++i) blocks.emplace_back(new char[16 + random() % 496]);
+        for (size_t i = 0; i < blocks.size(); i += 2) blocks[i].reset();
+    }
+};
+
+// The preset built the way it was before arenas: every module on the heap
+static std::unique_ptr<PreparedPreset> buildOnHeap(const PresetManager& presetManager, int index) {
+    auto prepared = std::make_unique<PreparedPreset>();
+    prepared->presetIndex = index;
+    prepared->sound = std::make_unique<Sound>(BenchSampleRate);
+    prepared->controller = std::make_unique<LiveController>();
+    presetManager.getPresets()[index].setupFunction(prepared->sound.get(), *prepared->controller);
+    double scratch[Sound::MaxBlockSize];
+    prepared->sound->generateSamples(scratch, Sound::MaxBlockSize);
+    return prepared;
+}
+
+struct GraphWalk {
+    double blockUs = 0.0;
+    double misses = 0.0;
+};
+
+// Average cost of a 64-sample block rendered right after flushing the caches,
+// the case where scattered nodes hurt most
+static GraphWalk measureColdWalk(Sound& sound, CacheMissCounter& counter) {
+    constexpr int Blocks = 200;
+    static std::vector<unsigned char> flush(16 * 1024 * 1024);
+    double block[64];
+    GraphWalk walk;
+    sound.noteOn();
+    for (int i = 0; i < Blocks; ++i) {
+        for (size_t line = 0; line < flush.size(); line += 64) flush[line]++;
+        if (counter.isAvailable()) counter.start();
+        walk.blockUs += elapsedUs([&]() { sound.generateSamples(block, 64); });
+        if (counter.isAvailable()) walk.misses += static_cast<double>(counter.stop());
+        sink = sink + block[0];
+    }
+    walk.blockUs /= Blocks;
+    walk.misses /= Blocks;
+    return walk;
+}
+
+static bool benchArena() {
+    printHeader("Patch Arena");
+
+    PresetManager presetManager;
+    auto heavy = std::make_shared<CompiledPatch>();
+    bool ok = compilePatch(makeHeavyPatchText(), *heavy);
+    presetManager.registerPatch(heavy);
+
+    CacheMissCounter counter;
+    FragmentedHeap fragmented;
+    long totalHeapAllocations = 0, totalArenaAllocations = 0, totalHeapFrees = 0, totalArenaFrees = 0;
+    bool sameAudio = true;
+
+    std::cout << "  " << std::left << std::setw(26) << "" << std::right << "  allocations      frees   teardown us"
+              << "   cold block us" << (counter.isAvailable() ? "   cache misses" : "") << std::endl;
+    std::cout << "  " << std::left << std::setw(26) << "" << std::right << "  heap arena   heap arena   heap arena"
+              << "    heap  arena" << (counter.isAvailable() ? "     heap  arena" : "") << std::endl;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        long start = heapAllocations.load();
+        auto onHeap = buildOnHeap(presetManager, i);
+        long heapBuild = heapAllocations.load() - start;
+        start = heapAllocations.load();
+        auto inArena = PresetCache::build(presetManager, i, BenchSampleRate);
+        long arenaBuild = heapAllocations.load() - start;
+
+        GraphWalk heapWalk = measureColdWalk(*onHeap->sound, counter);
+        GraphWalk arenaWalk = measureColdWalk(*inArena->sound, counter);
+        sameAudio = renderSound(*onHeap->sound, 4096) == renderSound(*inArena->sound, 4096) && sameAudio;
+
+        start = heapFrees.load();
+        double heapTeardownUs = elapsedUs([&]() { onHeap.reset(); });
+        long heapTeardown = heapFrees.load() - start;
+        start = heapFrees.load();
+        double arenaTeardownUs = elapsedUs([&]() { inArena.reset(); });
+        long arenaTeardown = heapFrees.load() - start;
+
+        totalHeapAllocations += heapBuild;
+        totalArenaAllocations += arenaBuild;
+        totalHeapFrees += heapTeardown;
+        totalArenaFrees += arenaTeardown;
+        std::cout << "  " << std::left << std::setw(26) << presetManager.getPresets()[i].name << std::right
+                  << std::setw(6) << heapBuild << std::setw(6) << arenaBuild
+                  << std::setw(7) << heapTeardown << std::setw(6) << arenaTeardown
+                  << std::fixed << std::setprecision(1) << std::setw(7) << heapTeardownUs << std::setw(6) << arenaTeardownUs
+                  << std::setprecision(2) << std::setw(8) << heapWalk.blockUs << std::setw(7) << arenaWalk.blockUs;
+        if (counter.isAvailable()) {
+            std::cout << std::setprecision(0) << std::setw(9) << heapWalk.misses << std::setw(7) << arenaWalk.misses;
+        }
+        std::cout << std::endl;
+    }
+    if (!counter.isAvailable()) std::cout << "  (hardware cache-miss counters unavailable here)" << std::endl;
+
+    std::cout << "  total: " << totalHeapAllocations << " -> " << totalArenaAllocations << " allocations, "
+              << totalHeapFrees << " -> " << totalArenaFrees << " frees at teardown"
+              << (totalArenaAllocations < totalHeapAllocations && totalArenaFrees < totalHeapFrees ? "  ok" : "  FAIL")
+              << std::endl;
+    std::cout << "  arena and heap graphs render the same audio" << (sameAudio ? "  ok" : "  FAIL") << std::endl;
+
+    return ok && sameAudio && totalArenaAllocations < totalHeapAllocations && totalArenaFrees < totalHeapFrees;
+}
+
+// -----------------------------------------------------------------------------
+// Real-time check: every preset rendered on a marked render thread
+// -----------------------------------------------------------------------------
+static bool benchRealtimeCheck() {
+    printHeader("Real-time Check");
+    if (!RealtimeCheck::isActive()) {
+        std::cout << "  not compiled in - run `make clean && make bench RT_CHECK=1`" << std::endl;
+        return true;
+    }
+    RealtimeCheck::reset();
+
+    // The checker must see deliberate violations (called through volatile
+    // pointers so the compiler cannot drop the pair)
+    {
+        void* (*volatile allocate)(size_t) = std::malloc;
+        void (*volatile release)(void*) = std::free;
+        std::mutex mutex;
+        RealtimeCheck::Scope realtime;
+        release(allocate(64));
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    bool detected = RealtimeCheck::getViolationCount(RealtimeCheck::Violation::Allocation) >= 1
+                 && RealtimeCheck::getViolationCount(RealtimeCheck::Violation::Free) >= 1
+                 && RealtimeCheck::getViolationCount(RealtimeCheck::Violation::Lock) >= 1;
+    std::cout << "  deliberate malloc, free and mutex lock trapped" << (detected ? "  ok" : "  FAIL") << std::endl;
+    RealtimeCheck::reset();
+
+    PresetManager presetManager;
+    presetManager.loadPatchDirectory("patches");
+    auto heavy = std::make_shared<CompiledPatch>();
+    bool ok = compilePatch(makeHeavyPatchText(), *heavy);
+    presetManager.registerPatch(heavy);
+
+    // Built off the render thread, then picked up and played the way the
+    // audio callback does: serially and on a worker pool
+    WorkerPool pool(2);
+    WorkerPool* const renderPools[] = {nullptr, &pool};
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        auto prepared = PresetCache::build(presetManager, i, BenchSampleRate);
+        SoundExchange exchange;
+        exchange.publish(prepared->sound.get());
+
+        long violations[2];
+        for (int p = 0; p < 2; ++p) {
+            prepared->sound->setWorkerPool(renderPools[p]);
+            long before = RealtimeCheck::getViolationCount();
+            {
+                RealtimeCheck::Scope realtime;
+                double block[Sound::MaxBlockSize];
+                Sound* sound = exchange.acquire();
+                sound->noteOn();
+                for (int b = 0; b < 40; ++b) {
+                    if (b == 20) sound->noteOff();
+                    sound->generateSamples(block, (b % 2) ? 64 : Sound::MaxBlockSize);
+                    sink = sink + block[0];
+                }
+            }
+            violations[p] = RealtimeCheck::getViolationCount() - before;
+        }
+        std::cout << "  " << std::left << std::setw(28) << presetManager.getPresets()[i].name << std::right
+                  << " serial " << std::setw(4) << violations[0] << "   pool " << std::setw(4) << violations[1]
+                  << " violations" << std::endl;
+    }
+
+    // The multichannel path: panning, per-channel filter state, stereo layers
+    long beforeStereo = RealtimeCheck::getViolationCount();
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        auto prepared = PresetCache::build(presetManager, i, BenchSampleRate, 2);
+        RealtimeCheck::Scope realtime;
+        double left[Sound::MaxBlockSize], right[Sound::MaxBlockSize];
+        double* planar[2] = {left, right};
+        prepared->sound->noteOn();
+        for (int b = 0; b < 20; ++b) {
+            prepared->sound->generateChannels(planar, (b % 2) ? 64 : Sound::MaxBlockSize);
+            sink = sink + left[0] + right[0];
+        }
+    }
+    std::cout << "  every preset in stereo       " << std::setw(4) << RealtimeCheck::getViolationCount() - beforeStereo
+              << " violations" << std::endl;
+
+    // Every preset at once, one per part, through the part mixer and recorded
+    long beforeParts = RealtimeCheck::getViolationCount();
+    {
+        std::vector<std::unique_ptr<PreparedPreset>> partPresets;
+        std::vector<SoundExchange> partExchanges(SoundRenderer::MaxParts);
+        DiskRecorder recorder;
+        recorder.start("/tmp/synth_bench_rtcheck.raw", BenchSampleRate, 2);
+        SoundRenderer renderer;
+        renderer.setRecorder(&recorder);
+        for (int i = 0; i < presetManager.getPresetCount() && i < SoundRenderer::MaxParts; ++i) {
+            partPresets.push_back(PresetCache::build(presetManager, i, BenchSampleRate, 2));
+            partPresets.back()->sound->noteOn();
+            partExchanges[i].publish(partPresets.back()->sound.get());
+            renderer.setPartExchange(i, &partExchanges[i]);
+            renderer.setPartVolume(i, 0.5);
+            renderer.setPartPan(i, (i % 3) - 1.0);
+            renderer.setPartBypassed(i, i % 4 == 3);
+        }
+        float interleaved[Sound::MaxBlockSize * 2];
+        for (int b = 0; b < 20; ++b) {
+            renderer.render(interleaved, (b % 2) ? 64 : Sound::MaxBlockSize, 2);
+            sink = sink + interleaved[0];
+        }
+        recorder.stop();
+        std::remove("/tmp/synth_bench_rtcheck.raw");
+    }
+    std::cout << "  every preset as parts        " << std::setw(4) << RealtimeCheck::getViolationCount() - beforeParts
+              << " violations" << std::endl;
+
+    long total = RealtimeCheck::getViolationCount();
+    std::cout << "  " << presetManager.getPresetCount() << " presets, " << total << " violations"
+              << (total == 0 ? "  ok" : "  FAIL") << std::endl;
+    if (total > 0) {
+        RealtimeCheck::report();
+        Logger::instance().flush();
+    }
+    return ok && detected && total == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Real-time setup: priority and memory locking as granted here, and the page
+// faults taken by the first notes with and without preparation
+// -----------------------------------------------------------------------------
+static long threadMinorFaults() {
+#ifdef __linux__
+    struct rusage usage {};
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_minflt;
+#else
+    return 0;
+#endif
+}
+
+// Plays the first blocks of a note on a fresh thread, the way a just
+// started audio thread meets a just published Sound; returns its page faults
+static long firstNoteFaults(Sound& sound, bool prepared) {
+    long faults = 0;
+    std::thread render([&] {
+        if (prepared) RealtimeSetup::prepareCurrentThread("bench render");
+        double block[Sound::MaxBlockSize];
+        long before = threadMinorFaults();
+        sound.noteOn();
+        for (int b = 0; b < 8; ++b) {
+            sound.generateSamples(block, Sound::MaxBlockSize);
+            sink = sink + block[0];
+        }
+        faults = threadMinorFaults() - before;
+    });
+    render.join();
+    return faults;
+}
+
+// Freshly built graph in its own arena, not rendered yet
+static std::unique_ptr<Sound> buildColdSound(PresetManager& presetManager, int preset, LiveController& controller) {
+    auto sound = std::make_unique<Sound>(BenchSampleRate);
+    sound->setArena(std::make_unique<PatchArena>());
+    PatchArena::Scope scope(sound->getArena());
+    presetManager.getPresets()[preset].setupFunction(sound.get(), controller);
+    return sound;
+}
+
+static bool benchRealtimeSetup() {
+    printHeader("Real-time Setup");
+    PresetManager presetManager;
+    presetManager.loadPatchDirectory("patches");
+    const int presetCount = presetManager.getPresetCount();
+
+    // Plain first, before anything is locked
+    std::vector<long> faults[2];
+    for (int prepared = 0; prepared < 2; ++prepared) {
+        if (prepared) {
+            RealtimeSetup::MemoryLock memory = RealtimeSetup::lockMemory();
+            std::cout << "  memory lock: " << RealtimeSetup::getName(memory) << std::endl;
+        }
+        for (int i = 0; i < presetCount; ++i) {
+            LiveController controller;
+            auto sound = buildColdSound(presetManager, i, controller);
+            if (prepared) sound->prepareMemory();
+            faults[prepared].push_back(firstNoteFaults(*sound, prepared));
+        }
+    }
+
+    long totals[2] = {0, 0};
+    for (int i = 0; i < presetCount; ++i) {
+        totals[0] += faults[0][i];
+        totals[1] += faults[1][i];
+        std::cout << "  " << std::left << std::setw(28) << presetManager.getPresets()[i].name << std::right
+                  << " first-note page faults " << std::setw(4) << faults[0][i]
+                  << "  prepared " << std::setw(4) << faults[1][i] << std::endl;
+    }
+
+    const RealtimeSetup::Priority kinds[] = {RealtimeSetup::Priority::Fifo, RealtimeSetup::Priority::Rtkit,
+                                             RealtimeSetup::Priority::Normal};
+    std::cout << "  threads:";
+    for (auto kind : kinds) std::cout << " " << RealtimeSetup::getName(kind) << " " << RealtimeSetup::getThreadCount(kind);
+    std::cout << ", " << RealtimeSetup::getPreparedBytes() / 1024 << " KB prefaulted, "
+              << RealtimeSetup::getLockedBytes() / 1024 << " KB locked by range" << std::endl;
+    std::cout << "  first-note page faults: " << totals[0] << " plain, " << totals[1] << " prepared" << std::endl;
+    bool ok = checkBound("first-note faults when prepared", static_cast<double>(totals[1]), 1.0);
+
+#ifdef __linux__
+    // Keep the other sections' timings comparable to a normal process
+    if (RealtimeSetup::getMemoryLock() == RealtimeSetup::MemoryLock::All) munlockall();
+#endif
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Backends: the device-less backends driving the engine's render path
+// -----------------------------------------------------------------------------
+static bool benchBackends() {
+    printHeader("Audio Backends");
+    PresetManager presetManager;
+    const std::string path = "/tmp/synth_bench_backend.wav";
+    const int presetIndex = 2;  // FM: enough going on to notice a misplaced block
+
+    // The file backend paces a period every 256 frames and writes what the
+    // renderer produced; it must match an offline render of the same preset
+    SoundExchange exchange;
+    SoundRenderer renderer(&exchange);
+    auto live = PresetCache::build(presetManager, presetIndex, BenchSampleRate);
+    live->sound->noteOn();
+    exchange.publish(live->sound.get());
+
+    AudioBackend::Config config;
+    config.backend = "file";
+    config.path = path;
+    config.sampleRate = BenchSampleRate;
+    config.periodFrames = 256;
+    config.channels = 1;  // Compared sample for sample with the mono render
+    NullAudioBackend fileBackend(true);
+    bool ok = fileBackend.start(config, SoundRenderer::renderCallback, &renderer);
+    auto started = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    fileBackend.stop();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    long long frames = fileBackend.getFramesRendered();
+
+    std::vector<float> written;
+    if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+        unsigned char header[44];
+        if (std::fread(header, 1, sizeof(header), file) == sizeof(header)) {
+            uint32_t dataBytes = header[40] | (header[41] << 8) | (header[42] << 16) | (uint32_t(header[43]) << 24);
+            written.resize(dataBytes / sizeof(float));
+            written.resize(std::fread(written.data(), sizeof(float), written.size(), file));
+        }
+        std::fclose(file);
+    }
+    std::remove(path.c_str());
+
+    auto reference = PresetCache::build(presetManager, presetIndex, BenchSampleRate);
+    reference->sound->noteOn();
+    std::vector<double> expected(written.size());
+    reference->sound->generateSamples(expected.data(), static_cast<int>(expected.size()));
+    int mismatches = 0;
+    for (size_t i = 0; i < written.size(); ++i) {
+        if (written[i] != static_cast<float>(expected[i])) ++mismatches;
+    }
+
+    double paced = frames / (seconds * BenchSampleRate);
+    std::cout << "  file backend: " << frames << " frames in " << std::setprecision(3) << seconds << " s (x"
+              << std::setprecision(2) << paced << " real time), " << written.size() << " in the WAV, "
+              << mismatches << " differ from an offline render"
+              << (written.size() == static_cast<size_t>(frames) && frames > 0 && mismatches == 0 ? "  ok" : "  FAIL")
+              << std::endl;
+    ok = ok && frames > 0 && written.size() == static_cast<size_t>(frames) && mismatches == 0;
+    ok = checkBound("file backend pacing error", std::fabs(paced - 1.0), 0.2) && ok;
+
+    std::cout << "  alsa backend: " << (AlsaAudioBackend::isAvailable() ? "built in" : "not built (no ALSA headers)")
+              << std::endl;
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Recording: takes match an offline render, full rings drop whole blocks
+// and every frame is accounted for
+// -----------------------------------------------------------------------------
+// Samples of a recording; WAV data starts after the aligned header
+static std::vector<float> readRecording(const std::string& path, DiskRecorder::Format format) {
+    std::vector<float> samples;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return samples;
+    size_t count = 0;
+    if (format == DiskRecorder::Format::Wav) {
+        std::vector<unsigned char> header(DiskRecorder::WriteAlignment);
+        if (std::fread(header.data(), 1, header.size(), file) == header.size()) {
+            const unsigned char* size = header.data() + header.size() - 4;
+            count = (size[0] | (size[1] << 8) | (size[2] << 16) | (uint32_t(size[3]) << 24)) / sizeof(float);
+        }
+    } else {
+        std::fseek(file, 0, SEEK_END);
+        count = static_cast<size_t>(std::ftell(file)) / sizeof(float);
+        std::fseek(file, 0, SEEK_SET);
+    }
+    samples.resize(count);
+    samples.resize(std::fread(samples.data(), sizeof(float), count, file));
+    std::fclose(file);
+    return samples;
+}
+
+static bool benchRecording() {
+    printHeader("Disk recording");
+    PresetManager presetManager;
+    const int presetIndex = 2;
+    const int periodFrames = 256;
+    const int periods = 400;
+    bool ok = true;
+
+    // A stereo take through the renderer, as the audio thread would produce it
+    struct Take {
+        const char* name;
+        DiskRecorder::Format format;
+        bool direct;
+    };
+    for (const Take& take : {Take{"WAV", DiskRecorder::Format::Wav, false}, Take{"raw", DiskRecorder::Format::Raw, false},
+                             Take{"WAV, O_DIRECT", DiskRecorder::Format::Wav, true}}) {
+        const std::string path = "/tmp/synth_bench_take";
+        auto live = PresetCache::build(presetManager, presetIndex, BenchSampleRate, 2);
+        live->sound->noteOn();
+        SoundExchange exchange;
+        SoundRenderer renderer(&exchange);
+        exchange.publish(live->sound.get());
+        DiskRecorder recorder;
+        DiskRecorder::Options options;
+        options.format = take.format;
+        options.direct = take.direct;
+        options.writeBytes = 64 * 1024;
+        recorder.start(path, BenchSampleRate, 2, options);
+        renderer.setRecorder(&recorder);
+        std::vector<float> period(periodFrames * 2);
+        for (int p = 0; p < periods; ++p) renderer.render(period.data(), periodFrames, 2);
+        recorder.stop();
+        DiskRecorder::Stats stats = recorder.getStats();
+        std::vector<float> written = readRecording(path, take.format);
+        std::remove(path.c_str());
+
+        auto reference = PresetCache::build(presetManager, presetIndex, BenchSampleRate, 2);
+        reference->sound->noteOn();
+        std::vector<double> left(written.size() / 2), right(written.size() / 2);
+        double* planar[2] = {left.data(), right.data()};
+        reference->sound->generateChannels(planar, static_cast<int>(left.size()));
+        int mismatches = 0;
+        for (size_t n = 0; n < left.size(); ++n) {
+            if (written[2 * n] != static_cast<float>(left[n]) || written[2 * n + 1] != static_cast<float>(right[n])) {
+                ++mismatches;
+            }
+        }
+        const long long expected = static_cast<long long>(periods) * periodFrames;
+        bool takeOk = stats.framesWritten == expected && static_cast<long long>(left.size()) == expected &&
+                      stats.droppedBlocks == 0 && mismatches == 0;
+        std::cout << "  " << std::left << std::setw(14) << take.name << std::right << std::setw(7) << left.size()
+                  << " frames, " << stats.writes << " writes, " << stats.droppedBlocks << " dropped, " << mismatches
+                  << " differ" << (take.direct && !recorder.isDirect() ? " (O_DIRECT refused, buffered)" : "")
+                  << (takeOk ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && takeOk;
+    }
+
+    // Periods before any Sound is published are silence, but still part of
+    // the take and of the renderer's frame count
+    {
+        const std::string path = "/tmp/synth_bench_silence.raw";
+        auto live = PresetCache::build(presetManager, presetIndex, BenchSampleRate, 2);
+        live->sound->noteOn();
+        SoundExchange exchange;
+        SoundRenderer renderer(&exchange);
+        DiskRecorder recorder;
+        DiskRecorder::Options options;
+        options.format = DiskRecorder::Format::Raw;
+        recorder.start(path, BenchSampleRate, 2, options);
+        renderer.setRecorder(&recorder);
+        std::vector<float> period(periodFrames * 2);
+        for (int p = 0; p < periods; ++p) {
+            if (p == periods / 2) exchange.publish(live->sound.get());
+            renderer.render(period.data(), periodFrames, 2);
+        }
+        recorder.stop();
+        std::remove(path.c_str());
+        const long long expected = static_cast<long long>(periods) * periodFrames;
+        bool counted = renderer.getFramesRendered() == expected && recorder.getStats().framesWritten == expected;
+        std::cout << "  half silent: " << renderer.getFramesRendered() << " frames rendered, "
+                  << recorder.getStats().framesWritten << " recorded of " << expected
+                  << (counted ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && counted;
+    }
+
+    // A ring far too small for the producer: blocks are dropped whole,
+    // never split, and written + dropped adds up to what was pushed
+    {
+        const std::string path = "/tmp/synth_bench_drops.raw";
+        const int blockFrames = 512;
+        const int blocks = 2000;
+        DiskRecorder recorder;
+        DiskRecorder::Options options;
+        options.format = DiskRecorder::Format::Raw;
+        options.ringSeconds = 0.0;  // The minimum: two writes
+        options.writeBytes = DiskRecorder::WriteAlignment;
+        recorder.start(path, BenchSampleRate, 1, options);
+        std::vector<float> block(blockFrames);
+        double maxPushUs = 0.0;
+        for (int b = 0; b < blocks; ++b) {
+            std::fill(block.begin(), block.end(), static_cast<float>(b));
+            auto begin = std::chrono::steady_clock::now();
+            recorder.push(block.data(), blockFrames, 1);
+            maxPushUs = std::max(maxPushUs, std::chrono::duration<double, std::micro>(
+                                                std::chrono::steady_clock::now() - begin).count());
+        }
+        recorder.stop();
+        DiskRecorder::Stats stats = recorder.getStats();
+        std::vector<float> written = readRecording(path, DiskRecorder::Format::Raw);
+        std::remove(path.c_str());
+
+        // Whole blocks, in order
+        bool whole = written.size() % blockFrames == 0;
+        for (size_t i = 0; whole && i < written.size(); i += blockFrames) {
+            whole = std::all_of(written.begin() + i, written.begin() + i + blockFrames,
+                                [&](float v) { return v == written[i]; }) &&
+                    (i == 0 || written[i] > written[i - 1]);
+        }
+        const long long pushed = static_cast<long long>(blocks) * blockFrames;
+        bool accounted = stats.framesWritten + stats.droppedFrames == pushed &&
+                         stats.droppedFrames == stats.droppedBlocks * blockFrames;
+        bool dropsOk = stats.droppedBlocks > 0 && accounted && whole;
+        std::cout << "  overrun: " << stats.framesWritten << " written + " << stats.droppedFrames << " dropped of "
+                  << pushed << " (" << stats.droppedBlocks << " blocks), " << (whole ? "whole blocks" : "split blocks")
+                  << (dropsOk ? "  ok" : "  FAIL") << std::endl;
+        std::cout << "  overrun: longest push " << std::fixed << std::setprecision(1) << maxPushUs << " us"
+                  << std::defaultfloat << std::endl;
+        ok = ok && dropsOk;
+    }
+
+    // What recording adds to the audio thread: one copy per period
+    {
+        DiskRecorder recorder;
+        recorder.start("/tmp/synth_bench_cost.raw", BenchSampleRate, 2);
+        std::vector<float> block(static_cast<size_t>(BenchBlockSize) * 2, 0.5f);
+        double pushNs = measureNsPerSample([&](double* buffer, int n) {
+            recorder.push(block.data(), n, 2);
+            buffer[0] = block[0];
+        });
+        recorder.stop();
+        std::remove("/tmp/synth_bench_cost.raw");
+        printResult("push, stereo frame", pushNs);
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Output conversion: device formats and resampling
+// -----------------------------------------------------------------------------
+// Engine stand-in for the output stage: a sine at a fixed rate
+struct SineSource {
+    double phase = 0.0;
+    double increment = 0.0;
+
+    SineSource(double frequency, double sampleRate) : increment(frequency / sampleRate) {}
+
+    static void render(void* context, float* output, int numFrames, int channels) {
+        auto* source = static_cast<SineSource*>(context);
+        for (int i = 0; i < numFrames; ++i) {
+            float value = static_cast<float>(0.5 * std::sin(2.0 * M_PI * source->phase));
+            for (int c = 0; c < channels; ++c) output[i * channels + c] = value;
+            source->phase += source->increment;
+        }
+    }
+};
+
+// Largest deviation of a resampled sine from the exact one at the output
+// rate (skipping the filter's warm-up), or its peak when the input sits in
+// the stopband
+static double resampledSineError(double inputRate, double outputRate, double frequency, bool expectSilence) {
+    SineSource source(frequency, inputRate);
+    OutputStage stage;
+    stage.configure(SineSource::render, &source, inputRate, outputRate, 1);
+    std::vector<float> output(16384);
+    stage.render(output.data(), static_cast<int>(output.size()));
+
+    const Resampler& resampler = *stage.getResampler();
+    const double step = static_cast<double>(resampler.getDownFactor()) / resampler.getUpFactor();
+    double maxError = 0.0;
+    for (size_t k = 2 * Resampler::Taps; k < output.size(); ++k) {
+        double inputTime = k * step - resampler.getLatency();
+        double expected = expectSilence ? 0.0 : 0.5 * std::sin(2.0 * M_PI * frequency * inputTime / inputRate);
+        maxError = std::max(maxError, std::fabs(output[k] - expected));
+    }
+    return maxError;
+}
+
+static bool benchConversion() {
+    printHeader("Output conversion");
+    bool ok = true;
+
+    // Accuracy: in-band sines come out at the new rate, sines above the
+    // output's Nyquist frequency do not fold back
+    ok = checkBound("44.1 -> 48 kHz, 1 kHz sine error", resampledSineError(44100.0, 48000.0, 1000.0, false), 1e-3) && ok;
+    ok = checkBound("44.1 -> 48 kHz, 15 kHz sine error", resampledSineError(44100.0, 48000.0, 15000.0, false), 2e-3) && ok;
+    ok = checkBound("48 -> 44.1 kHz, 1 kHz sine error", resampledSineError(48000.0, 44100.0, 1000.0, false), 1e-3) && ok;
+    ok = checkBound("48 -> 44.1 kHz, 23 kHz alias level", resampledSineError(48000.0, 44100.0, 23000.0, true), 3e-4) && ok;
+
+    // Cost per device frame, 256-frame periods
+    struct Layout {
+        const char* name;
+        SampleType type;
+        int channels;
+        double deviceRate;
+    };
+    const Layout layouts[] = {
+        {"float mono (pass-through)", SampleType::Float32, 1, 44100.0},
+        {"float stereo", SampleType::Float32, 2, 44100.0},
+        {"int32 stereo", SampleType::Int32, 2, 44100.0},
+        {"int16 stereo", SampleType::Int16, 2, 44100.0},
+        {"int16 stereo at 48 kHz", SampleType::Int16, 2, 48000.0},
+        {"float mono at 96 kHz", SampleType::Float32, 1, 96000.0},
+        {"float mono at 22.05 kHz", SampleType::Float32, 1, 22050.0},
+    };
+    std::vector<char> device(256 * 2 * sizeof(float));
+    double baseline = 0.0;
+    // A constant source, so the numbers are the stage's own cost
+    auto constant = [](void*, float* output, int numFrames, int channels) {
+        std::fill(output, output + numFrames * channels, 0.25f);
+    };
+    for (const Layout& layout : layouts) {
+        OutputStage stage;
+        stage.configure(constant, nullptr, BenchSampleRate, layout.deviceRate, layout.channels);
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            for (int done = 0; done < n; done += 256) stage.write(device.data(), 256, layout.type);
+            buffer[0] = device[0];
+        });
+        if (baseline == 0.0) baseline = ns;
+        printResult(layout.name, ns, ratioNote(ns / baseline, "vs pass-through"));
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Sample rates: every node follows Sound::setSampleRate, and what each rate costs
+// -----------------------------------------------------------------------------
+// The preset's graph at a rate, without the warm-up block PresetCache renders
+static PreparedPreset buildAtRate(const PresetManager& presetManager, int index, double rate) {
+    PreparedPreset preset;
+    preset.presetIndex = index;
+    preset.sound = std::make_unique<Sound>(rate);
+    preset.controller = std::make_unique<LiveController>();
+    presetManager.getPresets()[index].setupFunction(preset.sound.get(), *preset.controller);
+    return preset;
+}
+
+// Frequency from the rising zero crossings of one second of output
+static double measuredFrequency(Sound& sound) {
+    const int frames = static_cast<int>(sound.getSampleRate());
+    std::vector<double> output(frames);
+    sound.generateSamples(output.data(), frames);
+    int first = -1, last = -1, crossings = 0;
+    for (int i = 1; i < frames; ++i) {
+        if (output[i - 1] < 0.0 && output[i] >= 0.0) {
+            if (first < 0) first = i;
+            last = i;
+            ++crossings;
+        }
+    }
+    return crossings > 1 ? (crossings - 1) * sound.getSampleRate() / (last - first) : 0.0;
+}
+
+static bool benchSampleRates() {
+    printHeader("Sample rates");
+    PresetManager presetManager;
+    presetManager.loadPatchDirectory("patches");
+    const double rates[] = {44100.0, 48000.0, 96000.0, 192000.0};
+    bool ok = true;
+
+    // A graph built at 44.1 kHz and switched to 96 kHz must render exactly
+    // like one built at 96 kHz: any node that keeps a rate-derived value shows up
+    double worst = 0.0;
+    std::string worstName;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        PreparedPreset native = buildAtRate(presetManager, i, 96000.0);
+        PreparedPreset switched = buildAtRate(presetManager, i, BenchSampleRate);
+        switched.sound->setSampleRate(96000.0);
+        native.sound->noteOn();
+        switched.sound->noteOn();
+        std::vector<double> expected(8192), actual(8192);
+        native.sound->generateSamples(expected.data(), 8192);
+        switched.sound->generateSamples(actual.data(), 8192);
+        for (int n = 0; n < 8192; ++n) {
+            double error = std::fabs(expected[n] - actual[n]);
+            if (error > worst) {
+                worst = error;
+                worstName = presetManager.getPresets()[i].name;
+            }
+        }
+    }
+    ok = checkBound("switched vs built at 96 kHz", worst, 1e-12) && ok;
+    if (worst > 0.0) std::cout << "    worst: " << worstName << std::endl;
+
+    // Pitch stays put at every rate
+    for (double rate : rates) {
+        PreparedPreset sine = buildAtRate(presetManager, 0, rate);  // Simple Sine Wave, 440 Hz
+        sine.sound->noteOn();
+        std::ostringstream name;
+        name << "440 Hz sine at " << rate / 1000.0 << " kHz, error Hz";
+        ok = checkBound(name.str(), std::fabs(measuredFrequency(*sine.sound) - 440.0), 0.5) && ok;
+    }
+
+    // A rate change rewarms the preset cache, so switching stays a hit
+    PresetCache cache(presetManager, BenchSampleRate);
+    cache.start();
+    cache.waitUntilIdle();
+    cache.setSampleRate(96000.0);
+    cache.waitUntilIdle();
+    auto prepared = cache.acquire(2);
+    bool rewarmed = prepared && prepared->sound->getSampleRate() == 96000.0 && cache.getStats().hits == 1;
+    std::cout << "  preset cache rewarmed at 96 kHz" << (rewarmed ? "  ok" : "  FAIL") << std::endl;
+    ok = ok && rewarmed;
+
+    // Real-time load per rate: ns per sample times samples per second
+    std::cout << "  " << std::left << std::setw(28) << "% of a core" << std::right;
+    for (double rate : rates) std::cout << std::setw(9) << std::fixed << std::setprecision(1) << rate / 1000.0 << "k";
+    std::cout << std::endl;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        std::cout << "  " << std::left << std::setw(28) << presetManager.getPresets()[i].name << std::right;
+        for (double rate : rates) {
+            PreparedPreset preset = buildAtRate(presetManager, i, rate);
+            preset.sound->noteOn();
+            double ns = measureNsPerSample([&](double* buffer, int n) { preset.sound->generateSamples(buffer, n); },
+                                           static_cast<int>(rate) / 2);
+            std::cout << std::setw(10) << std::fixed << std::setprecision(2) << ns * rate / 1e9 * 100.0;
+        }
+        std::cout << std::endl;
+    }
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Stereo: constant-power panning, unison spread, per-channel filter state and
+// what channels cost
+// -----------------------------------------------------------------------------
+// A sine layer (or a unison layer) through a lowpass, without an envelope
+static std::unique_ptr<Sound> makePannedSound(int channels, bool unison, double pan, double spread) {
+    auto sound = std::make_unique<Sound>(BenchSampleRate);
+    sound->setChannelCount(channels);
+    if (unison) {
+        auto voices = std::make_unique<VoiceLaneSynthesizer>(VoiceLaneSynthesizer::Waveform::Saw,
+                                                             VoiceLaneSynthesizer::FilterType::LowPass, BenchSampleRate);
+        voices->setFrequency(220.0);
+        voices->setVoiceCount(8);
+        voices->setDetune(15.0);
+        voices->setSpread(spread);
+        voices->setADSR(0.0, 0.0, 100.0, 0.0);
+        voices->noteOn();
+        sound->addOscillator(std::move(voices));
+    } else {
+        auto sine = std::make_unique<SineOscillator>(BenchSampleRate);
+        sine->setFrequency(330.0);
+        sound->addOscillator(std::move(sine));
+    }
+    auto lowpass = std::make_unique<LowPassFilter>(BenchSampleRate);
+    lowpass->setCutoffFrequency(1500.0);
+    lowpass->setResonance(2.0);
+    sound->addFilter(std::move(lowpass));
+    sound->setOscillatorPan(0, pan);
+    return sound;
+}
+
+struct StereoRender {
+    std::vector<double> left, right;
+};
+
+static StereoRender renderStereo(Sound& sound, int frames) {
+    StereoRender render{std::vector<double>(frames), std::vector<double>(frames)};
+    double* planar[2] = {render.left.data(), render.right.data()};
+    sound.generateChannels(planar, frames);
+    return render;
+}
+
+static bool benchStereo() {
+    printHeader("Stereo and multichannel");
+    const int frames = 8192;
+    bool ok = true;
+
+    // Constant power: L^2 + R^2 equals the mono signal's power at every pan.
+    // The filter runs once per channel, so shared state would break this too.
+    auto mono = makePannedSound(1, false, 0.0, 0.0);
+    std::vector<double> reference(frames);
+    mono->generateSamples(reference.data(), frames);
+    double worstPower = 0.0;
+    for (double pan : {-1.0, -0.5, 0.0, 0.3, 1.0}) {
+        auto stereo = makePannedSound(2, false, pan, 0.0);
+        StereoRender render = renderStereo(*stereo, frames);
+        for (int n = 0; n < frames; ++n) {
+            double power = render.left[n] * render.left[n] + render.right[n] * render.right[n];
+            worstPower = std::max(worstPower, std::fabs(power - reference[n] * reference[n]));
+        }
+    }
+    ok = checkBound("panned sine, |L^2+R^2 - mono^2|", worstPower, 1e-12) && ok;
+
+    // Pan moved from another thread while the Sound renders: each block
+    // takes one whole set of gains, so the same holds at every sample. No
+    // filter here, as its state would carry the previous block's gains.
+    {
+        auto makeSine = [](int channels) {
+            auto sound = std::make_unique<Sound>(BenchSampleRate);
+            sound->setChannelCount(channels);
+            auto sine = std::make_unique<SineOscillator>(BenchSampleRate);
+            sine->setFrequency(330.0);
+            sound->addOscillator(std::move(sine));
+            return sound;
+        };
+        auto moving = makeSine(2), still = makeSine(1);
+        std::atomic<bool> done{false};
+        std::atomic<long> moves{0};
+        std::thread control([&]() {
+            for (int k = 0; !done.load(std::memory_order_relaxed); ++k) {
+                moving->setOscillatorPan(0, std::sin(k * 0.37));
+                moves.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        std::vector<double> left(BenchBlockSize), right(BenchBlockSize), mono(BenchBlockSize);
+        double worst = 0.0;
+        for (int block = 0; block < 4000; ++block) {
+            double* planar[2] = {left.data(), right.data()};
+            moving->generateChannels(planar, BenchBlockSize);
+            still->generateSamples(mono.data(), BenchBlockSize);
+            for (int n = 0; n < BenchBlockSize; ++n) {
+                double power = left[n] * left[n] + right[n] * right[n];
+                worst = std::max(worst, std::fabs(power - mono[n] * mono[n]));
+            }
+        }
+        done.store(true);
+        control.join();
+        std::cout << "  pan moves during the render: " << moves.load() << std::endl;
+        ok = checkBound("pan moved while rendering, |L^2+R^2 - mono^2|", worst, 1e-12) && ok;
+    }
+
+    // Surround: the same holds across 6 channels
+    double worstSurround = 0.0;
+    for (double pan : {-1.0, -0.35, 0.5}) {
+        auto surround = makePannedSound(6, false, pan, 0.0);
+        std::vector<std::vector<double>> outputs(6, std::vector<double>(frames));
+        double* planar[6];
+        for (int c = 0; c < 6; ++c) planar[c] = outputs[c].data();
+        surround->generateChannels(planar, frames);
+        for (int n = 0; n < frames; ++n) {
+            double power = 0.0;
+            for (int c = 0; c < 6; ++c) power += outputs[c][n] * outputs[c][n];
+            worstSurround = std::max(worstSurround, std::fabs(power - reference[n] * reference[n]));
+        }
+    }
+    ok = checkBound("6 channels, |sum of squares - mono^2|", worstSurround, 1e-12) && ok;
+
+    // A 4-channel Sound on a stereo device: the renderer folds every channel
+    // down, so a layer on any of them keeps its power (float output)
+    double worstFold = 0.0;
+    for (double pan : {-1.0 / 3.0, 1.0 / 3.0, 1.0}) {
+        auto quad = makePannedSound(4, false, pan, 0.0);
+        SoundExchange exchange;
+        SoundRenderer renderer(&exchange);
+        exchange.publish(quad.get());
+        std::vector<float> interleaved(static_cast<size_t>(frames) * 2);
+        for (int offset = 0; offset < frames; offset += BenchBlockSize) {
+            renderer.render(interleaved.data() + offset * 2, std::min(BenchBlockSize, frames - offset), 2);
+        }
+        for (int n = 0; n < frames; ++n) {
+            double power = double(interleaved[2 * n]) * interleaved[2 * n]
+                         + double(interleaved[2 * n + 1]) * interleaved[2 * n + 1];
+            worstFold = std::max(worstFold, std::fabs(power - reference[n] * reference[n]));
+        }
+    }
+    ok = checkBound("4 channels on stereo, |L^2+R^2 - mono^2|", worstFold, 1e-6) && ok;
+
+    // Unison: without spread both sides are the mono render at -3 dB; with
+    // it the voices separate
+    auto unisonMono = makePannedSound(1, true, 0.0, 0.0);
+    std::vector<double> unisonReference(frames);
+    unisonMono->generateSamples(unisonReference.data(), frames);
+    auto narrow = makePannedSound(2, true, 0.0, 0.0);
+    StereoRender narrowRender = renderStereo(*narrow, frames);
+    double narrowError = 0.0;
+    for (int n = 0; n < frames; ++n) {
+        double expected = unisonReference[n] * M_SQRT1_2;
+        narrowError = std::max({narrowError, std::fabs(narrowRender.left[n] - expected),
+                                std::fabs(narrowRender.right[n] - expected)});
+    }
+    ok = checkBound("unison, spread 0, |side - mono/sqrt2|", narrowError, 1e-12) && ok;
+
+    auto wide = makePannedSound(2, true, 0.0, 100.0);
+    StereoRender wideRender = renderStereo(*wide, frames);
+    double sideEnergy = 0.0, midEnergy = 0.0;
+    for (int n = frames / 2; n < frames; ++n) {
+        double mid = wideRender.left[n] + wideRender.right[n];
+        double side = wideRender.left[n] - wideRender.right[n];
+        midEnergy += mid * mid;
+        sideEnergy += side * side;
+    }
+    double width = midEnergy > 0.0 ? sideEnergy / midEnergy : 0.0;
+    bool spreadOk = width > 0.05;
+    std::cout << "  unison, spread 100%, side/mid energy  " << std::setprecision(3) << width
+              << (spreadOk ? "  ok" : "  FAIL") << std::endl;
+    ok = ok && spreadOk;
+
+    // Layer pans from a patch: stored through text and binary, then moved by
+    // the "Layer N Pan" parameters the volume registers
+    {
+        Patch patch, nested;
+        std::string error;
+        CompiledPatch compiled;
+        bool loaded = PatchFormat::parse("sine pan=-0.5\nsaw frequency=220\nvolume register\n", patch, error)
+                   && PatchFormat::parse(PatchFormat::write(patch), patch, error)
+                   && compiled.load(CompiledPatch::compile(patch));
+        bool nestedRejected = !PatchFormat::parse("additive\n  sine pan=0.5\n", nested, error);
+
+        Sound sound(BenchSampleRate);
+        LiveController controller;
+        compiled.instantiate(&sound, controller);
+        controller.setParameter(controller.findParameter("Layer 2 Pan"), 0.75);
+        bool panOk = loaded && nestedRejected && sound.getOscillatorPan(0) == -0.5
+                  && sound.getOscillatorPan(1) == 0.75 && compiled.decompile().nodes[0].pan == -0.5;
+        std::cout << "  patch layer pans  " << sound.getOscillatorPan(0) << ", " << sound.getOscillatorPan(1)
+                  << (panOk ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && panOk;
+    }
+
+    // Cost of the channels through the renderer, per frame. The mono path
+    // must cost what rendering the Sound directly does. The three are
+    // measured in turns, in short runs that fit between two preemptions of
+    // a busy machine, and each keeps its best run.
+    PresetManager presetManager;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        if (presetManager.getPresets()[i].name != "Unison Saw Pad") continue;
+        std::vector<float> interleaved(static_cast<size_t>(BenchBlockSize) * 2);
+        auto direct = PresetCache::build(presetManager, i, BenchSampleRate, 1);
+        direct->sound->noteOn();
+        std::unique_ptr<PreparedPreset> presets[2];
+        SoundExchange exchanges[2];
+        std::unique_ptr<SoundRenderer> renderers[2];
+        for (int channels : {1, 2}) {
+            presets[channels - 1] = PresetCache::build(presetManager, i, BenchSampleRate, channels);
+            presets[channels - 1]->sound->noteOn();
+            renderers[channels - 1] = std::make_unique<SoundRenderer>(&exchanges[channels - 1]);
+            exchanges[channels - 1].publish(presets[channels - 1]->sound.get());
+        }
+
+        constexpr int Runs = 20;
+        const int runSamples = static_cast<int>(BenchSampleRate) / 4;
+        double directNs = 0.0, rendererNs[2] = {};
+        for (int run = 0; run < Runs; ++run) {
+            double ns = measureNsPerSample([&](double* buffer, int n) { direct->sound->generateSamples(buffer, n); },
+                                           runSamples);
+            directNs = run == 0 ? ns : std::min(directNs, ns);
+            for (int channels : {1, 2}) {
+                SoundRenderer& renderer = *renderers[channels - 1];
+                ns = measureNsPerSample([&](double* buffer, int n) {
+                    renderer.render(interleaved.data(), n, channels);
+                    buffer[0] = interleaved[0];
+                }, runSamples);
+                rendererNs[channels - 1] = run == 0 ? ns : std::min(rendererNs[channels - 1], ns);
+            }
+        }
+
+        printResult("Unison Saw Pad, Sound only", directNs);
+        for (int channels : {1, 2}) {
+            double ns = rendererNs[channels - 1];
+            printResult(std::string("Unison Saw Pad, renderer ") + (channels == 1 ? "mono" : "stereo"), ns,
+                        ratioNote(ns / directNs, "vs Sound only"));
+            ok = checkBound(channels == 1 ? "mono renderer / Sound only" : "stereo renderer / Sound only",
+                            ns / directNs, channels == 1 ? 1.5 : 2.0) && ok;
+        }
+    }
+
+    // The interleave kernels against the generic strided path
+    std::vector<double> left(BenchBlockSize, 0.25), right(BenchBlockSize, -0.25);
+    const double* planar[2] = {left.data(), right.data()};
+    std::vector<float> out(static_cast<size_t>(BenchBlockSize) * 2);
+    double monoKernel = measureNsPerSample([&](double* buffer, int n) {
+        channels::interleaveMono(left.data(), out.data(), n);
+        buffer[0] = out[0];
+    });
+    double stereoKernel = measureNsPerSample([&](double* buffer, int n) {
+        channels::interleaveStereo(left.data(), right.data(), out.data(), n);
+        buffer[0] = out[1];
+    });
+    double strided = measureNsPerSample([&](double* buffer, int n) {
+        for (int c = 0; c < 2; ++c) {
+            for (int k = 0; k < n; ++k) out[k * 2 + c] = static_cast<float>(planar[c][k]);
+        }
+        buffer[0] = out[1];
+    });
+    printResult("interleave, mono conversion", monoKernel);
+    printResult("interleave, stereo zip", stereoKernel, ratioNote(strided / stereoKernel, "faster than strided"));
+    printResult("interleave, stereo strided", strided);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Virtual device: xrun accounting against a known load, then real sounds on
+// the paced and the simulated clock
+// -----------------------------------------------------------------------------
+// Render callback that burns a fixed share of each period
+struct SpinLoad {
+    double seconds;
+
+    static void render(void* context, float* output, int numFrames, int channels) {
+        auto until = std::chrono::steady_clock::now()
+                   + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(static_cast<SpinLoad*>(context)->seconds));
+        while (std::chrono::steady_clock::now() < until) {}
+        std::fill(output, output + numFrames * channels, 0.0f);
+    }
+};
+
+static const VirtualAudioBackend::Stats& runVirtualDevice(VirtualAudioBackend& device, AudioBackend::Config config,
+                                                           AudioBackend::RenderCallback render, void* context,
+                                                           long long frames) {
+    config.backend = "virtual";
+    device.setRunLength(frames);
+    device.start(config, render, context);
+    device.finish();
+    return device.getStats();
+}
+
+static void printDeviceStats(const std::string& name, const VirtualAudioBackend::Stats& stats) {
+    std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed
+              << std::setw(6) << stats.periods << " periods " << std::setw(4) << stats.xruns << " xruns"
+              << "  jitter " << std::setprecision(1) << stats.meanJitterUs << "/" << stats.maxJitterUs << " us"
+              << "  load " << std::setprecision(0) << stats.meanLoad * 100.0 << "/" << stats.peakLoad * 100.0 << " %"
+              << "  fill min " << stats.minFill * 100.0 << " %" << std::endl;
+}
+
+static bool benchVirtualDevice() {
+    printHeader("Virtual Device");
+    AudioBackend::Config config;
+    config.sampleRate = BenchSampleRate;
+    config.periodFrames = 256;
+    config.periods = 2;
+    const double periodSeconds = config.periodFrames / BenchSampleRate;
+    bool ok = true;
+
+    // Simulated clock with three periods: a render well under a period never
+    // underruns, one longer than the two periods left underruns every time.
+    // The margins absorb preemption, which the spin counts as render time.
+    for (double share : {0.25, 3.0}) {
+        SpinLoad load{share * periodSeconds};
+        config.clockSpeed = 0.0;
+        config.periods = 3;
+        VirtualAudioBackend device;
+        const auto& stats = runVirtualDevice(device, config, SpinLoad::render, &load, 40 * config.periodFrames);
+        bool expected = share < 1.0 ? stats.xruns == 0 && stats.periods > 0 : stats.xruns > 0 && stats.periods == 0;
+        printDeviceStats("spin " + std::to_string(static_cast<int>(share * 100)) + "% of a period", stats);
+        std::cout << "    " << (expected ? "ok" : "FAIL") << std::endl;
+        ok = ok && expected;
+    }
+
+    // A real preset on the paced clock at 1x and 4x, and on the simulated one
+    config.periods = 2;
+    PresetManager presetManager;
+    for (double speed : {1.0, 4.0, 0.0}) {
+        auto preset = PresetCache::build(presetManager, 3, BenchSampleRate);  // Nested FM
+        preset->sound->noteOn();
+        SoundExchange exchange;
+        SoundRenderer renderer(&exchange);
+        exchange.publish(preset->sound.get());
+        config.clockSpeed = speed;
+        VirtualAudioBackend device;
+        const auto& stats = runVirtualDevice(device, config, SoundRenderer::renderCallback, &renderer,
+                                             static_cast<long long>(BenchSampleRate / 2));
+        std::ostringstream name;
+        name << "Nested FM, " << (speed > 0.0 ? "paced x" + std::to_string(static_cast<int>(speed)) : "simulated");
+        printDeviceStats(name.str(), stats);
+        ok = ok && stats.periods > 0;
+    }
+
+    // A device that settles on another rate: the prepare callback switches the
+    // renderer before its first period, so no block renders at the build rate
+    struct FirstPeriod {
+        SoundRenderer* renderer;
+        Sound* sound;
+        double rate = 0.0;  // The Sound's rate when the first period was rendered
+
+        static void prepare(void* context, double engineRate) {
+            SoundRenderer::prepareCallback(static_cast<FirstPeriod*>(context)->renderer, engineRate);
+        }
+        static void render(void* context, float* output, int numFrames, int channelCount) {
+            auto* self = static_cast<FirstPeriod*>(context);
+            self->renderer->render(output, numFrames, channelCount);
+            if (self->rate == 0.0) self->rate = self->sound->getSampleRate();
+        }
+    };
+    auto preset = PresetCache::build(presetManager, 0, BenchSampleRate);
+    preset->sound->noteOn();
+    SoundExchange exchange;
+    SoundRenderer renderer(&exchange);
+    exchange.publish(preset->sound.get());
+    FirstPeriod first{&renderer, preset->sound.get()};
+    config.clockSpeed = 0.0;
+    config.deviceRate = 96000.0;
+    VirtualAudioBackend device;
+    device.setPrepareCallback(FirstPeriod::prepare);
+    runVirtualDevice(device, config, FirstPeriod::render, &first, config.periodFrames * 4);
+    bool prepared = first.rate == 96000.0;
+    std::cout << "  first period on a 96 kHz device rendered at " << std::setprecision(0) << first.rate << " Hz"
+              << (prepared ? "  ok" : "  FAIL") << std::endl;
+    return ok && prepared;
+}
+
+// -----------------------------------------------------------------------------
+// Soak: the most layers each period size renders without an xrun
+// -----------------------------------------------------------------------------
+static bool soakTrial(int periodFrames, int layers, VirtualAudioBackend::Stats& result) {
+    auto sound = makeLayeredSound(layers);
+    std::vector<double> warmup(periodFrames);
+    sound->generateSamples(warmup.data(), periodFrames);  // First-render costs are not the device's
+    SoundExchange exchange;
+    SoundRenderer renderer(&exchange);
+    exchange.publish(sound.get());
+
+    AudioBackend::Config config;
+    config.sampleRate = BenchSampleRate;
+    config.periodFrames = periodFrames;
+    config.periods = 2;
+    config.clockSpeed = 0.0;  // Simulated: a perfectly scheduled device, as fast as the CPU allows
+    VirtualAudioBackend device;
+    result = runVirtualDevice(device, config, SoundRenderer::renderCallback, &renderer,
+                              static_cast<long long>(BenchSampleRate / 2));
+    return result.xruns == 0;
+}
+
+// A single preemption of the device thread looks like an xrun, so a failing
+// trial gets one more chance, as the budget check re-measures
+static bool soakPasses(int periodFrames, int layers, VirtualAudioBackend::Stats& result) {
+    return soakTrial(periodFrames, layers, result) || soakTrial(periodFrames, layers, result);
+}
+
+static bool benchSoak() {
+    printHeader("Soak (oversampled FM layers, 2 periods, 0.5 s per trial)");
+    const int MaxLayers = 512;
+    int best = 0;
+    for (int periodFrames : {64, 128, 256, 512}) {
+        // Double until the first xrun, then bisect between the last pass and it
+        VirtualAudioBackend::Stats stats, bestStats;
+        int pass = 0, fail = 1;
+        while (fail <= MaxLayers && soakPasses(periodFrames, fail, stats)) {
+            pass = fail;
+            bestStats = stats;
+            fail *= 2;
+        }
+        while (fail - pass > 1 && pass > 0) {
+            int middle = (pass + fail) / 2;
+            if (soakPasses(periodFrames, middle, stats)) {
+                pass = middle;
+                bestStats = stats;
+            } else {
+                fail = middle;
+            }
+        }
+
+        std::ostringstream note;
+        note << std::fixed << std::setprecision(2) << 1000.0 * periodFrames / BenchSampleRate << " ms";
+        std::cout << "  period " << std::setw(4) << periodFrames << " (" << note.str() << "): "
+                  << std::setw(4) << pass << " layers before xruns";
+        if (pass > 0) {
+            std::cout << "  load " << std::fixed << std::setprecision(0) << bestStats.meanLoad * 100.0 << "/"
+                      << bestStats.peakLoad * 100.0 << " %";
+        }
+        std::cout << std::endl;
+        best = std::max(best, pass);
+    }
+    return best > 0;
+}
+
+// -----------------------------------------------------------------------------
+// Golden renders: every preset played through a fixed script and compared
+// against stored output
+// -----------------------------------------------------------------------------
+namespace {
+
+const char* const GoldenDirectory = "bench/golden";
+const char* const BudgetFile = "bench/budgets.txt";
+constexpr int GoldenSamples = 8192;
+// Goldens are stored as float; its rounding stays below 6e-8 at full scale
+constexpr double GoldenTolerance = 1e-6;
+
+struct ScriptEvent {
+    enum class Type { NoteOn, NoteOff, Parameter };
+    Type type;
+    int at;                 // Sample offset
+    int parameter = 0;      // Registration index, counted from the end when negative
+    double toward = 0.0;    // Fraction of the way to the parameter's max (> 0) or min (< 0)
+};
+
+// Attack, two live parameter moves while the note holds, then the release tail
+const ScriptEvent GoldenScript[] = {
+    {ScriptEvent::Type::NoteOn, 0},
+    {ScriptEvent::Type::Parameter, 2048, 0, 0.2},
+    {ScriptEvent::Type::Parameter, 3072, -1, -0.3},
+    {ScriptEvent::Type::NoteOff, 5120},
+};
+
+struct GoldenHeader {
+    char magic[4];
+    uint32_t sampleRate;
+    uint32_t sampleCount;
+    uint32_t reserved;
+};
+
+void applyEvent(const ScriptEvent& event, Sound& sound, LiveController& controller) {
+    switch (event.type) {
+    case ScriptEvent::Type::NoteOn:
+        sound.noteOn();
+        break;
+    case ScriptEvent::Type::NoteOff:
+        sound.noteOff();
+        break;
+    case ScriptEvent::Type::Parameter: {
+        int count = controller.getParameterCount();
+        int index = event.parameter < 0 ? count + event.parameter : event.parameter;
+        if (index < 0 || index >= count) break;
+        const LiveParameter& parameter = controller.getParameter(index);
+        double value = *parameter.valuePtr;
+        double bound = event.toward > 0.0 ? parameter.maxValue : parameter.minValue;
+        controller.setParameter(index, value + std::fabs(event.toward) * (bound - value));
+        break;
+    }
+    }
+}
+
+std::vector<float> renderGolden(PresetManager& presetManager, int preset) {
+    Sound sound(BenchSampleRate);
+    LiveController controller;
+    presetManager.loadPreset(preset, &sound, controller);
+
+    std::vector<float> output(GoldenSamples);
+    double block[Sound::MaxBlockSize];
+    size_t nextEvent = 0;
+    const size_t eventCount = sizeof(GoldenScript) / sizeof(GoldenScript[0]);
+    for (int position = 0; position < GoldenSamples;) {
+        while (nextEvent < eventCount && GoldenScript[nextEvent].at <= position) {
+            applyEvent(GoldenScript[nextEvent++], sound, controller);
+        }
+        // Blocks end at the next event so it lands on its exact sample
+        int end = std::min(GoldenSamples, position + BenchBlockSize);
+        if (nextEvent < eventCount) end = std::min(end, GoldenScript[nextEvent].at);
+        int count = std::min(end - position, Sound::MaxBlockSize);
+        sound.generateSamples(block, count);
+        for (int i = 0; i < count; ++i) output[position + i] = static_cast<float>(block[i]);
+        position += count;
+    }
+    return output;
+}
+
+// "Sine Unison Pad" -> "sine-unison-pad"
+std::string presetSlug(const std::string& name) {
+    std::string slug;
+    for (char c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            slug += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!slug.empty() && slug.back() != '-') {
+            slug += '-';
+        }
+    }
+    while (!slug.empty() && slug.back() == '-') slug.pop_back();
+    return slug;
+}
+
+std::string goldenPath(const std::string& presetName) {
+    return std::string(GoldenDirectory) + "/" + presetSlug(presetName) + ".golden";
+}
+
+bool writeGolden(const std::string& path, const std::vector<float>& samples) {
+    std::error_code error;
+    std::filesystem::create_directories(GoldenDirectory, error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    GoldenHeader header{{'G', 'L', 'D', '1'}, static_cast<uint32_t>(BenchSampleRate),
+                        static_cast<uint32_t>(samples.size()), 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(float));
+    return static_cast<bool>(file);
+}
+
+bool readGolden(const std::string& path, std::vector<float>& samples) {
+    std::ifstream file(path, std::ios::binary);
+    GoldenHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, "GLD1", 4) != 0 || header.sampleRate != static_cast<uint32_t>(BenchSampleRate)) {
+        return false;
+    }
+    samples.resize(header.sampleCount);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(float)));
+}
+
+} // namespace
+
+static bool benchGolden() {
+    printHeader("Golden Renders");
+    PresetManager presetManager;
+    presetManager.loadPatchDirectory("patches");
+
+    bool passed = true;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        const std::string& name = presetManager.getPresets()[i].name;
+        std::vector<float> rendered = renderGolden(presetManager, i);
+        std::string path = goldenPath(name);
+        std::cout << "  " << std::left << std::setw(28) << name << std::right;
+
+        if (updateReferences) {
+            bool written = writeGolden(path, rendered);
+            std::cout << (written ? "  written to " : "  FAIL could not write ") << path << std::endl;
+            passed = written && passed;
+            continue;
+        }
+
+        std::vector<float> golden;
+        if (!readGolden(path, golden)) {
+            std::cout << "  FAIL no golden at " << path << " (run `./synth_bench golden --update`)" << std::endl;
+            passed = false;
+            continue;
+        }
+        if (golden.size() != rendered.size()) {
+            std::cout << "  FAIL golden has " << golden.size() << " samples, rendered " << rendered.size() << std::endl;
+            passed = false;
+            continue;
+        }
+
+        double maxError = 0.0;
+        double peak = 0.0;
+        int firstBad = -1;
+        for (size_t s = 0; s < rendered.size(); ++s) {
+            double error = std::fabs(static_cast<double>(rendered[s]) - golden[s]);
+            if (error > GoldenTolerance && firstBad < 0) firstBad = static_cast<int>(s);
+            maxError = std::max(maxError, error);
+            peak = std::max(peak, std::fabs(static_cast<double>(golden[s])));
+        }
+        std::cout << "  peak " << std::fixed << std::setprecision(3) << peak
+                  << "  max error " << std::scientific << std::setprecision(1) << maxError << std::fixed;
+        if (firstBad >= 0) std::cout << "  FAIL from sample " << firstBad;
+        else std::cout << "  ok";
+        std::cout << std::endl;
+        passed = firstBad < 0 && passed;
+    }
+    if (!updateReferences) {
+        std::cout << "  tolerance " << std::scientific << std::setprecision(0) << GoldenTolerance << std::fixed
+                  << " over " << GoldenSamples << " samples per preset" << std::endl;
+    }
+    return passed;
+}
+
+// -----------------------------------------------------------------------------
+// Budgets: per-preset cost against the recorded baseline, as a multiple of a
+// reference workload timed in the same run so the file holds across machines
+// -----------------------------------------------------------------------------
+namespace {
+
+// "name<TAB>cost" per line, cost in units of the reference; '#' starts a comment
+std::map<std::string, double> readBudgets(const std::string& path) {
+    std::map<std::string, double> budgets;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t tab = line.rfind('\t');
+        if (tab == std::string::npos) continue;
+        budgets[line.substr(0, tab)] = std::atof(line.c_str() + tab + 1);
+    }
+    return budgets;
+}
+
+bool writeBudgets(const std::string& path, const std::vector<std::pair<std::string, double>>& measured) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) return false;
+    file << "# Per-preset render cost, checked by `./synth_bench budgets`. Each entry is the\n"
+         << "# preset's ns/sample divided by the reference workload's, timed in the same run,\n"
+         << "# so it carries over between machines. Regenerate with `./synth_bench budgets --update`.\n";
+    for (const auto& [name, cost] : measured) {
+        file << name << '\t' << std::fixed << std::setprecision(3) << cost << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+// Best of five one-second runs: scheduling noise only ever makes a run slower
+double measureBestNsPerSample(Sound& sound) {
+    double best = 0.0;
+    for (int run = 0; run < 5; ++run) {
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            sound.generateSamples(buffer, n);
+        }, static_cast<int>(BenchSampleRate));
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// The machine's speed: a naive sine oscillator through a biquad, the same
+// mix of libm calls, multiplies and short dependency chains the presets run,
+// but none of the synth's code, so a regression there cannot hide in it
+double measureReferenceNsPerSample() {
+    double phase = 0.0, x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+    double best = 0.0;
+    for (int run = 0; run < 5; ++run) {
+        double ns = measureNsPerSample([&](double* buffer, int n) {
+            for (int i = 0; i < n; ++i) {
+                phase += 440.0 / BenchSampleRate;
+                if (phase >= 1.0) phase -= 1.0;
+                const double x = std::sin(2.0 * M_PI * phase);
+                const double y = 0.067 * (x + 2.0 * x1 + x2) + 1.143 * y1 - 0.413 * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                buffer[i] = y;
+            }
+        }, static_cast<int>(BenchSampleRate));
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+} // namespace
+
+static bool benchBudgets() {
+    printHeader("Budgets");
+    PresetManager presetManager;
+    presetManager.loadPatchDirectory("patches");
+    std::map<std::string, double> budgets = readBudgets(BudgetFile);
+
+    // Timed before and after the presets and averaged, so a clock that
+    // drifts during the run moves the reference with the presets
+    double reference = measureReferenceNsPerSample();
+    std::vector<std::pair<std::string, double>> timings;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        Sound sound(BenchSampleRate);
+        LiveController controller;
+        presetManager.loadPreset(i, &sound, controller);
+        sound.noteOn();
+        timings.emplace_back(presetManager.getPresets()[i].name, measureBestNsPerSample(sound));
+    }
+    reference = 0.5 * (reference + measureReferenceNsPerSample());
+    printResult("reference workload", reference, "= 1.000");
+
+    bool passed = true;
+    std::vector<std::pair<std::string, double>> measured;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        const auto& [name, ns] = timings[i];
+        double cost = ns / reference;
+        measured.emplace_back(name, cost);
+
+        std::ostringstream note;
+        note << "= " << std::fixed << std::setprecision(3) << cost;
+        if (updateReferences) {
+            printResult(name, ns, note.str() + "  recorded");
+            continue;
+        }
+        auto budget = budgets.find(name);
+        if (budget == budgets.end()) {
+            printResult(name, ns, "FAIL no budget (run `./synth_bench budgets --update`)");
+            passed = false;
+            continue;
+        }
+        double limit = budget->second * (1.0 + budgetTolerance);
+        // A real regression survives a second measurement, a busy machine rarely does
+        if (cost > limit) {
+            Sound sound(BenchSampleRate);
+            LiveController controller;
+            presetManager.loadPreset(i, &sound, controller);
+            sound.noteOn();
+            cost = std::min(cost, measureBestNsPerSample(sound) / measureReferenceNsPerSample());
+        }
+        bool within = cost <= limit;
+        printResult(name, cost * reference,
+                    note.str() + ", " + ratioNote(cost / budget->second, "vs budget") + (within ? "  ok" : "  FAIL"));
+        passed = within && passed;
+    }
+
+    if (updateReferences) {
+        bool written = writeBudgets(BudgetFile, measured);
+        std::cout << (written ? "  written to " : "  FAIL could not write ") << BudgetFile << std::endl;
+        return written;
+    }
+    std::cout << "  allowed slowdown " << std::setprecision(0) << budgetTolerance * 100.0 << " %" << std::endl;
+    return passed;
+}
+// -----------------------------------------------------------------------------
+// Parts: the multi-timbral mix against the parts rendered one by one, and
+// what idle parts cost
+// -----------------------------------------------------------------------------
+static bool benchParts() {
+    printHeader("Multi-timbral parts");
+    const int frames = 4096;
+    const int channelCount = 2;
+    bool ok = true;
+
+    // Four parts, mono and stereo Sounds, each with its own volume and pan;
+    // a fifth is bypassed and must not reach the mix
+    struct PartSetup {
+        int soundChannels;
+        bool unison;
+        double soundPan, volume, pan;
+        bool bypassed;
+    };
+    const PartSetup setups[] = {
+        {1, false, 0.0, 1.0, 0.0, false},
+        {2, false, -0.6, 0.5, 0.4, false},
+        {2, true, 0.0, 0.8, -0.7, false},
+        {1, true, 0.0, 0.3, 1.0, false},
+        {2, false, 0.2, 1.0, 0.0, true},
+    };
+    const int partCount = static_cast<int>(std::size(setups));
+
+    std::vector<std::unique_ptr<Sound>> sounds;
+    std::vector<SoundExchange> exchanges(partCount);
+    SoundRenderer renderer;
+    for (int p = 0; p < partCount; ++p) {
+        const PartSetup& setup = setups[p];
+        sounds.push_back(makePannedSound(setup.soundChannels, setup.unison, setup.soundPan, 60.0));
+        exchanges[p].publish(sounds.back().get());
+        renderer.setPartExchange(p, &exchanges[p]);
+        renderer.setPartVolume(p, setup.volume);
+        renderer.setPartPan(p, setup.pan);
+        renderer.setPartBypassed(p, setup.bypassed);
+    }
+    std::vector<float> mixed(static_cast<size_t>(frames) * channelCount);
+    for (int offset = 0; offset < frames; offset += BenchBlockSize) {
+        renderer.render(mixed.data() + offset * channelCount, BenchBlockSize, channelCount);
+    }
+    bool activeOk = renderer.getActivePartCount() == partCount - 1;
+
+    // The same parts rendered on their own from fresh copies
+    std::vector<double> expected(static_cast<size_t>(frames) * channelCount, 0.0);
+    for (const PartSetup& setup : setups) {
+        if (setup.bypassed) continue;
+        auto sound = makePannedSound(setup.soundChannels, setup.unison, setup.soundPan, 60.0);
+        std::vector<double> left(frames), right(frames);
+        if (setup.soundChannels == 1) {
+            sound->generateSamples(left.data(), frames);
+            right = left;
+        } else {
+            double* planar[2] = {left.data(), right.data()};
+            sound->generateChannels(planar, frames);
+        }
+        double gains[channelCount];
+        channels::balanceGains(setup.pan, channelCount, gains);
+        for (int n = 0; n < frames; ++n) {
+            expected[2 * n] += left[n] * gains[0] * setup.volume;
+            expected[2 * n + 1] += right[n] * gains[1] * setup.volume;
+        }
+    }
+    double worstMix = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        worstMix = std::max(worstMix, std::fabs(mixed[i] - expected[i]));
+    }
+    ok = checkBound("mix, |parts - sum of solo renders|", worstMix, 1e-6) && ok;
+    std::cout << "  active parts " << renderer.getActivePartCount() << " of " << partCount
+              << (activeOk ? "  ok" : "  FAIL") << std::endl;
+    ok = ok && activeOk;
+
+    // Cost: one part alone, one part beside 15 bypassed ones, and all 16 mixed
+    std::vector<float> interleaved(static_cast<size_t>(BenchBlockSize) * channelCount);
+    std::vector<std::unique_ptr<Sound>> costSounds;
+    std::vector<SoundExchange> costExchanges(SoundRenderer::MaxParts);
+    for (int p = 0; p < SoundRenderer::MaxParts; ++p) {
+        costSounds.push_back(makePannedSound(channelCount, true, 0.0, 60.0));
+        costExchanges[p].publish(costSounds.back().get());
+    }
+    auto renderNs = [&](SoundRenderer& parts) {
+        return measureNsPerSample([&](double* buffer, int n) {
+            parts.render(interleaved.data(), n, channelCount);
+            buffer[0] = interleaved[0];
+        });
+    };
+
+    SoundRenderer single(&costExchanges[0]);
+    double singleNs = renderNs(single);
+    printResult("1 part", singleNs);
+
+    SoundRenderer idle;
+    for (int p = 0; p < SoundRenderer::MaxParts; ++p) {
+        idle.setPartExchange(p, &costExchanges[p]);
+        idle.setPartBypassed(p, p != 0);
+    }
+    double idleNs = renderNs(idle);
+    printResult("1 part + 15 bypassed", idleNs, ratioNote(idleNs / singleNs, "vs 1 part"));
+    ok = checkBound("15 bypassed parts / 1 part", idleNs / singleNs, 1.25) && ok;
+
+    SoundRenderer full;
+    for (int p = 0; p < SoundRenderer::MaxParts; ++p) {
+        full.setPartExchange(p, &costExchanges[p]);
+        full.setPartVolume(p, 0.25);
+        full.setPartPan(p, -1.0 + 2.0 * p / (SoundRenderer::MaxParts - 1));
+    }
+    double fullNs = renderNs(full);
+    printResult("16 parts mixed", fullNs, ratioNote(fullNs / singleNs, "vs 1 part"));
+
+    // The mixer alone: 16 stereo parts summed into a stereo bus
+    std::vector<double> source(BenchBlockSize, 0.25), busLeft(BenchBlockSize), busRight(BenchBlockSize);
+    double* bus[2] = {busLeft.data(), busRight.data()};
+    double busGains[2] = {0.7, 0.5};
+    double mixNs = measureNsPerSample([&](double* buffer, int n) {
+        for (int p = 0; p < SoundRenderer::MaxParts; ++p) channels::mixPanned(source.data(), busGains, bus, 2, n);
+        buffer[0] = busLeft[0];
+    });
+    printResult("mixer, 16 stereo parts", mixNs);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Samples: streamed playback matches the file, varispeed holds pitch, and
+// memory stays bounded however long the file is
+// -----------------------------------------------------------------------------
+// A float WAV (or raw float) holding a sine of frequency Hz at BenchSampleRate
+static void writeSineFile(const std::string& path, long long frames, double frequency, bool wav) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return;
+    if (wav) {
+        auto put = [file](uint32_t value, int bytes) {
+            for (int i = 0; i < bytes; ++i) std::fputc(static_cast<int>((value >> (8 * i)) & 0xff), file);
+        };
+        const uint32_t dataBytes = static_cast<uint32_t>(frames * sizeof(float));
+        std::fputs("RIFF", file);
+        put(36 + dataBytes, 4);
+        std::fputs("WAVEfmt ", file);
+        put(16, 4);
+        put(3, 2);
+        put(1, 2);
+        put(static_cast<uint32_t>(BenchSampleRate), 4);
+        put(static_cast<uint32_t>(BenchSampleRate) * 4, 4);
+        put(4, 2);
+        put(32, 2);
+        std::fputs("data", file);
+        put(dataBytes, 4);
+    }
+    std::vector<float> block(65536);
+    for (long long done = 0; done < frames;) {
+        int count = static_cast<int>(std::min<long long>(static_cast<long long>(block.size()), frames - done));
+        for (int n = 0; n < count; ++n) {
+            block[n] = static_cast<float>(std::sin(2.0 * M_PI * frequency * (done + n) / BenchSampleRate));
+        }
+        std::fwrite(block.data(), sizeof(float), count, file);
+        done += count;
+    }
+    std::fclose(file);
+}
+
+// Renders a block once the prefetch thread has decoded what it needs, the
+// way a device with a period of slack lets it keep ahead
+static void renderWhenDecoded(SampleOscillator& oscillator, double* buffer, int count) {
+    const SampleFile& file = oscillator.getSample();
+    long long needed = std::min(file.getFrameCount(),
+                                static_cast<long long>(oscillator.getPosition() + oscillator.getSpeed() * count) + 3);
+    for (int wait = 0; wait < 2000 && oscillator.getDecodedFrames() < needed; ++wait) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    oscillator.generateBlock(buffer, count);
+}
+
+static long residentBytes() {
+    long pages = 0, resident = 0;
+    if (std::FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        std::fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+static bool benchSamples() {
+    printHeader("Sample streaming");
+    const std::string path = "/tmp/synth_bench_sample.wav";
+    const double toneHz = 441.0;
+    const long long frames = static_cast<long long>(BenchSampleRate) * 10;
+    bool ok = true;
+    writeSineFile(path, frames, toneHz, true);
+
+    // A small head and ring, so nearly all of it comes through the stream
+    auto file = SampleFile::open(path, 4096);
+    if (!file) {
+        std::cout << "  cannot open the test sample  FAIL" << std::endl;
+        return false;
+    }
+
+    // At the root frequency the output is the file, sample for sample
+    {
+        SampleOscillator oscillator(file, BenchSampleRate, 16384);
+        std::vector<double> output(frames);
+        for (long long done = 0; done < frames; done += BenchBlockSize) {
+            int count = static_cast<int>(std::min<long long>(BenchBlockSize, frames - done));
+            renderWhenDecoded(oscillator, output.data() + done, count);
+        }
+        double worst = 0.0;
+        for (long long n = 0; n < frames; ++n) {
+            worst = std::max(worst, std::fabs(output[n] - static_cast<float>(std::sin(2.0 * M_PI * toneHz * n / BenchSampleRate))));
+        }
+        ok = checkBound("natural speed, |output - file|", worst, 1e-12) && ok;
+        std::cout << "  natural speed, underruns " << oscillator.getUnderruns()
+                  << (oscillator.getUnderruns() == 0 ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && oscillator.getUnderruns() == 0;
+    }
+
+    // Paced like a device, without waiting on the stream: the head covers
+    // the start and the prefetch thread keeps ahead from there
+    {
+        SampleOscillator oscillator(file, BenchSampleRate, 16384);
+        oscillator.setFrequency(oscillator.getRootFrequency() * 2.0);
+        const int periodFrames = 256;
+        const auto period = std::chrono::duration<double>(periodFrames / BenchSampleRate);
+        std::vector<double> block(periodFrames);
+        auto due = std::chrono::steady_clock::now();
+        long violations = RealtimeCheck::getViolationCount();
+        for (int p = 0; p < static_cast<int>(BenchSampleRate) / periodFrames; ++p) {
+            {
+                RealtimeCheck::Scope realtime;  // Counted in RT_CHECK builds
+                oscillator.generateBlock(block.data(), periodFrames);
+            }
+            due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+            std::this_thread::sleep_until(due);
+        }
+        violations = RealtimeCheck::getViolationCount() - violations;
+        std::cout << "  paced 1 s at x2, underruns " << oscillator.getUnderruns() << ", real-time violations "
+                  << violations << (oscillator.getUnderruns() == 0 && violations == 0 ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && oscillator.getUnderruns() == 0 && violations == 0;
+    }
+
+    // Varispeed: a fifth up is the tone at 1.5 times its frequency
+    {
+        SampleOscillator oscillator(file, BenchSampleRate, 16384);
+        oscillator.setFrequency(oscillator.getRootFrequency() * 1.5);
+        const int count = static_cast<int>(BenchSampleRate);
+        std::vector<double> output(count);
+        for (int done = 0; done < count; done += BenchBlockSize) {
+            renderWhenDecoded(oscillator, output.data() + done, std::min(count, done + BenchBlockSize) - done);
+        }
+        double worst = 0.0;
+        for (int n = 2; n < count; ++n) {
+            worst = std::max(worst, std::fabs(output[n] - std::sin(2.0 * M_PI * toneHz * 1.5 * n / BenchSampleRate)));
+        }
+        ok = checkBound("x1.5 speed, |output - sine|", worst, 1e-4) && ok;
+
+        // Restarting replays the head at once, before the stream catches up
+        oscillator.noteOn();
+        double first[BenchBlockSize];
+        oscillator.generateBlock(first, BenchBlockSize);
+        bool restarted = std::fabs(first[10] - output[10]) < 1e-12;
+        std::cout << "  noteOn restarts from the head  " << (restarted ? "ok" : "FAIL") << std::endl;
+        ok = ok && restarted;
+    }
+
+    // As an FM carrier, behind a filter and an envelope: a normal oscillator
+    {
+        auto fm = std::make_unique<FMSynthesizer>(BenchSampleRate);
+        fm->setCarrierOscillator(std::make_unique<SampleOscillator>(file, BenchSampleRate));
+        fm->setModulatorFrequency(110.0);
+        fm->setModulationDepth(0.5);
+        Sound sound(BenchSampleRate);
+        sound.addOscillator(std::move(fm));
+        auto lowpass = std::make_unique<LowPassFilter>(BenchSampleRate);
+        lowpass->setCutoffFrequency(3000.0);
+        sound.addFilter(std::move(lowpass));
+        sound.noteOn();
+        std::vector<double> output = renderSound(sound, 4096);
+        double energy = 0.0;
+        bool finite = true;
+        for (double v : output) {
+            energy += v * v;
+            finite = finite && std::isfinite(v);
+        }
+        double rms = std::sqrt(energy / output.size());
+        bool fmOk = finite && rms > 0.05;
+        std::cout << "  FM carrier + lowpass + envelope, rms " << std::setprecision(3) << rms
+                  << (fmOk ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && fmOk;
+    }
+
+    // Bounded memory: playing a file through leaves little of it resident
+    {
+        const std::string bigPath = "/tmp/synth_bench_sample.raw";
+        const long long bigFrames = 16LL << 20;  // 64 MiB of float
+        writeSineFile(bigPath, bigFrames, toneHz, false);
+        SampleFile::RawFormat raw;
+        raw.sampleRate = BenchSampleRate;
+        auto big = SampleFile::open(bigPath, SampleFile::DefaultHeadFrames, raw);
+        long before = residentBytes();
+        long peak = before;
+        {
+            SampleOscillator oscillator(big, BenchSampleRate);
+            oscillator.setFrequency(oscillator.getRootFrequency() * 8.0);  // Through the file in 2M frames
+            std::vector<double> block(Sound::MaxBlockSize);
+            while (big && oscillator.getPosition() < big->getFrameCount()) {
+                renderWhenDecoded(oscillator, block.data(), Sound::MaxBlockSize);
+                peak = std::max(peak, residentBytes());
+            }
+        }
+        big.reset();
+        std::remove(bigPath.c_str());
+        double growthMiB = (peak - before) / (1024.0 * 1024.0);
+        std::cout << "  64 MiB streamed, resident growth " << std::fixed << std::setprecision(1) << growthMiB << " MiB"
+                  << std::defaultfloat << std::endl;
+        ok = checkBound("resident growth / file size", growthMiB / 64.0, 0.25) && ok;
+    }
+
+    // Per-sample cost; the file is decoded by then, so this is the interpolation
+    for (double speed : {1.0, 1.37}) {
+        SampleOscillator oscillator(file, BenchSampleRate, 1 << 20);
+        oscillator.setFrequency(oscillator.getRootFrequency() * speed);
+        double ns = measureNsPerSample([&](double* buffer, int n) { oscillator.generateBlock(buffer, n); });
+        printResult(speed == 1.0 ? "sample, natural speed" : "sample, x1.37 varispeed", ns);
+    }
+    std::cout << "  prefetch chunks decoded " << SampleStreamer::instance().getChunksDecoded() << std::endl;
+    std::remove(path.c_str());
+    return ok;
+}
+
+
+// -----------------------------------------------------------------------------
+// Granular: onsets are sample-accurate, the grain pool allocates nothing, and
+// a cloud of hundreds of grains stays affordable
+// -----------------------------------------------------------------------------
+static bool benchGranular() {
+    printHeader("Granular");
+    const std::string path = "/tmp/synth_bench_grains.wav";
+    writeSineFile(path, static_cast<long long>(BenchSampleRate) * 4, 441.0, true);
+    auto file = SampleFile::open(path);
+    std::remove(path.c_str());  // Mapped and read in: the name is no longer needed
+    if (!file) {
+        std::cout << "  cannot open the test sample  FAIL" << std::endl;
+        return false;
+    }
+    bool ok = true;
+
+    auto makeCloud = [&](double density, double sizeMs) {
+        auto cloud = std::make_unique<GranularOscillator>(file, BenchSampleRate);
+        cloud->setDensity(density);
+        cloud->setGrainSize(sizeMs);
+        cloud->setSpray(40.0);
+        cloud->setPitch(-5.0);
+        cloud->setSeed(1234);
+        return cloud;
+    };
+
+    // The same cloud rendered in blocks of 1, 64 and 512 samples (and an
+    // odd mix) is the same signal: grains start on their own sample
+    const int count = static_cast<int>(BenchSampleRate);
+    std::vector<double> reference(count);
+    makeCloud(733.0, 37.0)->generateBlock(reference.data(), count);
+    for (int blockSize : {1, 64, 512, 0}) {
+        auto cloud = makeCloud(733.0, 37.0);
+        std::vector<double> output(count);
+        for (int done = 0, k = 0; done < count; ++k) {
+            int size = blockSize ? blockSize : 1 + (k * 97) % 300;
+            size = std::min(size, count - done);
+            if (blockSize == 1) {
+                output[done] = cloud->nextSample();
+            } else {
+                cloud->generateBlock(output.data() + done, size);
+            }
+            done += size;
+        }
+        double worst = 0.0;
+        for (int n = 0; n < count; ++n) worst = std::max(worst, std::fabs(output[n] - reference[n]));
+        std::string name = blockSize ? "blocks of " + std::to_string(blockSize) : std::string("uneven blocks");
+        ok = checkBound(name + ", |output - one block|", worst, 1e-12) && ok;
+    }
+
+    // A dense cloud: hundreds of grains at once, none dropped, no allocation
+    // or other real-time violation while it plays
+    {
+        auto cloud = makeCloud(2000.0, 200.0);
+        std::vector<double> block(BenchBlockSize);
+        long allocations = heapAllocations.load();
+        long violations = RealtimeCheck::getViolationCount();
+        double energy = 0.0;
+        for (int done = 0; done < count; done += BenchBlockSize) {
+            RealtimeCheck::Scope realtime;  // Counted in RT_CHECK builds
+            cloud->generateBlock(block.data(), BenchBlockSize);
+            for (double v : block) energy += v * v;
+        }
+        allocations = heapAllocations.load() - allocations;
+        violations = RealtimeCheck::getViolationCount() - violations;
+        double rms = std::sqrt(energy / count);
+        bool dense = cloud->getPeakGrainCount() >= 380 && cloud->getGrainsDropped() == 0 && rms > 0.05 && rms < 2.0;
+        std::cout << "  2000 grains/s x 200 ms: peak " << cloud->getPeakGrainCount() << " grains, dropped "
+                  << cloud->getGrainsDropped() << ", rms " << std::setprecision(3) << rms
+                  << (dense ? "  ok" : "  FAIL") << std::endl;
+        std::cout << "  heap allocations " << allocations << ", real-time violations " << violations
+                  << (allocations == 0 && violations == 0 ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && dense && allocations == 0 && violations == 0;
+
+        // Past the pool's size, grains are skipped and counted, not allocated
+        cloud->setGrainSize(400.0);
+        for (int done = 0; done < count; done += BenchBlockSize) cloud->generateBlock(block.data(), BenchBlockSize);
+        bool capped = cloud->getPeakGrainCount() == GranularOscillator::MaxGrains && cloud->getGrainsDropped() > 0;
+        std::cout << "  2000 grains/s x 400 ms: peak " << cloud->getPeakGrainCount() << ", dropped "
+                  << cloud->getGrainsDropped() << (capped ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && capped;
+    }
+
+    // Per-sample cost of the whole cloud
+    for (double sizeMs : {50.0, 200.0}) {
+        auto cloud = makeCloud(2000.0, sizeMs);
+        double ns = measureNsPerSample([&](double* buffer, int n) { cloud->generateBlock(buffer, n); });
+        const int grainCount = static_cast<int>(2000.0 * sizeMs / 1000.0);
+        char note[48];
+        std::snprintf(note, sizeof(note), "%.2f ns per grain", ns / grainCount);
+        printResult(std::to_string(grainCount) + " grains", ns, note);
+    }
+    return ok;
+}
+
+
+// -----------------------------------------------------------------------------
+// Convolution: the partitioned filter is the direct convolution, whatever
+// the block size or thread that computes it, at a fraction of its cost
+// -----------------------------------------------------------------------------
+// A decaying noise burst, like a room's response
+static std::vector<double> makeImpulse(int taps, double decaySeconds, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    std::vector<double> impulse(taps);
+    for (int n = 0; n < taps; ++n) impulse[n] = noise(random) * std::exp(-n / (decaySeconds * BenchSampleRate));
+    return impulse;
+}
+
+// Runs filter over input in blocks of blockSize (0: uneven blocks up to 700)
+static std::vector<double> convolveInBlocks(ConvolutionFilter& filter, const std::vector<double>& input, int blockSize) {
+    std::vector<double> output(input);
+    for (int done = 0, k = 0; done < static_cast<int>(output.size()); ++k) {
+        int size = std::min(blockSize ? blockSize : 1 + (k * 211) % 700, static_cast<int>(output.size()) - done);
+        filter.processBuffer(output.data() + done, size);
+        done += size;
+    }
+    return output;
+}
+
+static bool benchConvolution() {
+    printHeader("Convolution");
+    bool ok = true;
+
+    // The transform itself: round trip, and one bin against a plain DFT
+    {
+        RealFFT fft(1024);
+        std::vector<double> signal = makeImpulse(1024, 1.0, 7), back(1024), work(1024);
+        std::vector<double> real(fft.getBinCount()), imag(fft.getBinCount());
+        fft.forward(signal.data(), real.data(), imag.data(), work.data());
+        fft.inverse(real.data(), imag.data(), back.data(), work.data());
+        double worst = 0.0;
+        for (int n = 0; n < 1024; ++n) worst = std::max(worst, std::fabs(back[n] - signal[n]));
+        ok = checkBound("FFT round trip", worst, 1e-12) && ok;
+        worst = 0.0;
+        for (int k : {0, 1, 37, 511, 512}) {
+            double dftReal = 0.0, dftImag = 0.0;
+            for (int n = 0; n < 1024; ++n) {
+                dftReal += signal[n] * std::cos(2.0 * M_PI * k * n / 1024);
+                dftImag -= signal[n] * std::sin(2.0 * M_PI * k * n / 1024);
+            }
+            worst = std::max(worst, std::hypot(real[k] - dftReal, imag[k] - dftImag));
+        }
+        ok = checkBound("FFT against DFT", worst, 1e-9) && ok;
+    }
+
+    // Half a second of response over every segment size, against the direct sum
+    const int taps = static_cast<int>(BenchSampleRate / 2);
+    const std::vector<double> impulse = makeImpulse(taps, 0.15, 11);
+    const std::vector<double> input = makeImpulse(20000, 10.0, 13);
+    std::vector<double> direct(input.size(), 0.0);
+    for (size_t n = 0; n < input.size(); ++n) {
+        const size_t count = std::min<size_t>(n + 1, impulse.size());
+        double sum = 0.0;
+        for (size_t k = 0; k < count; ++k) sum += impulse[k] * input[n - k];
+        direct[n] = sum;
+    }
+    double peak = 0.0;
+    for (double v : direct) peak = std::max(peak, std::fabs(v));
+
+    ConvolutionFilter::Options exact;
+    exact.normalize = false;
+    for (bool uniform : {false, true}) {
+        exact.uniform = uniform;
+        for (int blockSize : {1, 512, 0}) {
+            ConvolutionFilter filter(impulse, BenchSampleRate, exact);
+            filter.setMix(100.0);
+            std::vector<double> output = convolveInBlocks(filter, input, blockSize);
+            double worst = 0.0;
+            for (size_t n = 0; n < output.size(); ++n) worst = std::max(worst, std::fabs(output[n] - direct[n]));
+            std::string name = std::string(uniform ? "uniform" : "non-uniform") + ", " +
+                               (blockSize ? "blocks of " + std::to_string(blockSize) : std::string("uneven blocks"));
+            ok = checkBound(name, worst / peak, 1e-10) && ok;
+            if (!uniform && blockSize == 512) {
+                std::cout << "  layout: " << filter.getSegmentCount() << " segments after 64 direct taps:";
+                for (int s = 0; s < filter.getSegmentCount(); ++s) {
+                    std::cout << " " << filter.getSegmentPartitions(s) << "x" << filter.getSegmentBlockSize(s)
+                              << (filter.isSegmentInBackground(s) ? "(bg)" : "");
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    // Two channels through one filter, as a stereo Sound runs it: each lane
+    // keeps its own history
+    {
+        ConvolutionFilter::Options stereo = exact;
+        stereo.uniform = false;
+        stereo.lanes = 2;
+        ConvolutionFilter shared(impulse, BenchSampleRate, stereo);
+        shared.setMix(100.0);
+        std::vector<double> left(input), right(input.rbegin(), input.rend());
+        double states[2] = {0.0, 0.0};
+        for (int done = 0; done < static_cast<int>(left.size()); done += BenchBlockSize) {
+            int size = std::min(BenchBlockSize, static_cast<int>(left.size()) - done);
+            double* channels[2] = {left.data() + done, right.data() + done};
+            for (int c = 0; c < 2; ++c) {
+                shared.restoreState(&states[c]);
+                shared.processBuffer(channels[c], size);
+                shared.saveState(&states[c]);
+            }
+        }
+        ConvolutionFilter alone(impulse, BenchSampleRate, exact);
+        alone.setMix(100.0);
+        std::vector<double> reversed(input.rbegin(), input.rend());
+        std::vector<double> expected = convolveInBlocks(alone, reversed, BenchBlockSize);
+        double worst = 0.0;
+        for (size_t n = 0; n < left.size(); ++n) {
+            worst = std::max({worst, std::fabs(left[n] - direct[n]), std::fabs(right[n] - expected[n])});
+        }
+        ok = checkBound("two lanes, |channel - own filter|", worst / peak, 1e-10) && ok;
+    }
+
+    // Loaded from a mapped file: the same response, rounded to float
+    {
+        const std::string path = "/tmp/synth_bench_impulse.raw";
+        std::vector<float> samples(impulse.begin(), impulse.end());
+        if (std::FILE* file = std::fopen(path.c_str(), "wb")) {
+            std::fwrite(samples.data(), sizeof(float), samples.size(), file);
+            std::fclose(file);
+        }
+        auto loaded = ConvolutionFilter::load(path, BenchSampleRate, exact);
+        auto resampled = ConvolutionFilter::load(path, 48000.0, exact);
+        std::remove(path.c_str());
+        bool loadOk = loaded && resampled && loaded->getImpulseLength() == taps &&
+                      std::abs(resampled->getImpulseLength() - std::lround(taps * 48000.0 / BenchSampleRate)) <= 1;
+        if (loaded) {
+            loaded->setMix(100.0);
+            std::vector<double> output = convolveInBlocks(*loaded, input, BenchBlockSize);
+            double worst = 0.0;
+            for (size_t n = 0; n < output.size(); ++n) worst = std::max(worst, std::fabs(output[n] - direct[n]));
+            loadOk = loadOk && worst / peak < 1e-6;
+        }
+        std::cout << "  loaded from file, and resampled to 48 kHz  " << (loadOk ? "ok" : "FAIL") << std::endl;
+        ok = ok && loadOk;
+
+        // The device settling on 48 kHz after the fact: the worker rebuilds
+        // the response and the audio thread switches to it between blocks,
+        // without allocating, to what loading at 48 kHz gives
+        if (loaded && resampled) {
+            std::vector<double> silence(BenchBlockSize, 0.0);
+            long violations = RealtimeCheck::getViolationCount();
+            {
+                RealtimeCheck::Scope realtime;
+                loaded->setSampleRate(48000.0);
+            }
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (loaded->getResponseRate() != 48000.0 && std::chrono::steady_clock::now() < deadline) {
+                {
+                    RealtimeCheck::Scope realtime;
+                    loaded->processBuffer(silence.data(), BenchBlockSize);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            violations = RealtimeCheck::getViolationCount() - violations;
+            loaded->reset();
+            resampled->setMix(100.0);
+            std::vector<double> switched = convolveInBlocks(*loaded, input, BenchBlockSize);
+            std::vector<double> reference = convolveInBlocks(*resampled, input, BenchBlockSize);
+            double worst = 0.0;
+            for (size_t n = 0; n < switched.size(); ++n) worst = std::max(worst, std::fabs(switched[n] - reference[n]));
+            bool switchOk = loaded->getResponseRate() == 48000.0 && violations == 0 &&
+                            loaded->getImpulseLength() == resampled->getImpulseLength();
+            std::cout << "  44.1 -> 48 kHz after load: rebuilt on the worker, real-time violations " << violations
+                      << (switchOk ? "  ok" : "  FAIL") << std::endl;
+            ok = ok && switchOk;
+            ok = checkBound("rate switch, |switched - loaded at 48 kHz|", worst / peak, 1e-12) && ok;
+        }
+    }
+
+    // A three-second room paced like a device: the worker keeps up with
+    // the background segments, and the audio thread stays real-time safe
+    const std::vector<double> room = makeImpulse(static_cast<int>(BenchSampleRate) * 3, 0.6, 17);
+    {
+        ConvolutionFilter reverb(room, BenchSampleRate);
+        const int periodFrames = 256;
+        const auto period = std::chrono::duration<double>(periodFrames / BenchSampleRate);
+        std::vector<double> block = makeImpulse(periodFrames, 1.0, 19);
+        auto due = std::chrono::steady_clock::now();
+        long violations = RealtimeCheck::getViolationCount();
+        for (int p = 0; p < 2 * static_cast<int>(BenchSampleRate) / periodFrames; ++p) {
+            {
+                RealtimeCheck::Scope realtime;  // Counted in RT_CHECK builds
+                reverb.processBuffer(block.data(), periodFrames);
+            }
+            due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+            std::this_thread::sleep_until(due);
+        }
+        violations = RealtimeCheck::getViolationCount() - violations;
+        ConvolutionFilter::Cost cost = reverb.getCost();
+        std::cout << "  3 s room paced 2 s: audio thread " << std::fixed << std::setprecision(2)
+                  << 100.0 * cost.audioThread << " % RT, worker " << 100.0 * cost.background
+                  << " % RT, late blocks " << cost.lateBlocks << ", real-time violations " << violations
+                  << (violations == 0 ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && violations == 0;
+        double backgroundBlocks = 0.0;
+        for (int s = 0; s < reverb.getSegmentCount(); ++s) {
+            if (reverb.isSegmentInBackground(s)) backgroundBlocks += 2.0 * BenchSampleRate / reverb.getSegmentBlockSize(s);
+        }
+        ok = checkBound("late blocks / background blocks", cost.lateBlocks / backgroundBlocks, 0.1) && ok;
+    }
+
+    // Whole cost of the same room, every block computed in the caller, as
+    // partitioned and as uniform 64-sample partitions; the direct FIR is
+    // timed on 4096 taps and scaled to the room's length
+    ConvolutionFilter::Options uniform;
+    uniform.uniform = true;
+    ConvolutionFilter partitioned(room, BenchSampleRate), flat(room, BenchSampleRate, uniform);
+    double partitionedNs = measureNsPerSample([&](double* buffer, int n) { partitioned.processBuffer(buffer, n); });
+    double flatNs = measureNsPerSample([&](double* buffer, int n) { flat.processBuffer(buffer, n); });
+    std::vector<double> history(4096 + BenchBlockSize, 0.5);
+    double directNs = measureNsPerSample([&](double* buffer, int n) {
+        fft::directConvolve(room.data(), 4096, history.data() + 4095, buffer, n);
+    }) * room.size() / 4096.0;
+    printResult("3 s room, non-uniform", partitionedNs, ratioNote(directNs / partitionedNs, "faster than direct"));
+    printResult("3 s room, uniform 64", flatNs, ratioNote(directNs / flatNs, "faster than direct"));
+    printResult("3 s room, direct (scaled)", directNs);
+    ok = checkBound("non-uniform / uniform cost", partitionedNs / flatNs, 0.5) && ok;
+    return ok;
+}
+
+
+// -----------------------------------------------------------------------------
+// Effects: the FDN reverb decays at its set time and does not depend on the
+// block size, the tempo delay lands on the beat, the send bus returns the
+// reverb to the mix, and all of it costs a fraction of convolution
+// -----------------------------------------------------------------------------
+// RT60 from the Schroeder backward-integrated energy, fitted from -5 to -25 dB
+static double measureDecayTime(const std::vector<double>& response) {
+    std::vector<double> energy(response.size());
+    double sum = 0.0;
+    for (size_t n = response.size(); n-- > 0;) {
+        sum += response[n] * response[n];
+        energy[n] = sum;
+    }
+    size_t from = 0, to = 0;
+    for (size_t n = 0; n < energy.size(); ++n) {
+        double decibels = 10.0 * std::log10(energy[n] / energy[0]);
+        if (!from && decibels <= -5.0) from = n;
+        if (decibels <= -25.0) {
+            to = n;
+            break;
+        }
+    }
+    return to > from ? 3.0 * (to - from) / BenchSampleRate : 0.0;
+}
+
+static bool benchEffects() {
+    printHeader("Effects");
+    bool ok = true;
+
+    // Decay time at 8 and 16 lines, with damping and modulation off (the
+    // interpolated taps lowpass the loop too) so every band decays alike
+    for (int lines : {8, 16}) {
+        FDNReverb reverb(BenchSampleRate, lines);
+        reverb.setMix(100.0);
+        reverb.setDecay(1.5);
+        reverb.setDamping(20000.0);
+        reverb.setModulation(0.0, 0.0);
+        std::vector<double> response(static_cast<size_t>(BenchSampleRate) * 3, 0.0);
+        response[0] = 1.0;
+        for (size_t done = 0; done < response.size(); done += BenchBlockSize) {
+            reverb.processBuffer(response.data() + done, static_cast<int>(std::min<size_t>(BenchBlockSize, response.size() - done)));
+        }
+        double measured = measureDecayTime(response);
+        ok = checkBound(std::to_string(lines) + " lines, |RT60 / 1.5 s - 1|", std::fabs(measured / 1.5 - 1.0), 0.05) && ok;
+    }
+
+    // The longest decay stays bounded, and the block size does not matter
+    {
+        const std::vector<double> noise = makeImpulse(static_cast<int>(BenchSampleRate), 100.0, 23);
+        std::vector<double> reference;
+        for (int blockSize : {512, 1, 0}) {
+            FDNReverb reverb(BenchSampleRate, 16);
+            reverb.setMix(100.0);
+            reverb.setDecay(20.0);
+            reverb.setSize(2.0);
+            reverb.setModulation(2.0, 1.5);
+            std::vector<double> output(noise);
+            for (int done = 0, k = 0; done < static_cast<int>(output.size()); ++k) {
+                int size = std::min(blockSize ? blockSize : 1 + (k * 131) % 400, static_cast<int>(output.size()) - done);
+                reverb.processBuffer(output.data() + done, size);
+                done += size;
+            }
+            if (reference.empty()) {
+                double peak = 0.0;
+                for (double v : output) peak = std::max(peak, std::fabs(v));
+                ok = checkBound("20 s decay, peak after 1 s of noise", peak, 8.0) && ok;
+                reference = output;
+                continue;
+            }
+            double worst = 0.0;
+            for (size_t n = 0; n < output.size(); ++n) worst = std::max(worst, std::fabs(output[n] - reference[n]));
+            ok = checkBound(blockSize ? "blocks of 1, |output - blocks of 512|" : "uneven blocks, |output - 512|",
+                            worst, 1e-6) && ok;
+        }
+    }
+
+    // In a stereo Sound each channel has its own lines: a layer panned hard
+    // left leaves the right channel's reverb silent
+    {
+        auto sound = makePannedSound(2, false, -1.0, 0.0);
+        auto reverb = std::make_unique<FDNReverb>(BenchSampleRate, 8, 2);
+        reverb->setMix(100.0);
+        sound->addFilter(std::move(reverb));
+        sound->noteOn();
+        std::vector<double> left(BenchBlockSize), right(BenchBlockSize);
+        double* planar[2] = {left.data(), right.data()};
+        double leftEnergy = 0.0, rightPeak = 0.0;
+        for (int block = 0; block < 40; ++block) {
+            sound->generateChannels(planar, BenchBlockSize);
+            for (int n = 0; n < BenchBlockSize; ++n) {
+                leftEnergy += left[n] * left[n];
+                rightPeak = std::max(rightPeak, std::fabs(right[n]));
+            }
+        }
+        bool lanesOk = leftEnergy > 1.0 && rightPeak < 1e-9;
+        std::cout << "  stereo Sound, hard-left layer: right channel peak " << std::scientific << std::setprecision(2)
+                  << rightPeak << std::fixed << (lanesOk ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && lanesOk;
+    }
+
+    // Tempo delay: the first echo of a click lands exactly one division later
+    {
+        TempoDelay delay(BenchSampleRate);
+        delay.setMix(100.0);
+        delay.setTempo(120.0);
+        delay.setDivision(TempoDelay::Division::DottedEighth);
+        const int expected = static_cast<int>(std::lround(0.375 * BenchSampleRate));
+        std::vector<double> output(expected + 4096, 0.0);
+        output[0] = 1.0;
+        for (size_t done = 0; done < output.size(); done += BenchBlockSize) {
+            delay.processBuffer(output.data() + done, static_cast<int>(std::min<size_t>(BenchBlockSize, output.size() - done)));
+        }
+        size_t echo = std::max_element(output.begin(), output.end(),
+                                       [](double a, double b) { return std::fabs(a) < std::fabs(b); }) - output.begin();
+        delay.setTempo(100.0);
+        bool onBeat = static_cast<int>(echo) == expected && std::fabs(output[echo] - 1.0) < 1e-6 &&
+                      delay.getDelaySamples() == static_cast<int>(std::lround(0.45 * BenchSampleRate));
+        std::cout << "  dotted 1/8 at 120 BPM: echo at " << echo << " (expected " << expected << "), at 100 BPM "
+                  << delay.getDelaySamples() << " samples" << (onBeat ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && onBeat;
+    }
+
+    // The send bus: silent sends leave the mix untouched, a send adds the
+    // reverb, and its tail outlasts the part
+    {
+        const int frames = 8192;
+        auto drySound = makePannedSound(1, false, 0.0, 0.0);
+        auto wetSound = makePannedSound(1, false, 0.0, 0.0);
+        SoundExchange dryExchange, wetExchange;
+        dryExchange.publish(drySound.get());
+        wetExchange.publish(wetSound.get());
+        FDNReverb sendReverb(BenchSampleRate, 16);
+        sendReverb.setMix(100.0);
+        auto renderFrames = [&](SoundRenderer& target, int count) {
+            std::vector<float> output(static_cast<size_t>(count) * 2);
+            for (int offset = 0; offset < count; offset += BenchBlockSize) {
+                target.render(output.data() + offset * 2, BenchBlockSize, 2);
+            }
+            return output;
+        };
+        SoundRenderer dry(&dryExchange), wet(&wetExchange);
+        dry.setPartVolume(0, 0.5);
+        wet.setPartVolume(0, 0.5);
+        wet.setSendEffect(&sendReverb);
+        drySound->noteOn();
+        wetSound->noteOn();
+        std::vector<float> plain = renderFrames(dry, frames);
+        std::vector<float> unsent = renderFrames(wet, frames);
+        bool silentOk = plain == unsent;
+
+        wet.setPartSend(0, 0.5);
+        plain = renderFrames(dry, frames);
+        std::vector<float> sent = renderFrames(wet, frames);
+        wet.setPartBypassed(0, true);
+        std::vector<float> tail = renderFrames(wet, frames);
+        double difference = 0.0, tailEnergy = 0.0;
+        for (size_t n = 0; n < sent.size(); ++n) difference += std::fabs(sent[n] - plain[n]);
+        for (float v : tail) tailEnergy += v * v;
+        bool sendOk = silentOk && difference > 1.0 && tailEnergy > 1e-3;
+        std::cout << "  send bus: no send bit-exact " << (silentOk ? "yes" : "no") << ", tail energy after bypass "
+                  << std::setprecision(3) << tailEnergy << (sendOk ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && sendOk;
+    }
+
+    // Real-time safety of both, inside a render scope
+    {
+        FDNReverb reverb(BenchSampleRate, 16);
+        TempoDelay delay(BenchSampleRate);
+        std::vector<double> block = makeImpulse(BenchBlockSize, 1.0, 29);
+        long violations = RealtimeCheck::getViolationCount();
+        {
+            RealtimeCheck::Scope realtime;  // Counted in RT_CHECK builds
+            for (int i = 0; i < 100; ++i) {
+                reverb.processBuffer(block.data(), BenchBlockSize);
+                delay.processBuffer(block.data(), BenchBlockSize);
+                reverb.setDecay(1.0 + (i % 5));
+                delay.setTempo(90.0 + i);
+            }
+        }
+        violations = RealtimeCheck::getViolationCount() - violations;
+        std::cout << "  real-time violations " << violations << (violations == 0 ? "  ok" : "  FAIL") << std::endl;
+        ok = ok && violations == 0;
+    }
+
+    // Cost, against the partitioned convolution of a 3 s room
+    ConvolutionFilter room(makeImpulse(static_cast<int>(BenchSampleRate) * 3, 0.6, 17), BenchSampleRate);
+    double convolutionNs = measureNsPerSample([&](double* buffer, int n) { room.processBuffer(buffer, n); });
+    printResult("convolution, 3 s room", convolutionNs);
+    for (int lines : {8, 16}) {
+        FDNReverb reverb(BenchSampleRate, lines);
+        double ns = measureNsPerSample([&](double* buffer, int n) { reverb.processBuffer(buffer, n); });
+        printResult("FDN reverb, " + std::to_string(lines) + " lines", ns, ratioNote(ns / convolutionNs, "vs convolution"));
+        if (lines == 8) ok = checkBound("8-line FDN / convolution cost", ns / convolutionNs, 0.4) && ok;
+    }
+    TempoDelay delay(BenchSampleRate);
+    double delayNs = measureNsPerSample([&](double* buffer, int n) { delay.processBuffer(buffer, n); });
+    printResult("tempo delay", delayNs, ratioNote(delayNs / convolutionNs, "vs convolution"));
+    return ok;
+}
+
+
+// -----------------------------------------------------------------------------
+// Section table
+// -----------------------------------------------------------------------------
+struct BenchSection {
+    const char* name;
+    bool (*run)();  // Returns false when a checked bound is violated
+};
+
+static const BenchSection sections[] = {
+    {"presets", benchPresets},
+    {"oversampling", benchOversampling},
+    {"fastmath", benchFastMath},
+    {"voicelanes", benchVoiceLanes},
+    {"parallel", benchParallel},
+    {"parameters", benchParameters},
+    {"patches", benchPatches},
+    {"presetcache", benchPresetCache},
+    {"arena", benchArena},
+    {"rtcheck", benchRealtimeCheck},
+    {"realtime", benchRealtimeSetup},
+    {"backends", benchBackends},
+    {"recording", benchRecording},
+    {"conversion", benchConversion},
+    {"rates", benchSampleRates},
+    {"stereo", benchStereo},
+    {"parts", benchParts},
+    {"samples", benchSamples},
+    {"granular", benchGranular},
+    {"convolution", benchConvolution},
+    {"effects", benchEffects},
+    {"virtual", benchVirtualDevice},
+    {"soak", benchSoak},
+    {"golden", benchGolden},
+    {"budgets", benchBudgets},
+};
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--update") {
+            updateReferences = true;
+        } else if (argument.rfind("--budget-tolerance=", 0) == 0) {
+            budgetTolerance = std::atof(argument.c_str() + std::strlen("--budget-tolerance=")) / 100.0;
+        } else {
+            selected.push_back(argument);
+        }
+    }
+
+    // Keep preset-loading chatter out of the report
+    Logger::instance().setLevel(LogLevel::Warning);
+
+    bool passed = true;
+    for (const auto& section : sections) {
+        if (selected.empty() || std::find(selected.begin(), selected.end(), section.name) != selected.end()) {
+            passed = section.run() && passed;
+        }
+    }
+    return passed ? 0 : 1;
+}
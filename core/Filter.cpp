@@ -20,28 +20,25 @@ double Filter::getSampleRate() const {
 
 void Filter::addParameterWithPrefix(LiveController& controller, const std::string& prefix,
                                    const std::string& name, double* valuePtr, double minVal, 
-                                   double maxVal, double step, std::function<void()> callback) {
-    // Create full parameter name with prefix
-    std::string fullName = prefix + " " + name;
-    controller.addParameter(fullName, valuePtr, minVal, maxVal, step);
+                                   double maxVal, double step, std::function<void()> callback,
+                                   const ParameterInfo& info) {
+    // The prefix becomes the parameter's group; its full name is "prefix name"
+    ParameterId id = controller.addParameterInGroup(prefix, name, valuePtr, minVal, maxVal, step, info);
     
     // Connect the callback to the parameter
-    int paramIndex = controller.getParameterCount() - 1;
-    if (callback && paramIndex >= 0) {
-        controller.setParameterCallback(paramIndex, callback);
+    if (callback) {
+        controller.setParameterCallback(id, callback);
     }
 }
 
 void Filter::addParameter(LiveController& controller, const std::string& name, 
                          double* valuePtr, double minVal, double maxVal, double step,
-                         std::function<void()> callback) {
+                         std::function<void()> callback, const ParameterInfo& info) {
     // Create parameter name with filter type prefix
-    std::string fullName = getTypeName() + " " + name;
-    controller.addParameter(fullName, valuePtr, minVal, maxVal, step);
+    ParameterId id = controller.addParameterInGroup(getTypeName(), name, valuePtr, minVal, maxVal, step, info);
     
     // Connect the callback to the parameter
-    int paramIndex = controller.getParameterCount() - 1;
-    if (callback && paramIndex >= 0) {
-        controller.setParameterCallback(paramIndex, callback);
+    if (callback) {
+        controller.setParameterCallback(id, callback);
     }
 }
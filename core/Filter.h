@@ -3,6 +3,9 @@
 
 #include <string>
 #include <functional>
+#include <new>
+#include "PatchArena.h"
+#include "../interface/ParameterInfo.h"
 
 // Forward declaration
 class LiveController;
@@ -12,6 +15,14 @@ public:
     Filter(double sampleRate = 44100.0);
     virtual ~Filter() = default;
 
+    // Placed in the active PatchArena, if any; see PatchArena::Scope
+    static void* operator new(std::size_t size) { return PatchArena::allocateObject(size, alignof(std::max_align_t)); }
+    static void* operator new(std::size_t size, std::align_val_t alignment) {
+        return PatchArena::allocateObject(size, static_cast<std::size_t>(alignment));
+    }
+    static void operator delete(void* object) { PatchArena::releaseObject(object); }
+    static void operator delete(void* object, std::align_val_t) { PatchArena::releaseObject(object); }
+
     // Core filter functionality - process input signal instead of generating
     virtual double processSample(double input) = 0;
     
@@ -19,11 +30,19 @@ public:
     virtual void processBuffer(double* buffer, int numSamples);
     
     // Sample rate management
-    void setSampleRate(double rate);
+    virtual void setSampleRate(double rate);  // Overridden where coefficients depend on the rate
     double getSampleRate() const;
     
     // Filter state management
     virtual void reset() = 0;
+
+    // Signal history (delay lines, not settings), so one filter can run
+    // several channels in turn: a multichannel Sound saves each channel's
+    // state after its block and restores it before the next. The size is
+    // fixed for the filter's lifetime; 0 means the filter keeps no history.
+    virtual int getStateSize() const { return 0; }
+    virtual void saveState(double* /* state */) const {}
+    virtual void restoreState(const double* /* state */) {}
     
     // Automatic parameter registration
     virtual void registerParameters(LiveController& controller) = 0;
@@ -49,12 +68,13 @@ protected:
     // Helper to register a parameter with the controller
     void addParameter(LiveController& controller, const std::string& name, 
                      double* valuePtr, double minVal, double maxVal, double step,
-                     std::function<void()> callback = nullptr);
+                     std::function<void()> callback = nullptr, const ParameterInfo& info = {});
     
     // Helper to register a parameter with custom prefix
     void addParameterWithPrefix(LiveController& controller, const std::string& prefix,
                                const std::string& name, double* valuePtr, double minVal, 
-                               double maxVal, double step, std::function<void()> callback = nullptr);
+                               double maxVal, double step, std::function<void()> callback = nullptr,
+                               const ParameterInfo& info = {});
 
 private:
     bool isUsedAsComponent = false;  // Flag to prevent duplicate parameter registration
@@ -0,0 +1,96 @@
+#include "Logger.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+constexpr auto IdleInterval = std::chrono::milliseconds(5);
+}
+
+Logger& Logger::instance() {
+    // Constructed by the first log call - main() logs before audio starts,
+    // so the writer thread is never spawned from the audio thread
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : ring(new Slot[Capacity]) {
+    for (int i = 0; i < Capacity; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    stopping.store(true);
+    if (writer.joinable()) writer.join();
+}
+
+void Logger::log(LogLevel level, const char* format, ...) {
+    // Claim a slot (bounded MPMC queue, one sequence number per slot)
+    size_t position = writePosition.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &ring[position & (Capacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);  // Full - never block the caller
+            return;
+        } else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->text, MaxMessageLength, format, args);
+    va_end(args);
+    slot->level = level;
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool Logger::drain() {
+    bool wroteAny = false;
+    for (;;) {
+        Slot& slot = ring[readPosition & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) break;
+
+        FILE* stream = (slot.level >= LogLevel::Warning) ? stderr : stdout;
+        std::fputs(slot.text, stream);
+        std::fputc('\n', stream);
+
+        slot.sequence.store(readPosition + Capacity, std::memory_order_release);
+        ++readPosition;
+        wroteAny = true;
+    }
+    if (wroteAny) {
+        std::fflush(stdout);
+        writtenPosition.store(readPosition, std::memory_order_release);
+    }
+    return wroteAny;
+}
+
+void Logger::writerLoop() {
+    uint64_t reportedDrops = 0;
+    while (!stopping.load()) {
+        if (!drain()) std::this_thread::sleep_for(IdleInterval);
+
+        uint64_t drops = dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            std::fprintf(stderr, "⚠️ Logger dropped %llu messages\n",
+                         static_cast<unsigned long long>(drops - reportedDrops));
+            reportedDrops = drops;
+        }
+    }
+    drain();
+}
+
+void Logger::flush() {
+    size_t target = writePosition.load(std::memory_order_acquire);
+    while (writtenPosition.load(std::memory_order_acquire) < target && !stopping.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
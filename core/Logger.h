@@ -0,0 +1,94 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Asynchronous logger.
+//
+// log() formats into a fixed-size slot of a lock-free ring buffer and returns;
+// a background thread writes the slots to stdout/stderr. No locks, no heap
+// and no I/O on the calling thread, so it is safe from the audio thread and
+// never stalls the GUI. When the buffer is full messages are dropped and
+// counted instead of blocking.
+//
+// Use the LOG_* macros: their arguments are not evaluated when the level is
+// disabled, and LOG_DEBUG compiles to nothing unless SYNTH_LOG_LEVEL is 0
+// (e.g. `make CXXFLAGS+=-DSYNTH_LOG_LEVEL=0`).
+enum class LogLevel { Debug = 0, Info = 1, Warning = 2, Error = 3 };
+
+#ifndef SYNTH_LOG_LEVEL
+#define SYNTH_LOG_LEVEL 1
+#endif
+
+#if defined(__GNUC__)
+#define SYNTH_PRINTF_FORMAT(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define SYNTH_PRINTF_FORMAT(fmt, args)
+#endif
+
+class Logger {
+public:
+    static constexpr int Capacity = 1024;       // Messages in flight, power of two
+    static constexpr int MaxMessageLength = 240;
+
+    static Logger& instance();
+
+    // printf-style; longer messages are truncated
+    void log(LogLevel level, const char* format, ...) SYNTH_PRINTF_FORMAT(3, 4);
+
+    // Runtime threshold on top of the compile-time one
+    void setLevel(LogLevel level) { minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    // Blocks until everything logged so far is written (not for the audio thread)
+    void flush();
+
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogLevel level = LogLevel::Info;
+        char text[MaxMessageLength];
+    };
+
+    std::unique_ptr<Slot[]> ring;  // Not "slots": Qt defines that as a macro
+    alignas(64) std::atomic<size_t> writePosition{0};   // Shared by all producers
+    alignas(64) size_t readPosition = 0;                // Writer thread only
+    std::atomic<size_t> writtenPosition{0};             // Published by the writer thread for flush()
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<int> minimumLevel{SYNTH_LOG_LEVEL};
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+
+    void writerLoop();
+    bool drain();
+};
+
+#define SYNTH_LOG(level, ...)                                   \
+    do {                                                        \
+        if (Logger::instance().isEnabled(level))                \
+            Logger::instance().log(level, __VA_ARGS__);         \
+    } while (0)
+
+#if SYNTH_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) SYNTH_LOG(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+#define LOG_INFO(...) SYNTH_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) SYNTH_LOG(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) SYNTH_LOG(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -1,5 +1,7 @@
 #include "Oscillator.h"
+#include "RenderGraph.h"
 #include "../interface/LiveController.h"
+#include <algorithm>
 
 Oscillator::Oscillator(double sampleRate)
     : frequency(440.0), amplitude(0.5), sampleRate(sampleRate), phase(0.0) {}
@@ -16,6 +18,27 @@ void Oscillator::setSampleRate(double rate) {
     sampleRate = rate;
 }
 
+void Oscillator::generateBlock(double* buffer, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        buffer[i] = nextSample();
+    }
+}
+
+int Oscillator::buildRenderGraph(RenderGraph& graph, double* output) {
+    return graph.addNode([this, output](int numSamples) {
+        generateBlock(output, numSamples);
+    });
+}
+
+int Oscillator::buildStereoRenderGraph(RenderGraph& graph, double* left, double* right) {
+    int monoNode = buildRenderGraph(graph, left);
+    int copyNode = graph.addNode([left, right](int numSamples) {
+        std::copy(left, left + numSamples, right);
+    });
+    graph.addDependency(copyNode, monoNode);
+    return copyNode;
+}
+
 double Oscillator::getFrequency() const {
     return frequency;
 }
@@ -30,28 +53,25 @@ double Oscillator::getSampleRate() const {
 
 void Oscillator::addParameterWithPrefix(LiveController& controller, const std::string& prefix,
                                        const std::string& name, double* valuePtr, double minVal, 
-                                       double maxVal, double step, std::function<void()> callback) {
-    // Create full parameter name with prefix
-    std::string fullName = prefix + " " + name;
-    controller.addParameter(fullName, valuePtr, minVal, maxVal, step);
+                                       double maxVal, double step, std::function<void()> callback,
+                                       const ParameterInfo& info) {
+    // The prefix becomes the parameter's group; its full name is "prefix name"
+    ParameterId id = controller.addParameterInGroup(prefix, name, valuePtr, minVal, maxVal, step, info);
     
     // Connect the callback to the parameter
-    int paramIndex = controller.getParameterCount() - 1;
-    if (callback && paramIndex >= 0) {
-        controller.setParameterCallback(paramIndex, callback);
+    if (callback) {
+        controller.setParameterCallback(id, callback);
     }
 }
 
 void Oscillator::addParameter(LiveController& controller, const std::string& name, 
                              double* valuePtr, double minVal, double maxVal, double step,
-                             std::function<void()> callback) {
+                             std::function<void()> callback, const ParameterInfo& info) {
     // Create parameter name with oscillator type prefix
-    std::string fullName = getTypeName() + " " + name;
-    controller.addParameter(fullName, valuePtr, minVal, maxVal, step);
+    ParameterId id = controller.addParameterInGroup(getTypeName(), name, valuePtr, minVal, maxVal, step, info);
     
     // Connect the callback to the parameter
-    int paramIndex = controller.getParameterCount() - 1;
-    if (callback && paramIndex >= 0) {
-        controller.setParameterCallback(paramIndex, callback);
+    if (callback) {
+        controller.setParameterCallback(id, callback);
     }
 }
\ No newline at end of file
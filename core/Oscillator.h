@@ -5,9 +5,13 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <new>
+#include "PatchArena.h"
+#include "../interface/ParameterInfo.h"
 
 // Forward declaration
 class LiveController;
+class RenderGraph;
 
 // Parameter info for automatic registration
 struct OscillatorParameter {
@@ -24,9 +28,17 @@ public:
     Oscillator(double sampleRate = 44100.0);
     virtual ~Oscillator() = default;
 
+    // Placed in the active PatchArena, if any; see PatchArena::Scope
+    static void* operator new(std::size_t size) { return PatchArena::allocateObject(size, alignof(std::max_align_t)); }
+    static void* operator new(std::size_t size, std::align_val_t alignment) {
+        return PatchArena::allocateObject(size, static_cast<std::size_t>(alignment));
+    }
+    static void operator delete(void* object) { PatchArena::releaseObject(object); }
+    static void operator delete(void* object, std::align_val_t) { PatchArena::releaseObject(object); }
+
     virtual void setFrequency(double freq);  // Made virtual
     void setAmplitude(double amp);
-    void setSampleRate(double rate);
+    virtual void setSampleRate(double rate);  // Containers forward this to their children
 
     double getFrequency() const;
     double getAmplitude() const;
@@ -34,6 +46,22 @@ public:
 
     // Generate one sample — implemented differently by each oscillator type
     virtual double nextSample() = 0;
+
+    // Generate a block of samples; the default just calls nextSample()
+    virtual void generateBlock(double* buffer, int numSamples);
+
+    // Add the nodes that render this oscillator into output and return the
+    // node that completes it. The default is a single generateBlock() node;
+    // containers expose their independent children as separate nodes.
+    virtual int buildRenderGraph(RenderGraph& graph, double* output);
+
+    // Stereo image. Oscillators that place voices or partials in the stereo
+    // field return true; a multichannel Sound then builds them with
+    // buildStereoRenderGraph() and pans the pair as one layer. In a mono
+    // Sound they keep rendering through buildRenderGraph(). The default
+    // renders mono and copies it to both sides.
+    virtual bool isStereo() const { return false; }
+    virtual int buildStereoRenderGraph(RenderGraph& graph, double* left, double* right);
     
     // Automatic parameter registration
     virtual void registerParameters(LiveController& controller) = 0;
@@ -53,6 +81,10 @@ public:
     // Get oscillator type name for display
     virtual std::string getTypeName() const = 0;
 
+    // Gate events, for oscillators that own per-voice envelopes. Containers forward them.
+    virtual void noteOn() {}
+    virtual void noteOff() {}
+
 protected:
     double frequency;
     double amplitude;
@@ -62,12 +94,13 @@ protected:
     // Helper to register a parameter with the controller
     void addParameter(LiveController& controller, const std::string& name, 
                      double* valuePtr, double minVal, double maxVal, double step,
-                     std::function<void()> callback = nullptr);
+                     std::function<void()> callback = nullptr, const ParameterInfo& info = {});
     
     // Helper to register a parameter with custom prefix
     void addParameterWithPrefix(LiveController& controller, const std::string& prefix,
                                const std::string& name, double* valuePtr, double minVal, 
-                               double maxVal, double step, std::function<void()> callback = nullptr);
+                               double maxVal, double step, std::function<void()> callback = nullptr,
+                               const ParameterInfo& info = {});
 
 private:
     bool isUsedAsComponent = false;  // Flag to prevent duplicate parameter registration
@@ -0,0 +1,198 @@
+#include "Oversampler.h"
+#include <cmath>
+#include <algorithm>
+
+// -----------------------------------------------------------------------------
+// HalfBandStage
+// -----------------------------------------------------------------------------
+HalfBandStage::HalfBandStage(int halfLength)
+    : halfLength(std::max(2, halfLength)), position(0), centrePosition(0) {
+    coeffs.resize(this->halfLength);
+    history.resize(4 * this->halfLength, 0.0);
+    centreDelay.resize(this->halfLength - 1, 0.0);
+    designCoefficients();
+}
+
+void HalfBandStage::designCoefficients() {
+    // Blackman-windowed sinc with cutoff at a quarter of the higher rate.
+    // Only the odd offsets from the centre are non-zero.
+    double windowSpan = 2.0 * halfLength;
+    double sum = 0.0;
+    for (int k = 0; k < halfLength; ++k) {
+        double offset = 2.0 * k + 1.0;
+        double x = M_PI * offset / 2.0;
+        double sinc = sin(x) / x;
+        double window = 0.42 + 0.5 * cos(M_PI * offset / windowSpan)
+                      + 0.08 * cos(2.0 * M_PI * offset / windowSpan);
+        coeffs[k] = sinc * window;
+        sum += coeffs[k];
+    }
+
+    // Normalize for unity DC gain: the side taps of each branch sum to 0.5 per side
+    for (double& c : coeffs) {
+        c *= 0.5 / sum;
+    }
+}
+
+void HalfBandStage::push(double input) {
+    int length = 2 * halfLength;
+    position = (position + 1) % length;
+    history[position] = input;
+    history[position + length] = input;
+}
+
+double HalfBandStage::foldedSum() const {
+    // window[j] is the j-th oldest of the last 2 * halfLength inputs
+    const double* window = &history[position + 1];
+    const double* upper = window + halfLength;
+    const double* lower = window + halfLength - 1;
+
+    double sum = 0.0;
+    for (int i = 0; i < halfLength; ++i) {
+        sum += coeffs[i] * (upper[i] + lower[-i]);
+    }
+    return sum;
+}
+
+void HalfBandStage::upsample(double input, double* output) {
+    push(input);
+    output[0] = foldedSum();                        // Interpolated phase
+    output[1] = history[position + 1 + halfLength]; // Centre tap: delayed input
+}
+
+double HalfBandStage::downsample(const double* input) {
+    // Centre-tap branch sees the even samples, side-tap branch the odd ones
+    double delayed = centreDelay[centrePosition];
+    centreDelay[centrePosition] = input[0];
+    centrePosition = (centrePosition + 1) % static_cast<int>(centreDelay.size());
+
+    // Decimation uses half the interpolation gain on both branches
+    push(input[1]);
+    return 0.5 * (delayed + foldedSum());
+}
+
+void HalfBandStage::reset() {
+    std::fill(history.begin(), history.end(), 0.0);
+    std::fill(centreDelay.begin(), centreDelay.end(), 0.0);
+    position = 0;
+    centrePosition = 0;
+}
+
+void HalfBandStage::saveState(double* state) const {
+    // The doubled ring is rebuilt from its first half
+    const int length = 2 * halfLength;
+    std::copy(history.begin(), history.begin() + length, state);
+    std::copy(centreDelay.begin(), centreDelay.end(), state + length);
+    state[length + centreDelay.size()] = position;
+    state[length + centreDelay.size() + 1] = centrePosition;
+}
+
+void HalfBandStage::restoreState(const double* state) {
+    const int length = 2 * halfLength;
+    std::copy(state, state + length, history.begin());
+    std::copy(state, state + length, history.begin() + length);
+    std::copy(state + length, state + length + centreDelay.size(), centreDelay.begin());
+    position = static_cast<int>(state[length + centreDelay.size()]) % length;
+    centrePosition = static_cast<int>(state[length + centreDelay.size() + 1]) % static_cast<int>(centreDelay.size());
+}
+
+// -----------------------------------------------------------------------------
+// Oversampler
+// -----------------------------------------------------------------------------
+namespace {
+
+// Snap to the nearest supported power of two
+int snapFactor(int factor) {
+    if (factor >= 6) return 8;
+    if (factor >= 3) return 4;
+    if (factor >= 2) return 2;
+    return 1;
+}
+
+int stagesFor(int factor) {
+    return (factor == 8) ? 3 : (factor == 4) ? 2 : (factor == 2) ? 1 : 0;
+}
+
+} // namespace
+
+Oversampler::Oversampler(int initialFactor)
+    : factor(snapFactor(initialFactor)), pendingFactor(snapFactor(initialFactor)) {
+    numStages = stagesFor(factor.load(std::memory_order_relaxed));
+
+    // The stage next to the base rate does the real anti-aliasing work;
+    // later stages have a much wider transition band and need fewer taps.
+    for (int s = 0; s < MaxStages; ++s) {
+        int halfLength = (s == 0) ? 8 : 4;
+        upStages.emplace_back(halfLength);
+        downStages.emplace_back(halfLength);
+    }
+}
+
+void Oversampler::setFactor(int newFactor) {
+    pendingFactor.store(snapFactor(newFactor), std::memory_order_relaxed);
+}
+
+bool Oversampler::applyPendingFactor() {
+    const int requested = pendingFactor.load(std::memory_order_relaxed);
+    if (requested == factor.load(std::memory_order_relaxed)) return false;
+    factor.store(requested, std::memory_order_relaxed);
+    numStages = stagesFor(requested);
+    reset();
+    return true;
+}
+
+void Oversampler::upsample(double input, double* output) {
+    output[0] = input;
+    int count = 1;
+    for (int s = 0; s < numStages; ++s) {
+        std::copy(output, output + count, scratch);
+        for (int j = 0; j < count; ++j) {
+            upStages[s].upsample(scratch[j], output + 2 * j);
+        }
+        count *= 2;
+    }
+}
+
+double Oversampler::downsample(double* input) {
+    int count = factor.load(std::memory_order_relaxed);
+    for (int s = numStages - 1; s >= 0; --s) {
+        count /= 2;
+        for (int j = 0; j < count; ++j) {
+            input[j] = downStages[s].downsample(input + 2 * j);
+        }
+    }
+    return input[0];
+}
+
+void Oversampler::reset() {
+    for (auto& stage : upStages) stage.reset();
+    for (auto& stage : downStages) stage.reset();
+}
+
+void Oversampler::saveState(double* state) const {
+    for (int s = 0; s < numStages; ++s) {
+        upStages[s].saveState(state);
+        state += upStages[s].getStateSize();
+        downStages[s].saveState(state);
+        state += downStages[s].getStateSize();
+    }
+}
+
+void Oversampler::restoreState(const double* state) {
+    for (int s = 0; s < numStages; ++s) {
+        upStages[s].restoreState(state);
+        state += upStages[s].getStateSize();
+        downStages[s].restoreState(state);
+        state += downStages[s].getStateSize();
+    }
+}
+
+double Oversampler::getLatency() const {
+    double latency = 0.0;
+    double rateScale = 1.0;
+    for (int s = 0; s < numStages; ++s) {
+        latency += 2.0 * upStages[s].getLatency() / rateScale;
+        rateScale *= 2.0;
+    }
+    return latency;
+}
@@ -0,0 +1,90 @@
+#ifndef OVERSAMPLER_H
+#define OVERSAMPLER_H
+
+#include <atomic>
+#include <vector>
+
+// One 2x stage built from a symmetric half-band FIR.
+// Every other tap of a half-band filter is zero, so the polyphase split
+// leaves one branch with only the centre tap (a pure delay) and one branch
+// with the 2 * halfLength side taps, which are folded in symmetric pairs.
+class HalfBandStage {
+public:
+    explicit HalfBandStage(int halfLength = 8);
+
+    // Upsample: one input sample in, two output samples out
+    void upsample(double input, double* output);
+
+    // Downsample: two input samples in, one output sample out
+    double downsample(const double* input);
+
+    void reset();
+
+    // History and ring positions, for filters that run several channels
+    static constexpr int stateSize(int halfLength) { return 3 * halfLength + 1; }
+    int getStateSize() const { return stateSize(halfLength); }
+    void saveState(double* state) const;
+    void restoreState(const double* state);
+
+    // Group delay in samples at the lower of the two rates
+    double getLatency() const { return halfLength - 0.5; }
+
+private:
+    int halfLength;                  // Number of side taps on each side of the centre
+    std::vector<double> coeffs;      // Side taps, innermost first
+    std::vector<double> history;     // Doubled ring so the FIR window is always contiguous
+    std::vector<double> centreDelay; // Delay line for the centre-tap branch (downsampling)
+    int position;
+    int centrePosition;
+
+    void push(double input);
+    double foldedSum() const;
+    void designCoefficients();
+};
+
+// Cascade of half-band stages giving 1x/2x/4x/8x oversampling.
+// All three stages are built up front, so the factor can change at runtime
+// without allocating: setFactor() may be called from any thread and only
+// records the request; the audio thread takes it over at a block boundary
+// with applyPendingFactor(), which resets the filter state.
+class Oversampler {
+public:
+    static constexpr int MaxFactor = 8;
+    static constexpr int MaxStages = 3;
+
+    explicit Oversampler(int factor = 2);
+
+    // Any thread: snapped to 1, 2, 4 or 8 and applied by applyPendingFactor()
+    void setFactor(int factor);
+    int getPendingFactor() const { return pendingFactor.load(std::memory_order_relaxed); }
+    // Audio thread: switches to the requested factor; true if it changed
+    bool applyPendingFactor();
+    int getFactor() const { return factor.load(std::memory_order_relaxed); }
+
+    // Writes getFactor() samples to output
+    void upsample(double input, double* output);
+
+    // Consumes getFactor() samples from input (the buffer is used as scratch space)
+    double downsample(double* input);
+
+    void reset();
+
+    // State of every stage, sized for MaxFactor so it does not change with
+    // the factor; applying a new factor discards it like reset() would
+    static constexpr int StateSize = 2 * (HalfBandStage::stateSize(8) + 2 * HalfBandStage::stateSize(4));
+    void saveState(double* state) const;
+    void restoreState(const double* state);
+
+    // Round-trip (up + down) group delay in base-rate samples
+    double getLatency() const;
+
+private:
+    std::atomic<int> factor;         // Written only by the audio thread
+    std::atomic<int> pendingFactor;
+    int numStages;
+    std::vector<HalfBandStage> upStages;
+    std::vector<HalfBandStage> downStages;
+    double scratch[MaxFactor];
+};
+
+#endif // OVERSAMPLER_H
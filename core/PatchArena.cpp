@@ -0,0 +1,95 @@
+#include "PatchArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+constexpr size_t ChunkAlignment = 64;  // Cache line
+
+// Stored right before every object from allocateObject()
+struct ObjectHeader {
+    PatchArena* arena;   // nullptr when the object is on the heap
+    uint32_t offset;     // From the start of the allocation to the object
+    uint32_t alignment;
+};
+
+thread_local PatchArena* currentArena = nullptr;
+
+uintptr_t alignUp(uintptr_t value, size_t alignment) {
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+} // namespace
+
+PatchArena::PatchArena(size_t chunkSize) : chunkSize(chunkSize) {
+}
+
+PatchArena::~PatchArena() {
+    for (const Chunk& chunk : chunks) {
+        ::operator delete(chunk.memory, std::align_val_t(ChunkAlignment));
+    }
+}
+
+void* PatchArena::allocate(size_t size, size_t alignment) {
+    uintptr_t address = alignUp(reinterpret_cast<uintptr_t>(cursor), alignment);
+    if (cursor == nullptr || address + size > reinterpret_cast<uintptr_t>(limit)) {
+        address = alignUp(reinterpret_cast<uintptr_t>(addChunk(size + alignment)), alignment);
+    }
+    cursor = reinterpret_cast<unsigned char*>(address + size);
+    bytesUsed += size;
+    ++allocationCount;
+    return reinterpret_cast<void*>(address);
+}
+
+unsigned char* PatchArena::addChunk(size_t minimumSize) {
+    // Chunks double up to MaxChunkSize, so a large patch needs only a few
+    size_t size = std::max(chunkSize, minimumSize);
+    if (chunkSize < MaxChunkSize) chunkSize = std::min(chunkSize * 2, MaxChunkSize);
+
+    auto* memory = static_cast<unsigned char*>(::operator new(size, std::align_val_t(ChunkAlignment)));
+    if (chunks.empty()) chunks.reserve(8);  // Doubling reaches MaxChunkSize within that
+    chunks.push_back({memory, size});
+    bytesReserved += size;
+    cursor = memory;
+    limit = memory + size;
+    return memory;
+}
+
+// -----------------------------------------------------------------------------
+// Scopes and graph objects
+// -----------------------------------------------------------------------------
+PatchArena::Scope::Scope(PatchArena* arena) : previous(currentArena) {
+    currentArena = arena;
+}
+
+PatchArena::Scope::~Scope() {
+    currentArena = previous;
+}
+
+PatchArena* PatchArena::current() {
+    return currentArena;
+}
+
+void* PatchArena::allocateObject(size_t size, size_t alignment) {
+    alignment = std::max(alignment, alignof(ObjectHeader));
+    size_t offset = alignUp(sizeof(ObjectHeader), alignment);
+
+    unsigned char* base;
+    if (currentArena) {
+        base = static_cast<unsigned char*>(currentArena->allocate(offset + size, alignment));
+    } else {
+        base = static_cast<unsigned char*>(::operator new(offset + size, std::align_val_t(alignment)));
+    }
+    unsigned char* object = base + offset;
+    new (object - sizeof(ObjectHeader)) ObjectHeader{currentArena, static_cast<uint32_t>(offset),
+                                                     static_cast<uint32_t>(alignment)};
+    return object;
+}
+
+void PatchArena::releaseObject(void* object) {
+    if (!object) return;
+    auto* header = reinterpret_cast<ObjectHeader*>(static_cast<unsigned char*>(object) - sizeof(ObjectHeader));
+    if (header->arena) return;  // Reclaimed with the whole arena
+    ::operator delete(static_cast<unsigned char*>(object) - header->offset, std::align_val_t(header->alignment));
+}
@@ -0,0 +1,82 @@
+#ifndef PATCHARENA_H
+#define PATCHARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Per-patch bump allocator. Everything a patch graph is made of - its
+// oscillators, filters and envelopes, and the render graph's scratch
+// buffers - is placed back to back in a few large chunks, in construction
+// order, so the render walk touches neighbouring cache lines instead of
+// objects scattered across the heap. The chunks are released together when
+// the arena is destroyed.
+//
+// Oscillator, Filter and Envelope route their operator new through
+// allocateObject(): inside a Scope objects come from that arena, otherwise
+// from the heap, and a small header records which. Deleting an arena object
+// runs its destructor as usual but frees nothing, so unique_ptr ownership
+// and virtual destructors work unchanged. The arena must outlive every
+// object allocated from it (Sound holds it as its first member).
+//
+// Not thread-safe: one arena is filled by one thread at a time.
+class PatchArena {
+public:
+    static constexpr size_t DefaultChunkSize = 16 * 1024;
+    static constexpr size_t MaxChunkSize = 1024 * 1024;
+
+    explicit PatchArena(size_t chunkSize = DefaultChunkSize);
+    ~PatchArena();
+    PatchArena(const PatchArena&) = delete;
+    PatchArena& operator=(const PatchArena&) = delete;
+
+    // Uninitialized memory that lives as long as the arena
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    size_t getBytesUsed() const { return bytesUsed; }
+    size_t getBytesReserved() const { return bytesReserved; }
+    int getChunkCount() const { return static_cast<int>(chunks.size()); }
+    int getAllocationCount() const { return allocationCount; }
+
+    // Calls fn(memory, size) for every chunk, e.g. to lock or prefault them
+    template <typename Fn>
+    void forEachChunk(Fn&& fn) const {
+        for (const Chunk& chunk : chunks) fn(chunk.memory, chunk.size);
+    }
+
+    // Makes an arena the target of allocateObject() on this thread until the
+    // scope ends. Scopes nest; a nullptr scope sends objects to the heap.
+    class Scope {
+    public:
+        explicit Scope(PatchArena* arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PatchArena* previous;
+    };
+
+    static PatchArena* current();
+
+    // Backing for the class-level operator new/delete of graph objects
+    static void* allocateObject(size_t size, size_t alignment);
+    static void releaseObject(void* object);
+
+private:
+    struct Chunk {
+        unsigned char* memory;
+        size_t size;
+    };
+
+    size_t chunkSize;
+    std::vector<Chunk> chunks;
+    unsigned char* cursor = nullptr;  // Next free byte of the current chunk
+    unsigned char* limit = nullptr;
+    size_t bytesUsed = 0;
+    size_t bytesReserved = 0;
+    int allocationCount = 0;
+
+    unsigned char* addChunk(size_t minimumSize);
+};
+
+#endif // PATCHARENA_H
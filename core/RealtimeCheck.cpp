@@ -0,0 +1,364 @@
+// Fortified inline wrappers of read()/write() would clash with the interposers below
+#undef _FORTIFY_SOURCE
+
+#include "RealtimeCheck.h"
+#include "Logger.h"
+#include <atomic>
+#include <cstdint>
+
+#if defined(SYNTH_RT_CHECK) && defined(__GLIBC__)
+#define REALTIME_CHECK_INTERPOSE 1
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int ViolationKinds = static_cast<int>(RealtimeCheck::Violation::Count);
+constexpr int MaxFrames = 24;
+constexpr int MaxSites = 128;
+constexpr int SkippedFrames = 2;  // record() and the interposer
+
+// One distinct call site. Filled inside the intercepted call, so it is all
+// fixed storage: recording must not allocate or lock itself.
+struct Site {
+    std::atomic<uint64_t> key{0};  // 0 while free
+    RealtimeCheck::Violation kind = RealtimeCheck::Violation::Allocation;
+    int depth = 0;
+    void* frames[MaxFrames] = {};
+    std::atomic<long> count{0};
+};
+
+std::atomic<long> violationCounts[ViolationKinds];
+Site sites[MaxSites];
+std::atomic<long> droppedSites{0};
+
+thread_local int renderDepth = 0;
+
+const char* const ViolationNames[ViolationKinds] = {
+    "allocation", "free", "mutex lock", "blocking wait", "sleep", "file I/O"
+};
+
+#ifdef REALTIME_CHECK_INTERPOSE
+thread_local bool recording = false;  // The checker's own calls are not violations
+
+uint64_t hashSite(RealtimeCheck::Violation kind, void* const* frames, int depth) {
+    uint64_t hash = 1469598103934665603ull ^ static_cast<uint64_t>(kind);
+    for (int i = 0; i < depth; ++i) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+    return hash | 1;
+}
+
+void record(RealtimeCheck::Violation kind) {
+    if (renderDepth == 0 || recording) return;
+    recording = true;
+    violationCounts[static_cast<int>(kind)].fetch_add(1, std::memory_order_relaxed);
+
+    void* frames[MaxFrames];
+    int depth = backtrace(frames, MaxFrames);
+    uint64_t key = hashSite(kind, frames, depth);
+    bool placed = false;
+    for (int probe = 0; probe < MaxSites && !placed; ++probe) {
+        Site& site = sites[(key + probe) % MaxSites];
+        uint64_t existing = site.key.load(std::memory_order_acquire);
+        if (existing == 0) {
+            if (site.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+                site.kind = kind;
+                site.depth = depth;
+                for (int i = 0; i < depth; ++i) site.frames[i] = frames[i];
+                existing = key;
+            }
+        }
+        if (existing == key) {
+            site.count.fetch_add(1, std::memory_order_relaxed);
+            placed = true;
+        }
+    }
+    if (!placed) droppedSites.fetch_add(1, std::memory_order_relaxed);
+    recording = false;
+}
+
+// backtrace() loads the unwinder on first use, which allocates
+void loadUnwinder() {
+    static bool loaded = false;
+    if (loaded) return;
+    void* frame;
+    backtrace(&frame, 1);
+    loaded = true;
+}
+#endif
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Scopes and reporting
+// -----------------------------------------------------------------------------
+#ifdef SYNTH_RT_CHECK
+RealtimeCheck::Scope::Scope() {
+#ifdef REALTIME_CHECK_INTERPOSE
+    if (renderDepth == 0) loadUnwinder();
+#endif
+    ++renderDepth;
+}
+
+RealtimeCheck::Scope::~Scope() {
+    --renderDepth;
+}
+#endif
+
+bool RealtimeCheck::isActive() {
+#ifdef REALTIME_CHECK_INTERPOSE
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RealtimeCheck::isRenderThread() {
+    return renderDepth > 0;
+}
+
+long RealtimeCheck::getViolationCount() {
+    long total = 0;
+    for (int kind = 0; kind < ViolationKinds; ++kind) {
+        total += violationCounts[kind].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+long RealtimeCheck::getViolationCount(Violation kind) {
+    return violationCounts[static_cast<int>(kind)].load(std::memory_order_relaxed);
+}
+
+int RealtimeCheck::getSiteCount() {
+    int count = 0;
+    for (const Site& site : sites) {
+        if (site.key.load(std::memory_order_acquire) != 0) ++count;
+    }
+    return count;
+}
+
+const char* RealtimeCheck::getName(Violation kind) {
+    int index = static_cast<int>(kind);
+    return (index >= 0 && index < ViolationKinds) ? ViolationNames[index] : "unknown";
+}
+
+void RealtimeCheck::report() {
+    if (!isActive()) {
+        LOG_INFO("⏱️ Real-time check not compiled in (build with RT_CHECK=1)");
+        return;
+    }
+    long total = getViolationCount();
+    if (total == 0) {
+        LOG_INFO("✅ Real-time check: no violations on render threads");
+        return;
+    }
+
+    LOG_ERROR("⛔ Real-time check: %ld violations at %d call sites", total, getSiteCount());
+    for (int kind = 0; kind < ViolationKinds; ++kind) {
+        long count = violationCounts[kind].load(std::memory_order_relaxed);
+        if (count) LOG_ERROR("   %-14s %ld", ViolationNames[kind], count);
+    }
+#ifdef REALTIME_CHECK_INTERPOSE
+    for (const Site& site : sites) {
+        if (site.key.load(std::memory_order_acquire) == 0) continue;
+        LOG_ERROR("⛔ %s x%ld", getName(site.kind), site.count.load(std::memory_order_relaxed));
+        int depth = site.depth - SkippedFrames;
+        if (depth <= 0) continue;
+        char** symbols = backtrace_symbols(site.frames + SkippedFrames, depth);
+        for (int i = 0; i < depth; ++i) {
+            LOG_ERROR("     #%d %s", i, symbols ? symbols[i] : "?");
+        }
+        free(symbols);
+    }
+#endif
+    long dropped = droppedSites.load(std::memory_order_relaxed);
+    if (dropped) LOG_ERROR("   %ld violations at further sites were not traced", dropped);
+}
+
+void RealtimeCheck::reset() {
+    for (auto& count : violationCounts) count.store(0, std::memory_order_relaxed);
+    for (Site& site : sites) {
+        site.count.store(0, std::memory_order_relaxed);
+        site.key.store(0, std::memory_order_release);
+    }
+    droppedSites.store(0, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// Interposers: record, then forward to the C library
+// -----------------------------------------------------------------------------
+#ifdef REALTIME_CHECK_INTERPOSE
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* memory, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* memory);
+}
+
+namespace {
+
+using Violation = RealtimeCheck::Violation;
+
+// The next definition of a symbol, looked up on first use. dlsym() only
+// allocates through the interposed malloc, which never needs it.
+template <typename Fn>
+Fn next(Fn& cached, const char* name) {
+    if (!cached) cached = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+    return cached;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+    record(Violation::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    record(Violation::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, size_t size) noexcept {
+    record(Violation::Allocation);
+    return __libc_realloc(memory, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+    record(Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    record(Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memory, size_t alignment, size_t size) noexcept {
+    record(Violation::Allocation);
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* allocated = __libc_memalign(alignment, size);
+    if (!allocated) return ENOMEM;
+    *memory = allocated;
+    return 0;
+}
+
+void free(void* memory) noexcept {
+    if (memory) record(Violation::Free);
+    __libc_free(memory);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+    static int (*real)(pthread_mutex_t*) = nullptr;
+    record(Violation::Lock);
+    return next(real, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept {
+    static int (*real)(pthread_rwlock_t*) = nullptr;
+    record(Violation::Lock);
+    return next(real, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept {
+    static int (*real)(pthread_rwlock_t*) = nullptr;
+    record(Violation::Lock);
+    return next(real, "pthread_rwlock_wrlock")(lock);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+    static int (*real)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    record(Violation::Wait);
+    return next(real, "pthread_cond_wait")(condition, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* until) {
+    static int (*real)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+    record(Violation::Wait);
+    return next(real, "pthread_cond_timedwait")(condition, mutex, until);
+}
+
+int pthread_join(pthread_t thread, void** result) {
+    static int (*real)(pthread_t, void**) = nullptr;
+    record(Violation::Wait);
+    return next(real, "pthread_join")(thread, result);
+}
+
+int sem_wait(sem_t* semaphore) {
+    static int (*real)(sem_t*) = nullptr;
+    record(Violation::Wait);
+    return next(real, "sem_wait")(semaphore);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+    static int (*real)(const struct timespec*, struct timespec*) = nullptr;
+    record(Violation::Sleep);
+    return next(real, "nanosleep")(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining) {
+    static int (*real)(clockid_t, int, const struct timespec*, struct timespec*) = nullptr;
+    record(Violation::Sleep);
+    return next(real, "clock_nanosleep")(clock, flags, duration, remaining);
+}
+
+int usleep(useconds_t microseconds) {
+    static int (*real)(useconds_t) = nullptr;
+    record(Violation::Sleep);
+    return next(real, "usleep")(microseconds);
+}
+
+ssize_t read(int fd, void* buffer, size_t count) {
+    static ssize_t (*real)(int, void*, size_t) = nullptr;
+    record(Violation::FileIO);
+    return next(real, "read")(fd, buffer, count);
+}
+
+ssize_t write(int fd, const void* buffer, size_t count) {
+    static ssize_t (*real)(int, const void*, size_t) = nullptr;
+    record(Violation::FileIO);
+    return next(real, "write")(fd, buffer, count);
+}
+
+int open(const char* path, int flags, ...) {
+    static int (*real)(const char*, int, ...) = nullptr;
+    record(Violation::FileIO);
+    mode_t mode = 0;
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = static_cast<mode_t>(va_arg(args, int));
+        va_end(args);
+    }
+    return next(real, "open")(path, flags, mode);
+}
+
+int close(int fd) {
+    static int (*real)(int) = nullptr;
+    record(Violation::FileIO);
+    return next(real, "close")(fd);
+}
+
+int fsync(int fd) {
+    static int (*real)(int) = nullptr;
+    record(Violation::FileIO);
+    return next(real, "fsync")(fd);
+}
+
+} // extern "C"
+
+#endif // REALTIME_CHECK_INTERPOSE
@@ -0,0 +1,47 @@
+#ifndef REALTIMECHECK_H
+#define REALTIMECHECK_H
+
+// Debug/CI guard for the render path.
+//
+// A thread inside a RealtimeCheck::Scope is a render thread: the audio
+// device callback and the worker pool's task loop open one. Built with
+// SYNTH_RT_CHECK (`make RT_CHECK=1`) on glibc, the checker interposes
+// malloc/free and friends (operator new/delete end up there), mutex locks,
+// condition/semaphore/join waits, sleeps and file I/O. Every such call made
+// on a render thread is counted and its call site recorded with a stack
+// trace; the call itself still goes through, so a run shows every offender
+// instead of stopping at the first. Without the flag a Scope is empty and
+// nothing is counted.
+class RealtimeCheck {
+public:
+    enum class Violation { Allocation, Free, Lock, Wait, Sleep, FileIO, Count };
+
+    // Marks the calling thread as a render thread until destroyed; nests
+    class Scope {
+    public:
+#ifdef SYNTH_RT_CHECK
+        Scope();
+        ~Scope();
+#else
+        Scope() {}
+        ~Scope() {}
+#endif
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // True when built with SYNTH_RT_CHECK on a platform where calls can be intercepted
+    static bool isActive();
+    static bool isRenderThread();
+
+    static long getViolationCount();
+    static long getViolationCount(Violation kind);
+    static int getSiteCount();  // Distinct call sites
+    static const char* getName(Violation kind);
+
+    // Logs the counts and one stack trace per call site
+    static void report();
+    static void reset();
+};
+
+#endif // REALTIMECHECK_H
@@ -0,0 +1,302 @@
+#include "RealtimeSetup.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define REALTIME_SETUP_POSIX 1
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <dlfcn.h>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+constexpr int PriorityKinds = static_cast<int>(RealtimeSetup::Priority::Count);
+
+std::atomic<int> threadCounts[PriorityKinds];
+std::atomic<size_t> lockedBytes{0};
+std::atomic<size_t> preparedBytes{0};
+std::atomic<RealtimeSetup::MemoryLock> memoryLock{RealtimeSetup::MemoryLock::None};
+std::once_flag memoryLockOnce;
+size_t lockBudget = 0;  // Ranges mode: how much mlock() may take in total
+
+const char* const PriorityNames[PriorityKinds] = {"SCHED_FIFO", "rtkit", "normal"};
+
+size_t pageSize() {
+#ifdef REALTIME_SETUP_POSIX
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+#ifdef __linux__
+// The slice of sd-bus needed to ask rtkit, resolved from libsystemd at run
+// time: the build needs no D-Bus headers and systems without it still start.
+struct BusError {
+    const char* name;
+    const char* message;
+    int needFree;
+};
+
+struct SdBus {
+    using OpenSystem = int (*)(void** bus);
+    using Unref = void* (*)(void* bus);
+    using CallMethod = int (*)(void* bus, const char* destination, const char* path, const char* interface,
+                               const char* member, BusError* error, void** reply, const char* types, ...);
+    using GetProperty = int (*)(void* bus, const char* destination, const char* path, const char* interface,
+                                const char* member, BusError* error, char type, void* value);
+    using MessageUnref = void* (*)(void* message);
+    using ErrorFree = void (*)(BusError* error);
+
+    OpenSystem openSystem = nullptr;
+    Unref unref = nullptr;
+    CallMethod callMethod = nullptr;
+    GetProperty getProperty = nullptr;
+    MessageUnref messageUnref = nullptr;
+    ErrorFree errorFree = nullptr;
+
+    bool load() {
+        void* library = dlopen("libsystemd.so.0", RTLD_NOW | RTLD_LOCAL);
+        if (!library) return false;
+        openSystem = reinterpret_cast<OpenSystem>(dlsym(library, "sd_bus_open_system"));
+        unref = reinterpret_cast<Unref>(dlsym(library, "sd_bus_unref"));
+        callMethod = reinterpret_cast<CallMethod>(dlsym(library, "sd_bus_call_method"));
+        getProperty = reinterpret_cast<GetProperty>(dlsym(library, "sd_bus_get_property_trivial"));
+        messageUnref = reinterpret_cast<MessageUnref>(dlsym(library, "sd_bus_message_unref"));
+        errorFree = reinterpret_cast<ErrorFree>(dlsym(library, "sd_bus_error_free"));
+        return openSystem && unref && callMethod && getProperty && messageUnref && errorFree;
+    }
+};
+
+const char* const RtkitService = "org.freedesktop.RealtimeKit1";
+const char* const RtkitPath = "/org/freedesktop/RealtimeKit1";
+
+bool requestRtkit(int priority) {
+    static SdBus sdBus;
+    static const bool loaded = sdBus.load();
+    if (!loaded) {
+        LOG_DEBUG("rtkit: libsystemd not available");
+        return false;
+    }
+
+    void* bus = nullptr;
+    if (sdBus.openSystem(&bus) < 0) {
+        LOG_DEBUG("rtkit: no system bus");
+        return false;
+    }
+
+    BusError error = {nullptr, nullptr, 0};
+    int32_t maxPriority = 0;
+    int64_t maxRealtimeUs = 0;
+    bool ok = sdBus.getProperty(bus, RtkitService, RtkitPath, RtkitService, "MaxRealtimePriority",
+                                &error, 'i', &maxPriority) >= 0
+           && sdBus.getProperty(bus, RtkitService, RtkitPath, RtkitService, "RTTimeUSecMax",
+                                &error, 'x', &maxRealtimeUs) >= 0
+           && maxPriority > 0;
+
+    // rtkit only serves processes that cap their real-time CPU time
+    struct rlimit limit {};
+    if (ok && getrlimit(RLIMIT_RTTIME, &limit) == 0
+        && (limit.rlim_max == RLIM_INFINITY || limit.rlim_max > static_cast<rlim_t>(maxRealtimeUs))) {
+        limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(maxRealtimeUs);
+        ok = setrlimit(RLIMIT_RTTIME, &limit) == 0;
+    }
+
+    if (ok) {
+        void* reply = nullptr;
+        uint64_t thread = static_cast<uint64_t>(syscall(SYS_gettid));
+        uint32_t granted = static_cast<uint32_t>(std::clamp(priority, 1, static_cast<int>(maxPriority)));
+        ok = sdBus.callMethod(bus, RtkitService, RtkitPath, RtkitService, "MakeThreadRealtime",
+                              &error, &reply, "tu", thread, granted) >= 0;
+        if (reply) sdBus.messageUnref(reply);
+    }
+    if (!ok) LOG_DEBUG("rtkit: %s", error.message ? error.message : "request refused");
+    sdBus.errorFree(&error);
+    sdBus.unref(bus);
+    return ok;
+}
+
+// CAP_IPC_LOCK lifts RLIMIT_MEMLOCK; uid 0 alone does not inside a container
+bool canLockWithoutLimit() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("CapEff:", 0) == 0) {
+            unsigned long long capabilities = std::strtoull(line.c_str() + 7, nullptr, 16);
+            return (capabilities >> 14) & 1;  // CAP_IPC_LOCK
+        }
+    }
+    return false;
+}
+#elif defined(REALTIME_SETUP_POSIX)
+bool canLockWithoutLimit() {
+    return geteuid() == 0;
+}
+#endif
+
+int currentPriority() {
+#ifdef __linux__
+    int policy = 0;
+    sched_param param {};
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) return param.sched_priority;
+#endif
+    return 0;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Threads
+// -----------------------------------------------------------------------------
+RealtimeSetup::Priority RealtimeSetup::prepareCurrentThread(const char* role, int priority) {
+    Priority granted = promoteCurrentThread(priority);
+    threadCounts[static_cast<int>(granted)].fetch_add(1, std::memory_order_relaxed);
+    prefaultStack();
+
+    if (granted == Priority::Normal) {
+        LOG_WARNING("⚠️ %s thread: no real-time priority granted, running with normal scheduling", role);
+    } else {
+        LOG_INFO("⚡ %s thread: %s priority %d", role, getName(granted), currentPriority());
+    }
+    return granted;
+}
+
+RealtimeSetup::Priority RealtimeSetup::promoteCurrentThread(int priority) {
+#ifdef __linux__
+    sched_param param {};
+    param.sched_priority = std::clamp(priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result == 0) return Priority::Fifo;
+    LOG_DEBUG("SCHED_FIFO %d refused: %s", param.sched_priority, std::strerror(result));
+
+    if (requestRtkit(param.sched_priority)) return Priority::Rtkit;
+#else
+    (void)priority;
+#endif
+    return Priority::Normal;
+}
+
+void RealtimeSetup::prefaultStack() {
+    // Render calls go this deep at most; the pages below stay mapped afterwards
+    volatile unsigned char stack[StackPrefaultBytes];
+    for (size_t offset = 0; offset < StackPrefaultBytes; offset += pageSize()) {
+        stack[offset] = 0;
+    }
+    (void)stack[0];
+}
+
+// -----------------------------------------------------------------------------
+// Memory
+// -----------------------------------------------------------------------------
+RealtimeSetup::MemoryLock RealtimeSetup::lockMemory() {
+    std::call_once(memoryLockOnce, [] {
+#ifdef REALTIME_SETUP_POSIX
+        struct rlimit limit {};
+        getrlimit(RLIMIT_MEMLOCK, &limit);
+
+        // With a finite limit MCL_FUTURE would make allocations fail once the
+        // limit is reached, so only an unlimited process locks everything
+        if (limit.rlim_cur == RLIM_INFINITY || canLockWithoutLimit()) {
+            int flags = MCL_CURRENT | MCL_FUTURE;
+#ifdef MCL_ONFAULT
+            flags |= MCL_ONFAULT;  // Lock pages as they are touched instead of populating every reservation
+#endif
+            if (mlockall(flags) == 0) {
+                memoryLock.store(MemoryLock::All);
+                return;
+            }
+            LOG_WARNING("⚠️ mlockall failed (%s) - locking render buffers only", std::strerror(errno));
+        }
+
+        // Leave half of the limit to the audio backend
+        lockBudget = limit.rlim_cur == RLIM_INFINITY ? SIZE_MAX : static_cast<size_t>(limit.rlim_cur) / 2;
+        memoryLock.store(lockBudget > 0 ? MemoryLock::Ranges : MemoryLock::None);
+#endif
+    });
+    return memoryLock.load();
+}
+
+size_t RealtimeSetup::prepareRange(void* data, size_t size) {
+    if (!data || size == 0) return 0;
+    const size_t page = pageSize();
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size + page - 1) & ~static_cast<uintptr_t>(page - 1);
+    size_t span = end - begin;
+
+#ifdef REALTIME_SETUP_POSIX
+    // Locked pages are not given back when the range is freed, so the budget
+    // only ever shrinks and later graphs fall back to prefaulting alone
+    if (memoryLock.load() == MemoryLock::Ranges && lockedBytes.load() + span <= lockBudget
+        && mlock(reinterpret_cast<void*>(begin), span) == 0) {
+        lockedBytes.fetch_add(span);
+    }
+#endif
+
+    // Write each page back to itself: reading alone would map the shared zero page
+    volatile unsigned char* bytes = static_cast<volatile unsigned char*>(data);
+    for (size_t offset = 0; offset < size; offset += page) {
+        bytes[offset] = bytes[offset];
+    }
+    bytes[size - 1] = bytes[size - 1];
+    preparedBytes.fetch_add(span, std::memory_order_relaxed);
+    return span;
+}
+
+// -----------------------------------------------------------------------------
+// Reporting
+// -----------------------------------------------------------------------------
+int RealtimeSetup::getThreadCount(Priority priority) {
+    int index = static_cast<int>(priority);
+    return (index >= 0 && index < PriorityKinds) ? threadCounts[index].load(std::memory_order_relaxed) : 0;
+}
+
+RealtimeSetup::MemoryLock RealtimeSetup::getMemoryLock() {
+    return memoryLock.load();
+}
+
+size_t RealtimeSetup::getLockedBytes() {
+    return lockedBytes.load();
+}
+
+size_t RealtimeSetup::getPreparedBytes() {
+    return preparedBytes.load(std::memory_order_relaxed);
+}
+
+const char* RealtimeSetup::getName(Priority priority) {
+    int index = static_cast<int>(priority);
+    return (index >= 0 && index < PriorityKinds) ? PriorityNames[index] : "unknown";
+}
+
+const char* RealtimeSetup::getName(MemoryLock lock) {
+    switch (lock) {
+    case MemoryLock::All: return "mlockall";
+    case MemoryLock::Ranges: return "render buffers";
+    case MemoryLock::None: break;
+    }
+    return "not locked";
+}
+
+void RealtimeSetup::report() {
+    LOG_INFO("🔒 Real-time setup: threads %s %d, %s %d, %s %d; memory %s (%zu KB by range), %zu KB prefaulted",
+             getName(Priority::Fifo), getThreadCount(Priority::Fifo),
+             getName(Priority::Rtkit), getThreadCount(Priority::Rtkit),
+             getName(Priority::Normal), getThreadCount(Priority::Normal),
+             getName(getMemoryLock()), getLockedBytes() / 1024, getPreparedBytes() / 1024);
+}
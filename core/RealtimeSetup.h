@@ -0,0 +1,51 @@
+#ifndef REALTIMESETUP_H
+#define REALTIMESETUP_H
+
+#include <cstddef>
+
+// Scheduling and memory setup for render threads, done once before they
+// render so the first notes after power-on do not stall.
+//
+// prepareCurrentThread() asks for SCHED_FIFO, falls back to RealtimeKit
+// (rtkit, over D-Bus through a libsystemd loaded at run time) when the
+// process lacks the privilege, and otherwise leaves the thread as it is.
+// It then touches the top of the thread's stack so render calls do not
+// page-fault on it. lockMemory() pins the process with mlockall() when the
+// memlock limit allows it; otherwise prepareRange() locks individual render
+// buffers within the limit. prepareRange() also prefaults its range, so
+// memory a graph has not touched yet is mapped before the audio thread reads it.
+//
+// Everything here may block or allocate: call it off the render path (worker
+// start-up, the first device read before its RealtimeCheck::Scope, or the
+// GUI thread before a Sound is published). Every request degrades to a
+// logged fallback; report() sums up what was granted.
+class RealtimeSetup {
+public:
+    enum class Priority { Fifo, Rtkit, Normal, Count };
+    enum class MemoryLock { None, Ranges, All };
+
+    static constexpr int DefaultPriority = 70;               // SCHED_FIFO 1..99
+    static constexpr size_t StackPrefaultBytes = 128 * 1024;
+
+    // Promotes and prefaults the calling thread; role names it in the log
+    static Priority prepareCurrentThread(const char* role, int priority = DefaultPriority);
+    static Priority promoteCurrentThread(int priority = DefaultPriority);
+    static void prefaultStack();
+
+    // Process-wide; later calls return the first result
+    static MemoryLock lockMemory();
+    // Locks (in Ranges mode, while the limit allows) and prefaults a range
+    // that no other thread is using yet. Returns the bytes touched.
+    static size_t prepareRange(void* data, size_t size);
+
+    static int getThreadCount(Priority priority);
+    static MemoryLock getMemoryLock();
+    static size_t getLockedBytes();    // Ranges mode only
+    static size_t getPreparedBytes();
+    static const char* getName(Priority priority);
+    static const char* getName(MemoryLock lock);
+
+    static void report();
+};
+
+#endif // REALTIMESETUP_H
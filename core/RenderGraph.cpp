@@ -0,0 +1,115 @@
+#include "RenderGraph.h"
+#include "PatchArena.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <thread>
+
+void RenderGraph::clear() {
+    nodes.clear();
+    buffersInUse = 0;
+    remainingDependencies.reset();
+    readyQueue.reset();
+    finalized = false;
+}
+
+double* RenderGraph::allocateBuffer() {
+    double* buffer;
+    if (buffersInUse < static_cast<int>(buffers.size())) {
+        buffer = buffers[buffersInUse];
+    } else if (PatchArena* arena = PatchArena::current()) {
+        buffer = static_cast<double*>(arena->allocate(MaxBlockSize * sizeof(double), 64));
+        buffers.push_back(buffer);
+    } else {
+        heapBuffers.push_back(std::make_unique<double[]>(MaxBlockSize));
+        buffer = heapBuffers.back().get();
+        buffers.push_back(buffer);
+    }
+    ++buffersInUse;
+    std::fill(buffer, buffer + MaxBlockSize, 0.0);
+    return buffer;
+}
+
+int RenderGraph::addNode(NodeFunction render) {
+    Node node;
+    node.render = std::move(render);
+    nodes.push_back(std::move(node));
+    finalized = false;
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+void RenderGraph::addDependency(int node, int dependsOn) {
+    // Ignore edges that could close a cycle - inputs always come first
+    if (node < 0 || node >= getNodeCount() || dependsOn < 0 || dependsOn >= node) return;
+    nodes[dependsOn].dependents.push_back(node);
+    nodes[node].dependencyCount++;
+    finalized = false;
+}
+
+void RenderGraph::finalize() {
+    int count = getNodeCount();
+    remainingDependencies = std::make_unique<std::atomic<int>[]>(count);
+    readyQueue = std::make_unique<std::atomic<int>[]>(count);
+    finalized = true;
+}
+
+void RenderGraph::render(int numSamples, WorkerPool* pool) {
+    if (!finalized || nodes.empty()) return;
+    blockSize = numSamples;
+
+    if (!pool || pool->getThreadCount() == 1) {
+        for (auto& node : nodes) {
+            node.render(numSamples);
+        }
+        return;
+    }
+
+    int count = getNodeCount();
+    for (int i = 0; i < count; ++i) {
+        remainingDependencies[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+        readyQueue[i].store(-1, std::memory_order_relaxed);
+    }
+    queueHead.store(0, std::memory_order_relaxed);
+    queueTail.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (nodes[i].dependencyCount == 0) pushReady(i);
+    }
+
+    // One drain loop per thread; the pool's release/acquire handshake
+    // publishes the reset state above to the workers
+    pool->run(pool->getThreadCount(), drainTask, this);
+}
+
+void RenderGraph::pushReady(int node) {
+    int slot = queueTail.fetch_add(1, std::memory_order_relaxed);
+    readyQueue[slot].store(node, std::memory_order_release);
+}
+
+void RenderGraph::drain() {
+    int count = getNodeCount();
+    for (;;) {
+        // Every node is pushed exactly once, so claiming slot >= count means
+        // all remaining work is already owned by other workers
+        int slot = queueHead.fetch_add(1, std::memory_order_relaxed);
+        if (slot >= count) return;
+
+        // The slot is claimed before its node is published; wait for a
+        // running dependency to finish and push it
+        int node;
+        int spins = 0;
+        while ((node = readyQueue[slot].load(std::memory_order_acquire)) < 0) {
+            if ((++spins & 255) == 0) std::this_thread::yield();
+        }
+
+        nodes[node].render(blockSize);
+
+        for (int dependent : nodes[node].dependents) {
+            if (remainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pushReady(dependent);
+            }
+        }
+    }
+}
+
+void RenderGraph::drainTask(void* context, int /* taskIndex */) {
+    static_cast<RenderGraph*>(context)->drain();
+}
@@ -0,0 +1,111 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+class WorkerPool;
+
+// A patch flattened into a DAG of block-rendering nodes.
+//
+// Each node renders one block into buffers owned by the graph; an edge
+// from A to B means B reads what A wrote. Nodes whose inputs are ready are
+// pushed onto a lock-free queue and picked up by whichever worker is free, so
+// independent branches of one patch (the partials of an additive voice, the
+// modulator chains of nested FM) render on different cores within a block.
+//
+// Build the graph off the audio thread, then call finalize(); render() does
+// not allocate or lock. Any change to the patch structure needs a rebuild.
+class RenderGraph {
+public:
+    // A node's render closure, stored inline in the node so the graph walk
+    // does not chase a separate heap allocation per node. Captures must be
+    // plain pointers and values that fit in Capacity bytes.
+    class NodeFunction {
+    public:
+        static constexpr size_t Capacity = 32;
+
+        NodeFunction() = default;
+        template <typename Fn, typename = std::enable_if_t<!std::is_same<std::decay_t<Fn>, NodeFunction>::value>>
+        NodeFunction(Fn render) : invoke(&call<Fn>) {
+            static_assert(sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t),
+                          "render closure too large for a graph node");
+            static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+                          "render closures may only capture pointers and plain values");
+            new (storage) Fn(render);
+        }
+
+        void operator()(int numSamples) { invoke(storage, numSamples); }
+
+    private:
+        alignas(std::max_align_t) unsigned char storage[Capacity] = {};
+        void (*invoke)(void*, int) = nullptr;
+
+        template <typename Fn>
+        static void call(void* closure, int numSamples) { (*static_cast<Fn*>(closure))(numSamples); }
+    };
+
+    static constexpr int MaxBlockSize = 512;
+
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    void clear();
+
+    // Zeroed scratch buffer of MaxBlockSize samples. Buffers live as long as
+    // the graph and are reused by the next build after clear(); new ones come
+    // from the active PatchArena, if any.
+    double* allocateBuffer();
+
+    // Returns the node id used by addDependency(). A node may only depend on
+    // nodes added before it, which keeps the graph acyclic by construction.
+    int addNode(NodeFunction render);
+    void addDependency(int node, int dependsOn);
+
+    // Sizes the scheduling state; call after the last addNode()
+    void finalize();
+    bool isFinalized() const { return finalized; }
+
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    int getBufferCount() const { return buffersInUse; }
+    // Calls fn(memory, bytes) for the buffers not placed in an arena
+    template <typename Fn>
+    void forEachHeapBuffer(Fn&& fn) const {
+        for (const auto& buffer : heapBuffers) fn(buffer.get(), MaxBlockSize * sizeof(double));
+    }
+
+    // Renders every node once. Without a pool the nodes run in id order on
+    // the calling thread.
+    void render(int numSamples, WorkerPool* pool);
+
+private:
+    struct Node {
+        NodeFunction render;
+        std::vector<int> dependents;
+        int dependencyCount = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<double*> buffers;                        // Pool, the first buffersInUse are taken
+    std::vector<std::unique_ptr<double[]>> heapBuffers;  // Those not placed in an arena
+    int buffersInUse = 0;
+    bool finalized = false;
+
+    // Per-block scheduling state, sized by finalize()
+    std::unique_ptr<std::atomic<int>[]> remainingDependencies;
+    std::unique_ptr<std::atomic<int>[]> readyQueue;  // Node ids, -1 until published
+    std::atomic<int> queueHead{0};                   // Next slot to claim
+    std::atomic<int> queueTail{0};                   // Next slot to publish
+    int blockSize = 0;
+
+    void pushReady(int node);
+    void drain();
+    static void drainTask(void* context, int taskIndex);
+};
+
+#endif // RENDERGRAPH_H
@@ -1,6 +1,9 @@
 #include "Sound.h"
 #include "../oscillators/SineOscillator.h"  // Fixed: Correct path from core/ to oscillators/
 #include "Filter.h"
+#include "WorkerPool.h"
+#include "RealtimeSetup.h"
+#include "../interface/LiveController.h"
 #include <algorithm>
 
 Sound::Sound(double sampleRate) : sampleRate(sampleRate), masterVolume(0.7) {
@@ -9,11 +12,14 @@ Sound::Sound(double sampleRate) : sampleRate(sampleRate), masterVolume(0.7) {
 void Sound::addOscillator(std::unique_ptr<Oscillator> oscillator) {
     oscillators.push_back(std::move(oscillator));
     mixRatios.push_back(1.0);  // Default equal mix
+    pans.push_back(0.0);
     normalizeMixRatios();
+    rebuildRenderGraph();
 }
 
 void Sound::addFilter(std::unique_ptr<Filter> filter) {
     filters.push_back(std::move(filter));
+    resizeFilterStates();
 }
 
 void Sound::addEnvelope(std::unique_ptr<Envelope> env) {
@@ -22,11 +28,14 @@ void Sound::addEnvelope(std::unique_ptr<Envelope> env) {
 
 void Sound::clearFilters() {
     filters.clear();
+    resizeFilterStates();
 }
 
 void Sound::clearOscillators() {
     oscillators.clear();
     mixRatios.clear();
+    pans.clear();
+    rebuildRenderGraph();
     clearFilters();  // Also clear filters when clearing oscillators
 }
 
@@ -35,8 +44,186 @@ void Sound::clearEnvelopes() {
 }
 
 void Sound::generateSamples(double* buffer, int numSamples) {
-    for (int i = 0; i < numSamples; ++i) {
-        buffer[i] = nextSample();
+    if (channelCount == 1) {
+        for (int offset = 0; offset < numSamples; offset += MaxBlockSize) {
+            renderBlock(buffer + offset, std::min(MaxBlockSize, numSamples - offset));
+        }
+        return;
+    }
+
+    double* planar[MaxChannels];
+    for (int c = 0; c < channelCount; ++c) planar[c] = channelScratch.data() + c * MaxBlockSize;
+    const double scale = 1.0 / channelCount;
+    for (int offset = 0; offset < numSamples; offset += MaxBlockSize) {
+        int count = std::min(MaxBlockSize, numSamples - offset);
+        renderChannels(planar, count);
+        double* out = buffer + offset;
+        std::copy(planar[0], planar[0] + count, out);
+        for (int c = 1; c < channelCount; ++c) {
+            for (int n = 0; n < count; ++n) out[n] += planar[c][n];
+        }
+        for (int n = 0; n < count; ++n) out[n] *= scale;
+    }
+}
+
+void Sound::generateChannels(double* const* planar, int numSamples) {
+    if (channelCount == 1) {
+        generateSamples(planar[0], numSamples);
+        return;
+    }
+    double* block[MaxChannels];
+    for (int offset = 0; offset < numSamples; offset += MaxBlockSize) {
+        for (int c = 0; c < channelCount; ++c) block[c] = planar[c] + offset;
+        renderChannels(block, std::min(MaxBlockSize, numSamples - offset));
+    }
+}
+
+void Sound::setChannelCount(int count) {
+    count = std::clamp(count, 1, MaxChannels);
+    if (count == channelCount) return;
+    channelCount = count;
+    channelScratch.assign(channelCount > 1 ? static_cast<size_t>(channelCount) * MaxBlockSize : 0, 0.0);
+    resizeFilterStates();
+    rebuildRenderGraph();
+}
+
+void Sound::rebuildRenderGraph() {
+    PatchArena::Scope scope(arena.get());  // New scratch buffers go next to the nodes
+    renderGraph.clear();
+    layerBuffers.clear();
+    layerRightBuffers.clear();
+    for (auto& oscillator : oscillators) {
+        double* buffer = renderGraph.allocateBuffer();
+        if (channelCount > 1 && oscillator->isStereo()) {
+            double* right = renderGraph.allocateBuffer();
+            oscillator->buildStereoRenderGraph(renderGraph, buffer, right);
+            layerRightBuffers.push_back(right);
+        } else {
+            oscillator->buildRenderGraph(renderGraph, buffer);
+            layerRightBuffers.push_back(nullptr);
+        }
+        layerBuffers.push_back(buffer);
+    }
+    renderGraph.finalize();
+
+    // Not published yet, so every set can be resized here
+    for (auto& gains : layerGainSets) gains.assign(oscillators.size() * 2 * MaxChannels, 0.0);
+    updateLayerGains();
+    renderGains = publishedGains.exchange(renderGains, std::memory_order_acq_rel) & 3;
+}
+
+void Sound::updateLayerGains() {
+    // Mono layers use the first set of gains, stereo layers both
+    const int layerCount = static_cast<int>(oscillators.size());
+    std::vector<double>& layerGains = layerGainSets[writeGains];
+    std::fill(layerGains.begin(), layerGains.end(), 0.0);
+    for (int i = 0; i < layerCount; ++i) {
+        double* left = &layerGains[static_cast<size_t>(i) * 2 * MaxChannels];
+        double* right = left + MaxChannels;
+        if (i < static_cast<int>(layerRightBuffers.size()) && layerRightBuffers[i]) {
+            channels::stereoGains(pans[i], channelCount, left, right);
+        } else {
+            channels::constantPowerGains(pans[i], channelCount, left);
+        }
+        for (int c = 0; c < channelCount; ++c) {
+            left[c] *= mixRatios[i];
+            right[c] *= mixRatios[i];
+        }
+    }
+    writeGains = publishedGains.exchange(writeGains | FreshGains, std::memory_order_acq_rel) & 3;
+}
+
+void Sound::resizeFilterStates() {
+    filterStateOffsets.clear();
+    int total = 0;
+    for (auto& filter : filters) {
+        filterStateOffsets.push_back(total);
+        total += filter->getStateSize() * channelCount;
+    }
+    filterStates.assign(channelCount > 1 ? static_cast<size_t>(total) : 0, 0.0);
+}
+
+size_t Sound::prepareMemory() {
+    size_t bytes = 0;
+    auto prepare = [&bytes](void* memory, size_t size) { bytes += RealtimeSetup::prepareRange(memory, size); };
+    if (arena) arena->forEachChunk(prepare);
+    renderGraph.forEachHeapBuffer(prepare);
+    if (!channelScratch.empty()) prepare(channelScratch.data(), channelScratch.size() * sizeof(double));
+    if (!filterStates.empty()) prepare(filterStates.data(), filterStates.size() * sizeof(double));
+    return bytes;
+}
+
+void Sound::renderBlock(double* buffer, int numSamples) {
+    // Same signal flow as nextSample(), one stage at a time over the block.
+    // Layers and their independent branches are nodes of the render graph.
+    int layerCount = static_cast<int>(oscillators.size());
+    renderGraph.render(numSamples, workerPool);
+
+    // Deterministic mix-down in layer order
+    std::fill(buffer, buffer + numSamples, 0.0);
+    for (int i = 0; i < layerCount; ++i) {
+        const double* layer = layerBuffers[i];
+        double ratio = mixRatios[i];
+        for (int n = 0; n < numSamples; ++n) {
+            buffer[n] += layer[n] * ratio;
+        }
+    }
+
+    for (auto& filter : filters) {
+        filter->processBuffer(buffer, numSamples);
+    }
+
+    if (!envelopes.empty() && envelopes[0]) {
+        Envelope* env = envelopes[0].get();
+        for (int n = 0; n < numSamples; ++n) {
+            buffer[n] *= env->nextSample();
+        }
+    }
+
+    for (int n = 0; n < numSamples; ++n) {
+        buffer[n] *= masterVolume;
+    }
+}
+
+void Sound::renderChannels(double* const* planar, int numSamples) {
+    // Same stages as renderBlock(): layers are panned into every channel,
+    // each channel runs the filter chain with its own filter state, and the
+    // envelope is evaluated once for all of them
+    const int layerCount = static_cast<int>(oscillators.size());
+    renderGraph.render(numSamples, workerPool);
+
+    if (publishedGains.load(std::memory_order_relaxed) & FreshGains) {
+        renderGains = publishedGains.exchange(renderGains, std::memory_order_acq_rel) & 3;
+    }
+    const std::vector<double>& layerGains = layerGainSets[renderGains];
+    for (int c = 0; c < channelCount; ++c) std::fill(planar[c], planar[c] + numSamples, 0.0);
+    for (int i = 0; i < layerCount; ++i) {
+        const double* gains = &layerGains[static_cast<size_t>(i) * 2 * MaxChannels];
+        channels::mixPanned(layerBuffers[i], gains, planar, channelCount, numSamples);
+        if (layerRightBuffers[i]) {
+            channels::mixPanned(layerRightBuffers[i], gains + MaxChannels, planar, channelCount, numSamples);
+        }
+    }
+
+    for (size_t f = 0; f < filters.size(); ++f) {
+        Filter* filter = filters[f].get();
+        const int stateSize = filter->getStateSize();
+        for (int c = 0; c < channelCount; ++c) {
+            double* state = filterStates.data() + filterStateOffsets[f] + c * stateSize;
+            filter->restoreState(state);
+            filter->processBuffer(planar[c], numSamples);
+            filter->saveState(state);
+        }
+    }
+
+    if (!envelopes.empty() && envelopes[0]) {
+        Envelope* env = envelopes[0].get();
+        for (int n = 0; n < numSamples; ++n) envelopeBlock[n] = env->nextSample();
+    } else {
+        std::fill(envelopeBlock, envelopeBlock + numSamples, 1.0);
+    }
+    for (int c = 0; c < channelCount; ++c) {
+        channels::applyGain(envelopeBlock, masterVolume, planar[c], numSamples);
     }
 }
 
@@ -84,6 +271,31 @@ void Sound::setOscillatorMixRatio(int index, double ratio) {
     if (index >= 0 && index < static_cast<int>(mixRatios.size())) {
         mixRatios[index] = std::max(0.0, std::min(1.0, ratio));
         normalizeMixRatios();
+        updateLayerGains();
+    }
+}
+
+void Sound::setOscillatorPan(int index, double pan) {
+    if (index >= 0 && index < static_cast<int>(pans.size())) {
+        pans[index] = clamp(pan, -1.0, 1.0);
+        updateLayerGains();
+    }
+}
+
+double Sound::getOscillatorPan(int index) const {
+    if (index >= 0 && index < static_cast<int>(pans.size())) {
+        return pans[index];
+    }
+    return 0.0;
+}
+
+void Sound::registerLayerPans(LiveController& controller, const std::string& group) {
+    for (int i = 0; i < static_cast<int>(pans.size()); ++i) {
+        std::string name = "Layer " + std::to_string(i + 1) + " Pan";
+        ParameterId id = group.empty()
+            ? controller.addParameter(name, &pans[i], -1.0, 1.0, 0.05)
+            : controller.addParameterInGroup(group, name, &pans[i], -1.0, 1.0, 0.05);
+        controller.setParameterCallback(id, [this, i]() { setOscillatorPan(i, pans[i]); });
     }
 }
 
@@ -121,6 +333,14 @@ double Sound::getSampleRate() const {
     return sampleRate;
 }
 
+void Sound::setSampleRate(double rate) {
+    if (rate <= 0.0 || rate == sampleRate) return;
+    sampleRate = rate;
+    for (auto& osc : oscillators) osc->setSampleRate(rate);
+    for (auto& filter : filters) filter->setSampleRate(rate);
+    for (auto& env : envelopes) env->setSampleRate(rate);
+}
+
 Envelope* Sound::getEnvelope(int idx) {
     if (idx >= 0 && idx < static_cast<int>(envelopes.size()))
         return envelopes[idx].get();
@@ -131,10 +351,16 @@ void Sound::noteOn() {
     for (auto& env : envelopes) {
         env->noteOn();
     }
+    for (auto& osc : oscillators) {
+        osc->noteOn();
+    }
 }
 
 void Sound::noteOff() {
     for (auto& env : envelopes) {
         env->noteOff();
     }
+    for (auto& osc : oscillators) {
+        osc->noteOff();
+    }
 }
\ No newline at end of file
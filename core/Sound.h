@@ -1,26 +1,66 @@
 #ifndef SOUND_H
 #define SOUND_H
 
+#include <atomic>
 #include <vector>
 #include <memory>
 #include "../envelopes/Envelope.h"
 #include "Oscillator.h"
 #include "Filter.h"
+#include "PatchArena.h"
+#include "RenderGraph.h"
+#include "../dsp/ChannelKernels.h"
+
+class WorkerPool;
 
 class Sound {
 public:
+    // Largest block rendered in one pass; longer requests are split
+    static constexpr int MaxBlockSize = RenderGraph::MaxBlockSize;
+    static constexpr int MaxChannels = channels::MaxChannels;
+
     Sound(double sampleRate = 44100.0);
     ~Sound() = default;
 
+    // Memory for the patch graph. Set it before adding modules and build
+    // them inside a PatchArena::Scope for it; the arena is freed with the Sound.
+    void setArena(std::unique_ptr<PatchArena> patchArena) { arena = std::move(patchArena); }
+    PatchArena* getArena() const { return arena.get(); }
+
     // Module management
     void addOscillator(std::unique_ptr<Oscillator> oscillator);
     void addFilter(std::unique_ptr<Filter> filter);
     void clearOscillators();
     void clearFilters();
     
-    // Audio generation
+    // Audio generation. generateSamples() is the mono render; a
+    // multichannel Sound writes the average of its channels there.
+    // nextSample() is always mono and ignores panning.
     void generateSamples(double* buffer, int numSamples);
     double nextSample();
+
+    // Output channels, 1 to MaxChannels. One channel keeps the mono path;
+    // more pan every layer into planar blocks, stereo oscillators as a
+    // left/right pair. Rebuilds the render graph, so set it before the
+    // Sound is published.
+    void setChannelCount(int channels);
+    int getChannelCount() const { return channelCount; }
+    // Fills getChannelCount() planar buffers with numSamples each
+    void generateChannels(double* const* channels, int numSamples);
+    
+    // Render the oscillator graph on a worker pool (nullptr = render on the calling thread).
+    // Every sum keeps its serial order, so the output does not depend on threading.
+    void setWorkerPool(WorkerPool* pool) { workerPool = pool; }
+    WorkerPool* getWorkerPool() const { return workerPool; }
+
+    // Rebuilds the render graph; needed after changing the structure of an
+    // oscillator that was already added (done automatically for add/clear)
+    void rebuildRenderGraph();
+    const RenderGraph& getRenderGraph() const { return renderGraph; }
+
+    // Locks and prefaults the arena and graph buffers (see RealtimeSetup).
+    // Call before the Sound is published to the audio thread; returns the bytes touched.
+    size_t prepareMemory();
     
     // Master volume control
     void setMasterVolume(double volume);
@@ -31,11 +71,27 @@ public:
     // Mix ratios for combining oscillators
     void setOscillatorMixRatio(int index, double ratio);
     double getOscillatorMixRatio(int index) const;
+
+    // Layer position, -1 (first channel) to +1 (last), constant power. For
+    // stereo layers it is a balance control. Not used by a mono Sound.
+    // Like the mix ratio, safe to set while the Sound renders: the new
+    // gains apply from the next block.
+    void setOscillatorPan(int index, double pan);
+    double getOscillatorPan(int index) const;
+    // Live "Layer N Pan" parameters (N from 1) for the oscillators added so
+    // far, inside group when one is given; presets register them just before
+    // the master volume
+    void registerLayerPans(LiveController& controller, const std::string& group = std::string());
     
     int getOscillatorCount() const { return static_cast<int>(oscillators.size()); }
     
     // Add missing method declarations
     double getSampleRate() const;
+    // Every node recomputes what depends on the rate: phase increments, filter
+    // coefficients, envelope stage lengths. Real-time safe, but not while a
+    // block renders - call it between blocks on the rendering thread (as
+    // SoundRenderer does) or before the Sound is published.
+    void setSampleRate(double rate);
     double clamp(double value, double min, double max);
 
     // Envelope management
@@ -46,14 +102,42 @@ public:
     void noteOff();
 
 private:
+    std::unique_ptr<PatchArena> arena;  // First member, so it is destroyed last
     std::vector<std::unique_ptr<Oscillator>> oscillators;
     std::vector<std::unique_ptr<Filter>> filters;
     std::vector<double> mixRatios;  // Mix ratios for each oscillator
+    std::vector<double> pans;       // Pan of each oscillator
     double sampleRate;
     double masterVolume;
     std::vector<std::unique_ptr<Envelope>> envelopes;
+    
+    // Block rendering
+    WorkerPool* workerPool = nullptr;
+    RenderGraph renderGraph;
+    std::vector<const double*> layerBuffers;  // Graph output of each oscillator
+
+    // Multichannel rendering
+    int channelCount = 1;
+    std::vector<const double*> layerRightBuffers;  // Right side of stereo layers, nullptr for mono ones
+    // Gains of each layer, [layer][left, right source][MaxChannels] with the
+    // mix ratio included, in three sets: the control thread fills its own
+    // and publishes it, the rendering thread takes the newest at the start
+    // of a block, so no block sees a half-written set
+    static constexpr int FreshGains = 4;           // In publishedGains: not taken yet
+    std::vector<double> layerGainSets[3];
+    std::atomic<int> publishedGains{1};
+    int renderGains = 0;                           // Rendering thread's set
+    int writeGains = 2;                            // Control thread's set
+    std::vector<double> filterStates;              // [filter][channel][state] while channelCount > 1
+    std::vector<int> filterStateOffsets;
+    std::vector<double> channelScratch;            // Planar blocks for generateSamples()
+    double envelopeBlock[MaxBlockSize];
 
     void normalizeMixRatios();  // Ensure ratios sum to 1.0
+    void updateLayerGains();
+    void resizeFilterStates();
+    void renderBlock(double* buffer, int numSamples);
+    void renderChannels(double* const* channels, int numSamples);
 };
 
 #endif // SOUND_H
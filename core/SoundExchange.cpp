@@ -0,0 +1,21 @@
+#include "SoundExchange.h"
+
+Sound* SoundExchange::publish(Sound* next) {
+    return pending.exchange(next, std::memory_order_acq_rel);
+}
+
+Sound* SoundExchange::collectRetired() {
+    return retired.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+Sound* SoundExchange::acquire() {
+    // Only switch once the previous graph was collected; the retired slot holds one
+    if (retired.load(std::memory_order_acquire) == nullptr) {
+        Sound* next = pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (next) {
+            if (active) retired.store(active, std::memory_order_release);
+            active = next;
+        }
+    }
+    return active;
+}
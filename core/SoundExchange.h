@@ -0,0 +1,33 @@
+#ifndef SOUNDEXCHANGE_H
+#define SOUNDEXCHANGE_H
+
+#include <atomic>
+
+class Sound;
+
+// Hands complete Sound graphs from the GUI thread to the audio thread.
+//
+// The audio thread calls acquire() once per block and switches to a newly
+// published Sound there - wait-free, no locks, no frees. The Sound it
+// stops using is parked in a retired slot until the publishing side
+// collects it and frees it off the audio thread. While that slot is still
+// full the audio thread keeps rendering the current Sound, so it never has
+// to own more than one graph. Ownership stays with the publisher.
+class SoundExchange {
+public:
+    // Publisher side. Returns a previously published Sound the audio thread
+    // never picked up (safe to free now), or nullptr.
+    Sound* publish(Sound* next);
+    // A Sound the audio thread has stopped using, or nullptr
+    Sound* collectRetired();
+
+    // Audio thread: the Sound to render this block (nullptr before the first publish)
+    Sound* acquire();
+
+private:
+    alignas(64) std::atomic<Sound*> pending{nullptr};
+    alignas(64) std::atomic<Sound*> retired{nullptr};
+    Sound* active = nullptr;  // Audio thread only
+};
+
+#endif // SOUNDEXCHANGE_H
@@ -0,0 +1,198 @@
+#include "WorkerPool.h"
+#include "RealtimeCheck.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long an idle worker spins before parking. Audio blocks arrive every few
+// milliseconds, so a short spin catches back-to-back blocks without a syscall.
+constexpr auto SpinDuration = std::chrono::microseconds(2000);
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+// Spin-wait step that still lets an oversubscribed core run the thread we wait for
+inline void spinPause(int& spins) {
+    cpuRelax();
+    if ((++spins & 255) == 0) std::this_thread::yield();
+}
+
+inline int64_t elapsedNs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count();
+}
+
+} // namespace
+
+WorkerPool::WorkerPool(int count, ThreadSetup setup)
+    : threadCount(std::clamp(count, 1, MaxThreads)),
+      ranges(new TaskRange[MaxThreads]),
+      workers(new WorkerState[MaxThreads]),
+      threadSetup(setup) {
+    // Worker 0 is the caller of run(); only the helpers get their own thread
+    threads.reserve(threadCount - 1);
+    for (int w = 1; w < threadCount; ++w) {
+        threads.emplace_back(&WorkerPool::workerLoop, this, w);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stopping.store(true);
+    generation.fetch_add(1);
+    wakeWorkers();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+int WorkerPool::defaultThreadCount() {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(cores / 2, 1, MaxThreads);
+}
+
+void WorkerPool::run(int taskCount, TaskFunction task, void* context) {
+    if (taskCount <= 0) return;
+
+    // Nothing to share - skip the handshake entirely
+    if (threadCount == 1 || taskCount == 1) {
+        for (int i = 0; i < taskCount; ++i) {
+            task(context, i);
+        }
+        workers[0].tasks.fetch_add(taskCount, std::memory_order_relaxed);
+        workers[0].load.store(0.9 * workers[0].load.load(std::memory_order_relaxed) + 0.1,
+                              std::memory_order_relaxed);
+        return;
+    }
+
+    // Set up the ranges while no worker can be inside execute()
+    currentTask = task;
+    currentContext = context;
+    for (int w = 0; w < threadCount; ++w) {
+        int begin = static_cast<int>(static_cast<int64_t>(taskCount) * w / threadCount);
+        int end = static_cast<int>(static_cast<int64_t>(taskCount) * (w + 1) / threadCount);
+        ranges[w].end = end;
+        ranges[w].next.store(begin, std::memory_order_relaxed);
+    }
+    pendingTasks.store(taskCount, std::memory_order_relaxed);
+
+    running.store(true);
+    generation.fetch_add(1);
+    wakeWorkers();
+
+    auto start = Clock::now();
+    execute(0);
+    int spins = 0;
+    while (pendingTasks.load(std::memory_order_acquire) > 0) {
+        spinPause(spins);
+    }
+
+    // Close the run and wait for stragglers still scanning the ranges
+    running.store(false);
+    while (activeWorkers.load() > 0) {
+        spinPause(spins);
+    }
+
+    double wallNs = static_cast<double>(std::max<int64_t>(1, elapsedNs(start)));
+    for (int w = 0; w < threadCount; ++w) {
+        double busy = static_cast<double>(workers[w].busyNs.exchange(0, std::memory_order_relaxed));
+        double load = std::min(1.0, busy / wallNs);
+        workers[w].load.store(0.9 * workers[w].load.load(std::memory_order_relaxed) + 0.1 * load,
+                              std::memory_order_relaxed);
+    }
+}
+
+void WorkerPool::execute(int worker) {
+    auto start = Clock::now();
+    int done = 0;
+    int stolen = 0;
+
+    // Own range first, then steal from the others in round-robin order
+    for (int k = 0; k < threadCount; ++k) {
+        TaskRange& range = ranges[(worker + k) % threadCount];
+        for (;;) {
+            int index = range.next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= range.end) break;
+            currentTask(currentContext, index);
+            ++done;
+            if (k > 0) ++stolen;
+        }
+    }
+
+    if (done > 0) {
+        WorkerState& state = workers[worker];
+        state.busyNs.fetch_add(elapsedNs(start), std::memory_order_relaxed);
+        state.tasks.fetch_add(done, std::memory_order_relaxed);
+        state.steals.fetch_add(stolen, std::memory_order_relaxed);
+        pendingTasks.fetch_sub(done, std::memory_order_acq_rel);
+    }
+}
+
+void WorkerPool::workerLoop(int worker) {
+    if (threadSetup) threadSetup(worker);
+    uint32_t seen = generation.load();
+    while (!stopping.load(std::memory_order_relaxed)) {
+        waitForWork(seen);
+        seen = generation.load();
+
+        // Announce ourselves before looking at the run, so run() cannot
+        // reset the ranges underneath us
+        activeWorkers.fetch_add(1);
+        if (running.load() && !stopping.load(std::memory_order_relaxed)) {
+            RealtimeCheck::Scope realtime;  // Tasks are render work; parking is not
+            execute(worker);
+        }
+        activeWorkers.fetch_sub(1);
+    }
+}
+
+void WorkerPool::waitForWork(uint32_t seenGeneration) {
+    auto spinUntil = Clock::now() + SpinDuration;
+    int spins = 0;
+    while (generation.load(std::memory_order_acquire) == seenGeneration) {
+        spinPause(spins);
+        if ((spins & 63) == 0 && Clock::now() > spinUntil) break;
+    }
+
+    sleepingWorkers.fetch_add(1);
+    while (generation.load() == seenGeneration) {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&generation), FUTEX_WAIT_PRIVATE,
+                seenGeneration, nullptr, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+    }
+    sleepingWorkers.fetch_sub(1);
+}
+
+void WorkerPool::wakeWorkers() {
+    if (sleepingWorkers.load() == 0) return;
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&generation), FUTEX_WAKE_PRIVATE,
+            INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+WorkerPool::WorkerStats WorkerPool::getWorkerStats(int worker) const {
+    WorkerStats stats{0.0, 0, 0};
+    if (worker >= 0 && worker < threadCount) {
+        stats.load = workers[worker].load.load(std::memory_order_relaxed);
+        stats.tasksExecuted = workers[worker].tasks.load(std::memory_order_relaxed);
+        stats.tasksStolen = workers[worker].steals.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
@@ -0,0 +1,84 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Real-time friendly fork/join pool for per-block rendering.
+//
+// All threads and queues are created up front; run() allocates nothing and
+// takes no locks. Tasks of a run are split into one contiguous range per
+// participant; a participant drains its own range first and then steals from
+// the others' ranges, so an expensive layer does not leave cores idle.
+// Idle workers spin for a short while and then park (futex on Linux).
+// The calling thread always takes part as worker 0.
+class WorkerPool {
+public:
+    using TaskFunction = void (*)(void* context, int taskIndex);
+    // Runs first on each helper thread, e.g. to raise its priority
+    using ThreadSetup = void (*)(int worker);
+
+    static constexpr int MaxThreads = 64;
+
+    // threadCount includes the calling thread; 1 means everything runs inline
+    explicit WorkerPool(int threadCount, ThreadSetup setup = nullptr);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int getThreadCount() const { return threadCount; }
+
+    // Runs task(context, i) for i in [0, taskCount) and returns when all are done
+    void run(int taskCount, TaskFunction task, void* context);
+
+    // Load is the smoothed fraction of each run's wall time the worker was busy
+    struct WorkerStats {
+        double load;
+        uint64_t tasksExecuted;
+        uint64_t tasksStolen;
+    };
+    WorkerStats getWorkerStats(int worker) const;
+
+    // Default thread count for rendering: half the cores, at least one
+    static int defaultThreadCount();
+
+private:
+    struct alignas(64) TaskRange {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    struct alignas(64) WorkerState {
+        std::atomic<int64_t> busyNs{0};   // Busy time in the current run
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<double> load{0.0};
+    };
+
+    int threadCount;
+    std::vector<std::thread> threads;
+    std::unique_ptr<TaskRange[]> ranges;
+    std::unique_ptr<WorkerState[]> workers;
+
+    ThreadSetup threadSetup;
+    TaskFunction currentTask = nullptr;
+    void* currentContext = nullptr;
+
+    std::atomic<uint32_t> generation{0};  // Bumped once per run; workers wait on it
+    std::atomic<bool> running{false};
+    std::atomic<int> pendingTasks{0};
+    std::atomic<int> activeWorkers{0};
+    std::atomic<int> sleepingWorkers{0};
+    std::atomic<bool> stopping{false};
+
+    void workerLoop(int worker);
+    void execute(int worker);
+    void waitForWork(uint32_t seenGeneration);
+    void wakeWorkers();
+};
+
+#endif // WORKERPOOL_H
@@ -0,0 +1,86 @@
+#include "ChannelKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace channels {
+
+void constantPowerGains(double pan, int channelCount, double* gains) {
+    if (channelCount <= 1) {
+        gains[0] = 1.0;
+        return;
+    }
+    std::fill(gains, gains + channelCount, 0.0);
+    double position = (std::clamp(pan, -1.0, 1.0) + 1.0) * 0.5 * (channelCount - 1);
+    int first = std::min(static_cast<int>(position), channelCount - 2);
+    double fraction = position - first;
+    gains[first] = std::cos(fraction * M_PI_2);
+    gains[first + 1] = std::sin(fraction * M_PI_2);
+}
+
+void stereoGains(double pan, int channelCount, double* leftGains, double* rightGains) {
+    constantPowerGains(std::clamp(pan, -1.0, 1.0) - 1.0, channelCount, leftGains);
+    constantPowerGains(std::clamp(pan, -1.0, 1.0) + 1.0, channelCount, rightGains);
+}
+
+void balanceGains(double pan, int channelCount, double* gains) {
+    if (channelCount <= 1) {
+        gains[0] = 1.0;
+        return;
+    }
+    pan = std::clamp(pan, -1.0, 1.0);
+    for (int c = 0; c < channelCount; ++c) {
+        double position = 2.0 * c / (channelCount - 1) - 1.0;
+        gains[c] = std::min(1.0, 1.0 + pan * position);
+    }
+}
+
+void mixPanned(const double* source, const double* gains, double* const* planar, int channelCount, int frames) {
+    for (int c = 0; c < channelCount; ++c) {
+        const double gain = gains[c];
+        if (gain == 0.0) continue;
+        double* out = planar[c];
+        for (int n = 0; n < frames; ++n) {
+            out[n] += source[n] * gain;
+        }
+    }
+}
+
+void applyGain(const double* envelope, double scale, double* io, int frames) {
+    for (int n = 0; n < frames; ++n) {
+        io[n] *= envelope[n] * scale;
+    }
+}
+
+void interleaveMono(const double* input, float* output, int frames) {
+    for (int n = 0; n < frames; ++n) {
+        output[n] = static_cast<float>(input[n]);
+    }
+}
+
+void interleaveStereo(const double* left, const double* right, float* output, int frames) {
+    for (int n = 0; n < frames; ++n) {
+        output[2 * n] = static_cast<float>(left[n]);
+        output[2 * n + 1] = static_cast<float>(right[n]);
+    }
+}
+
+void interleave(const double* const* planar, int channelCount, float* output, int frames) {
+    if (channelCount == 1) {
+        interleaveMono(planar[0], output, frames);
+        return;
+    }
+    if (channelCount == 2) {
+        interleaveStereo(planar[0], planar[1], output, frames);
+        return;
+    }
+    // One channel at a time: each pass is a strided store of one column
+    for (int c = 0; c < channelCount; ++c) {
+        const double* in = planar[c];
+        float* out = output + c;
+        for (int n = 0; n < frames; ++n) {
+            out[n * channelCount] = static_cast<float>(in[n]);
+        }
+    }
+}
+
+} // namespace channels
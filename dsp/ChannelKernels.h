@@ -0,0 +1,45 @@
+#ifndef CHANNELKERNELS_H
+#define CHANNELKERNELS_H
+
+// Multichannel building blocks: constant-power panning, planar mixing and
+// the planar double -> interleaved float conversion at the end of the render
+// path. Like the other DSP kernels they are plain loops the compiler
+// vectorizes with DSP_FLAGS; the interleave kernels rely on it turning
+// strided stores into unpack/zip shuffles (a SIMD transpose of Lanes frames
+// at a time).
+//
+// Channels form an arc from the first (pan -1) to the last (pan +1). A
+// source between two neighbouring channels gets cos/sin gains, so its power
+// stays constant wherever it sits; centred in stereo it plays at -3 dB on
+// both sides.
+namespace channels {
+
+constexpr int MaxChannels = 8;
+
+// gains[c] for c < channelCount; one channel always gets gain 1
+void constantPowerGains(double pan, int channelCount, double* gains);
+
+// A stereo source (left, right) with a balance control: each side is panned
+// as its own source, left towards the first channel and right towards the last
+void stereoGains(double pan, int channelCount, double* leftGains, double* rightGains);
+
+// A balance control for an already mixed signal: centred leaves every
+// channel at unity, turning it attenuates the channels on the far side
+// linearly, down to silence for the outermost one at pan -1 or +1
+void balanceGains(double pan, int channelCount, double* gains);
+
+// channels[c][n] += source[n] * gains[c]; silent channels are skipped
+void mixPanned(const double* source, const double* gains, double* const* planar, int channelCount, int frames);
+
+// io[n] *= envelope[n] * scale
+void applyGain(const double* envelope, double scale, double* io, int frames);
+
+// Planar doubles -> interleaved floats. One channel is a plain conversion,
+// two a stereo zip; others take the generic path.
+void interleave(const double* const* planar, int channelCount, float* output, int frames);
+void interleaveMono(const double* input, float* output, int frames);
+void interleaveStereo(const double* left, const double* right, float* output, int frames);
+
+} // namespace channels
+
+#endif // CHANNELKERNELS_H
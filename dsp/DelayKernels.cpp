@@ -0,0 +1,73 @@
+#include "DelayKernels.h"
+#include <algorithm>
+
+namespace delays {
+
+void read(const float* ring, int mask, long long position, int delay, double* out, int count) {
+    // Up to two contiguous runs around the end of the ring
+    const int start = static_cast<int>((position - delay) & mask);
+    const int first = std::min(count, mask + 1 - start);
+    for (int n = 0; n < first; ++n) out[n] = ring[start + n];
+    for (int n = first; n < count; ++n) out[n] = ring[n - first];
+}
+
+void readModulated(const float* ring, int mask, long long position, double delay, double delayStep, int first,
+                   double* out, int count) {
+    // Relative to the block's first sample so the index math stays in int,
+    // and one ring length ahead so it stays positive and truncation floors
+    const int base = static_cast<int>(position & mask) + mask + 1;
+    for (int n = 0; n < count; ++n) {
+        const double at = base + n - (delay + (first + n) * delayStep);
+        const int index = static_cast<int>(at);
+        const double fraction = at - index;
+        const double a = ring[index & mask];
+        const double b = ring[(index + 1) & mask];
+        out[n] = a + fraction * (b - a);
+    }
+}
+
+void write(float* ring, int mask, long long position, const double* in, int count) {
+    const int start = static_cast<int>(position & mask);
+    const int first = std::min(count, mask + 1 - start);
+    for (int n = 0; n < first; ++n) ring[start + n] = static_cast<float>(in[n]);
+    for (int n = first; n < count; ++n) ring[n - first] = static_cast<float>(in[n]);
+}
+
+void hadamard(double* const* lines, int lineCount, int count) {
+    for (int span = 1; span < lineCount; span <<= 1) {
+        for (int i = 0; i < lineCount; i += 2 * span) {
+            for (int j = i; j < i + span; ++j) {
+                double* a = lines[j];
+                double* b = lines[j + span];
+                for (int n = 0; n < count; ++n) {
+                    const double x = a[n];
+                    const double y = b[n];
+                    a[n] = x + y;
+                    b[n] = x - y;
+                }
+            }
+        }
+    }
+}
+
+void onePole(double* samples, double coefficient, double& state, int count) {
+    double y = state;
+    for (int n = 0; n < count; ++n) {
+        y += coefficient * (samples[n] - y);
+        samples[n] = y;
+    }
+    state = y;
+}
+
+void onePole(double* const* lines, int lineCount, double coefficient, double* states, int count) {
+    // Sample by sample across the lines: each line's filter is a serial
+    // chain, but the lines are independent and overlap in the pipeline
+    for (int n = 0; n < count; ++n) {
+        for (int l = 0; l < lineCount; ++l) {
+            states[l] += coefficient * (lines[l][n] - states[l]);
+            lines[l][n] = states[l];
+        }
+    }
+}
+
+} // namespace delays
@@ -0,0 +1,40 @@
+#ifndef DELAYKERNELS_H
+#define DELAYKERNELS_H
+
+// Block operations on delay lines for the time-based effects (FDNReverb,
+// TempoDelay). A line is a power-of-two ring of floats indexed by a running
+// sample position and a mask; half the memory of doubles keeps more of
+// every line in cache. As long as a line's delay is at least the block
+// length, a whole block of its output was written before the block starts,
+// so it is read in one pass and the feedback written back in another, and
+// each loop runs along contiguous samples and vectorizes with DSP_FLAGS.
+namespace delays {
+
+// out[n] = ring[position + n - delay], for n < count
+void read(const float* ring, int mask, long long position, int delay, double* out, int count);
+
+// Fractional delay moving in a straight line, with linear interpolation:
+// out[n] = ring at position + n - (delay + (first + n) * delayStep). first
+// is the block's offset into the segment the line was fitted over, so a
+// segment read in pieces gives the same samples as read whole.
+void readModulated(const float* ring, int mask, long long position, double delay, double delayStep, int first,
+                   double* out, int count);
+
+// ring[position + n] = in[n], for n < count
+void write(float* ring, int mask, long long position, const double* in, int count);
+
+// Unnormalized fast Walsh-Hadamard transform across lineCount (a power of
+// two) planar blocks, sample by sample; scale by 1 / sqrt(lineCount) for
+// an orthogonal mix
+void hadamard(double* const* lines, int lineCount, int count);
+
+// One-pole lowpass y += coefficient * (x - y), in place; state carries y
+// between blocks
+void onePole(double* samples, double coefficient, double& state, int count);
+
+// The same over lineCount planar blocks, one state per line
+void onePole(double* const* lines, int lineCount, double coefficient, double* states, int count);
+
+} // namespace delays
+
+#endif // DELAYKERNELS_H
@@ -0,0 +1,122 @@
+#include "FFT.h"
+#include <algorithm>
+#include <cmath>
+
+RealFFT::RealFFT(int fftSize) : size(fftSize), half(fftSize / 2) {
+    int bits = 0;
+    while ((1 << bits) < half) ++bits;
+    reversed.resize(half);
+    for (int n = 0; n < half; ++n) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b) r |= ((n >> b) & 1) << (bits - 1 - b);
+        reversed[n] = r;
+    }
+
+    // Stage with span s combines pairs s apart with e^(-i pi k / s), k < s
+    cosines.resize(std::max(1, half - 1));
+    sines.resize(cosines.size());
+    for (int span = 1; span < half; span <<= 1) {
+        for (int k = 0; k < span; ++k) {
+            cosines[span - 1 + k] = std::cos(M_PI * k / span);
+            sines[span - 1 + k] = std::sin(M_PI * k / span);
+        }
+    }
+
+    unpackCos.resize(half + 1);
+    unpackSin.resize(half + 1);
+    for (int k = 0; k <= half; ++k) {
+        unpackCos[k] = std::cos(2.0 * M_PI * k / size);
+        unpackSin[k] = std::sin(2.0 * M_PI * k / size);
+    }
+}
+
+void RealFFT::transform(double* re, double* im, bool inverse) const {
+    // Decimation in time on bit-reversed input
+    const double sign = inverse ? -1.0 : 1.0;
+    for (int span = 1; span < half; span <<= 1) {
+        const double* c = &cosines[span - 1];
+        const double* s = &sines[span - 1];
+        for (int i = 0; i < half; i += 2 * span) {
+            double* aRe = re + i;
+            double* aIm = im + i;
+            double* bRe = re + i + span;
+            double* bIm = im + i + span;
+            for (int k = 0; k < span; ++k) {
+                double tRe = bRe[k] * c[k] + sign * bIm[k] * s[k];
+                double tIm = bIm[k] * c[k] - sign * bRe[k] * s[k];
+                bRe[k] = aRe[k] - tRe;
+                bIm[k] = aIm[k] - tIm;
+                aRe[k] += tRe;
+                aIm[k] += tIm;
+            }
+        }
+    }
+}
+
+void RealFFT::forward(const double* input, double* real, double* imag, double* work) const {
+    // Even samples as the real part, odd as the imaginary part of half points
+    double* re = work;
+    double* im = work + half;
+    for (int n = 0; n < half; ++n) {
+        re[reversed[n]] = input[2 * n];
+        im[reversed[n]] = input[2 * n + 1];
+    }
+    transform(re, im, false);
+
+    // Split into the spectra of the even and odd samples and recombine
+    for (int k = 0; k <= half; ++k) {
+        const int a = k % half;
+        const int b = (half - k) % half;
+        const double evenRe = 0.5 * (re[a] + re[b]);
+        const double evenIm = 0.5 * (im[a] - im[b]);
+        const double oddRe = 0.5 * (im[a] + im[b]);
+        const double oddIm = -0.5 * (re[a] - re[b]);
+        real[k] = evenRe + unpackCos[k] * oddRe + unpackSin[k] * oddIm;
+        imag[k] = evenIm + unpackCos[k] * oddIm - unpackSin[k] * oddRe;
+    }
+}
+
+void RealFFT::inverse(const double* real, const double* imag, double* output, double* work) const {
+    double* re = work;
+    double* im = work + half;
+    for (int k = 0; k < half; ++k) {
+        const int m = half - k;
+        const double evenRe = 0.5 * (real[k] + real[m]);
+        const double evenIm = 0.5 * (imag[k] - imag[m]);
+        const double diffRe = 0.5 * (real[k] - real[m]);
+        const double diffIm = 0.5 * (imag[k] + imag[m]);
+        const double oddRe = diffRe * unpackCos[k] - diffIm * unpackSin[k];
+        const double oddIm = diffRe * unpackSin[k] + diffIm * unpackCos[k];
+        re[reversed[k]] = evenRe - oddIm;
+        im[reversed[k]] = evenIm + oddRe;
+    }
+    transform(re, im, true);
+
+    const double scale = 1.0 / half;
+    for (int n = 0; n < half; ++n) {
+        output[2 * n] = re[n] * scale;
+        output[2 * n + 1] = im[n] * scale;
+    }
+}
+
+namespace fft {
+
+void multiplyAccumulate(const double* xReal, const double* xImag, const double* hReal, const double* hImag,
+                        double* accReal, double* accImag, int bins) {
+    for (int k = 0; k < bins; ++k) {
+        accReal[k] += xReal[k] * hReal[k] - xImag[k] * hImag[k];
+        accImag[k] += xReal[k] * hImag[k] + xImag[k] * hReal[k];
+    }
+}
+
+void directConvolve(const double* taps, int tapCount, const double* input, double* output, int count) {
+    // Tap by tap over the block: the inner loop runs along contiguous samples
+    std::fill(output, output + count, 0.0);
+    for (int k = 0; k < tapCount; ++k) {
+        const double tap = taps[k];
+        const double* delayed = input - k;
+        for (int n = 0; n < count; ++n) output[n] += tap * delayed[n];
+    }
+}
+
+} // namespace fft
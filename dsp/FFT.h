@@ -0,0 +1,56 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+
+// Real-input FFT of a fixed power-of-two size, for block convolution.
+//
+// Spectra are split complex: the size / 2 + 1 bins from DC to Nyquist as
+// separate real and imaginary arrays, so the products and sums over them
+// (multiplyAccumulate below) vectorize with DSP_FLAGS. The real transform
+// runs as a complex one of half the size, iterative radix-2 with each
+// stage's twiddles stored contiguously so the butterflies vectorize too.
+//
+// forward() is unnormalized and inverse() divides by the size, so
+// inverse(forward(x)) is x. Tables are built by the constructor; the
+// transforms allocate nothing and keep no state between calls, so one
+// object can be shared by threads that each pass their own buffers.
+class RealFFT {
+public:
+    explicit RealFFT(int size);
+
+    int getSize() const { return size; }
+    int getBinCount() const { return size / 2 + 1; }
+
+    // size samples in; getBinCount() bins out. work holds size doubles.
+    void forward(const double* input, double* real, double* imag, double* work) const;
+    // getBinCount() bins in (left untouched); size samples out
+    void inverse(const double* real, const double* imag, double* output, double* work) const;
+
+private:
+    int size;
+    int half;                      // Size of the complex transform
+    std::vector<int> reversed;     // Bit-reversal permutation of half
+    std::vector<double> cosines;   // Per stage, contiguous: stage with span s at s - 1
+    std::vector<double> sines;
+    std::vector<double> unpackCos; // e^(-2 pi i k / size) for the real/complex split
+    std::vector<double> unpackSin;
+
+    // In place on half points; inverse conjugates the twiddles, unscaled
+    void transform(double* re, double* im, bool inverse) const;
+};
+
+namespace fft {
+
+// accReal/accImag += (xReal, xImag) * (hReal, hImag), bin by bin
+void multiplyAccumulate(const double* xReal, const double* xImag, const double* hReal, const double* hImag,
+                        double* accReal, double* accImag, int bins);
+
+// output[n] = sum over k < tapCount of taps[k] * input[n - k], for n < count.
+// input points at the first new sample and has tapCount - 1 samples of
+// history before it.
+void directConvolve(const double* taps, int tapCount, const double* input, double* output, int count);
+
+} // namespace fft
+
+#endif // FFT_H
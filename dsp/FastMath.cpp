@@ -0,0 +1,39 @@
+#include "FastMath.h"
+
+// Plain loops over the inline kernels: no branches or libcalls in the bodies,
+// so the compiler emits packed SIMD code for them.
+namespace fastmath {
+
+void sin2piBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = sin2pi(in[i]);
+}
+
+void cos2piBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = cos2pi(in[i]);
+}
+
+void sinBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = sin(in[i]);
+}
+
+void cosBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = cos(in[i]);
+}
+
+void tanBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = tan(in[i]);
+}
+
+void expBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = exp(in[i]);
+}
+
+void logBatch(const double* in, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = log(in[i]);
+}
+
+void powBatch(const double* base, const double* exponent, double* out, int count) {
+    for (int i = 0; i < count; ++i) out[i] = pow(base[i], exponent[i]);
+}
+
+} // namespace fastmath
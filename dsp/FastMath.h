@@ -0,0 +1,182 @@
+#ifndef FASTMATH_H
+#define FASTMATH_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Polynomial approximations of the libm functions used on audio paths.
+//
+// All functions are branch-free (range reduction uses the 2^52 rounding trick
+// and bit manipulation instead of floor/ldexp) so the batch variants below
+// vectorize on both SSE2/AVX and NEON when built with DSP_FLAGS from the
+// makefile. Do not build with -ffast-math: it folds away the rounding trick.
+//
+// Documented maximum errors (checked by `./synth_bench fastmath`):
+//   sin2pi / cos2pi   absolute error < 1e-9   for |x| < 2^30 turns
+//   sin / cos         absolute error < 1e-9   for |x| < 1e6 rad
+//   tan               relative error < 1e-8   away from the poles (|cos x| > 1e-3)
+//   exp / exp2        relative error < 1e-12  for x in [-700, 700]
+//   log               absolute error < 1e-12  for normal positive x
+//   pow               relative error < 1e-10  for a > 0, |b * log(a)| < 700
+namespace fastmath {
+
+constexpr double TwoPi = 6.283185307179586476925;
+constexpr double InvTwoPi = 0.159154943091895335768;
+constexpr double Ln2 = 0.693147180559945309417;
+constexpr double Log2e = 1.442695040888963407360;
+
+constexpr double SinMaxError = 1e-9;
+constexpr double TanMaxRelError = 1e-8;
+constexpr double ExpMaxRelError = 1e-12;
+constexpr double LogMaxError = 1e-12;
+constexpr double PowMaxRelError = 1e-10;
+
+// Round to nearest integer for |x| < 2^51 without a branch or libcall
+inline double roundNearest(double x) {
+    const double magic = 6755399441055744.0; // 2^52 + 2^51
+    return (x + magic) - magic;
+}
+
+// sin(2 * pi * x), x in turns - the natural unit for oscillator phase
+inline double sin2pi(double x) {
+    double r = x - roundNearest(x);                  // [-0.5, 0.5]
+    double a = std::fabs(r);
+    double folded = 0.25 - std::fabs(0.25 - a);      // [0, 0.25], sin(pi - t) = sin(t)
+    double y = folded * TwoPi;
+    double y2 = y * y;
+
+    // Taylor series to y^13; truncation error < (pi/2)^15 / 15! ~ 7e-10
+    double p = 1.0 / 6227020800.0;
+    p = p * y2 - 1.0 / 39916800.0;
+    p = p * y2 + 1.0 / 362880.0;
+    p = p * y2 - 1.0 / 5040.0;
+    p = p * y2 + 1.0 / 120.0;
+    p = p * y2 - 1.0 / 6.0;
+    p = p * y2 + 1.0;
+    return std::copysign(y * p, r);
+}
+
+inline double cos2pi(double x) {
+    return sin2pi(x + 0.25);
+}
+
+inline double sin(double x) {
+    return sin2pi(x * InvTwoPi);
+}
+
+inline double cos(double x) {
+    return cos2pi(x * InvTwoPi);
+}
+
+inline double tan(double x) {
+    double turns = x * InvTwoPi;
+    return sin2pi(turns) / cos2pi(turns);
+}
+
+// 2^k for integral k in [-1022, 1023], built directly in the exponent bits
+inline double pow2i(double k) {
+    // Adding 2^52 lands the biased exponent in the low mantissa bits
+    double biased = k + (4503599627370496.0 + 1023.0);
+    uint64_t bits;
+    std::memcpy(&bits, &biased, sizeof(bits));
+    bits <<= 52;
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline double exp(double x) {
+    x = (x < -708.0) ? -708.0 : x;                    // Plain selects, unlike fmin/fmax
+    x = (x > 709.0) ? 709.0 : x;
+    double k = roundNearest(x * Log2e);
+    // Cody-Waite reduction with a two-part ln(2)
+    double r = x - k * 0.693147180369123816490;
+    r = r - k * 1.90821492927058770002e-10;           // |r| <= ln(2) / 2
+
+    // Taylor series to r^12; truncation error < 0.35^13 / 13! ~ 2e-16
+    double p = 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    return p * pow2i(k);
+}
+
+inline double exp2(double x) {
+    return exp(x * Ln2);
+}
+
+// Natural log for normal positive x
+inline double log(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // Exponent field converted to double through the same 2^52 trick as pow2i
+    uint64_t exponentBits = ((bits >> 52) & 0x7ff) | 0x4330000000000000ULL;
+    double e;
+    std::memcpy(&e, &exponentBits, sizeof(e));
+    e -= 4503599627370496.0 + 1023.0;
+
+    // Mantissa in [1, 2), then shifted to [sqrt(0.5), sqrt(2)) to keep the series short
+    uint64_t mantissaBits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double m;
+    std::memcpy(&m, &mantissaBits, sizeof(m));
+    double shift = (m > 1.41421356237309504880) ? 1.0 : 0.0;
+    m = m * (1.0 - 0.5 * shift);
+    e = e + shift;
+
+    // ln(m) = 2 atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double p = 1.0 / 19.0;
+    p = p * s2 + 1.0 / 17.0;
+    p = p * s2 + 1.0 / 15.0;
+    p = p * s2 + 1.0 / 13.0;
+    p = p * s2 + 1.0 / 11.0;
+    p = p * s2 + 1.0 / 9.0;
+    p = p * s2 + 1.0 / 7.0;
+    p = p * s2 + 1.0 / 5.0;
+    p = p * s2 + 1.0 / 3.0;
+    p = p * s2 + 1.0;
+    return e * Ln2 + 2.0 * s * p;
+}
+
+// a^b for a > 0
+inline double pow(double a, double b) {
+    return exp(b * log(a));
+}
+
+// Musical conversions built on the approximations above
+inline double semitonesToRatio(double semitones) {
+    return exp2(semitones * (1.0 / 12.0));
+}
+
+inline double midiToFrequency(double note) {
+    return 440.0 * semitonesToRatio(note - 69.0);
+}
+
+inline double decibelsToGain(double db) {
+    return exp(db * (2.30258509299404568402 / 20.0)); // 10^(db / 20)
+}
+
+// Batch variants: out[i] = f(in[i]). In-place use (out == in) is allowed.
+void sin2piBatch(const double* in, double* out, int count);
+void cos2piBatch(const double* in, double* out, int count);
+void sinBatch(const double* in, double* out, int count);
+void cosBatch(const double* in, double* out, int count);
+void tanBatch(const double* in, double* out, int count);
+void expBatch(const double* in, double* out, int count);
+void logBatch(const double* in, double* out, int count);
+void powBatch(const double* base, const double* exponent, double* out, int count);
+
+} // namespace fastmath
+
+#endif // FASTMATH_H
@@ -0,0 +1,21 @@
+#include "GrainKernels.h"
+#include "FastMath.h"
+
+namespace grains {
+
+void accumulate(const float* source, double position, double step, double windowStep, double gain, int first,
+                double* out, int count) {
+    const double halfGain = 0.5 * gain;
+    for (int n = 0; n < count; ++n) {
+        const double sample = first + n;
+        double at = position + sample * step;
+        int index = static_cast<int>(at);
+        double fraction = at - index;
+        double a = source[index];
+        double b = source[index + 1];
+        double envelope = halfGain - halfGain * fastmath::cos2pi(sample * windowStep);
+        out[n] += envelope * (a + fraction * (b - a));
+    }
+}
+
+} // namespace grains
@@ -0,0 +1,22 @@
+#ifndef GRAINKERNELS_H
+#define GRAINKERNELS_H
+
+// Grain rendering for GranularOscillator: one grain over a stretch of the
+// output block. Each output sample is computed from its index alone (no
+// running phase), so the loop has no carried dependency and vectorizes with
+// DSP_FLAGS: the Hann window comes from fastmath::cos2pi and the source is
+// read with linear interpolation through a gather.
+namespace grains {
+
+// Samples first to first + count of a grain starting at source frame
+// position: out[n] += gain * hann((first + n) * windowStep) *
+// source(position + (first + n) * step). Computed from the grain's start, so
+// a grain rendered in pieces matches one rendered whole. The window runs
+// over [0, 1) across the grain; the source is read between frames and must
+// hold every frame the grain reaches plus one.
+void accumulate(const float* source, double position, double step, double windowStep, double gain, int first,
+                double* out, int count);
+
+} // namespace grains
+
+#endif // GRAINKERNELS_H
@@ -0,0 +1,155 @@
+#include "Resampler.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// Stopband attenuation of about 80 dB
+constexpr double KaiserBeta = 8.0;
+// Cutoff as a share of the lower Nyquist frequency; the transition band ends near it
+constexpr double Rolloff = 0.91;
+
+// Zeroth-order modified Bessel function of the first kind (power series)
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-17) break;
+    }
+    return sum;
+}
+
+// Best up/down pair for outputRate / inputRate with up <= maxUp, from the
+// continued fraction convergents
+void approximateRatio(long long outputRate, long long inputRate, int maxUp, int& up, int& down) {
+    long long h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+    long long numerator = outputRate, denominator = inputRate;
+    up = 1;
+    down = std::max<long long>(1, inputRate / std::max<long long>(1, outputRate));
+    while (denominator != 0) {
+        long long a = numerator / denominator;
+        long long h2 = a * h1 + h0, k2 = a * k1 + k0;
+        if (h2 > maxUp || k2 > maxUp * 64LL) break;
+        up = static_cast<int>(h2);
+        down = static_cast<int>(k2);
+        h0 = h1; h1 = h2; k0 = k1; k1 = k2;
+        long long remainder = numerator - a * denominator;
+        numerator = denominator;
+        denominator = remainder;
+    }
+}
+
+// One output sample of one phase
+float dotProduct(const float* window, const float* phaseCoeffs) {
+    float lanes[Resampler::Lanes] = {};
+    for (int i = 0; i < Resampler::Taps; i += Resampler::Lanes) {
+        for (int l = 0; l < Resampler::Lanes; ++l) lanes[l] += window[i + l] * phaseCoeffs[i + l];
+    }
+    float sum = 0.0f;
+    for (int l = 0; l < Resampler::Lanes; ++l) sum += lanes[l];
+    return sum;
+}
+
+} // namespace
+
+Resampler::Resampler(double inputRate, double outputRate, int channels) : channels(std::max(1, channels)) {
+    long long inputHz = std::max(1LL, std::llround(inputRate));
+    long long outputHz = std::max(1LL, std::llround(outputRate));
+    long long divisor = std::gcd(inputHz, outputHz);
+    if (outputHz / divisor <= MaxPhases) {
+        up = static_cast<int>(outputHz / divisor);
+        down = static_cast<int>(inputHz / divisor);
+    } else {
+        approximateRatio(outputHz, inputHz, MaxPhases, up, down);
+        LOG_WARNING("⚠️ Resampler: %lld -> %lld Hz approximated as %d/%d (%.3f cents)", inputHz, outputHz, up, down,
+                    1200.0 * std::log2((static_cast<double>(up) / down) / (static_cast<double>(outputHz) / inputHz)));
+    }
+
+    coeffs.resize(static_cast<size_t>(up) * Taps);
+    line.assign(static_cast<size_t>(this->channels) * (Taps + MaxInputFrames), 0.0f);
+    designCoefficients();
+}
+
+void Resampler::designCoefficients() {
+    // Prototype of Taps * L coefficients at L times the input rate
+    const int length = Taps * up;
+    const double centre = (length - 1) / 2.0;
+    const double cutoff = 0.5 * std::min(1.0, static_cast<double>(up) / down) * Rolloff / up;
+    const double windowNorm = besselI0(KaiserBeta);
+
+    std::vector<double> prototype(length);
+    for (int i = 0; i < length; ++i) {
+        double offset = i - centre;
+        double x = 2.0 * M_PI * cutoff * offset;
+        double sinc = (offset == 0.0) ? 1.0 : std::sin(x) / x;
+        double r = offset / (centre + 0.5);
+        double window = besselI0(KaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+        prototype[i] = sinc * window;
+    }
+
+    // Phase p takes every L-th coefficient from p; normalize each to unity DC gain
+    for (int p = 0; p < up; ++p) {
+        double sum = 0.0;
+        for (int j = 0; j < Taps; ++j) sum += prototype[p + j * up];
+        float* phaseCoeffs = &coeffs[static_cast<size_t>(p) * Taps];
+        for (int j = 0; j < Taps; ++j) {
+            phaseCoeffs[Taps - 1 - j] = static_cast<float>(prototype[p + j * up] / sum);
+        }
+    }
+}
+
+int Resampler::inputFramesNeeded(int outputFrames) const {
+    return static_cast<int>((phase + static_cast<long long>(outputFrames) * down) / up);
+}
+
+int Resampler::maxOutputFrames() const {
+    return std::max(1, static_cast<int>((static_cast<long long>(MaxInputFrames) * up - phase) / down));
+}
+
+void Resampler::process(const float* input, int inputFrames, float* output, int outputFrames) {
+    inputFrames = std::min(inputFrames, MaxInputFrames);
+    const int stride = Taps + MaxInputFrames;
+    if (channels == 1) {
+        std::memcpy(line.data() + Taps, input, sizeof(float) * inputFrames);
+    } else {
+        for (int c = 0; c < channels; ++c) {
+            float* channelLine = line.data() + c * stride + Taps;
+            for (int n = 0; n < inputFrames; ++n) channelLine[n] = input[n * channels + c];
+        }
+    }
+
+    // Advance, then filter: the window holds the Taps most recent input frames
+    int consumed = 0;
+    for (int k = 0; k < outputFrames; ++k) {
+        phase += down;
+        consumed += phase / up;
+        phase %= up;
+
+        const float* phaseCoeffs = coeffs.data() + static_cast<size_t>(phase) * Taps;
+        for (int c = 0; c < channels; ++c) {
+            output[k * channels + c] = dotProduct(line.data() + c * stride + consumed, phaseCoeffs);
+        }
+    }
+
+    // Keep the last Taps frames as history for the next call
+    for (int c = 0; c < channels; ++c) {
+        float* channelLine = line.data() + c * stride;
+        std::memmove(channelLine, channelLine + inputFrames, sizeof(float) * Taps);
+    }
+}
+
+double Resampler::getLatency() const {
+    // Output k is the filtered zero-stuffed signal at (k + 1) * M - L, delayed
+    // by the prototype's centre
+    return 1.0 - static_cast<double>(down) / up + (Taps * up - 1) / (2.0 * up);
+}
+
+void Resampler::reset() {
+    std::fill(line.begin(), line.end(), 0.0f);
+    phase = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <vector>
+
+// Polyphase windowed-sinc sample-rate converter for a fixed ratio.
+//
+// The ratio is reduced to up/down factors L/M (44.1 -> 48 kHz is 160/147).
+// Conceptually the input is zero-stuffed to L times its rate, low-passed
+// below the lower of the two Nyquist frequencies and kept every M-th sample;
+// the polyphase form only evaluates the Taps coefficients of the one phase
+// each output sample needs. The prototype is a Kaiser-windowed sinc, and each
+// phase is normalized to unity DC gain so the gain does not ripple with the
+// phase.
+//
+// Frames are interleaved; each channel keeps its own history line and all
+// of them share the phase. Like the DSP kernels, the dot product is written
+// in vertical lanes so the compiler vectorizes it with DSP_FLAGS (see the
+// makefile).
+class Resampler {
+public:
+    static constexpr int Taps = 64;            // Per phase, a multiple of Lanes
+    static constexpr int Lanes = 8;
+    static constexpr int MaxPhases = 1024;     // Larger L are approximated
+    static constexpr int MaxInputFrames = 2048; // Per process() call
+
+    Resampler(double inputRate, double outputRate, int channels = 1);
+
+    int getUpFactor() const { return up; }
+    int getDownFactor() const { return down; }
+    int getChannelCount() const { return channels; }
+
+    // Input frames the next outputFrames output frames consume
+    int inputFramesNeeded(int outputFrames) const;
+    // Largest output count whose input fits in one process() call
+    int maxOutputFrames() const;
+
+    // input must hold exactly inputFramesNeeded(outputFrames) frames
+    void process(const float* input, int inputFrames, float* output, int outputFrames);
+
+    // Output frame k sits at input time k * M / L - getLatency()
+    double getLatency() const;
+
+    void reset();
+
+private:
+    int up;
+    int down;
+    int channels;
+    int phase = 0;                  // Position between input frames, in 1/L steps
+    std::vector<float> coeffs;      // [phase][tap], taps reversed to match the window
+    std::vector<float> line;        // Per channel: Taps frames of history, then the new input
+
+    void designCoefficients();
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,275 @@
+#include "VoiceLanes.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <climits>
+
+namespace voicelanes {
+
+namespace {
+constexpr int Forever = INT_MAX / 2;  // Stage length for Sustain/Idle
+}
+
+// -----------------------------------------------------------------------------
+// Lane state
+// -----------------------------------------------------------------------------
+void OscillatorLanes::setFrequency(int lane, double frequency, double sampleRate) {
+    increment[lane] = frequency / sampleRate;
+}
+
+void BiquadLanes::setLowPass(int lane, double cutoff, double q, double sampleRate) {
+    cutoff = std::max(1.0, std::min(cutoff, sampleRate * 0.45));
+    q = std::max(0.1, std::min(q, 10.0));
+
+    double turns = cutoff / sampleRate;
+    double cosOmega = fastmath::cos2pi(turns);
+    double alpha = fastmath::sin2pi(turns) / (2.0 * q);
+    double norm = 1.0 + alpha;
+
+    b0[lane] = (1.0 - cosOmega) / 2.0 / norm;
+    b1[lane] = (1.0 - cosOmega) / norm;
+    b2[lane] = (1.0 - cosOmega) / 2.0 / norm;
+    a1[lane] = -2.0 * cosOmega / norm;
+    a2[lane] = (1.0 - alpha) / norm;
+}
+
+void BiquadLanes::setBandPass(int lane, double centre, double bandwidth, double sampleRate) {
+    centre = std::max(1.0, std::min(centre, sampleRate * 0.45));
+    bandwidth = std::max(1.0, std::min(bandwidth, sampleRate * 0.4));
+    double q = std::max(0.1, std::min(centre / bandwidth, 30.0));
+
+    double turns = centre / sampleRate;
+    double cosOmega = fastmath::cos2pi(turns);
+    double alpha = fastmath::sin2pi(turns) / (2.0 * q);
+    double norm = 1.0 + alpha;
+
+    b0[lane] = alpha / norm;
+    b1[lane] = 0.0;
+    b2[lane] = -alpha / norm;
+    a1[lane] = -2.0 * cosOmega / norm;
+    a2[lane] = (1.0 - alpha) / norm;
+}
+
+void BiquadLanes::reset(int lane) {
+    x1[lane] = x2[lane] = y1[lane] = y2[lane] = 0.0;
+}
+
+void EnvelopeLanes::noteOn(int lane) {
+    enterStage(lane, Attack);
+}
+
+void EnvelopeLanes::noteOff(int lane) {
+    enterStage(lane, Release);
+}
+
+void EnvelopeLanes::refreshSustain() {
+    for (int l = 0; l < MaxLanes; ++l) {
+        if (stage[l] == Sustain) value[l] = sustain / 100.0;
+    }
+}
+
+void EnvelopeLanes::setSampleRate(double rate) {
+    double ratio = rate / sampleRate;
+    sampleRate = rate;
+    for (int l = 0; l < MaxLanes; ++l) {
+        if (stage[l] == Idle || stage[l] == Sustain || remaining[l] >= Forever) continue;
+        int length = std::max(1, static_cast<int>(remaining[l] * ratio + 0.5));
+        slope[l] *= static_cast<double>(remaining[l]) / length;
+        remaining[l] = length;
+    }
+}
+
+void EnvelopeLanes::enterStage(int lane, Stage newStage) {
+    // Same stage lengths and shapes as Envelope::enterStage / Envelope::nextSample
+    double sustainNorm = sustain / 100.0;
+    double start = 0.0;
+    double delta = 0.0;
+    int length = Forever;
+
+    auto stageLength = [this](double ms) {
+        return static_cast<int>((ms / 1000.0) * sampleRate);
+    };
+
+    switch (newStage) {
+        case Attack: {
+            int n = stageLength(attack);
+            start = (n > 0) ? 0.0 : 1.0;
+            delta = (n > 0) ? 1.0 / n : 0.0;
+            length = std::max(n, 1);
+            break;
+        }
+        case Decay: {
+            int n = stageLength(decay);
+            start = (n > 0) ? 1.0 : sustainNorm;
+            delta = (n > 0) ? (sustainNorm - 1.0) / n : 0.0;
+            length = std::max(n, 1);
+            break;
+        }
+        case Sustain:
+            start = sustainNorm;
+            break;
+        case Release: {
+            int n = stageLength(release);
+            double releaseStart = value[lane];
+            start = (n > 0) ? releaseStart : 0.0;
+            delta = (n > 0) ? -releaseStart / n : 0.0;
+            length = std::max(n, 1);
+            break;
+        }
+        case Idle:
+            break;
+    }
+
+    stage[lane] = newStage;
+    slope[lane] = delta;
+    value[lane] = start - delta;  // The first rendered sample adds slope back
+    remaining[lane] = length;
+}
+
+// -----------------------------------------------------------------------------
+// Kernels
+// -----------------------------------------------------------------------------
+// Each kernel copies the lane state into locals first: with the state out of
+// reach of the block stores the compiler can keep it in vector registers and
+// turn every inner lane loop into packed instructions.
+template <int Width>
+void renderSine(OscillatorLanes& osc, LaneBlock& out, int count) {
+    double phase[Width], increment[Width];
+    std::copy(osc.phase, osc.phase + Width, phase);
+    std::copy(osc.increment, osc.increment + Width, increment);
+
+    for (int n = 0; n < count; ++n) {
+        for (int l = 0; l < Width; ++l) {
+            out[n][l] = fastmath::sin2pi(phase[l]);
+            double next = phase[l] + increment[l];
+            phase[l] = (next >= 1.0) ? next - 1.0 : next;
+        }
+    }
+
+    std::copy(phase, phase + Width, osc.phase);
+}
+
+template <int Width>
+void renderSaw(OscillatorLanes& osc, LaneBlock& out, int count) {
+    double phase[Width], increment[Width];
+    std::copy(osc.phase, osc.phase + Width, phase);
+    std::copy(osc.increment, osc.increment + Width, increment);
+
+    for (int n = 0; n < count; ++n) {
+        for (int l = 0; l < Width; ++l) {
+            out[n][l] = 2.0 * phase[l] - 1.0;
+            double next = phase[l] + increment[l];
+            phase[l] = (next >= 1.0) ? next - 1.0 : next;
+        }
+    }
+
+    std::copy(phase, phase + Width, osc.phase);
+}
+
+template <int Width>
+void processBiquad(BiquadLanes& f, LaneBlock& io, int count) {
+    double b0[Width], b1[Width], b2[Width], a1[Width], a2[Width];
+    double x1[Width], x2[Width], y1[Width], y2[Width];
+    std::copy(f.b0, f.b0 + Width, b0);
+    std::copy(f.b1, f.b1 + Width, b1);
+    std::copy(f.b2, f.b2 + Width, b2);
+    std::copy(f.a1, f.a1 + Width, a1);
+    std::copy(f.a2, f.a2 + Width, a2);
+    std::copy(f.x1, f.x1 + Width, x1);
+    std::copy(f.x2, f.x2 + Width, x2);
+    std::copy(f.y1, f.y1 + Width, y1);
+    std::copy(f.y2, f.y2 + Width, y2);
+
+    for (int n = 0; n < count; ++n) {
+        for (int l = 0; l < Width; ++l) {
+            double input = io[n][l];
+            double output = b0[l] * input + b1[l] * x1[l] + b2[l] * x2[l]
+                          - a1[l] * y1[l] - a2[l] * y2[l];
+            x2[l] = x1[l];
+            x1[l] = input;
+            y2[l] = y1[l];
+            y1[l] = output;
+            io[n][l] = output;
+        }
+    }
+
+    std::copy(x1, x1 + Width, f.x1);
+    std::copy(x2, x2 + Width, f.x2);
+    std::copy(y1, y1 + Width, f.y1);
+    std::copy(y2, y2 + Width, f.y2);
+}
+
+template <int Width>
+void applyEnvelope(EnvelopeLanes& env, LaneBlock& io, int count) {
+    int position = 0;
+    while (position < count) {
+        // Render up to the next stage boundary of any lane without branching
+        int steps = count - position;
+        for (int l = 0; l < Width; ++l) {
+            steps = std::min(steps, env.remaining[l]);
+        }
+
+        double value[Width], slope[Width];
+        std::copy(env.value, env.value + Width, value);
+        std::copy(env.slope, env.slope + Width, slope);
+        for (int n = position; n < position + steps; ++n) {
+            for (int l = 0; l < Width; ++l) {
+                value[l] += slope[l];
+                io[n][l] *= value[l];
+            }
+        }
+        std::copy(value, value + Width, env.value);
+        position += steps;
+
+        for (int l = 0; l < Width; ++l) {
+            env.remaining[l] -= steps;
+            if (env.remaining[l] > 0) continue;
+            switch (env.stage[l]) {
+                case EnvelopeLanes::Attack:  env.enterStage(l, EnvelopeLanes::Decay); break;
+                case EnvelopeLanes::Decay:   env.enterStage(l, EnvelopeLanes::Sustain); break;
+                case EnvelopeLanes::Release: env.enterStage(l, EnvelopeLanes::Idle); break;
+                default:                     env.remaining[l] = Forever; break;
+            }
+        }
+    }
+}
+
+template <int Width>
+void mixLanes(const LaneBlock& in, double* out, int count, double gain) {
+    for (int n = 0; n < count; ++n) {
+        double sum = 0.0;
+        for (int l = 0; l < Width; ++l) {
+            sum += in[n][l];
+        }
+        out[n] = sum * gain;
+    }
+}
+
+template <int Width>
+void mixLanesStereo(const LaneBlock& in, const double* leftGains, const double* rightGains,
+                    double* left, double* right, int count, double gain) {
+    for (int n = 0; n < count; ++n) {
+        double leftSum = 0.0;
+        double rightSum = 0.0;
+        for (int l = 0; l < Width; ++l) {
+            leftSum += in[n][l] * leftGains[l];
+            rightSum += in[n][l] * rightGains[l];
+        }
+        left[n] = leftSum * gain;
+        right[n] = rightSum * gain;
+    }
+}
+
+template void renderSine<4>(OscillatorLanes&, LaneBlock&, int);
+template void renderSine<8>(OscillatorLanes&, LaneBlock&, int);
+template void renderSaw<4>(OscillatorLanes&, LaneBlock&, int);
+template void renderSaw<8>(OscillatorLanes&, LaneBlock&, int);
+template void processBiquad<4>(BiquadLanes&, LaneBlock&, int);
+template void processBiquad<8>(BiquadLanes&, LaneBlock&, int);
+template void applyEnvelope<4>(EnvelopeLanes&, LaneBlock&, int);
+template void applyEnvelope<8>(EnvelopeLanes&, LaneBlock&, int);
+template void mixLanes<4>(const LaneBlock&, double*, int, double);
+template void mixLanes<8>(const LaneBlock&, double*, int, double);
+template void mixLanesStereo<4>(const LaneBlock&, const double*, const double*, double*, double*, int, double);
+template void mixLanesStereo<8>(const LaneBlock&, const double*, const double*, double*, double*, int, double);
+
+} // namespace voicelanes
@@ -0,0 +1,85 @@
+#ifndef VOICELANES_H
+#define VOICELANES_H
+
+// Vertical SIMD building blocks: the state of up to MaxLanes voices of one
+// patch is stored structure-of-arrays, and every kernel loops over lanes in
+// its innermost loop so one vector instruction advances 4 or 8 voices at once.
+//
+// Block buffers are sample-major: block[n][lane]. Kernels are templated on
+// the active width (4 or 8) so a patch with few voices only pays for half the
+// vector. Sine/Saw/biquad/ADSR behaviour matches SineOscillator, SawOscillator,
+// LowPassFilter/BandPassFilter and Envelope sample for sample.
+namespace voicelanes {
+
+constexpr int MaxLanes = 8;
+constexpr int ChunkSize = 32;
+
+using LaneBlock = double[ChunkSize][MaxLanes];
+
+struct OscillatorLanes {
+    alignas(64) double phase[MaxLanes] = {};
+    alignas(64) double increment[MaxLanes] = {};
+
+    void setFrequency(int lane, double frequency, double sampleRate);
+    void resetPhase(int lane) { phase[lane] = 0.0; }
+};
+
+struct BiquadLanes {
+    alignas(64) double b0[MaxLanes] = {};
+    alignas(64) double b1[MaxLanes] = {};
+    alignas(64) double b2[MaxLanes] = {};
+    alignas(64) double a1[MaxLanes] = {};
+    alignas(64) double a2[MaxLanes] = {};
+    alignas(64) double x1[MaxLanes] = {};
+    alignas(64) double x2[MaxLanes] = {};
+    alignas(64) double y1[MaxLanes] = {};
+    alignas(64) double y2[MaxLanes] = {};
+
+    // Same RBJ designs (and clamping) as LowPassFilter / BandPassFilter
+    void setLowPass(int lane, double cutoff, double q, double sampleRate);
+    void setBandPass(int lane, double centre, double bandwidth, double sampleRate);
+    void reset(int lane);
+};
+
+struct EnvelopeLanes {
+    enum Stage { Idle, Attack, Decay, Sustain, Release };
+
+    // Shared ADSR settings for every lane (ms, ms, percent, ms) - same units as Envelope
+    double attack = 10.0;
+    double decay = 100.0;
+    double sustain = 70.0;
+    double release = 200.0;
+    double sampleRate = 44100.0;
+
+    // value holds the last emitted level; each sample adds slope first
+    alignas(64) double value[MaxLanes] = {};
+    alignas(64) double slope[MaxLanes] = {};
+    int remaining[MaxLanes] = {};  // Samples left in the current stage
+    Stage stage[MaxLanes] = {};
+
+    void noteOn(int lane);
+    void noteOff(int lane);
+    bool isActive(int lane) const { return stage[lane] != Idle; }
+
+    // Envelope reads sustain every sample; lanes already sustaining pick up a new level here
+    void refreshSustain();
+
+    // Stages in progress keep their level and remaining time in ms
+    void setSampleRate(double rate);
+
+    void enterStage(int lane, Stage newStage);
+};
+
+// Kernels - Width is 4 or 8
+template <int Width> void renderSine(OscillatorLanes& osc, LaneBlock& out, int count);
+template <int Width> void renderSaw(OscillatorLanes& osc, LaneBlock& out, int count);
+template <int Width> void processBiquad(BiquadLanes& filter, LaneBlock& io, int count);
+template <int Width> void applyEnvelope(EnvelopeLanes& env, LaneBlock& io, int count);
+template <int Width> void mixLanes(const LaneBlock& in, double* out, int count, double gain);
+// Each lane weighted by its own left/right pan gain
+template <int Width> void mixLanesStereo(const LaneBlock& in, const double* leftGains, const double* rightGains,
+                                         double* left, double* right, int count, double gain);
+
+} // namespace voicelanes
+
+#endif // VOICELANES_H
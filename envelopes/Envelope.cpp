@@ -22,6 +22,13 @@ void Envelope::noteOff() {
     enterStage(Release);
 }
 
+void Envelope::setSampleRate(double rate) {
+    double progress = stageSampleCount > 0 ? static_cast<double>(samplesInStage) / stageSampleCount : 0.0;
+    sampleRate = rate;
+    enterStage(state);  // Recounts the stage at the new rate
+    samplesInStage = static_cast<int>(progress * stageSampleCount);
+}
+
 void Envelope::enterStage(State newState) {
     state = newState;
     samplesInStage = 0;
@@ -1,15 +1,31 @@
 #pragma once
 
+#include <cstddef>
+#include <new>
+#include "../core/PatchArena.h"
+
 class Envelope {
 public:
     Envelope(double sampleRate = 44100.0);
 
+    // Placed in the active PatchArena, if any; see PatchArena::Scope
+    static void* operator new(std::size_t size) { return PatchArena::allocateObject(size, alignof(std::max_align_t)); }
+    static void* operator new(std::size_t size, std::align_val_t alignment) {
+        return PatchArena::allocateObject(size, static_cast<std::size_t>(alignment));
+    }
+    static void operator delete(void* object) { PatchArena::releaseObject(object); }
+    static void operator delete(void* object, std::align_val_t) { PatchArena::releaseObject(object); }
+
     // Attack, Decay, Release in ms; Sustain in percent (0-100)
     void setADSR(double attack, double decay, double sustain, double release);
 
     void noteOn();
     void noteOff();
 
+    // A stage in progress keeps its position; its remaining time in ms is unchanged
+    void setSampleRate(double rate);
+    double getSampleRate() const { return sampleRate; }
+
     double nextSample();
 
     // For parameter registration (attack/decay/release in ms, sustain in percent)
@@ -1,6 +1,7 @@
 #include "BandPassFilter.h"
 #include "../interface/LiveController.h"
-#include <iostream>
+#include "../dsp/FastMath.h"
+#include "../core/Logger.h"
 #include <cmath>
 #include <algorithm>
 
@@ -38,15 +39,15 @@ void BandPassFilter::setBandwidth(double bw) {
 
 void BandPassFilter::updateCoefficients() {
     // Calculate normalized frequency and Q factor
-    double omega = 2.0 * M_PI * targetFrequency / sampleRate;
+    double turns = targetFrequency / sampleRate;  // omega / (2 * pi)
     double Q = targetFrequency / bandwidth;
     
     // Limit Q to prevent instability
     Q = std::max(0.1, std::min(Q, 30.0));
     
     // Calculate filter coefficients for band-pass filter
-    double cosOmega = cos(omega);
-    double sinOmega = sin(omega);
+    double cosOmega = fastmath::cos2pi(turns);
+    double sinOmega = fastmath::sin2pi(turns);
     double alpha = sinOmega / (2.0 * Q);
     
     // Normalize coefficients
@@ -66,24 +67,45 @@ void BandPassFilter::reset() {
     x1 = x2 = y1 = y2 = 0.0;
 }
 
+void BandPassFilter::saveState(double* state) const {
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+}
+
+void BandPassFilter::restoreState(const double* state) {
+    x1 = state[0];
+    x2 = state[1];
+    y1 = state[2];
+    y2 = state[3];
+}
+
+void BandPassFilter::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    setTargetFrequency(targetFrequency); // Re-clamps to the new Nyquist and updates coefficients
+}
+
 void BandPassFilter::registerParameters(LiveController& controller) {
     registerParametersWithPrefix(controller, getTypeName());
 }
 
 void BandPassFilter::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering filter parameters..." << std::endl;
+    LOG_DEBUG("🎛️ %s registering filter parameters...", prefix.c_str());
     
     // Register target frequency parameter
     addParameterWithPrefix(controller, prefix, "Target Freq", &targetFrequency, 
                           20.0, 8000.0, 50.0,
                           [this]() {
                               setTargetFrequency(targetFrequency);
-                          });
+                          },
+                          {"Hz"});
 
     // Register bandwidth parameter
     addParameterWithPrefix(controller, prefix, "Bandwidth", &bandwidth, 
                           10.0, 2000.0, 200.0,
                           [this]() {
                               setBandwidth(bandwidth);
-                          });
+                          },
+                          {"Hz"});
 }
@@ -23,6 +23,12 @@ public:
     
     // Reset filter state
     void reset() override;
+    int getStateSize() const override { return 4; }
+    void saveState(double* state) const override;
+    void restoreState(const double* state) override;
+
+    // Recomputes coefficients for the new rate
+    void setSampleRate(double rate) override;
 
 private:
     // Filter parameters
@@ -0,0 +1,440 @@
+#include "ConvolutionFilter.h"
+#include "../interface/LiveController.h"
+#include "../oscillators/SampleFile.h"
+#include "../dsp/Resampler.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int MaxSegmentBlock = 1 << 15;        // Later segments just grow longer
+constexpr long long MaxImpulseFrames = 1 << 22; // About 95 s at 44.1 kHz
+
+int nextPowerOfTwo(long long value) {
+    int power = 1;
+    while (power < value) power <<= 1;
+    return power;
+}
+
+long long nanosSince(Clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+}
+
+// Through the output-stage resampler, skipping its delay; taps past the end
+// read as silence and flush it
+std::vector<double> resampleImpulse(const std::vector<double>& impulse, double from, double to) {
+    const double ratio = to / from;
+    Resampler resampler(from, to, 1);
+    const long long frames = static_cast<long long>(impulse.size());
+    const long long skip = std::llround(resampler.getLatency() * ratio);
+    const long long total = static_cast<long long>(std::ceil(frames * ratio)) + skip;
+    std::vector<float> input(Resampler::MaxInputFrames), output(resampler.maxOutputFrames());
+    std::vector<double> resampled;
+    resampled.reserve(static_cast<size_t>(total - skip));
+    long long read = 0;
+    for (long long done = 0; done < total;) {
+        const int count = static_cast<int>(std::min<long long>(resampler.maxOutputFrames(), total - done));
+        const int needed = resampler.inputFramesNeeded(count);
+        for (int n = 0; n < needed; ++n) {
+            input[n] = (read + n < frames) ? static_cast<float>(impulse[read + n]) : 0.0f;
+        }
+        resampler.process(input.data(), needed, output.data(), count);
+        for (int n = 0; n < count; ++n) {
+            if (done + n >= skip) resampled.push_back(output[n]);
+        }
+        read += needed;
+        done += count;
+    }
+    return resampled;
+}
+
+} // namespace
+
+ConvolutionFilter::ConvolutionFilter(std::vector<double> impulse, double impulseRate, double sampleRate,
+                                     const Options& settings)
+    : Filter(sampleRate), options(settings), source(std::move(impulse)), sourceRate(impulseRate),
+      requestedRate(sampleRate), builtRate(sampleRate), laneSelector(settings.lanes) {
+    options.headTaps = nextPowerOfTwo(std::clamp(options.headTaps, 16, 4096));
+    options.lanes = laneSelector.getCount();
+    if (source.empty()) source.push_back(1.0);
+    kernel.store(buildKernel(sampleRate).release());
+
+    const Kernel& built = current();
+    int background = 0;
+    for (const auto& segment : built.segments) background += segment->background ? 1 : 0;
+    LOG_INFO("🏛️ Convolution: %lld taps, %d direct + %d segments (%d in background), %d lane(s)", built.impulseLength,
+             static_cast<int>(built.headTaps.size()), static_cast<int>(built.segments.size()), background,
+             options.lanes);
+    // Also attached without background segments: the worker rebuilds the
+    // response when the rate changes
+    ConvolutionWorker::instance().attach(this);
+}
+
+ConvolutionFilter::~ConvolutionFilter() {
+    ConvolutionWorker::instance().detach(this);
+    delete kernel.load();
+    delete prepared.load();
+    delete retired.load();
+}
+
+std::unique_ptr<ConvolutionFilter::Kernel> ConvolutionFilter::buildKernel(double rate) const {
+    auto built = std::make_unique<Kernel>();
+    built->sampleRate = rate;
+    std::vector<double> impulse = (rate == sourceRate) ? source : resampleImpulse(source, sourceRate, rate);
+    if (impulse.empty()) impulse.push_back(1.0);
+    const long long impulseLength = static_cast<long long>(impulse.size());
+    built->impulseLength = impulseLength;
+
+    if (options.normalize) {
+        double energy = 0.0;
+        for (double tap : impulse) energy += tap * tap;
+        if (energy > 0.0) {
+            const double scale = 1.0 / std::sqrt(energy);
+            for (double& tap : impulse) tap *= scale;
+        }
+    }
+
+    const int head = options.headTaps;
+    built->headTaps.assign(impulse.begin(), impulse.begin() + std::min<long long>(head, impulseLength));
+
+    // Block sizes head, 16 * head, then 8 times larger; a segment with block
+    // B starts at tap 2 * B, so its output is due a block after its input
+    std::vector<std::unique_ptr<Segment>>& segments = built->segments;
+    long long start = head;
+    int block = head;
+    bool background = false;
+    while (start < impulseLength) {
+        long long end = impulseLength;
+        int next = block;
+        if (!options.uniform && block < MaxSegmentBlock) {
+            next = std::min(MaxSegmentBlock, background ? 8 * block : 16 * block);
+            end = std::min(impulseLength, 2LL * next);
+        }
+        const int partitions = static_cast<int>((end - start + block - 1) / block);
+        segments.push_back(std::make_unique<Segment>(block, start, partitions, background));
+        start = end;
+        block = next;
+        background = true;
+    }
+
+    // Each partition's taps, zero-padded to the transform size
+    for (auto& segment : segments) {
+        const int size = 2 * segment->blockSize;
+        std::vector<double> taps(size), work(size);
+        segment->real.assign(static_cast<size_t>(segment->partitions) * segment->bins, 0.0);
+        segment->imag.assign(segment->real.size(), 0.0);
+        for (int p = 0; p < segment->partitions; ++p) {
+            std::fill(taps.begin(), taps.end(), 0.0);
+            const long long first = segment->start + static_cast<long long>(p) * segment->blockSize;
+            const long long last = std::min(impulseLength, first + segment->blockSize);
+            std::copy(impulse.begin() + first, impulse.begin() + last, taps.begin());
+            const size_t offset = static_cast<size_t>(p) * segment->bins;
+            segment->fft.forward(taps.data(), segment->real.data() + offset, segment->imag.data() + offset, work.data());
+        }
+    }
+
+    // Every lane gets its own history for the head and each segment
+    int largestBlock = head;
+    for (const auto& segment : segments) largestBlock = std::max(largestBlock, segment->blockSize);
+    const int ringSize = 2 * largestBlock;
+    built->ringMask = ringSize - 1;
+    for (int l = 0; l < options.lanes; ++l) {
+        auto target = std::make_unique<Lane>();
+        target->recent.assign(2 * head - 1, 0.0);
+        target->head.assign(head, 0.0);
+        target->inputRing.assign(ringSize, 0.0);
+        target->outputRing.assign(ringSize, 0.0);
+        for (const auto& segment : segments) {
+            auto state = std::make_unique<SegmentState>();
+            const int size = segment->blockSize;
+            state->input.assign(size, 0.0);
+            state->window.assign(2 * size, 0.0);
+            state->spectraReal.assign(static_cast<size_t>(segment->partitions) * segment->bins, 0.0);
+            state->spectraImag.assign(state->spectraReal.size(), 0.0);
+            state->accReal.assign(segment->bins, 0.0);
+            state->accImag.assign(segment->bins, 0.0);
+            state->work.assign(2 * size, 0.0);
+            state->result.assign(2 * size, 0.0);
+            target->states.push_back(std::move(state));
+        }
+        built->lanes.push_back(std::move(target));
+    }
+    return built;
+}
+
+std::unique_ptr<ConvolutionFilter> ConvolutionFilter::load(const std::string& path, double sampleRate,
+                                                           const Options& options) {
+    auto file = SampleFile::open(path, 0);
+    if (!file) return nullptr;
+    long long frames = file->getFrameCount();
+    if (frames > MaxImpulseFrames) {
+        LOG_WARNING("⚠️ Convolution: '%s' truncated to %lld frames", path.c_str(), MaxImpulseFrames);
+        frames = MaxImpulseFrames;
+    }
+
+    // Kept at the file's rate, so a later rate change resamples from it
+    std::vector<float> decoded(static_cast<size_t>(frames));
+    file->decode(0, static_cast<int>(frames), decoded.data());
+    std::vector<double> impulse(decoded.begin(), decoded.end());
+    if (file->getSampleRate() != sampleRate) {
+        LOG_INFO("🏛️ Convolution: '%s' resampled from %.0f to %.0f Hz", path.c_str(), file->getSampleRate(), sampleRate);
+    }
+    return std::make_unique<ConvolutionFilter>(std::move(impulse), file->getSampleRate(), sampleRate, options);
+}
+
+double ConvolutionFilter::processSample(double input) {
+    processBuffer(&input, 1);
+    return input;
+}
+
+void ConvolutionFilter::processBuffer(double* buffer, int numSamples) {
+    const auto begin = Clock::now();
+    // A response rebuilt for a new rate takes over between blocks, once the
+    // worker has freed the previous one it replaced
+    if (!retired.load(std::memory_order_acquire)) {
+        if (Kernel* next = prepared.exchange(nullptr, std::memory_order_acq_rel)) {
+            retired.store(kernel.exchange(next, std::memory_order_acq_rel), std::memory_order_release);
+        }
+    }
+    Kernel& active = *kernel.load(std::memory_order_relaxed);
+    processLane(active, *active.lanes[laneSelector.getCurrent()], buffer, numSamples);
+    samplesProcessed.fetch_add(numSamples, std::memory_order_relaxed);
+    audioNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+}
+
+void ConvolutionFilter::processLane(Kernel& active, Lane& target, double* buffer, int numSamples) {
+    const int head = options.headTaps;
+    const long long ringMask = active.ringMask;
+    const int tapCount = static_cast<int>(active.headTaps.size());
+    const double wetGain = mix * 0.01 * std::pow(10.0, level / 20.0);
+    const double dryGain = 1.0 - mix * 0.01;
+
+    // Chunks end on head-block boundaries, where the segments take their input
+    for (int pos = 0; pos < numSamples;) {
+        const int phase = static_cast<int>(target.time & (head - 1));
+        const int count = std::min(numSamples - pos, head - phase);
+        double* fresh = target.recent.data() + (head - 1) + phase;
+        std::copy(buffer + pos, buffer + pos + count, fresh);
+        for (int n = 0; n < count; ++n) target.inputRing[(target.time + n) & ringMask] = fresh[n];
+
+        fft::directConvolve(active.headTaps.data(), tapCount, fresh, target.head.data(), count);
+        for (int n = 0; n < count; ++n) {
+            double& pending = target.outputRing[(target.time + n) & ringMask];
+            const double wet = target.head[n] + pending;
+            pending = 0.0;
+            buffer[pos + n] = dryGain * fresh[n] + wetGain * wet;
+        }
+
+        target.time += count;
+        pos += count;
+        if (phase + count == head) {
+            completeBlock(active, target);
+            std::copy(target.recent.begin() + head, target.recent.end(), target.recent.begin());
+        }
+    }
+}
+
+void ConvolutionFilter::completeBlock(Kernel& active, Lane& target) {
+    const std::vector<std::unique_ptr<Segment>>& segments = active.segments;
+    const long long ringMask = active.ringMask;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        const Segment& segment = *segments[s];
+        SegmentState& state = *target.states[s];
+        const int block = segment.blockSize;
+        if (target.time % block != 0) continue;
+
+        // The block published one block ago is due now, from this sample on
+        if (segment.background && state.inFlight) {
+            collect(segment, state);
+            const double* output = state.result.data() + block;
+            for (int n = 0; n < block; ++n) target.outputRing[(target.time + n) & ringMask] += output[n];
+        }
+
+        for (int n = 0; n < block; ++n) state.input[n] = target.inputRing[(target.time - block + n) & ringMask];
+        if (segment.background) {
+            state.inFlight = true;
+            state.job.store(Pending, std::memory_order_release);
+        } else {
+            runSegment(segment, state);
+            const double* output = state.result.data() + block;
+            for (int n = 0; n < block; ++n) target.outputRing[(target.time + n) & ringMask] += output[n];
+        }
+    }
+}
+
+void ConvolutionFilter::runSegment(const Segment& segment, SegmentState& state) const {
+    // Overlap-save: transform the last two blocks, multiply by every
+    // partition's spectrum against the input that many blocks back
+    const int block = segment.blockSize;
+    const int bins = segment.bins;
+    std::copy(state.window.begin() + block, state.window.end(), state.window.begin());
+    std::copy(state.input.begin(), state.input.end(), state.window.begin() + block);
+
+    state.newest = (state.newest + 1) % segment.partitions;
+    const size_t newest = static_cast<size_t>(state.newest) * bins;
+    segment.fft.forward(state.window.data(), state.spectraReal.data() + newest, state.spectraImag.data() + newest,
+                        state.work.data());
+
+    std::fill(state.accReal.begin(), state.accReal.end(), 0.0);
+    std::fill(state.accImag.begin(), state.accImag.end(), 0.0);
+    for (int p = 0; p < segment.partitions; ++p) {
+        const int slot = (state.newest - p + segment.partitions) % segment.partitions;
+        const size_t x = static_cast<size_t>(slot) * bins;
+        const size_t h = static_cast<size_t>(p) * bins;
+        fft::multiplyAccumulate(state.spectraReal.data() + x, state.spectraImag.data() + x, segment.real.data() + h,
+                                segment.imag.data() + h, state.accReal.data(), state.accImag.data(), bins);
+    }
+    segment.fft.inverse(state.accReal.data(), state.accImag.data(), state.result.data(), state.work.data());
+}
+
+void ConvolutionFilter::collect(const Segment& segment, SegmentState& state) {
+    // Take the block over if the worker has not started it; wait if it is
+    // running. Either way the output is the same, only later than planned.
+    int expected = Pending;
+    if (state.job.compare_exchange_strong(expected, Running, std::memory_order_acq_rel)) {
+        runSegment(segment, state);
+        lateBlocks.fetch_add(1, std::memory_order_relaxed);
+    } else if (expected == Running) {
+        lateBlocks.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0; state.job.load(std::memory_order_acquire) != Done;) {
+            if ((++spins & 255) == 0) std::this_thread::yield();
+        }
+    }
+    state.job.store(Idle, std::memory_order_relaxed);
+    state.inFlight = false;
+}
+
+bool ConvolutionFilter::serviceBackground() {
+    // The worker is the only thread that frees a kernel, and it is done with
+    // the one it serviced last time by now
+    bool busy = false;
+    if (Kernel* old = retired.exchange(nullptr, std::memory_order_acq_rel)) {
+        delete old;
+        busy = true;
+    }
+    const double rate = requestedRate.load(std::memory_order_relaxed);
+    if (rate != builtRate) {
+        builtRate = rate;
+        delete prepared.exchange(buildKernel(rate).release(), std::memory_order_acq_rel);  // One never picked up
+        LOG_INFO("🏛️ Convolution: response rebuilt for %.0f Hz", rate);
+        busy = true;
+    }
+
+    Kernel& active = *kernel.load(std::memory_order_acquire);
+    const std::vector<std::unique_ptr<Segment>>& segments = active.segments;
+    for (auto& target : active.lanes) {
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (!segments[s]->background) continue;
+            SegmentState& state = *target->states[s];
+            int expected = Pending;
+            if (!state.job.compare_exchange_strong(expected, Running, std::memory_order_acq_rel)) continue;
+            const auto begin = Clock::now();
+            runSegment(*segments[s], state);
+            backgroundNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+            state.job.store(Done, std::memory_order_release);
+            busy = true;
+        }
+    }
+    return busy;
+}
+
+ConvolutionFilter::Cost ConvolutionFilter::getCost() const {
+    Cost cost;
+    const double seconds = samplesProcessed.load() / (sampleRate * laneSelector.getUsed());
+    if (seconds > 0.0) {
+        cost.audioThread = audioNanos.load() * 1e-9 / seconds;
+        cost.background = backgroundNanos.load() * 1e-9 / seconds;
+    }
+    cost.lateBlocks = lateBlocks.load();
+    return cost;
+}
+
+void ConvolutionFilter::reset() {
+    Kernel& active = *kernel.load(std::memory_order_acquire);
+    const std::vector<std::unique_ptr<Segment>>& segments = active.segments;
+    for (auto& target : active.lanes) {
+        for (size_t s = 0; s < segments.size(); ++s) {
+            SegmentState& state = *target->states[s];
+            if (state.inFlight) collect(*segments[s], state);
+            std::fill(state.window.begin(), state.window.end(), 0.0);
+            std::fill(state.spectraReal.begin(), state.spectraReal.end(), 0.0);
+            std::fill(state.spectraImag.begin(), state.spectraImag.end(), 0.0);
+            state.newest = 0;
+        }
+        target->time = 0;
+        std::fill(target->recent.begin(), target->recent.end(), 0.0);
+        std::fill(target->inputRing.begin(), target->inputRing.end(), 0.0);
+        std::fill(target->outputRing.begin(), target->outputRing.end(), 0.0);
+    }
+    audioNanos = 0;
+    backgroundNanos = 0;
+    samplesProcessed = 0;
+    lateBlocks = 0;
+}
+
+void ConvolutionFilter::saveState(double* state) const {
+    laneSelector.save(state);
+}
+
+void ConvolutionFilter::restoreState(const double* state) {
+    laneSelector.restore(state, "Convolution");
+}
+
+void ConvolutionFilter::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    requestedRate.store(rate, std::memory_order_relaxed);  // Built on the worker, see serviceBackground()
+}
+
+void ConvolutionFilter::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void ConvolutionFilter::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering convolution parameters...", prefix.c_str());
+    addParameterWithPrefix(controller, prefix, "Mix", &mix, 0, 100, 5, []() { }, {"%"});
+    addParameterWithPrefix(controller, prefix, "Level", &level, -24, 12, 1, []() { }, {"dB"});
+}
+
+// -----------------------------------------------------------------------------
+// ConvolutionWorker
+// -----------------------------------------------------------------------------
+ConvolutionWorker& ConvolutionWorker::instance() {
+    static ConvolutionWorker worker;
+    return worker;
+}
+
+ConvolutionWorker::ConvolutionWorker() {
+    thread = std::thread(&ConvolutionWorker::run, this);
+}
+
+ConvolutionWorker::~ConvolutionWorker() {
+    stopping.store(true);
+    thread.join();
+}
+
+void ConvolutionWorker::attach(ConvolutionFilter* filter) {
+    std::lock_guard<std::mutex> lock(mutex);
+    filters.push_back(filter);
+}
+
+void ConvolutionWorker::detach(ConvolutionFilter* filter) {
+    std::lock_guard<std::mutex> lock(mutex);
+    filters.erase(std::remove(filters.begin(), filters.end(), filter), filters.end());
+}
+
+void ConvolutionWorker::run() {
+    // The shortest background block is about 23 ms at 44.1 kHz; polling
+    // every 200 us leaves nearly all of it for the transform
+    while (!stopping.load(std::memory_order_relaxed)) {
+        bool busy = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (ConvolutionFilter* filter : filters) busy = filter->serviceBackground() || busy;
+        }
+        if (!busy) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
@@ -0,0 +1,212 @@
+#ifndef CONVOLUTIONFILTER_H
+#define CONVOLUTIONFILTER_H
+
+#include "../core/Filter.h"
+#include "../dsp/FFT.h"
+#include "FilterLanes.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Convolution with a long impulse response (a room, a plate, a cabinet),
+// for reverbs of several seconds at a fraction of a direct FIR's cost.
+//
+// The response is split into segments that grow along it. The first
+// headTaps taps run as a direct FIR, so there is no latency. The taps after
+// them run as uniformly partitioned FFT convolution in blocks of headTaps
+// on the audio thread. In the default non-uniform layout that block only
+// covers the early part: later segments use blocks 16, then 8 times larger,
+// each starting at twice its block size. Their output is due one block
+// after their input is complete, so they run on the ConvolutionWorker
+// thread. A block the worker has not finished by then is computed on the
+// audio thread (and counted as late), so the output never depends on
+// scheduling. The uniform layout keeps every partition on the audio thread.
+//
+// One filter runs up to Options::lanes channels of a multichannel Sound,
+// each with its own history (see FilterLanes); the impulse response itself
+// is shared by the lanes.
+//
+// The partitions are built for one rate. A new rate has the worker rebuild
+// them from the response as given, resampled the way load() does; the audio
+// thread switches to them at its next block.
+class ConvolutionFilter : public Filter {
+public:
+    struct Options {
+        int headTaps = 64;       // Direct taps, also the first partition size (a power of two)
+        bool uniform = false;    // Every partition headTaps long, on the audio thread
+        int lanes = 1;           // Channels it can run
+        bool normalize = true;   // Scale the response to unit energy
+    };
+
+    // impulse recorded at impulseRate, played at sampleRate (resampled here)
+    ConvolutionFilter(std::vector<double> impulse, double impulseRate, double sampleRate, const Options& options);
+    ConvolutionFilter(std::vector<double> impulse, double sampleRate, const Options& options)
+        : ConvolutionFilter(std::move(impulse), sampleRate, sampleRate, options) {}
+    ConvolutionFilter(std::vector<double> impulse, double sampleRate = 44100.0)
+        : ConvolutionFilter(std::move(impulse), sampleRate, Options()) {}
+    ~ConvolutionFilter() override;
+
+    // Reads an impulse response through SampleFile (a memory-mapped WAV or
+    // raw float file, mixed to mono) and resamples it to sampleRate if it
+    // was recorded at another rate; nullptr (with a log) if it cannot be read
+    static std::unique_ptr<ConvolutionFilter> load(const std::string& path, double sampleRate, const Options& options);
+    static std::unique_ptr<ConvolutionFilter> load(const std::string& path, double sampleRate = 44100.0) {
+        return load(path, sampleRate, Options());
+    }
+
+    double processSample(double input) override;
+    void processBuffer(double* buffer, int numSamples) override;
+
+    // Wet/dry balance, 0 to 100 %, and the wet level in dB
+    void setMix(double percent) { mix = percent; }
+    double getMix() const { return mix; }
+    void setLevel(double decibels) { level = decibels; }
+    double getLevel() const { return level; }
+
+    int getImpulseLength() const { return static_cast<int>(current().impulseLength); }
+    // Partition layout after the direct head
+    int getSegmentCount() const { return static_cast<int>(current().segments.size()); }
+    int getSegmentBlockSize(int segment) const { return current().segments[segment]->blockSize; }
+    int getSegmentPartitions(int segment) const { return current().segments[segment]->partitions; }
+    bool isSegmentInBackground(int segment) const { return current().segments[segment]->background; }
+    // Rate the partitions in use were built for; trails getSampleRate()
+    // until the audio thread has switched to a rebuilt response
+    double getResponseRate() const { return current().sampleRate; }
+
+    // Processing time as a fraction of real time, on the audio thread and on
+    // the worker, since construction or reset()
+    struct Cost {
+        double audioThread = 0.0;
+        double background = 0.0;
+        long long lateBlocks = 0;  // Background blocks the audio thread had to finish
+    };
+    Cost getCost() const;
+
+    // The impulse response keeps playing out its tail unless reset. Waits
+    // for blocks in flight on the worker, so not for the audio thread.
+    void reset() override;
+    int getStateSize() const override { return 1; }
+    void saveState(double* state) const override;
+    void restoreState(const double* state) override;
+
+    // Real-time safe: only asks the worker for partitions at the new rate.
+    // The old ones keep playing until the rebuilt set replaces them, which
+    // starts the tail over.
+    void setSampleRate(double rate) override;
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Convolution"; }
+
+private:
+    friend class ConvolutionWorker;
+
+    // A run of equal partitions and their spectra; immutable once built
+    struct Segment {
+        int blockSize;
+        long long start;   // First tap
+        int partitions;
+        bool background;
+        RealFFT fft;
+        int bins;
+        std::vector<double> real;  // [partition][bin]
+        std::vector<double> imag;
+
+        Segment(int block, long long first, int count, bool onWorker) :
+            blockSize(block), start(first), partitions(count), background(onWorker), fft(2 * block),
+            bins(block + 1) {}
+    };
+
+    enum Job { Idle, Pending, Running, Done };
+
+    // One lane's history for one segment, handed between the audio thread
+    // and the worker through job
+    struct SegmentState {
+        std::vector<double> input;     // The block just completed
+        std::vector<double> window;    // Previous and current block, for the 2 * blockSize transform
+        std::vector<double> spectraReal; // Input spectra, [partition][bin], newest at slot newest
+        std::vector<double> spectraImag;
+        std::vector<double> accReal;
+        std::vector<double> accImag;
+        std::vector<double> work;
+        std::vector<double> result;    // Full transform output; the last blockSize samples are valid
+        int newest = 0;
+        bool inFlight = false;         // Audio thread's view: a job was published and not collected
+        std::atomic<int> job{Idle};
+    };
+
+    struct Lane {
+        long long time = 0;            // Samples processed
+        std::vector<double> recent;    // headTaps - 1 samples of history, then the current block
+        std::vector<double> head;      // Direct FIR output of a chunk
+        std::vector<double> inputRing;
+        std::vector<double> outputRing; // Wet output of the segments, added ahead of time
+        std::vector<std::unique_ptr<SegmentState>> states;
+    };
+
+    // The response prepared for one rate, with every lane's history;
+    // replaced whole when the rate changes
+    struct Kernel {
+        double sampleRate;
+        long long impulseLength;
+        std::vector<double> headTaps;
+        std::vector<std::unique_ptr<Segment>> segments;
+        std::vector<std::unique_ptr<Lane>> lanes;
+        long long ringMask = 0;
+    };
+
+    Options options;
+    std::vector<double> source;        // The response as given, before normalizing
+    double sourceRate;
+    std::atomic<Kernel*> kernel{nullptr};    // Owned; in use by the audio thread
+    std::atomic<Kernel*> prepared{nullptr};  // Built by the worker, not picked up yet
+    std::atomic<Kernel*> retired{nullptr};   // Switched away from, freed by the worker
+    std::atomic<double> requestedRate;
+    double builtRate;                  // Worker only: rate of the newest kernel built
+    FilterLanes laneSelector;          // Picks the lane a channel runs in
+
+    double mix = 35.0;                 // Percent wet
+    double level = 0.0;                // Wet level, dB
+
+    std::atomic<long long> audioNanos{0};
+    std::atomic<long long> backgroundNanos{0};
+    std::atomic<long long> samplesProcessed{0};
+    std::atomic<long long> lateBlocks{0};
+
+    const Kernel& current() const { return *kernel.load(std::memory_order_acquire); }
+    std::unique_ptr<Kernel> buildKernel(double rate) const;
+    void processLane(Kernel& active, Lane& target, double* buffer, int numSamples);
+    void completeBlock(Kernel& active, Lane& target);
+    void runSegment(const Segment& segment, SegmentState& state) const;
+    void collect(const Segment& segment, SegmentState& state);
+    // Worker side: frees a replaced kernel, builds one for a new rate and
+    // runs the pending background blocks; true if it did any of that
+    bool serviceBackground();
+};
+
+// The thread that runs every ConvolutionFilter's background segments. It
+// polls the attached filters' jobs. The audio thread never takes its lock;
+// at worst it spins while the worker finishes a block that is due.
+class ConvolutionWorker {
+public:
+    static ConvolutionWorker& instance();
+
+    void attach(ConvolutionFilter* filter);
+    void detach(ConvolutionFilter* filter);  // Returns once the worker has let go of it
+
+private:
+    ConvolutionWorker();
+    ~ConvolutionWorker();
+
+    std::mutex mutex;                  // Guards filters; held while servicing them
+    std::vector<ConvolutionFilter*> filters;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+
+    void run();
+};
+
+#endif // CONVOLUTIONFILTER_H
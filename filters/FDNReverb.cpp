@@ -0,0 +1,191 @@
+#include "FDNReverb.h"
+#include "../interface/LiveController.h"
+#include "../dsp/DelayKernels.h"
+#include "../dsp/FastMath.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Line lengths run exponentially from the shortest to the longest, in ms at Size 1
+constexpr double ShortestMs = 31.0;
+constexpr double LongestMs = 97.0;
+constexpr double MaxSize = 2.0;
+constexpr double MaxDepthMs = 5.0;
+constexpr double MaxDamping = 20000.0;
+
+bool isPrime(int value) {
+    if (value < 2) return false;
+    for (int divisor = 2; divisor * divisor <= value; ++divisor) {
+        if (value % divisor == 0) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FDNReverb::FDNReverb(double sampleRate, int lines, int laneCount)
+    : Filter(sampleRate), laneSelector(laneCount) {
+    lineCount = 4;
+    while (lineCount < std::min(lines, MaxLines)) lineCount <<= 1;
+
+    const double rate = std::max(sampleRate, CapacityRate);
+    const double needed = (LongestMs * MaxSize + MaxDepthMs) * 0.001 * rate + BlockSize + 2;
+    capacity = 1;
+    while (capacity < needed) capacity <<= 1;
+
+    for (int l = 0; l < laneSelector.getCount(); ++l) {
+        auto lane = std::make_unique<Lane>();
+        lane->rings.assign(static_cast<size_t>(lineCount) * capacity, 0.0f);
+        for (int line = 0; line < lineCount; ++line) lane->phases[line] = static_cast<double>(line) / lineCount;
+        lanes.push_back(std::move(lane));
+    }
+    update();
+    LOG_INFO("🌫️ FDNReverb: %d lines of %d samples, %d lane(s), %zu KiB", lineCount, capacity,
+             laneSelector.getCount(), (static_cast<size_t>(lineCount) * capacity * sizeof(float) * lanes.size()) >> 10);
+}
+
+void FDNReverb::update() {
+    // Mutually prime lengths, so the lines' echoes do not line up
+    const int longest = capacity - BlockSize - 2 - static_cast<int>(MaxDepthMs * 0.001 * sampleRate);
+    const double scale = std::clamp(size, 0.3, MaxSize) * 0.001 * sampleRate;
+    for (int l = 0; l < lineCount; ++l) {
+        const double ms = ShortestMs * std::pow(LongestMs / ShortestMs, static_cast<double>(l) / (lineCount - 1));
+        int length = std::clamp(static_cast<int>(ms * scale), BlockSize + 2, longest);
+        while (!isPrime(length) && length < longest) ++length;
+        for (int other = 0; other < l; ++other) {
+            if (lengths[other] == length && length < longest) ++length;
+        }
+        lengths[l] = length;
+    }
+
+    // Each pass through a line decays by its share of 60 dB over the decay
+    // time; the Hadamard sum is scaled back to unit gain here
+    const double normalize = 1.0 / std::sqrt(static_cast<double>(lineCount));
+    const double seconds = std::max(0.05, decay);
+    for (int l = 0; l < lineCount; ++l) {
+        gains[l] = normalize * std::pow(10.0, -3.0 * lengths[l] / (seconds * sampleRate));
+        // The tap may not swing into the block being written
+        depths[l] = std::clamp(modDepth * 0.001 * sampleRate, 0.0, lengths[l] - BlockSize - 2.0);
+        rates[l] = modRate * (0.7 + 0.6 * l / (lineCount - 1)) / sampleRate;
+    }
+    // Fully open, Damping leaves the feedback unfiltered
+    dampingCoefficient = damping >= MaxDamping ? 1.0
+                                               : std::clamp(1.0 - std::exp(-2.0 * M_PI * damping / sampleRate), 0.0, 1.0);
+}
+
+double FDNReverb::processSample(double input) {
+    processBuffer(&input, 1);
+    return input;
+}
+
+void FDNReverb::processBuffer(double* buffer, int numSamples) {
+    Lane& lane = *lanes[laneSelector.getCurrent()];
+    const int mask = capacity - 1;
+    const double inputGain = 1.0 / std::sqrt(static_cast<double>(lineCount));
+    const double wetGain = mix * 0.01 / std::sqrt(static_cast<double>(lineCount));
+    const double dryGain = 1.0 - mix * 0.01;
+    double* feedbackLines[MaxLines];
+    for (int l = 0; l < lineCount; ++l) feedbackLines[l] = feedback[l];
+
+    for (int pos = 0; pos < numSamples;) {
+        // Blocks stay on the BlockSize grid of the running position, so the
+        // output does not depend on how the caller splits the buffer
+        const int first = static_cast<int>(lane.position & (BlockSize - 1));
+        const int count = std::min(BlockSize - first, numSamples - pos);
+        double* block = buffer + pos;
+
+        // Every line's output for the whole block was written before it. The
+        // modulation sine is evaluated at the grid points and the tap moves in
+        // a straight line between them.
+        for (int l = 0; l < lineCount; ++l) {
+            const float* ring = lane.rings.data() + static_cast<size_t>(l) * capacity;
+            const double from = depths[l] * fastmath::sin2pi(lane.phases[l]);
+            const double to = depths[l] * fastmath::sin2pi(lane.phases[l] + BlockSize * rates[l]);
+            delays::readModulated(ring, mask, lane.position, lengths[l] + from, (to - from) / BlockSize, first,
+                                  taps[l], count);
+            if (first + count == BlockSize) {
+                lane.phases[l] += BlockSize * rates[l];
+                lane.phases[l] -= std::floor(lane.phases[l]);
+            }
+            std::copy(taps[l], taps[l] + count, feedback[l]);
+        }
+
+        // Mix the lines into each other, decay, damp, add the input, write back
+        delays::hadamard(feedbackLines, lineCount, count);
+        for (int l = 0; l < lineCount; ++l) {
+            double* line = feedback[l];
+            const double gain = gains[l];
+            for (int n = 0; n < count; ++n) line[n] *= gain;
+        }
+        delays::onePole(feedbackLines, lineCount, dampingCoefficient, lane.damped, count);
+        for (int l = 0; l < lineCount; ++l) {
+            double* line = feedback[l];
+            for (int n = 0; n < count; ++n) line[n] += inputGain * block[n];
+            delays::write(lane.rings.data() + static_cast<size_t>(l) * capacity, mask, lane.position, line, count);
+        }
+
+        // Output: the taps with alternating signs, so the lines decorrelate
+        double wet[BlockSize] = {};
+        for (int l = 0; l < lineCount; l += 2) {
+            for (int n = 0; n < count; ++n) wet[n] += taps[l][n] - taps[l + 1][n];
+        }
+        for (int n = 0; n < count; ++n) block[n] = dryGain * block[n] + wetGain * wet[n];
+        lane.position += count;
+        pos += count;
+    }
+}
+
+void FDNReverb::setSize(double scale) {
+    size = std::clamp(scale, 0.3, MaxSize);
+    update();
+}
+
+void FDNReverb::setDecay(double seconds) {
+    decay = std::clamp(seconds, 0.1, 20.0);
+    update();
+}
+
+void FDNReverb::setDamping(double frequency) {
+    damping = std::clamp(frequency, 500.0, MaxDamping);
+    update();
+}
+
+void FDNReverb::setModulation(double depthMs, double rateHz) {
+    modDepth = std::clamp(depthMs, 0.0, MaxDepthMs);
+    modRate = std::clamp(rateHz, 0.0, 5.0);
+    update();
+}
+
+void FDNReverb::reset() {
+    for (auto& lane : lanes) {
+        std::fill(lane->rings.begin(), lane->rings.end(), 0.0f);
+        std::fill(lane->damped, lane->damped + MaxLines, 0.0);
+        lane->position = 0;
+    }
+}
+
+void FDNReverb::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    update();  // Lengths past the rings' capacity are clamped
+}
+
+void FDNReverb::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void FDNReverb::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering reverb parameters...", prefix.c_str());
+    addParameterWithPrefix(controller, prefix, "Size", &size, 0.3, MaxSize, 0.1,
+                          [this]() { setSize(size); });
+    addParameterWithPrefix(controller, prefix, "Decay", &decay, 0.1, 20.0, 0.1,
+                          [this]() { setDecay(decay); }, {"s"});
+    addParameterWithPrefix(controller, prefix, "Damping", &damping, 500.0, MaxDamping, 100.0,
+                          [this]() { setDamping(damping); }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Mod Depth", &modDepth, 0.0, MaxDepthMs, 0.1,
+                          [this]() { setModulation(modDepth, modRate); }, {"ms"});
+    addParameterWithPrefix(controller, prefix, "Mod Rate", &modRate, 0.0, 5.0, 0.05,
+                          [this]() { setModulation(modDepth, modRate); }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Mix", &mix, 0.0, 100.0, 5.0, []() { }, {"%"});
+}
@@ -0,0 +1,96 @@
+#ifndef FDNREVERB_H
+#define FDNREVERB_H
+
+#include "../core/Filter.h"
+#include "FilterLanes.h"
+#include <memory>
+#include <vector>
+
+// Algorithmic reverb: a feedback delay network of 8 or 16 lines whose
+// outputs are mixed back into every input through an orthogonal Hadamard
+// matrix. Each line has its own decay gain for the Decay time (RT60) and a
+// one-pole lowpass for Damping; line lengths are spread exponentially and
+// scaled by Size, and each read tap is swept slowly by its own sine so the
+// tail does not ring at the line lengths.
+//
+// Every line is longer than a block (BlockSize samples), so the network
+// runs a block at a time: read every line's output block, mix, damp and
+// write the feedback block back, each step one pass over contiguous
+// samples (see dsp/DelayKernels.h). That keeps it a small fraction of a
+// convolution reverb's cost. Lines are float power-of-two rings sized when
+// the reverb is built for rates up to CapacityRate.
+//
+// Mono in, mono out; works as a Sound filter or on the renderer's send bus
+// (with Mix at 100 %). Each channel of a multichannel Sound runs in its own
+// lane (see FilterLanes).
+class FDNReverb : public Filter {
+public:
+    static constexpr int MaxLines = 16;
+    static constexpr int BlockSize = 64;
+    static constexpr double CapacityRate = 96000.0;
+
+    // lines is rounded to a power of two between 4 and MaxLines
+    FDNReverb(double sampleRate = 44100.0, int lines = 8, int lanes = 1);
+
+    double processSample(double input) override;
+    void processBuffer(double* buffer, int numSamples) override;
+
+    void setSize(double scale);            // 0.3 to 2, line lengths relative to a mid-sized room
+    void setDecay(double seconds);         // RT60
+    void setDamping(double frequency);     // Lowpass in the feedback, Hz; off at 20000
+    // The swept taps interpolate linearly, which also damps the tail a little
+    void setModulation(double depthMs, double rateHz);
+    void setMix(double percent) { mix = percent; }
+    double getSize() const { return size; }
+    double getDecay() const { return decay; }
+    double getDamping() const { return damping; }
+    double getMix() const { return mix; }
+    int getLineCount() const { return lineCount; }
+    int getLineLength(int line) const { return lengths[line]; }
+
+    void reset() override;
+    int getStateSize() const override { return 1; }
+    void saveState(double* state) const override { laneSelector.save(state); }
+    void restoreState(const double* state) override { laneSelector.restore(state, "FDNReverb"); }
+    // Real-time safe: recomputes lengths and gains within the rings' capacity
+    void setSampleRate(double rate) override;
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "FDNReverb"; }
+
+private:
+    struct Lane {
+        std::vector<float> rings;          // [line][capacity]
+        long long position = 0;
+        double phases[MaxLines] = {};      // Modulation, turns
+        double damped[MaxLines] = {};
+    };
+
+    int lineCount;
+    int capacity;                          // Ring length, a power of two
+    FilterLanes laneSelector;
+    std::vector<std::unique_ptr<Lane>> lanes;
+
+    // Live parameters
+    double size = 1.0;
+    double decay = 2.5;
+    double damping = 6000.0;
+    double modDepth = 0.6;                 // ms
+    double modRate = 0.4;                  // Hz
+    double mix = 30.0;                     // Percent wet
+
+    // Derived from them
+    int lengths[MaxLines];
+    double gains[MaxLines];                // Decay per pass, with the Hadamard normalization
+    double depths[MaxLines];               // Modulation depth in samples, kept short of the block
+    double rates[MaxLines];                // Modulation phase step per sample
+    double dampingCoefficient = 0.5;
+
+    double taps[MaxLines][BlockSize];
+    double feedback[MaxLines][BlockSize];
+
+    void update();
+};
+
+#endif // FDNREVERB_H
@@ -0,0 +1,43 @@
+#ifndef FILTERLANES_H
+#define FILTERLANES_H
+
+#include "../core/Logger.h"
+#include <algorithm>
+
+// Channel selection for filters whose history is too large to go through
+// Filter::saveState()/restoreState() every block (long delay lines,
+// convolution spectra). Such a filter keeps one lane of history per channel
+// it can run, and its per-channel state is just the lane number: a channel
+// restored with 0 has not run yet and is given the next lane.
+class FilterLanes {
+public:
+    explicit FilterLanes(int lanes = 1) : count(std::max(1, lanes)) {}
+
+    int getCount() const { return count; }
+    int getCurrent() const { return current; }
+    // Lanes given to channels so far, at least 1
+    int getUsed() const { return std::max(1, std::min(assigned, count)); }
+
+    void save(double* state) const { state[0] = current + 1; }
+
+    void restore(const double* state, const char* filterName) {
+        int index = static_cast<int>(state[0]) - 1;
+        if (index < 0) {
+            if (assigned >= count && !warned) {
+                // Once: this runs on the audio thread, and the log ring is shared
+                LOG_WARNING("⚠️ %s: more channels than its %d lane(s); channels share history", filterName, count);
+                warned = true;
+            }
+            index = assigned++ % count;
+        }
+        current = std::min(index, count - 1);
+    }
+
+private:
+    int count;
+    int current = 0;
+    int assigned = 0;
+    bool warned = false;
+};
+
+#endif // FILTERLANES_H
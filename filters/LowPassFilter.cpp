@@ -1,6 +1,7 @@
 #include "LowPassFilter.h"
 #include "../interface/LiveController.h"
-#include <iostream>
+#include "../dsp/FastMath.h"
+#include "../core/Logger.h"
 #include <cmath>
 #include <algorithm>
 
@@ -34,9 +35,9 @@ void LowPassFilter::setResonance(double q) {
 
 void LowPassFilter::updateCoefficients() {
     // Standard biquad lowpass (RBJ cookbook) with resonance (Q)
-    double omega = 2.0 * M_PI * cutoffFrequency / sampleRate;
-    double cosOmega = cos(omega);
-    double sinOmega = sin(omega);
+    double turns = cutoffFrequency / sampleRate;  // omega / (2 * pi)
+    double cosOmega = fastmath::cos2pi(turns);
+    double sinOmega = fastmath::sin2pi(turns);
     double Q = resonance;
     double alpha = sinOmega / (2.0 * Q);
 
@@ -52,17 +53,37 @@ void LowPassFilter::reset() {
     x1 = x2 = y1 = y2 = 0.0;
 }
 
+void LowPassFilter::saveState(double* state) const {
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+}
+
+void LowPassFilter::restoreState(const double* state) {
+    x1 = state[0];
+    x2 = state[1];
+    y1 = state[2];
+    y2 = state[3];
+}
+
+void LowPassFilter::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    setCutoffFrequency(cutoffFrequency); // Re-clamps to the new Nyquist and updates coefficients
+}
+
 void LowPassFilter::registerParameters(LiveController& controller) {
     registerParametersWithPrefix(controller, getTypeName());
 }
 
 void LowPassFilter::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering filter parameters..." << std::endl;
+    LOG_DEBUG("🎛️ %s registering filter parameters...", prefix.c_str());
     addParameterWithPrefix(controller, prefix, "Cutoff Freq", &cutoffFrequency,
                           20.0, 8000.0, 1000.0,
                           [this]() {
                               setCutoffFrequency(cutoffFrequency);
-                          });
+                          },
+                          {"Hz"});
     addParameterWithPrefix(controller, prefix, "Resonance", &resonance,
                           0.1, 10.0, 0.7071,
                           [this]() {
@@ -20,6 +20,12 @@ public:
     std::string getTypeName() const override { return "LowPass"; }
 
     void reset() override;
+    int getStateSize() const override { return 4; }
+    void saveState(double* state) const override;
+    void restoreState(const double* state) override;
+
+    // Recomputes coefficients for the new rate
+    void setSampleRate(double rate) override;
 
 private:
     double cutoffFrequency;
@@ -0,0 +1,94 @@
+#include "OversampledFilter.h"
+#include "../interface/LiveController.h"
+#include "../core/Logger.h"
+
+OversampledFilter::OversampledFilter(std::unique_ptr<Filter> innerFilter, int factor, double sampleRate)
+    : Filter(sampleRate), inner(std::move(innerFilter)), oversampler(factor) {
+    factorSetting = oversampler.getFactor();
+    if (inner) {
+        inner->setUsedAsComponent(true);
+        inner->setSampleRate(sampleRate * oversampler.getFactor());
+    }
+}
+
+double OversampledFilter::processSample(double input) {
+    // Containers that run sample by sample have no other block boundary
+    applyPendingFactor();
+    return renderSample(input);
+}
+
+void OversampledFilter::processBuffer(double* samples, int numSamples) {
+    applyPendingFactor();
+    for (int i = 0; i < numSamples; ++i) {
+        samples[i] = renderSample(samples[i]);
+    }
+}
+
+double OversampledFilter::renderSample(double input) {
+    if (!inner) return input;
+
+    int factor = oversampler.getFactor();
+    if (factor == 1) {
+        return inner->processSample(input);
+    }
+
+    oversampler.upsample(input, buffer);
+    for (int i = 0; i < factor; ++i) {
+        buffer[i] = inner->processSample(buffer[i]);
+    }
+    return oversampler.downsample(buffer);
+}
+
+void OversampledFilter::applyPendingFactor() {
+    if (oversampler.applyPendingFactor() && inner) {
+        inner->setSampleRate(sampleRate * oversampler.getFactor());
+    }
+}
+
+void OversampledFilter::setOversamplingFactor(int factor) {
+    oversampler.setFactor(factor);
+    factorSetting = oversampler.getPendingFactor();
+}
+
+void OversampledFilter::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    if (inner) inner->setSampleRate(rate * oversampler.getFactor());
+}
+
+void OversampledFilter::reset() {
+    oversampler.reset();
+    if (inner) inner->reset();
+}
+
+int OversampledFilter::getStateSize() const {
+    return Oversampler::StateSize + (inner ? inner->getStateSize() : 0);
+}
+
+void OversampledFilter::saveState(double* state) const {
+    oversampler.saveState(state);
+    if (inner) inner->saveState(state + Oversampler::StateSize);
+}
+
+void OversampledFilter::restoreState(const double* state) {
+    oversampler.restoreState(state);
+    if (inner) inner->restoreState(state + Oversampler::StateSize);
+}
+
+void OversampledFilter::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, inner ? inner->getTypeName() : getTypeName());
+}
+
+void OversampledFilter::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering oversampling parameters...", prefix.c_str());
+
+    if (inner) {
+        inner->registerParametersWithPrefix(controller, prefix);
+    }
+
+    addParameterWithPrefix(controller, prefix, "Oversampling", &factorSetting,
+                          1.0, 8.0, 1.0,
+                          [this]() {
+                              setOversamplingFactor(static_cast<int>(factorSetting));
+                          },
+                          {"x", ParameterType::Integer});
+}
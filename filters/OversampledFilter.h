@@ -0,0 +1,47 @@
+#ifndef OVERSAMPLEDFILTER_H
+#define OVERSAMPLEDFILTER_H
+
+#include "../core/Filter.h"
+#include "../core/Oversampler.h"
+#include <memory>
+
+// Runs an enclosed filter at 2x/4x/8x the host rate. Useful for filters
+// whose response warps or aliases close to Nyquist.
+class OversampledFilter : public Filter {
+public:
+    OversampledFilter(std::unique_ptr<Filter> inner, int factor = 2,
+                      double sampleRate = 44100.0);
+
+    double processSample(double input) override;
+    void processBuffer(double* samples, int numSamples) override;
+
+    // Oversampling factor (1, 2, 4 or 8), selectable at runtime from any
+    // thread; the audio thread switches over at its next block
+    void setOversamplingFactor(int factor);
+    int getOversamplingFactor() const { return oversampler.getFactor(); }
+
+    void setSampleRate(double rate) override;
+    Filter* getInner() { return inner.get(); }
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Oversampled"; }
+
+    void reset() override;
+
+    // The half-band stages' history, then the inner filter's
+    int getStateSize() const override;
+    void saveState(double* state) const override;
+    void restoreState(const double* state) override;
+
+private:
+    std::unique_ptr<Filter> inner;
+    Oversampler oversampler;
+    double factorSetting;  // Parameter value, snapped to a power of two
+    double buffer[Oversampler::MaxFactor];
+
+    void applyPendingFactor();
+    double renderSample(double input);
+};
+
+#endif // OVERSAMPLEDFILTER_H
@@ -0,0 +1,140 @@
+#include "TempoDelay.h"
+#include "../interface/LiveController.h"
+#include "../dsp/DelayKernels.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct DivisionInfo {
+    const char* name;
+    double beats;  // Quarter notes
+};
+
+const DivisionInfo divisions[] = {
+    {"1/1", 4.0}, {"1/2", 2.0}, {"1/4", 1.0}, {"1/8", 0.5}, {"1/16", 0.25},
+    {"1/4 dotted", 1.5}, {"1/8 dotted", 0.75}, {"1/4 triplet", 2.0 / 3.0}, {"1/8 triplet", 1.0 / 3.0},
+};
+static_assert(sizeof(divisions) / sizeof(divisions[0]) == static_cast<size_t>(TempoDelay::Division::Count),
+              "one entry per division");
+
+} // namespace
+
+TempoDelay::TempoDelay(double sampleRate, int laneCount) : Filter(sampleRate), laneSelector(laneCount) {
+    capacity = 1;
+    while (capacity < MaxDelaySeconds * sampleRate + 2 * BlockSize) capacity <<= 1;
+    for (int l = 0; l < laneSelector.getCount(); ++l) {
+        auto lane = std::make_unique<Lane>();
+        lane->ring.assign(capacity, 0.0f);
+        lanes.push_back(std::move(lane));
+    }
+    update();
+    for (auto& lane : lanes) lane->delay = targetDelay;
+}
+
+double TempoDelay::getBeats(Division value) {
+    return divisions[std::clamp(static_cast<int>(value), 0, static_cast<int>(Division::Count) - 1)].beats;
+}
+
+const char* TempoDelay::getDivisionName(Division value) {
+    return divisions[std::clamp(static_cast<int>(value), 0, static_cast<int>(Division::Count) - 1)].name;
+}
+
+void TempoDelay::update() {
+    // At least a block, so a whole block of the tap is already written
+    const double seconds = getBeats(getDivision()) * 60.0 / std::clamp(tempo, 40.0, 300.0);
+    targetDelay = std::clamp(static_cast<int>(std::lround(seconds * sampleRate)), BlockSize, capacity - 2 * BlockSize);
+    dampingCoefficient = std::clamp(1.0 - std::exp(-2.0 * M_PI * damping / sampleRate), 0.0, 1.0);
+}
+
+double TempoDelay::processSample(double input) {
+    processBuffer(&input, 1);
+    return input;
+}
+
+void TempoDelay::processBuffer(double* buffer, int numSamples) {
+    Lane& lane = *lanes[laneSelector.getCurrent()];
+    const int mask = capacity - 1;
+    const double loopGain = std::clamp(feedback, 0.0, 95.0) * 0.01;
+    const double wetGain = mix * 0.01;
+    const double dryGain = 1.0 - mix * 0.01;
+
+    for (int pos = 0; pos < numSamples; pos += BlockSize) {
+        const int count = std::min(BlockSize, numSamples - pos);
+        double* block = buffer + pos;
+
+        delays::read(lane.ring.data(), mask, lane.position, targetDelay, tap, count);
+        if (lane.delay != targetDelay) {
+            // Fade from the old tap over this block
+            delays::read(lane.ring.data(), mask, lane.position, lane.delay, previous, count);
+            for (int n = 0; n < count; ++n) {
+                const double fade = (n + 1.0) / count;
+                tap[n] = previous[n] + fade * (tap[n] - previous[n]);
+            }
+            lane.delay = targetDelay;
+        }
+
+        // Output, then the darkened repeat plus the input back into the line
+        for (int n = 0; n < count; ++n) {
+            const double echo = tap[n];
+            tap[n] = block[n];
+            block[n] = dryGain * block[n] + wetGain * echo;
+            previous[n] = echo;
+        }
+        delays::onePole(previous, dampingCoefficient, lane.damped, count);
+        for (int n = 0; n < count; ++n) tap[n] += loopGain * previous[n];
+        delays::write(lane.ring.data(), mask, lane.position, tap, count);
+        lane.position += count;
+    }
+}
+
+void TempoDelay::setTempo(double bpm) {
+    tempo = std::clamp(bpm, 40.0, 300.0);
+    update();
+}
+
+void TempoDelay::setDivision(Division value) {
+    division = std::clamp(static_cast<int>(value), 0, static_cast<int>(Division::Count) - 1);
+    update();
+}
+
+void TempoDelay::setFeedback(double percent) {
+    feedback = std::clamp(percent, 0.0, 95.0);
+}
+
+void TempoDelay::setDamping(double frequency) {
+    damping = std::clamp(frequency, 500.0, 20000.0);
+    update();
+}
+
+void TempoDelay::reset() {
+    for (auto& lane : lanes) {
+        std::fill(lane->ring.begin(), lane->ring.end(), 0.0f);
+        lane->position = 0;
+        lane->delay = targetDelay;
+        lane->damped = 0.0;
+    }
+}
+
+void TempoDelay::setSampleRate(double rate) {
+    Filter::setSampleRate(rate);
+    update();  // Delays past the ring's capacity are clamped
+}
+
+void TempoDelay::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void TempoDelay::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering delay parameters...", prefix.c_str());
+    addParameterWithPrefix(controller, prefix, "Tempo", &tempo, 40.0, 300.0, 1.0,
+                          [this]() { setTempo(tempo); }, {"BPM"});
+    addParameterWithPrefix(controller, prefix, "Division", &division, 0, static_cast<int>(Division::Count) - 1, 1,
+                          [this]() { setDivision(static_cast<Division>(static_cast<int>(std::lround(division)))); });
+    addParameterWithPrefix(controller, prefix, "Feedback", &feedback, 0.0, 95.0, 5.0,
+                          [this]() { setFeedback(feedback); }, {"%"});
+    addParameterWithPrefix(controller, prefix, "Damping", &damping, 500.0, 20000.0, 100.0,
+                          [this]() { setDamping(damping); }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Mix", &mix, 0.0, 100.0, 5.0, []() { }, {"%"});
+}
@@ -0,0 +1,83 @@
+#ifndef TEMPODELAY_H
+#define TEMPODELAY_H
+
+#include "../core/Filter.h"
+#include "FilterLanes.h"
+#include <memory>
+#include <vector>
+
+// Echo delay locked to a tempo: the delay time is a note Division at Tempo
+// beats per minute, so a host (or the user) changing the tempo keeps the
+// echoes on the beat. Repeats decay by Feedback and darken through a
+// one-pole lowpass in the loop.
+//
+// Like FDNReverb it runs a block at a time over a float power-of-two ring
+// (dsp/DelayKernels.h). A new delay time crossfades from the old tap to the
+// new one over a block instead of jumping. Each channel of a multichannel
+// Sound runs in its own lane (see FilterLanes).
+class TempoDelay : public Filter {
+public:
+    static constexpr int BlockSize = 64;
+    static constexpr double MaxDelaySeconds = 4.0;
+
+    enum class Division { Whole, Half, Quarter, Eighth, Sixteenth, DottedQuarter, DottedEighth,
+                          QuarterTriplet, EighthTriplet, Count };
+
+    TempoDelay(double sampleRate = 44100.0, int lanes = 1);
+
+    double processSample(double input) override;
+    void processBuffer(double* buffer, int numSamples) override;
+
+    void setTempo(double bpm);                // 40 to 300
+    void setDivision(Division value);
+    void setFeedback(double percent);         // 0 to 95
+    void setDamping(double frequency);        // Hz
+    void setMix(double percent) { mix = percent; }
+    double getTempo() const { return tempo; }
+    Division getDivision() const { return static_cast<Division>(static_cast<int>(division)); }
+    double getFeedback() const { return feedback; }
+    double getMix() const { return mix; }
+    // The current delay in samples, within the ring's capacity
+    int getDelaySamples() const { return targetDelay; }
+    // Length of a division in quarter notes
+    static double getBeats(Division value);
+    static const char* getDivisionName(Division value);
+
+    void reset() override;
+    int getStateSize() const override { return 1; }
+    void saveState(double* state) const override { laneSelector.save(state); }
+    void restoreState(const double* state) override { laneSelector.restore(state, "TempoDelay"); }
+    void setSampleRate(double rate) override;
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "TempoDelay"; }
+
+private:
+    struct Lane {
+        std::vector<float> ring;
+        long long position = 0;
+        int delay = 0;                       // Delay the last block was read at
+        double damped = 0.0;
+    };
+
+    int capacity;                            // Ring length, a power of two
+    FilterLanes laneSelector;
+    std::vector<std::unique_ptr<Lane>> lanes;
+
+    // Live parameters
+    double tempo = 120.0;
+    double division = static_cast<int>(Division::DottedEighth);  // Parameter value, snapped to a Division
+    double feedback = 40.0;
+    double damping = 5000.0;
+    double mix = 25.0;
+
+    int targetDelay = 1;
+    double dampingCoefficient = 0.5;
+    double tap[BlockSize];
+    double previous[BlockSize];
+
+    void update();
+};
+
+#endif // TEMPODELAY_H
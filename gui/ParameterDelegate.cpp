@@ -0,0 +1,121 @@
+#include "ParameterDelegate.h"
+#include "ParameterTreeModel.h"
+#include <QApplication>
+#include <QDoubleSpinBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+const QColor GrooveColor(0xE0, 0xE0, 0xE0);
+const QColor FillColor(0x34, 0x98, 0xDB);
+const QColor TextColor(0x2C, 0x3E, 0x50);
+constexpr int BarMargin = 3;
+}
+
+ParameterDelegate::ParameterDelegate(QObject* parent)
+    : QStyledItemDelegate(parent) {}
+
+bool ParameterDelegate::isValueCell(const QModelIndex& index) {
+    return index.isValid() && index.column() == ParameterTreeModel::ValueColumn &&
+           (index.flags() & Qt::ItemIsEditable);
+}
+
+// -----------------------------------------------------------------------------
+// Painting
+// -----------------------------------------------------------------------------
+void ParameterDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option,
+                              const QModelIndex& index) const {
+    if (!isValueCell(index)) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Selection/hover background from the style, then the bar on top
+    QStyleOptionViewItem background = option;
+    initStyleOption(&background, index);
+    background.text.clear();
+    QStyle* style = option.widget ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &background, painter, option.widget);
+
+    double fraction = index.data(ParameterTreeModel::NormalizedValueRole).toDouble();
+    QRect bar = option.rect.adjusted(BarMargin, BarMargin, -BarMargin, -BarMargin);
+    QRect filled = bar;
+    filled.setWidth(static_cast<int>(bar.width() * fraction));
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(GrooveColor);
+    painter->drawRoundedRect(bar, 3, 3);
+    painter->setBrush(FillColor);
+    painter->drawRoundedRect(filled, 3, 3);
+    painter->setPen(TextColor);
+    painter->drawText(bar, Qt::AlignCenter, index.data(Qt::DisplayRole).toString());
+    painter->restore();
+}
+
+QSize ParameterDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QSize size = QStyledItemDelegate::sizeHint(option, index);
+    if (index.column() == ParameterTreeModel::ValueColumn) size.setWidth(std::max(size.width(), 160));
+    return size;
+}
+
+// -----------------------------------------------------------------------------
+// Dragging on the bar
+// -----------------------------------------------------------------------------
+bool ParameterDelegate::editorEvent(QEvent* event, QAbstractItemModel* model,
+                                    const QStyleOptionViewItem& option, const QModelIndex& index) {
+    if (!isValueCell(index)) return QStyledItemDelegate::editorEvent(event, model, option, index);
+
+    if (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::MouseMove) {
+        auto* mouse = static_cast<QMouseEvent*>(event);
+        if (!(mouse->buttons() & Qt::LeftButton)) return false;
+        if (event->type() == QEvent::MouseButtonPress) dragIndex = index;
+        else if (dragIndex != index) return false;
+
+        QRect bar = option.rect.adjusted(BarMargin, BarMargin, -BarMargin, -BarMargin);
+        if (bar.width() <= 0) return false;
+        double fraction = std::clamp((mouse->position().x() - bar.left()) / bar.width(), 0.0, 1.0);
+
+        double minValue = index.data(ParameterTreeModel::MinimumRole).toDouble();
+        double maxValue = index.data(ParameterTreeModel::MaximumRole).toDouble();
+        model->setData(index, minValue + fraction * (maxValue - minValue), Qt::EditRole);
+        return true;
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+// -----------------------------------------------------------------------------
+// Typed entry (double-click) - one editor at a time
+// -----------------------------------------------------------------------------
+QWidget* ParameterDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem& option,
+                                         const QModelIndex& index) const {
+    if (!isValueCell(index)) return QStyledItemDelegate::createEditor(parent, option, index);
+
+    auto* spinBox = new QDoubleSpinBox(parent);
+    spinBox->setRange(index.data(ParameterTreeModel::MinimumRole).toDouble(),
+                      index.data(ParameterTreeModel::MaximumRole).toDouble());
+    spinBox->setDecimals(index.data(ParameterTreeModel::IsIntegerRole).toBool() ? 0 : 2);
+    spinBox->setAlignment(Qt::AlignCenter);
+    spinBox->setFrame(false);
+    return spinBox;
+}
+
+void ParameterDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const {
+    if (auto* spinBox = qobject_cast<QDoubleSpinBox*>(editor)) {
+        spinBox->setValue(index.data(Qt::EditRole).toDouble());
+        return;
+    }
+    QStyledItemDelegate::setEditorData(editor, index);
+}
+
+void ParameterDelegate::setModelData(QWidget* editor, QAbstractItemModel* model,
+                                     const QModelIndex& index) const {
+    if (auto* spinBox = qobject_cast<QDoubleSpinBox*>(editor)) {
+        spinBox->interpretText();
+        model->setData(index, spinBox->value(), Qt::EditRole);
+        return;
+    }
+    QStyledItemDelegate::setModelData(editor, model, index);
+}
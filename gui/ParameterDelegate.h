@@ -0,0 +1,35 @@
+#ifndef PARAMETERDELEGATE_H
+#define PARAMETERDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPersistentModelIndex>
+
+// Draws the value column of ParameterTreeModel as a slider bar.
+//
+// Nothing is instantiated per row: dragging on the bar writes the value
+// straight into the model, and a spin box editor exists only while a value
+// is being typed (double-click).
+class ParameterDelegate : public QStyledItemDelegate {
+public:
+    explicit ParameterDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const override;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const override;
+
+protected:
+    bool editorEvent(QEvent* event, QAbstractItemModel* model,
+                     const QStyleOptionViewItem& option, const QModelIndex& index) override;
+
+private:
+    // Cell the left button went down on; a drag only moves that value, not
+    // every bar the pointer crosses
+    QPersistentModelIndex dragIndex;
+
+    static bool isValueCell(const QModelIndex& index);
+};
+
+#endif // PARAMETERDELEGATE_H
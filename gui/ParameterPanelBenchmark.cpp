@@ -0,0 +1,91 @@
+#include "ParameterPanelBenchmark.h"
+#include "ParameterTreeModel.h"
+#include "ParameterDelegate.h"
+#include "../interface/LiveController.h"
+#include "../core/Logger.h"
+#include <QApplication>
+#include <QTreeView>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Current resident set size in bytes, 0 where unsupported
+long long residentBytes() {
+#if defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+        return static_cast<long long>(info.resident_size);
+    }
+    return 0;
+#elif defined(__linux__)
+    long long pages = 0;
+    long long resident = 0;
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%lld %lld", &pages, &resident) != 2) resident = 0;
+        std::fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+// Same shape as a large additive patch: partials with nested FM groups
+void fillController(LiveController& controller, std::vector<double>& values) {
+    for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+        std::string partial = "Additive Osc " + std::to_string(i / 4 + 1);
+        std::string prefix = (i % 4 < 2) ? partial : partial + " FM Carrier";
+        std::string name = (i % 2 == 0) ? "Frequency" : "Mod Depth";
+        controller.addParameterInGroup(prefix, name, &values[i], 0.0, 1000.0, 1.0, {"Hz"});
+    }
+}
+
+} // namespace
+
+int runParameterPanelBenchmark() {
+    LOG_INFO("\n📊 Parameter panel load (model + tree view, first paint)");
+
+    for (int count : {10, 1000, 10000}) {
+        std::vector<double> values(count, 0.0);
+        LiveController controller;
+        fillController(controller, values);
+
+        QApplication::processEvents();
+        long long memoryBefore = residentBytes();
+        auto start = std::chrono::steady_clock::now();
+
+        auto view = std::make_unique<QTreeView>();
+        ParameterTreeModel model(controller);
+        ParameterDelegate delegate;
+        view->setModel(&model);
+        view->setItemDelegate(&delegate);
+        view->setUniformRowHeights(true);
+        view->expandToDepth(1);
+        view->resize(850, 600);
+        view->show();
+        QApplication::processEvents();
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        long long memoryAfter = residentBytes();
+
+        LOG_INFO("  %6d parameters: %8.1f ms, %8.1f KiB resident growth",
+                 count, ms, (memoryAfter - memoryBefore) / 1024.0);
+
+        view.reset();  // Before the model it displays
+        QApplication::processEvents();
+    }
+    Logger::instance().flush();
+    return 0;
+}
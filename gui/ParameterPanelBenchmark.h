@@ -0,0 +1,9 @@
+#ifndef PARAMETERPANELBENCHMARK_H
+#define PARAMETERPANELBENCHMARK_H
+
+// Builds the parameter panel for synthetic patches with 10, 1k and 10k
+// parameters and prints load time and resident memory growth.
+// Run with `./synth_live --measure-panel`; needs a QApplication.
+int runParameterPanelBenchmark();
+
+#endif // PARAMETERPANELBENCHMARK_H
@@ -0,0 +1,183 @@
+#include "ParameterTreeModel.h"
+#include <QFont>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+} // namespace
+
+ParameterTreeModel::ParameterTreeModel(LiveController& controller, QObject* parent)
+    : QAbstractItemModel(parent), controller(&controller) {
+    refresh();
+}
+
+void ParameterTreeModel::setController(LiveController& newController) {
+    // Swap inside the reset so the view never asks the new controller about old rows
+    beginResetModel();
+    controller = &newController;
+    rebuildGroupRows();
+    endResetModel();
+}
+
+void ParameterTreeModel::refresh() {
+    beginResetModel();
+    rebuildGroupRows();
+    endResetModel();
+}
+
+void ParameterTreeModel::rebuildGroupRows() {
+    groupRows.assign(controller->getGroupCount(), 0);
+    for (int g = 0; g < controller->getGroupCount(); ++g) {
+        const auto& children = controller->getGroup(g).children;
+        for (size_t row = 0; row < children.size(); ++row) {
+            groupRows[children[row]] = static_cast<int>(row);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Structure
+// -----------------------------------------------------------------------------
+QModelIndex ParameterTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (row < 0 || column < 0 || column >= ColumnCount) return QModelIndex();
+    if (parent.isValid() && isParameterNode(parent.internalId())) return QModelIndex();
+
+    int groupIndex = parent.isValid() ? nodeIndex(parent.internalId()) : LiveController::RootGroup;
+    const ParameterGroup& group = controller->getGroup(groupIndex);
+    int childGroups = static_cast<int>(group.children.size());
+
+    if (row < childGroups) {
+        return createIndex(row, column, groupNode(group.children[row]));
+    }
+    int paramRow = row - childGroups;
+    if (paramRow < static_cast<int>(group.parameters.size())) {
+        return createIndex(row, column, parameterNode(group.parameters[paramRow]));
+    }
+    return QModelIndex();
+}
+
+QModelIndex ParameterTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) return QModelIndex();
+
+    quintptr node = child.internalId();
+    int parentGroup = isParameterNode(node)
+        ? controller->getParameter(nodeIndex(node)).group
+        : controller->getGroup(nodeIndex(node)).parent;
+
+    if (parentGroup <= LiveController::RootGroup) return QModelIndex();
+    return createIndex(groupRows[parentGroup], 0, groupNode(parentGroup));
+}
+
+int ParameterTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) return 0;
+    if (parent.isValid() && isParameterNode(parent.internalId())) return 0;
+
+    int groupIndex = parent.isValid() ? nodeIndex(parent.internalId()) : LiveController::RootGroup;
+    if (groupIndex >= controller->getGroupCount()) return 0;
+    const ParameterGroup& group = controller->getGroup(groupIndex);
+    return static_cast<int>(group.children.size() + group.parameters.size());
+}
+
+int ParameterTreeModel::columnCount(const QModelIndex& /* parent */) const {
+    return ColumnCount;
+}
+
+// -----------------------------------------------------------------------------
+// Values
+// -----------------------------------------------------------------------------
+bool ParameterTreeModel::isVolumeParameter(const LiveParameter& param) {
+    // Volume values live in 0.0-1.0 but are registered and shown as 0-100
+    return param.name.find("Volume") != std::string_view::npos ||
+           param.name.find("volume") != std::string_view::npos;
+}
+
+double ParameterTreeModel::displayValue(const LiveParameter& param) {
+    double value = param.valuePtr ? *param.valuePtr : param.minValue;
+    return isVolumeParameter(param) ? value * 100.0 : value;
+}
+
+QVariant ParameterTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) return QVariant();
+    quintptr node = index.internalId();
+
+    if (!isParameterNode(node)) {
+        const ParameterGroup& group = controller->getGroup(nodeIndex(node));
+        if (role == Qt::DisplayRole && index.column() == NameColumn)
+            return "📁 " + toQString(group.displayName);
+        if (role == Qt::FontRole) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return QVariant();
+    }
+
+    const LiveParameter& param = controller->getParameter(nodeIndex(node));
+    bool isInteger = param.info.type != ParameterType::Continuous;
+    QString unit = param.info.unit.empty() ? QString() : " " + QString::fromStdString(param.info.unit);
+
+    switch (role) {
+        case Qt::DisplayRole:
+            if (index.column() == NameColumn) return toQString(param.displayName);
+            if (index.column() == ValueColumn)
+                return QString::number(displayValue(param), 'f', isInteger ? 0 : 2) + unit;
+            if (index.column() == RangeColumn)
+                return QString("%1 - %2%3").arg(param.minValue).arg(param.maxValue).arg(unit);
+            return QVariant();
+        case Qt::EditRole:
+            return displayValue(param);
+        case Qt::ToolTipRole:
+            return toQString(param.name);
+        case NormalizedValueRole: {
+            double range = param.maxValue - param.minValue;
+            double fraction = (range > 0.0) ? (displayValue(param) - param.minValue) / range : 0.0;
+            return std::clamp(fraction, 0.0, 1.0);
+        }
+        case MinimumRole:
+            return param.minValue;
+        case MaximumRole:
+            return param.maxValue;
+        case IsIntegerRole:
+            return isInteger;
+        default:
+            return QVariant();
+    }
+}
+
+bool ParameterTreeModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (!index.isValid() || role != Qt::EditRole || index.column() != ValueColumn) return false;
+    if (!isParameterNode(index.internalId())) return false;
+
+    ParameterId id = nodeIndex(index.internalId());
+    const LiveParameter& param = controller->getParameter(id);
+
+    double newValue = std::clamp(value.toDouble(), param.minValue, param.maxValue);
+    if (param.info.type != ParameterType::Continuous) newValue = std::round(newValue);
+    controller->setParameter(id, isVolumeParameter(param) ? newValue / 100.0 : newValue);
+
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole, NormalizedValueRole});
+    return true;
+}
+
+Qt::ItemFlags ParameterTreeModel::flags(const QModelIndex& index) const {
+    if (!index.isValid()) return Qt::NoItemFlags;
+    Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.column() == ValueColumn && isParameterNode(index.internalId()))
+        itemFlags |= Qt::ItemIsEditable;
+    return itemFlags;
+}
+
+QVariant ParameterTreeModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    switch (section) {
+        case NameColumn:  return QString("Parameter");
+        case ValueColumn: return QString("Value");
+        case RangeColumn: return QString("Range");
+        default:          return QVariant();
+    }
+}
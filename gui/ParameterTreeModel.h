@@ -0,0 +1,57 @@
+#ifndef PARAMETERTREEMODEL_H
+#define PARAMETERTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <vector>
+#include "../interface/LiveController.h"
+
+// Item model over the LiveController parameter tree.
+//
+// Rows are never materialized as widgets: the view asks for the handful of
+// rows it can show, and every answer is an O(1) lookup into the controller.
+// Under each group the child groups come first, then its parameters.
+class ParameterTreeModel : public QAbstractItemModel {
+public:
+    enum Column { NameColumn, ValueColumn, RangeColumn, ColumnCount };
+
+    // Extra roles for ParameterDelegate; values are in display units
+    static constexpr int NormalizedValueRole = Qt::UserRole + 1;  // 0-1 fraction of the range
+    static constexpr int MinimumRole = Qt::UserRole + 2;
+    static constexpr int MaximumRole = Qt::UserRole + 3;
+    static constexpr int IsIntegerRole = Qt::UserRole + 4;
+
+    explicit ParameterTreeModel(LiveController& controller, QObject* parent = nullptr);
+
+    // Call after the controller was cleared and refilled (preset load)
+    void refresh();
+    // Shows another controller, e.g. the one of a prepared preset
+    void setController(LiveController& controller);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Displayed range of a parameter (volume parameters are shown 0-100)
+    static bool isVolumeParameter(const LiveParameter& param);
+    static double displayValue(const LiveParameter& param);
+
+private:
+    LiveController* controller;
+
+    // Row of each group inside its parent group, rebuilt by refresh()
+    std::vector<int> groupRows;
+    void rebuildGroupRows();
+
+    // internalId: (index << 1) | 1 for parameters, (index << 1) for groups
+    static quintptr groupNode(int group) { return static_cast<quintptr>(group) << 1; }
+    static quintptr parameterNode(ParameterId id) { return (static_cast<quintptr>(id) << 1) | 1; }
+    static bool isParameterNode(quintptr node) { return (node & 1) != 0; }
+    static int nodeIndex(quintptr node) { return static_cast<int>(node >> 1); }
+};
+
+#endif // PARAMETERTREEMODEL_H
@@ -1,23 +1,33 @@
 #include "SynthesizerWindow.h"
 #include <QApplication>
-#include <iostream>
-#include <sstream>
-#include <algorithm>
+#include <QFileDialog>
+#include <QSignalBlocker>
 #include <cmath>
+#include "../core/Logger.h"
 
 SynthesizerWindow::SynthesizerWindow(QWidget* parent)
     : QMainWindow(parent), mainWidget(nullptr), mainLayout(nullptr), isPlaying(false) {
     
     audioEngine = std::make_unique<AudioEngine>();
+    for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+        controllers[part] = std::make_unique<LiveController>();  // Replaced by each preset's own controller
+        partPresets[part] = -1;
+    }
+    presetManager.loadPatchDirectory("patches");  // Data presets, listed after the built-in ones
+
+    // Every preset is built and warmed in the background from here on
+    presetCache = std::make_unique<PresetCache>(presetManager, audioEngine->getSampleRate());
+    presetCache->setChannelCount(audioEngine->getChannelCount());
+    presetCache->start();
+
     setupUI();
     setupAudio();
     
     // Load default preset
-    presetManager.loadPreset(0, audioEngine->getSound(), controller);
-    createParameterControls();
+    switchToPreset(0);
     
     // Don't auto-start audio - wait for user to click play
-    std::cout << "🎧 Synthesizer ready! Click Play to start audio." << std::endl;
+    LOG_INFO("🎧 Synthesizer ready! Click Play to start audio.");
 }
 
 SynthesizerWindow::~SynthesizerWindow() {
@@ -50,6 +60,11 @@ void SynthesizerWindow::setupUI() {
     loadButton->setFixedSize(60, 30);
     presetLayout->addWidget(loadButton);
     
+    saveButton = new QPushButton("Save");
+    saveButton->setFixedSize(60, 30);
+    saveButton->setToolTip("Save the current parameter values of a data preset as a .patch file");
+    presetLayout->addWidget(saveButton);
+    
     // Add play/stop buttons
     playButton = new QPushButton("▶ Play");
     playButton->setFixedSize(80, 30);
@@ -68,9 +83,55 @@ void SynthesizerWindow::setupUI() {
     powerButton->setStyleSheet("QPushButton { background-color: #34495E; color: white; font-weight: bold; border-radius: 4px; }");
     presetLayout->addWidget(powerButton);
 
+    recordButton = new QPushButton("⏺ Record");
+    recordButton->setFixedSize(90, 30);
+    recordButton->setToolTip("Record the output to a WAV (or .raw float) file");
+    recordButton->setEnabled(false);
+    presetLayout->addWidget(recordButton);
+
     presetLayout->addStretch();
     
     mainLayout->addLayout(presetLayout);
+
+    // Part strip
+    QHBoxLayout* partLayout = new QHBoxLayout();
+    partLayout->addWidget(new QLabel("Part:"));
+
+    partSelector = new QComboBox();
+    for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+        partSelector->addItem(QString("Part %1").arg(part + 1));
+    }
+    partSelector->setFixedWidth(100);
+    partLayout->addWidget(partSelector);
+
+    partLayout->addWidget(new QLabel("Volume:"));
+    partVolume = new QSlider(Qt::Horizontal);
+    partVolume->setRange(0, 100);
+    partVolume->setValue(100);
+    partVolume->setFixedWidth(120);
+    partLayout->addWidget(partVolume);
+
+    partLayout->addWidget(new QLabel("Pan:"));
+    partPan = new QSlider(Qt::Horizontal);
+    partPan->setRange(-100, 100);
+    partPan->setValue(0);
+    partPan->setFixedWidth(120);
+    partLayout->addWidget(partPan);
+
+    partLayout->addWidget(new QLabel("Reverb:"));
+    partSend = new QSlider(Qt::Horizontal);
+    partSend->setRange(0, 100);
+    partSend->setValue(0);
+    partSend->setFixedWidth(120);
+    partSend->setToolTip("Send level into the shared reverb");
+    partLayout->addWidget(partSend);
+
+    partBypass = new QCheckBox("Bypass");
+    partBypass->setToolTip("Skip this part in the mix; its Sound and parameters are kept");
+    partLayout->addWidget(partBypass);
+
+    partLayout->addStretch();
+    mainLayout->addLayout(partLayout);
     
     // Separator
     QLabel* separator = new QLabel("");
@@ -84,27 +145,39 @@ void SynthesizerWindow::setupUI() {
     controlsLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(controlsLabel);
     
-    // Scrollable area
-    scrollArea = new QScrollArea();
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    scrollArea->setStyleSheet("QScrollArea { border: none; background-color: transparent; }");
-    
-    scrollContent = new QWidget();
-    scrollLayout = new QVBoxLayout(scrollContent);
-    scrollLayout->setAlignment(Qt::AlignTop);
-    scrollLayout->setSpacing(5);
-    scrollLayout->setContentsMargins(5, 5, 5, 5);
-    
-    scrollArea->setWidget(scrollContent);
-    mainLayout->addWidget(scrollArea, 1);
+    // Parameter tree - rows are painted on demand, no widgets per parameter
+    parameterModel = new ParameterTreeModel(*controllers[currentPart], this);
+    parameterDelegate = new ParameterDelegate(this);
+    parameterView = new QTreeView();
+    parameterView->setModel(parameterModel);
+    parameterView->setItemDelegate(parameterDelegate);
+    parameterView->setUniformRowHeights(true);  // Lets the view skip measuring rows
+    parameterView->setAlternatingRowColors(true);
+    parameterView->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+    parameterView->setColumnWidth(ParameterTreeModel::NameColumn, 320);
+    parameterView->setColumnWidth(ParameterTreeModel::ValueColumn, 220);
+    mainLayout->addWidget(parameterView, 1);
     
     // Connections
     connect(loadButton, &QPushButton::clicked, this, &SynthesizerWindow::onLoadPreset);
+    connect(saveButton, &QPushButton::clicked, this, [this]() { savePatchState(); });
     connect(playButton, &QPushButton::clicked, this, &SynthesizerWindow::onPlay);
     connect(stopButton, &QPushButton::clicked, this, &SynthesizerWindow::onStop);
     connect(powerButton, &QPushButton::clicked, this, &SynthesizerWindow::onPower);
+    connect(recordButton, &QPushButton::clicked, this, &SynthesizerWindow::onRecord);
+    connect(partSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SynthesizerWindow::onPartSelected);
+    connect(partVolume, &QSlider::valueChanged, this, [this](int value) {
+        audioEngine->setPartVolume(currentPart, value / 100.0);
+    });
+    connect(partPan, &QSlider::valueChanged, this, [this](int value) {
+        audioEngine->setPartPan(currentPart, value / 100.0);
+    });
+    connect(partSend, &QSlider::valueChanged, this, [this](int value) {
+        audioEngine->setPartSend(currentPart, value / 100.0);
+    });
+    connect(partBypass, &QCheckBox::toggled, this, [this](bool bypassed) {
+        audioEngine->setPartBypassed(currentPart, bypassed);
+    });
 }
 
 // -----------------------------------------------------------------------------
@@ -120,330 +193,158 @@ void SynthesizerWindow::setupAudio() {
 // Preset Handling
 // -----------------------------------------------------------------------------
 void SynthesizerWindow::onLoadPreset() {
-    int index = presetSelector->currentIndex();
-    presetManager.loadPreset(index, audioEngine->getSound(), controller);
-    
-    clearDynamicControls();
-    createParameterControls();
+    switchToPreset(presetSelector->currentIndex());
 }
 
-// -----------------------------------------------------------------------------
-// UI Cleanup
-// -----------------------------------------------------------------------------
-void SynthesizerWindow::clearDynamicControls() {
-    for (auto* layout : parameterLayouts) {
-        while (QLayoutItem* item = layout->takeAt(0)) {
-            if (QWidget* widget = item->widget()) widget->deleteLater();
-            delete item;
-        }
-        delete layout;
-    }
-    parameterLayouts.clear();
-    controlButtons.clear();
+void SynthesizerWindow::switchToPreset(int index) {
+    publishPreset(currentPart, index);
+    parameterView->expandToDepth(1);
 
-    while (QLayoutItem* item = scrollLayout->takeAt(0)) {
-        if (item->widget()) item->widget()->deleteLater();
-        else delete item;
-    }
+    LOG_INFO("🎵 Part %d switched to preset: %s", currentPart + 1, presetManager.getPresets()[index].name.c_str());
+    presetCache->logStats();
+}
+
+void SynthesizerWindow::publishPreset(int part, int index) {
+    // A ready graph from the cache (or built now on a miss); the audio
+    // thread swaps to it at its next block, nothing is rebuilt in place
+    std::unique_ptr<PreparedPreset> prepared = presetCache->acquire(index);
+    if (!prepared) return;
+    if (isPlaying) prepared->sound->noteOn();  // Keep the note sounding across the switch
+
+    if (part == currentPart) parameterModel->setController(*prepared->controller);
+    controllers[part] = std::move(prepared->controller);
+    partPresets[part] = index;
+    audioEngine->publishSound(part, std::move(prepared->sound));
 }
 
 // -----------------------------------------------------------------------------
-// Create Parameter Controls (Hierarchical)
+// Parts
 // -----------------------------------------------------------------------------
-void SynthesizerWindow::createParameterControls() {
-    std::map<std::string, std::vector<int>> parameterGroups;
-    std::vector<std::string> prefixes;
-
-    // Collect prefixes
-    for (int i = 0; i < controller.getParameterCount(); ++i) {
-        const auto& param = controller.getParameter(i);
-        std::string paramName = param.name;
-
-        size_t pos = 0;
-        while ((pos = paramName.find(" ", pos)) != std::string::npos) {
-            std::string prefix = paramName.substr(0, pos);
-            if (std::find(prefixes.begin(), prefixes.end(), prefix) == prefixes.end())
-                prefixes.push_back(prefix);
-            pos++;
-        }
-    }
-
-    std::sort(prefixes.begin(), prefixes.end(),
-        [](const std::string& a, const std::string& b) {
-            return a.length() > b.length();
-        });
-
-    // Group parameters
-    for (int i = 0; i < controller.getParameterCount(); ++i) {
-        const auto& param = controller.getParameter(i);
-        std::string paramName = param.name;
-
-        if (paramName == "Master Volume") {
-            parameterGroups["Master Controls"].push_back(i);
-            continue;
-        }
-
-        bool assigned = false;
-        for (const auto& prefix : prefixes) {
-            if (paramName.rfind(prefix, 0) == 0) {
-                parameterGroups[prefix].push_back(i);
-                assigned = true;
-                break;
-            }
-        }
-        if (!assigned)
-            parameterGroups["Main"].push_back(i);
-    }
-
-    // Build hierarchy
-    std::map<std::string, std::map<std::string, std::vector<int>>> hierarchicalGroups;
-    for (const auto& entry : parameterGroups) {
-        std::string prefix = entry.first;
-        std::vector<int> indices = entry.second;
-
-        std::istringstream iss(prefix);
-        std::vector<std::string> parts;
-        std::string part;
-        while (std::getline(iss, part, ' ')) 
-            if (!part.empty()) parts.push_back(part);
-
-        std::string path;
-        for (size_t i = 0; i < parts.size(); ++i) {
-            if (i > 0) path += " → ";
-            path += parts[i];
-        }
-
-        std::string topLevel = parts.empty() ? "Main" : parts[0];
-        hierarchicalGroups[topLevel][path] = indices;
-    }
+void SynthesizerWindow::onPartSelected(int part) {
+    if (part < 0 || part >= AudioEngine::MaxParts) return;
+    currentPart = part;
+    parameterModel->setController(*controllers[currentPart]);
+    parameterView->expandToDepth(1);
+    if (partPresets[currentPart] >= 0) presetSelector->setCurrentIndex(partPresets[currentPart]);
+    updatePartControls();
+}
 
-    // Create controls
-    for (const auto& topLevel : hierarchicalGroups) {
-        std::string topLevelName = topLevel.first;
-        
-        QLabel* topLevelHeader = new QLabel(QString::fromStdString("📁 " + topLevelName));
-        topLevelHeader->setStyleSheet(
-            "font-weight: bold; font-size: 16px; background-color: #E0E7FF;"
-            "border-left: 5px solid #3498DB; padding: 10px; margin-top: 10px;"
-        );
-        scrollLayout->addWidget(topLevelHeader);
-        
-        for (const auto& subgroup : topLevel.second) {
-            std::string path = subgroup.first;
-            const auto& indices = subgroup.second;
-
-            if (path != topLevelName)
-                createParameterGroup(path, indices);
-            else
-                for (int paramIndex : indices)
-                    createSingleParameter(paramIndex, 1);
-        }
+void SynthesizerWindow::updatePartControls() {
+    // Show the engine's values without writing them back
+    QSignalBlocker volumeBlocker(partVolume);
+    QSignalBlocker panBlocker(partPan);
+    QSignalBlocker sendBlocker(partSend);
+    QSignalBlocker bypassBlocker(partBypass);
+    partVolume->setValue(static_cast<int>(std::lround(audioEngine->getPartVolume(currentPart) * 100.0)));
+    partPan->setValue(static_cast<int>(std::lround(audioEngine->getPartPan(currentPart) * 100.0)));
+    partSend->setValue(static_cast<int>(std::lround(audioEngine->getPartSend(currentPart) * 100.0)));
+    partBypass->setChecked(audioEngine->isPartBypassed(currentPart));
+}
 
-        QLabel* spacer = new QLabel("");
-        spacer->setFixedHeight(15);
-        scrollLayout->addWidget(spacer);
+void SynthesizerWindow::notePartsOn() {
+    for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+        if (Sound* sound = audioEngine->getSound(part)) sound->noteOn();
     }
 }
 
-// -----------------------------------------------------------------------------
-// Create Group Header
-// -----------------------------------------------------------------------------
-void SynthesizerWindow::createParameterGroup(const std::string& groupName, const std::vector<int>& paramIndices) {
-    if (paramIndices.empty()) return;
-    
-    int indentLevel = 0;
-    std::string arrow = "→";
-    size_t pos = 0;
-    while ((pos = groupName.find(arrow, pos)) != std::string::npos) {
-        indentLevel++;
-        pos += arrow.length();
+void SynthesizerWindow::notePartsOff() {
+    for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+        if (Sound* sound = audioEngine->getSound(part)) sound->noteOff();
     }
-    
-    QHBoxLayout* headerLayout = new QHBoxLayout();
-    for (int i = 0; i < indentLevel; ++i)
-        headerLayout->addWidget(new QLabel("    "));
-    
-    QLabel* groupLabel = new QLabel(QString::fromStdString("📁 " + groupName));
-    QString headerStyle = "font-weight: bold; font-size: 14px; color: #2C3E50; padding: 8px 0px;";
-    
-    if (indentLevel == 0)
-        headerStyle += "background-color: #E8F4FD; border-left: 4px solid #3498DB;";
-    else if (indentLevel == 1)
-        headerStyle += "background-color: #FFF2E8; border-left: 4px solid #E67E22;";
-    else if (indentLevel == 2)
-        headerStyle += "background-color: #E8F8E8; border-left: 4px solid #27AE60;";
-    
-    groupLabel->setStyleSheet(headerStyle);
-    headerLayout->addWidget(groupLabel);
-    headerLayout->addStretch();
-    
-    scrollLayout->addLayout(headerLayout);
-    parameterLayouts.push_back(headerLayout);
-    
-    for (int paramIndex : paramIndices)
-        createSingleParameter(paramIndex, indentLevel + 1);
-    
-    QLabel* spacer = new QLabel("");
-    spacer->setFixedHeight(10);
-    scrollLayout->addWidget(spacer);
 }
 
-// -----------------------------------------------------------------------------
-// Create Parameter Row
-// -----------------------------------------------------------------------------
-void SynthesizerWindow::createSingleParameter(int paramIndex, int indentLevel) {
-    const auto param = controller.getParameter(paramIndex);
-    
-    // Check if this is a volume parameter
-    bool isVolumeParam = (param.name.find("Volume") != std::string::npos) || 
-                        (param.name.find("volume") != std::string::npos);
-    
-    QHBoxLayout* paramLayout = new QHBoxLayout();
-    QString indentStr;
-    for (int i = 0; i < indentLevel; ++i) indentStr += "    ";
-
-    std::string displayName = param.name;
-    size_t lastSpace = displayName.find_last_of(' ');
-    if (lastSpace != std::string::npos)
-        displayName = displayName.substr(lastSpace + 1);
-
-    QLabel* label = new QLabel(indentStr + "🔧 " + QString::fromStdString(displayName) + ":");
-    label->setFixedWidth(180 + (indentLevel * 20));
-    QString labelStyle = "font-weight: bold; padding: 2px;";
-    if (indentLevel == 1) labelStyle += "color: #2980B9;";
-    else if (indentLevel == 2) labelStyle += "color: #D35400;";
-    else if (indentLevel == 3) labelStyle += "color: #27AE60;";
-    label->setStyleSheet(labelStyle);
-    paramLayout->addWidget(label);
-
-    QSlider* slider = new QSlider(Qt::Horizontal);
-    slider->setRange(0, 1000);
-
-    double minV = param.minValue;
-    double maxV = param.maxValue;
-    double curV = (param.valuePtr ? *param.valuePtr : minV);
-    double range = maxV - minV;
-    double normalized = (range > 0.0) ? ((curV - minV) / range) : 0.0;
-    int initialSliderValue = std::clamp<int>(static_cast<int>(std::round(normalized * 1000.0)), 0, 1000);
-    slider->setValue(initialSliderValue);
-
-    slider->setStyleSheet(
-        "QSlider::groove:horizontal { height: 8px; background: #E0E0E0; } "
-        "QSlider::handle:horizontal { background: #3498DB; width: 18px; margin: -5px 0; border-radius: 9px; }"
-    );
-    slider->setFixedWidth(150);
-    paramLayout->addWidget(slider);
-
-    QLineEdit* valueEdit = new QLineEdit(QString::number(static_cast<int>(std::round(curV))));
-    valueEdit->setFixedWidth(70);
-    valueEdit->setAlignment(Qt::AlignCenter);
-    valueEdit->setStyleSheet("border: 2px solid #BDC3C7; padding: 4px; background: white; border-radius: 4px;");
-    QIntValidator* validator = new QIntValidator(static_cast<int>(minV), static_cast<int>(maxV), valueEdit);
-    valueEdit->setValidator(validator);
-    paramLayout->addWidget(valueEdit);
-
-    QLabel* rangeLabel = new QLabel(QString("(%1 - %2)")
-                                   .arg(static_cast<int>(minV))
-                                   .arg(static_cast<int>(maxV)));
-    rangeLabel->setStyleSheet("color: #7F8C8D; font-size: 9px; font-style: italic;");
-    paramLayout->addWidget(rangeLabel);
-    paramLayout->addStretch();
-
-    // Signal connections with volume conversion
-    connect(slider, &QSlider::valueChanged, this, [this, paramIndex, slider, valueEdit, minV, maxV, isVolumeParam]() {
-        double normalizedValue = slider->value() / 1000.0;
-        double actualValue = (maxV > minV)
-            ? minV + normalizedValue * (maxV - minV)
-            : minV;
-        int intValue = static_cast<int>(std::round(actualValue));
-
-        if (isVolumeParam) {
-            // Convert 0-100 to 0.0-1.0 for audio engine
-            double audioValue = intValue / 100.0;
-            controller.setParameter(paramIndex, audioValue);
-        } else {
-            controller.setParameter(paramIndex, intValue);
-        }
-        valueEdit->setText(QString::number(intValue));
-    });
-
-    connect(valueEdit, &QLineEdit::editingFinished, this, [this, paramIndex, valueEdit, slider, minV, maxV, isVolumeParam]() {
-        int value = valueEdit->text().toInt();
-        value = std::clamp(value, static_cast<int>(minV), static_cast<int>(maxV));
-        
-        if (isVolumeParam) {
-            // Convert 0-100 to 0.0-1.0 for audio engine
-            double audioValue = value / 100.0;
-            controller.setParameter(paramIndex, audioValue);
-        } else {
-            controller.setParameter(paramIndex, value);
-        }
-
-        double normalizedValue = (maxV > minV) ? ((value - minV) / (maxV - minV)) : 0.0;
-        int sliderPos = std::clamp<int>(static_cast<int>(std::round(normalizedValue * 1000.0)), 0, 1000);
-
-        bool oldBlock = slider->blockSignals(true);
-        slider->setValue(sliderPos);
-        slider->blockSignals(oldBlock);
-    });
-
-    scrollLayout->addLayout(paramLayout);
-    parameterLayouts.push_back(paramLayout);
+void SynthesizerWindow::savePatchState() {
+    QString path = QFileDialog::getSaveFileName(this, "Save Patch", "patches", "Patches (*.patch)");
+    if (path.isEmpty()) return;
+    presetManager.savePatchState(presetSelector->currentIndex(), *controllers[currentPart], path.toStdString());
 }
 
 // -----------------------------------------------------------------------------
 // Sync Audio Parameters
 // -----------------------------------------------------------------------------
 void SynthesizerWindow::syncAudioParameters() {
-    // Placeholder for additional real-time sync logic if needed.
+    // Free the graphs the audio thread switched away from, off the audio thread
+    if (audioEngine) audioEngine->reclaimRetired();
 }
 
 void SynthesizerWindow::onPower() {
     if (audioEngine && audioEngine->isRunning()) {
-        // Ensure sound is stopped and envelope is released
-        if (audioEngine->getSound())
-            audioEngine->getSound()->noteOff();
+        // Ensure every part is stopped and its envelope released
+        notePartsOff();
         isPlaying = false;
         playButton->setEnabled(false);
         stopButton->setEnabled(false);
         powerButton->setText("🔌 Power On");
-        audioEngine->stop();
-        std::cout << "🔌 Audio engine stopped." << std::endl;
+        audioEngine->stop();  // Also finishes a recording
+        recordButton->setText("⏺ Record");
+        recordButton->setEnabled(false);
+        LOG_INFO("🔌 Audio engine stopped.");
     } else {
-        // Re-create AudioEngine and Sound
+        // Re-create AudioEngine and every part's Sound, keeping the part mix
+        double volumes[AudioEngine::MaxParts], pans[AudioEngine::MaxParts], sends[AudioEngine::MaxParts];
+        bool bypassed[AudioEngine::MaxParts];
+        for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+            volumes[part] = audioEngine->getPartVolume(part);
+            pans[part] = audioEngine->getPartPan(part);
+            sends[part] = audioEngine->getPartSend(part);
+            bypassed[part] = audioEngine->isPartBypassed(part);
+        }
         audioEngine = std::make_unique<AudioEngine>();
-        int index = presetSelector->currentIndex();
-        presetManager.loadPreset(index, audioEngine->getSound(), controller);
-        createParameterControls();
+        for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+            audioEngine->setPartVolume(part, volumes[part]);
+            audioEngine->setPartPan(part, pans[part]);
+            audioEngine->setPartSend(part, sends[part]);
+            audioEngine->setPartBypassed(part, bypassed[part]);
+        }
 
+        // Publish only once the device has settled its rate and channels and
+        // the cache builds for them, so no part plays a graph built for others
         audioEngine->start();
+        presetCache->setSampleRate(audioEngine->getSampleRate());
+        presetCache->setChannelCount(audioEngine->getChannelCount());
+        for (int part = 0; part < AudioEngine::MaxParts; ++part) {
+            if (partPresets[part] >= 0 && part != currentPart) publishPreset(part, partPresets[part]);
+        }
+        switchToPreset(presetSelector->currentIndex());
         isPlaying = false;
         playButton->setEnabled(true);
         stopButton->setEnabled(false);
         powerButton->setText("🔋 Power Off");
-        std::cout << "🔋 Audio engine started." << std::endl;
+        recordButton->setText(audioEngine->isRecording() ? "⏹ Recording" : "⏺ Record");
+        recordButton->setEnabled(audioEngine->isRunning());
+        LOG_INFO("🔋 Audio engine started.");
+    }
+}
+
+void SynthesizerWindow::onRecord() {
+    if (!audioEngine || !audioEngine->isRunning()) return;
+    if (audioEngine->isRecording()) {
+        audioEngine->stopRecording();
+        recordButton->setText("⏺ Record");
+        return;
     }
+    QString path = QFileDialog::getSaveFileName(this, "Record To", "synth_take.wav", "Audio (*.wav *.raw)");
+    if (path.isEmpty() || !audioEngine->startRecording(path.toStdString())) return;
+    recordButton->setText("⏹ Recording");
 }
 
 void SynthesizerWindow::onPlay() {
     if (audioEngine && audioEngine->isRunning() && !isPlaying) {
-        if (audioEngine->getSound())
-            audioEngine->getSound()->noteOn();
+        notePartsOn();
         isPlaying = true;
         playButton->setEnabled(false);
         stopButton->setEnabled(true);
-        std::cout << "🎵 Note on" << std::endl;
+        LOG_INFO("🎵 Note on");
     }
 }
 
 void SynthesizerWindow::onStop() {
     if (audioEngine && audioEngine->isRunning() && isPlaying) {
-        if (audioEngine->getSound())
-            audioEngine->getSound()->noteOff();
+        notePartsOff();
         isPlaying = false;
         playButton->setEnabled(true);
         stopButton->setEnabled(false);
-        std::cout << "⏸️ Note released (envelope release phase)" << std::endl;
+        LOG_INFO("⏸️ Note released (envelope release phase)");
     }
 }
 
@@ -7,14 +7,16 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QComboBox>
-#include <QTimer>
-#include <QScrollArea>
 #include <QSlider>
-#include <QLineEdit>
-#include <QDoubleValidator> 
+#include <QCheckBox>
+#include <QTimer>
+#include <QTreeView>
 #include <vector>
 #include "../interface/LiveController.h"
+#include "ParameterTreeModel.h"
+#include "ParameterDelegate.h"
 #include "../presets/PresetManager.h"
+#include "../presets/PresetCache.h"
 #include "../audio/AudioEngine.h"
 
 class SynthesizerWindow : public QMainWindow {
@@ -29,6 +31,8 @@ private slots:
     void onPlay();
     void onStop();
     void onPower();
+    void onRecord();
+    void onPartSelected(int part);
     void syncAudioParameters();
 
 private:
@@ -37,24 +41,35 @@ private:
     QVBoxLayout* mainLayout;
     QComboBox* presetSelector;
     QPushButton* loadButton;
+    QPushButton* saveButton;
     QPushButton* playButton;
     QPushButton* stopButton;
     QPushButton* powerButton; // Add this
+    QPushButton* recordButton;
     QLabel* controlsLabel;
+
+    // Part strip - the preset selector, parameter panel and these controls
+    // all act on the selected part
+    QComboBox* partSelector;
+    QSlider* partVolume;   // 0 to 100 %
+    QSlider* partPan;      // -100 to +100
+    QSlider* partSend;     // Reverb send, 0 to 100
+    QCheckBox* partBypass;
     
-    // Scrolling components
-    QScrollArea* scrollArea;
-    QWidget* scrollContent;
-    QVBoxLayout* scrollLayout;
-    
-    // Parameter controls (dynamic)
-    std::vector<QHBoxLayout*> parameterLayouts;
-    std::vector<QPushButton*> controlButtons;
+    // Parameter panel - a virtualized view over the controller's parameter tree
+    QTreeView* parameterView;
+    ParameterTreeModel* parameterModel;
+    ParameterDelegate* parameterDelegate;
     
     // Core systems
     std::unique_ptr<AudioEngine> audioEngine;
-    LiveController controller;
+    // One controller per part, owned by the preset playing in it, so every
+    // part has its own parameter namespace
+    std::unique_ptr<LiveController> controllers[AudioEngine::MaxParts];
+    int partPresets[AudioEngine::MaxParts];  // Preset playing in each part, -1 for none
+    int currentPart = 0;
     PresetManager presetManager;
+    std::unique_ptr<PresetCache> presetCache;   // After presetManager, which it reads
     
     // Timer for audio sync
     QTimer* audioSyncTimer;
@@ -65,10 +80,13 @@ private:
     // Methods
     void setupUI();
     void setupAudio();
-    void clearDynamicControls();
-    void createParameterControls();
-    void createParameterGroup(const std::string& groupName, const std::vector<int>& paramIndices);
-    void createSingleParameter(int paramIndex, int indentLevel);
+    void switchToPreset(int index);
+    void publishPreset(int part, int index);
+    void updatePartControls();
+    // Note on or off in every part that has a Sound
+    void notePartsOn();
+    void notePartsOff();
+    void savePatchState();
 };
 
 #endif // SYNTHESIZERWINDOW_H
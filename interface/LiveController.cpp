@@ -1,86 +1,233 @@
 #include "LiveController.h"
-#include <iostream>
-#include <iomanip>
+#include "../core/Logger.h"
 #include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr int EmptySlot = -1;
+constexpr size_t MinimumSlots = 64;
+constexpr size_t NameChunkSize = 2048;  // Grows with the arena's doubling chunks
+constexpr size_t ExpectedParameters = 32;  // Typical preset; larger ones grow as usual
+constexpr size_t ExpectedGroups = 16;
+
+// "prefix name" (or just name) copied into the arena, NUL-terminated
+std::string_view storeName(PatchArena& arena, std::string_view prefix, std::string_view name) {
+    size_t prefixLength = prefix.empty() ? 0 : prefix.size() + 1;
+    size_t length = prefixLength + name.size();
+    char* stored = static_cast<char*>(arena.allocate(length + 1, 1));
+    if (prefixLength) {
+        std::memcpy(stored, prefix.data(), prefix.size());
+        stored[prefix.size()] = ' ';
+    }
+    std::memcpy(stored + prefixLength, name.data(), name.size());
+    stored[length] = '\0';
+    return std::string_view(stored, length);
+}
+
+// Slot that holds key, or the empty slot where it belongs. keyOf(id) is the
+// path stored for an id; tables are kept at most half full.
+template <typename KeyOf>
+size_t findSlot(const std::vector<int>& slots, std::string_view key, KeyOf keyOf) {
+    size_t mask = slots.size() - 1;
+    size_t slot = std::hash<std::string_view>()(key) & mask;
+    while (slots[slot] != EmptySlot && keyOf(slots[slot]) != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+template <typename KeyOf>
+int lookupSlot(const std::vector<int>& slots, std::string_view key, KeyOf keyOf) {
+    return slots.empty() ? EmptySlot : slots[findSlot(slots, key, keyOf)];
+}
+
+// Maps keyOf(id) to id, replacing an older id with the same path
+template <typename KeyOf>
+void insertSlot(std::vector<int>& slots, int& used, int id, KeyOf keyOf) {
+    if (static_cast<size_t>(used + 1) * 2 > slots.size()) {
+        std::vector<int> grown(std::max(MinimumSlots, slots.size() * 2), EmptySlot);
+        for (int stored : slots) {
+            if (stored != EmptySlot) grown[findSlot(grown, keyOf(stored), keyOf)] = stored;
+        }
+        slots.swap(grown);
+    }
+    size_t slot = findSlot(slots, keyOf(id), keyOf);
+    if (slots[slot] == EmptySlot) ++used;
+    slots[slot] = id;
+}
+
+} // namespace
 
 LiveController::LiveController() {
+    clearParameters();
+}
+
+ParameterId LiveController::addParameter(const std::string& name, double* valuePtr, 
+                                         double minValue, double maxValue, double step,
+                                         const ParameterInfo& info) {
+    return insertParameter(RootGroup, "", name, valuePtr, minValue, maxValue, step, info);
+}
+
+ParameterId LiveController::addParameterInGroup(const std::string& groupPath, const std::string& name,
+                                                double* valuePtr, double minValue, double maxValue,
+                                                double step, const ParameterInfo& info) {
+    int group = ensureGroup(groupPath);
+    return insertParameter(group, groupPath, name, valuePtr, minValue, maxValue, step, info);
 }
 
-void LiveController::addParameter(const std::string& name, double* valuePtr, 
-                                 double minValue, double maxValue, double step) {
-    parameters.emplace_back(name, valuePtr, minValue, maxValue, step);
+ParameterId LiveController::insertParameter(int group, std::string_view groupPath, std::string_view name,
+                                            double* valuePtr, double minValue, double maxValue, double step,
+                                            const ParameterInfo& info) {
+    // The full path is stored once; the display name is its tail
+    std::string_view fullName = storeName(*names, groupPath, name);
+    ParameterId id = static_cast<ParameterId>(parameters.size());
+    parameters.emplace_back(fullName, valuePtr, minValue, maxValue, step);
+    LiveParameter& param = parameters.back();
+    param.id = id;
+    param.group = group;
+    param.displayName = fullName.substr(fullName.size() - name.size());
+    param.info = info;
+
+    groups[group].parameters.push_back(id);
+    // A re-registered path resolves to the newest entry
+    insertSlot(parameterSlots, parameterSlotsUsed, id,
+               [this](int stored) -> std::string_view { return parameters[stored].name; });
+    return id;
+}
+
+int LiveController::ensureGroup(const std::string& path) {
+    if (path.empty()) return RootGroup;
+    auto groupPath = [this](int stored) -> std::string_view { return groups[stored].path; };
+    int found = lookupSlot(groupSlots, path, groupPath);
+    if (found != EmptySlot) return found;
+
+    // Parent is the longest existing group whose path is a word prefix of ours;
+    // prefixes are built outer-first, so this is a handful of hash lookups
+    std::string_view stored = storeName(*names, "", path);
+    int parent = RootGroup;
+    std::string_view displayName = stored;
+    for (size_t cut = stored.find_last_of(' '); cut != std::string_view::npos && cut > 0;
+         cut = stored.find_last_of(' ', cut - 1)) {
+        int ancestor = lookupSlot(groupSlots, stored.substr(0, cut), groupPath);
+        if (ancestor != EmptySlot) {
+            parent = ancestor;
+            displayName = stored.substr(cut + 1);
+            break;
+        }
+    }
+
+    int index = static_cast<int>(groups.size());
+    ParameterGroup group;
+    group.path = stored;
+    group.displayName = displayName;
+    group.parent = parent;
+    groups.push_back(std::move(group));
+    groups[parent].children.push_back(index);
+    insertSlot(groupSlots, groupSlotsUsed, index, groupPath);
+    return index;
 }
 
 void LiveController::clearParameters() {
     parameters.clear();
+    parameterSlots.clear();
+    groupSlots.clear();
+    parameterSlotsUsed = 0;
+    groupSlotsUsed = 0;
+    groups.clear();
+    parameters.reserve(ExpectedParameters);
+    groups.reserve(ExpectedGroups);
+    groups.emplace_back();  // Root
+    names = std::make_unique<PatchArena>(NameChunkSize);
+}
+
+ParameterId LiveController::findParameter(const std::string& path) const {
+    int found = lookupSlot(parameterSlots, path,
+                           [this](int stored) -> std::string_view { return parameters[stored].name; });
+    return (found != EmptySlot) ? found : InvalidParameterId;
+}
+
+int LiveController::findGroup(const std::string& path) const {
+    if (path.empty()) return RootGroup;
+    return lookupSlot(groupSlots, path, [this](int stored) -> std::string_view { return groups[stored].path; });
+}
+
+void LiveController::increaseParameter(ParameterId id) {
+    if (isValid(id)) {
+        *parameters[id].valuePtr += parameters[id].step;
+        clampValue(id);
+        LOG_DEBUG("📈 %s: %.2f", parameters[id].name.data(), *parameters[id].valuePtr);
+        executeCallback(id);
+    }
+}
+
+void LiveController::decreaseParameter(ParameterId id) {
+    if (isValid(id)) {
+        *parameters[id].valuePtr -= parameters[id].step;
+        clampValue(id);
+        LOG_DEBUG("📉 %s: %.2f", parameters[id].name.data(), *parameters[id].valuePtr);
+        executeCallback(id);
+    }
 }
 
-void LiveController::increaseParameter(int index) {
-    if (index >= 0 && index < static_cast<int>(parameters.size())) {
-        *parameters[index].valuePtr += parameters[index].step;
-        clampValue(index);
-        std::cout << "📈 " << parameters[index].name << ": " 
-                  << std::fixed << std::setprecision(2) << *parameters[index].valuePtr << std::endl;
-        executeCallback(index);
+void LiveController::setParameter(ParameterId id, double value) {
+    if (isValid(id)) {
+        *parameters[id].valuePtr = value;
+        clampValue(id);
+        LOG_DEBUG("🎛️  %s set to: %.2f", parameters[id].name.data(), *parameters[id].valuePtr);
+        executeCallback(id);
     }
 }
 
-void LiveController::decreaseParameter(int index) {
-    if (index >= 0 && index < static_cast<int>(parameters.size())) {
-        *parameters[index].valuePtr -= parameters[index].step;
-        clampValue(index);
-        std::cout << "📉 " << parameters[index].name << ": " 
-                  << std::fixed << std::setprecision(2) << *parameters[index].valuePtr << std::endl;
-        executeCallback(index);
+void LiveController::setParameterCallback(ParameterId id, std::function<void()> callback) {
+    if (isValid(id)) {
+        parameters[id].callback = callback;
     }
 }
 
-void LiveController::setParameter(int index, double value) {
-    if (index >= 0 && index < static_cast<int>(parameters.size())) {
-        *parameters[index].valuePtr = value;
-        clampValue(index);
-        std::cout << "🎛️  " << parameters[index].name << " set to: " 
-                  << std::fixed << std::setprecision(2) << *parameters[index].valuePtr << std::endl;
-        executeCallback(index);
+void LiveController::setParameterInfo(ParameterId id, const ParameterInfo& info) {
+    if (isValid(id)) {
+        parameters[id].info = info;
     }
 }
 
-void LiveController::setParameterCallback(int index, std::function<void()> callback) {
-    if (index >= 0 && index < static_cast<int>(parameters.size())) {
-        parameters[index].callback = callback;
+void LiveController::setParameterRange(ParameterId id, double minValue, double maxValue) {
+    if (isValid(id) && minValue <= maxValue) {
+        parameters[id].minValue = minValue;
+        parameters[id].maxValue = maxValue;
     }
 }
 
-void LiveController::executeCallback(int index) {
-    if (index >= 0 && index < static_cast<int>(parameters.size())) {
-        if (parameters[index].callback) {
-            parameters[index].callback();
+void LiveController::executeCallback(ParameterId id) {
+    if (isValid(id)) {
+        if (parameters[id].callback) {
+            parameters[id].callback();
         }
     }
 }
 
-void LiveController::clampValue(int index) {
-    auto& param = parameters[index];
+void LiveController::clampValue(ParameterId id) {
+    auto& param = parameters[id];
     *param.valuePtr = std::max(param.minValue, std::min(param.maxValue, *param.valuePtr));
 }
 
 void LiveController::printParameters() const {
-    std::cout << "\n🎛️  LIVE PARAMETERS" << std::endl;
-    std::cout << std::string(50, '=') << std::endl;
+    const std::string rule(50, '=');
+    LOG_INFO("\n🎛️  LIVE PARAMETERS");
+    LOG_INFO("%s", rule.c_str());
     
     for (int i = 0; i < static_cast<int>(parameters.size()); ++i) {
         const auto& param = parameters[i];
-        std::cout << "[" << i << "] " << std::setw(15) << param.name << ": " 
-                  << std::setw(8) << std::fixed << std::setprecision(2) << *param.valuePtr
-                  << " (" << param.minValue << " - " << param.maxValue << ")" << std::endl;
+        LOG_INFO("[%d] %15s: %8.2f (%.2f - %.2f)", i, param.name.data(), *param.valuePtr,
+                 param.minValue, param.maxValue);
     }
-    std::cout << std::string(50, '=') << std::endl;
+    LOG_INFO("%s", rule.c_str());
 }
 
 void LiveController::printControls() const {
-    std::cout << "\n🎮 CONTROLS:" << std::endl;
-    std::cout << "  Numbers 0-9: Select parameter" << std::endl;
-    std::cout << "  +/-: Increase/decrease selected parameter" << std::endl;
-    std::cout << "  p: Print current parameters" << std::endl;
-    std::cout << "  q: Quit" << std::endl;
+    LOG_INFO("\n🎮 CONTROLS:");
+    LOG_INFO("  Numbers 0-9: Select parameter");
+    LOG_INFO("  +/-: Increase/decrease selected parameter");
+    LOG_INFO("  p: Print current parameters");
+    LOG_INFO("  q: Quit");
 }
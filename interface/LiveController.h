@@ -3,49 +3,99 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <memory>
+#include "ParameterInfo.h"
+#include "../core/PatchArena.h"
 
-// Simple parameter for live control
+// Simple parameter for live control. Names are NUL-terminated views into
+// storage owned by the controller, valid until it is cleared.
 struct LiveParameter {
-    std::string name;
+    std::string_view name;      // Full path, e.g. "FM Carrier Sine Frequency"
     double* valuePtr;           // Direct pointer to the value to control
     double minValue;
     double maxValue;
     double step;               // How much to change per adjustment
     std::function<void()> callback; // Callback when parameter changes
-    
-    LiveParameter(const std::string& n, double* ptr, double min, double max, double s = 0.1)
-        : name(n), valuePtr(ptr), minValue(min), maxValue(max), step(s) {}
+
+    ParameterId id = InvalidParameterId;
+    int group = 0;              // Owning ParameterGroup, 0 is the root
+    std::string_view displayName;  // Name without the group path
+    ParameterInfo info;
+
+    LiveParameter(std::string_view n, double* ptr, double min, double max, double s = 0.1)
+        : name(n), valuePtr(ptr), minValue(min), maxValue(max), step(s), displayName(n) {}
+};
+
+// Node of the parameter tree. Groups come from the registration prefixes:
+// "FM Carrier" becomes a child "Carrier" of "FM" when "FM" already exists.
+struct ParameterGroup {
+    std::string_view path = "";         // Full prefix, e.g. "FM Carrier"
+    std::string_view displayName = "";  // Last part relative to the parent, e.g. "Carrier"
+    int parent = -1;            // -1 for the root
+    std::vector<int> children;
+    std::vector<ParameterId> parameters;
 };
 
 class LiveController {
 public:
+    static constexpr int RootGroup = 0;
+
     LiveController();
-    
-    // Parameter management
-    void addParameter(const std::string& name, double* valuePtr, 
-                     double minValue, double maxValue, double step = 0.1);
+
+    // Parameter management. The returned id indexes every other call in O(1).
+    ParameterId addParameter(const std::string& name, double* valuePtr,
+                             double minValue, double maxValue, double step = 0.1,
+                             const ParameterInfo& info = {});
+    // Registers "groupPath name" inside the group for groupPath, creating it on first use
+    ParameterId addParameterInGroup(const std::string& groupPath, const std::string& name,
+                                    double* valuePtr, double minValue, double maxValue,
+                                    double step = 0.1, const ParameterInfo& info = {});
     void clearParameters();
-    
+
     // Control functions
-    void increaseParameter(int index);
-    void decreaseParameter(int index);
-    void setParameter(int index, double value);
-    
+    void increaseParameter(ParameterId id);
+    void decreaseParameter(ParameterId id);
+    void setParameter(ParameterId id, double value);
+
     // Callback management
-    void setParameterCallback(int index, std::function<void()> callback);
-    
+    void setParameterCallback(ParameterId id, std::function<void()> callback);
+    void setParameterInfo(ParameterId id, const ParameterInfo& info);
+    // Narrow or widen the range of a registered parameter (stored patches carry their own)
+    void setParameterRange(ParameterId id, double minValue, double maxValue);
+
+    // Lookup by full path ("FM Carrier Sine Frequency"); InvalidParameterId if unknown
+    ParameterId findParameter(const std::string& path) const;
+    int findGroup(const std::string& path) const;
+
     // Info functions
     void printParameters() const;
     void printControls() const;
     int getParameterCount() const { return parameters.size(); }
-    const LiveParameter& getParameter(int index) const { return parameters[index]; }
+    const LiveParameter& getParameter(ParameterId id) const { return parameters[id]; }
+    int getGroupCount() const { return groups.size(); }
+    const ParameterGroup& getGroup(int index) const { return groups[index]; }
 
 private:
     std::vector<LiveParameter> parameters;
-    
-    void clampValue(int index);
-    void executeCallback(int index);
+    std::vector<ParameterGroup> groups;
+    std::unique_ptr<PatchArena> names;  // Every name and path above, freed together
+
+    // Open-addressed path indexes: slots hold ids and the keys are the names
+    // already stored above, so registering a parameter adds no hash nodes
+    std::vector<int> parameterSlots;
+    std::vector<int> groupSlots;
+    int parameterSlotsUsed = 0;
+    int groupSlotsUsed = 0;
+
+    int ensureGroup(const std::string& path);
+    ParameterId insertParameter(int group, std::string_view groupPath, std::string_view name,
+                                double* valuePtr, double minValue, double maxValue, double step,
+                                const ParameterInfo& info);
+    bool isValid(ParameterId id) const { return id >= 0 && id < static_cast<int>(parameters.size()); }
+    void clampValue(ParameterId id);
+    void executeCallback(ParameterId id);
 };
 
 #endif // LIVECONTROLLER_H
@@ -0,0 +1,22 @@
+#ifndef PARAMETERINFO_H
+#define PARAMETERINFO_H
+
+#include <string>
+
+// Stable handle of a registered parameter; valid until the controller is cleared
+using ParameterId = int;
+constexpr ParameterId InvalidParameterId = -1;
+
+enum class ParameterType {
+    Continuous,  // Any value in range
+    Integer,     // Whole steps only (voice counts, factors)
+    Toggle       // 0 or 1
+};
+
+// Typed metadata shown by the GUI next to a parameter
+struct ParameterInfo {
+    std::string unit;  // "Hz", "ms", "%", "cents", ... or empty
+    ParameterType type = ParameterType::Continuous;
+};
+
+#endif // PARAMETERINFO_H
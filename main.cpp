@@ -1,17 +1,58 @@
-#include <iostream>
+#include "core/Logger.h"
 #include <QApplication>
+#include <algorithm>
 #include "gui/SynthesizerWindow.h"
+#include "gui/ParameterPanelBenchmark.h"
+#include "audio/AudioEngine.h"
+
+// --audio=qt|alsa|null|file|virtual  --audio-device=hw:0  --period=FRAMES  --periods=N
+// --audio-file=out.wav  --clock-speed=X (virtual device; 0 = simulated clock)
+// --rate=HZ (asked of the device)  --engine-rate=HZ (render at this rate and resample)
+// --device-rate=HZ (null/file/virtual: emulate a device at another rate)
+// --channels=N (asked of the device; the engine renders what it grants)
+// --record=take.wav|take.raw (record the output from start)  --record-direct (O_DIRECT)
+static AudioBackend::Config parseAudioOptions(const QStringList& arguments) {
+    AudioBackend::Config config;
+    for (const QString& argument : arguments) {
+        QString value = argument.section('=', 1);
+        if (argument.startsWith("--audio=")) config.backend = value.toStdString();
+        else if (argument.startsWith("--audio-device=")) config.device = value.toStdString();
+        else if (argument.startsWith("--audio-file=")) config.path = value.toStdString();
+        else if (argument.startsWith("--period=")) config.periodFrames = std::max(16, value.toInt());
+        else if (argument.startsWith("--periods=")) config.periods = std::max(2, value.toInt());
+        else if (argument.startsWith("--clock-speed=")) config.clockSpeed = std::max(0.0, value.toDouble());
+        else if (argument.startsWith("--device-rate=")) config.deviceRate = std::max(0.0, value.toDouble());
+        else if (argument.startsWith("--rate=")) config.sampleRate = std::max(8000.0, value.toDouble());
+        else if (argument.startsWith("--engine-rate=")) config.engineRate = std::max(0.0, value.toDouble());
+        else if (argument.startsWith("--record=")) config.recordPath = value.toStdString();
+        else if (argument == "--record-direct") config.recordDirect = true;
+        else if (argument.startsWith("--channels=")) {
+            config.channels = std::clamp(value.toInt(), 1, AudioBackend::MaxChannels);
+        }
+    }
+    if (config.backend == "file" && config.path.empty()) config.path = "synth_output.wav";
+    return config;
+}
 
 int main(int argc, char *argv[]) {
-    std::cout << "=== Modular Sound Synthesis System ===" << std::endl;
-    std::cout << "🎛️  Starting synthesizer application..." << std::endl;
+    // First log call also starts the logger's writer thread, well before audio
+    LOG_INFO("=== Modular Sound Synthesis System ===");
+    LOG_INFO("🎛️  Starting synthesizer application...");
     
     QApplication app(argc, argv);
     
+    // Panel load/memory measurement instead of the synthesizer
+    if (app.arguments().contains("--measure-panel")) {
+        return runParameterPanelBenchmark();
+    }
+    
+    AudioEngine::setBackendConfig(parseAudioOptions(app.arguments()));
+    LOG_INFO("🔊 Audio backend: %s", AudioEngine::getBackendConfig().backend.c_str());
+
     SynthesizerWindow window;
     window.show();
     
-    std::cout << "✨ Application ready!" << std::endl;
+    LOG_INFO("✨ Application ready!");
     
     return app.exec();
 }
\ No newline at end of file
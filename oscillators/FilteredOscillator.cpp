@@ -0,0 +1,85 @@
+#include "FilteredOscillator.h"
+#include "../core/RenderGraph.h"
+#include "../interface/LiveController.h"
+#include "../core/Logger.h"
+
+FilteredOscillator::FilteredOscillator(std::unique_ptr<Oscillator> sourceOsc, double sampleRate)
+    : Oscillator(sampleRate), source(std::move(sourceOsc)) {
+    amplitude = 1.0;
+    if (source) {
+        source->setUsedAsComponent(true);
+        frequency = source->getFrequency();
+    }
+}
+
+void FilteredOscillator::addFilter(std::unique_ptr<Filter> filter) {
+    if (filter) {
+        filter->setUsedAsComponent(true);
+        filter->setSampleRate(sampleRate);
+        filters.push_back(std::move(filter));
+    }
+}
+
+double FilteredOscillator::nextSample() {
+    if (!source) return 0.0;
+
+    double sample = source->nextSample();
+    for (auto& filter : filters) {
+        sample = filter->processSample(sample);
+    }
+    return sample;
+}
+
+void FilteredOscillator::generateBlock(double* buffer, int numSamples) {
+    if (!source) {
+        Oscillator::generateBlock(buffer, numSamples);
+        return;
+    }
+    source->generateBlock(buffer, numSamples);
+    for (auto& filter : filters) {
+        filter->processBuffer(buffer, numSamples);
+    }
+}
+
+int FilteredOscillator::buildRenderGraph(RenderGraph& graph, double* output) {
+    if (!source) return Oscillator::buildRenderGraph(graph, output);
+
+    int sourceNode = source->buildRenderGraph(graph, output);
+    if (filters.empty()) return sourceNode;
+
+    int filterNode = graph.addNode([this, output](int numSamples) {
+        for (auto& filter : filters) {
+            filter->processBuffer(output, numSamples);
+        }
+    });
+    graph.addDependency(filterNode, sourceNode);
+    return filterNode;
+}
+
+void FilteredOscillator::setFrequency(double freq) {
+    Oscillator::setFrequency(freq);
+    if (source) source->setFrequency(freq);
+}
+
+void FilteredOscillator::setSampleRate(double rate) {
+    Oscillator::setSampleRate(rate);
+    if (source) source->setSampleRate(rate);
+    for (auto& filter : filters) {
+        filter->setSampleRate(rate);
+    }
+}
+
+void FilteredOscillator::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, source ? source->getTypeName() : getTypeName());
+}
+
+void FilteredOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering filtered oscillator parameters...", prefix.c_str());
+
+    if (source) {
+        source->registerParametersWithPrefix(controller, prefix);
+    }
+    for (size_t i = 0; i < filters.size(); ++i) {
+        filters[i]->registerParametersWithPrefix(controller, prefix + " Filter " + std::to_string(i + 1));
+    }
+}
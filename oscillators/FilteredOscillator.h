@@ -0,0 +1,41 @@
+#ifndef FILTEREDOSCILLATOR_H
+#define FILTEREDOSCILLATOR_H
+
+#include "../core/Oscillator.h"
+#include "../core/Filter.h"
+#include <memory>
+#include <vector>
+
+// An oscillator graph followed by its own filter chain, so a filtered voice
+// can be a layer or a partial (e.g. one saw -> bandpass band of an additive
+// patch) instead of going through the Sound-wide filters.
+class FilteredOscillator : public Oscillator {
+public:
+    FilteredOscillator(std::unique_ptr<Oscillator> source, double sampleRate = 44100.0);
+
+    // Filters run in the order they are added
+    void addFilter(std::unique_ptr<Filter> filter);
+    size_t getFilterCount() const { return filters.size(); }
+    Oscillator* getSource() { return source.get(); }
+
+    double nextSample() override;
+    void generateBlock(double* buffer, int numSamples) override;
+    // The source keeps its own subgraph; the filter chain is one node after it
+    int buildRenderGraph(RenderGraph& graph, double* output) override;
+
+    void setFrequency(double freq) override;
+    void setSampleRate(double rate) override;
+    void noteOn() override { if (source) source->noteOn(); }
+    void noteOff() override { if (source) source->noteOff(); }
+
+    // Source under the prefix itself, filters under "prefix Filter N"
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Filtered"; }
+
+private:
+    std::unique_ptr<Oscillator> source;
+    std::vector<std::unique_ptr<Filter>> filters;
+};
+
+#endif // FILTEREDOSCILLATOR_H
@@ -0,0 +1,129 @@
+#include "GranularOscillator.h"
+#include "../interface/LiveController.h"
+#include "../dsp/FastMath.h"
+#include "../dsp/GrainKernels.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+GranularOscillator::GranularOscillator(std::shared_ptr<const SampleFile> sampleFile, double sampleRate)
+    : Oscillator(sampleRate), sample(std::move(sampleFile)) {
+    amplitude = 1.0;
+    frequency = rootFrequency;
+    source = sample->getResidentFrames();
+    sourceFrames = std::min<long long>(sample->getFrameCount(), 0x7fffffff);  // The kernel indexes with int
+    reset();
+}
+
+void GranularOscillator::reset() {
+    activeCount = 0;
+    freeCount = MaxGrains;
+    for (int i = 0; i < MaxGrains; ++i) freeList[i] = MaxGrains - 1 - i;
+    untilNextGrain = 0.0;
+}
+
+double GranularOscillator::nextRandom() {
+    // xorshift32: cheap, allocation-free and repeatable from a seed
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random * (2.0 / 4294967296.0) - 1.0;
+}
+
+double GranularOscillator::nextSample() {
+    double sample;
+    render(&sample, 1);
+    return sample;
+}
+
+void GranularOscillator::generateBlock(double* buffer, int numSamples) {
+    render(buffer, numSamples);
+}
+
+void GranularOscillator::noteOn() {
+    restartRequested.store(true, std::memory_order_release);
+}
+
+void GranularOscillator::startGrain(int offset, double interval) {
+    ++grainsStarted;
+    const double step = fastmath::semitonesToRatio(pitch) * frequency / rootFrequency * sample->getSampleRate() / sampleRate;
+    const int length = std::max(2, static_cast<int>(grainSize * 0.001 * sampleRate));
+    const double span = step * length + 2.0;  // Source frames the grain reads, with the interpolation guard
+    const double centre = (position + spray * nextRandom()) * 0.01 * sourceFrames;
+    if (freeCount == 0 || span >= sourceFrames) {
+        ++grainsDropped;
+        return;
+    }
+
+    // Grains overlap length / interval deep; scale for constant loudness
+    const double overlap = std::max(1.0, length / interval);
+
+    Grain& grain = grains[freeList[--freeCount]];
+    grain.start = std::clamp(centre - 0.5 * span, 0.0, sourceFrames - span);
+    grain.step = step;
+    grain.windowStep = 1.0 / length;
+    grain.gain = amplitude / std::sqrt(overlap);
+    grain.length = length;
+    grain.played = 0;
+    grain.offset = offset;
+    active[activeCount++] = static_cast<int>(&grain - grains);
+    peakActive = std::max(peakActive, activeCount);
+}
+
+void GranularOscillator::renderGrains(double* buffer, int from, int to) {
+    // Every active grain over its part of [from, to); finished ones go back to the pool
+    for (int i = 0; i < activeCount;) {
+        Grain& grain = grains[active[i]];
+        const int begin = std::max(from, grain.offset);
+        const int count = std::min(grain.length - grain.played, to - begin);
+        if (count > 0) {
+            grains::accumulate(source, grain.start, grain.step, grain.windowStep, grain.gain, grain.played,
+                               buffer + begin, count);
+            grain.played += count;
+        }
+        if (grain.played == grain.length) {
+            freeList[freeCount++] = active[i];
+            active[i] = active[--activeCount];
+        } else {
+            ++i;
+        }
+    }
+}
+
+void GranularOscillator::render(double* buffer, int numSamples) {
+    if (restartRequested.exchange(false, std::memory_order_acq_rel)) reset();
+    std::fill(buffer, buffer + numSamples, 0.0);
+
+    // Onsets due in this block start at their own sample. While the pool has
+    // room they are only queued; once it is full the grains are rendered up
+    // to the onset first, so those that have ended by then make room just as
+    // they would with smaller blocks.
+    const double interval = sampleRate / std::max(0.01, density);
+    int rendered = 0;
+    for (int onset; (onset = static_cast<int>(std::ceil(untilNextGrain))) < numSamples; untilNextGrain += interval) {
+        onset = std::max(0, onset);
+        if (freeCount == 0) {
+            renderGrains(buffer, rendered, onset);
+            rendered = onset;
+        }
+        startGrain(onset, interval);
+    }
+    untilNextGrain -= numSamples;
+    renderGrains(buffer, rendered, numSamples);
+    for (int i = 0; i < activeCount; ++i) grains[active[i]].offset = 0;
+}
+
+void GranularOscillator::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void GranularOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering granular parameters...", prefix.c_str());
+    addParameterWithPrefix(controller, prefix, "Density", &density, 1, 2000, 10, []() { }, {"grains/s"});
+    addParameterWithPrefix(controller, prefix, "Grain Size", &grainSize, 5, 500, 5, []() { }, {"ms"});
+    addParameterWithPrefix(controller, prefix, "Position", &position, 0, 100, 1, []() { }, {"%"});
+    addParameterWithPrefix(controller, prefix, "Spray", &spray, 0, 100, 1, []() { }, {"%"});
+    addParameterWithPrefix(controller, prefix, "Pitch", &pitch, -24, 24, 1, []() { }, {"st"});
+    addParameterWithPrefix(controller, prefix, "Frequency", &frequency, 1, 4000, 20, []() { }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Root", &rootFrequency, 20, 2000, 10, []() { }, {"Hz"});
+}
@@ -0,0 +1,104 @@
+#ifndef GRANULAROSCILLATOR_H
+#define GRANULAROSCILLATOR_H
+
+#include "../core/Oscillator.h"
+#include "SampleFile.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// A grain cloud over a SampleFile. Grains are Hann-windowed snippets of the
+// source read at a pitch of their own; they start at Density per second,
+// each Grain Size long, around Position in the file scattered by Spray.
+//
+// Grains live in a fixed pool inside the oscillator (MaxGrains of them), so
+// a cloud of hundreds allocates nothing while it plays; a grain due while
+// the pool is exhausted is skipped and counted. Grain onsets are
+// sample-accurate: the output does not depend on how the host splits it
+// into blocks. Each grain is rendered over its stretch of a block with
+// grains::accumulate, a vectorized window-and-sum kernel.
+//
+// The source is read from memory: the mapping itself for mono float files
+// (see SampleFile::getResidentFrames), so building the oscillator reads the
+// file in. frequency / root scales every grain's pitch, as in
+// SampleOscillator.
+class GranularOscillator : public Oscillator {
+public:
+    static constexpr int MaxGrains = 512;
+
+    GranularOscillator(std::shared_ptr<const SampleFile> sample, double sampleRate = 44100.0);
+
+    double nextSample() override;
+    void generateBlock(double* buffer, int numSamples) override;
+    // Starts the cloud over: active grains end and the next one starts at once
+    void noteOn() override;
+
+    void setDensity(double grainsPerSecond) { density = grainsPerSecond; }
+    void setGrainSize(double milliseconds) { grainSize = milliseconds; }
+    void setPosition(double percent) { position = percent; }
+    void setSpray(double percent) { spray = percent; }
+    void setPitch(double semitones) { pitch = semitones; }
+    void setRootFrequency(double frequency) { rootFrequency = frequency; }
+    double getDensity() const { return density; }
+    double getGrainSize() const { return grainSize; }
+    double getPosition() const { return position; }
+    double getSpray() const { return spray; }
+    double getPitch() const { return pitch; }
+    double getRootFrequency() const { return rootFrequency; }
+
+    // Reseeds the spray so a render can be repeated exactly
+    void setSeed(uint32_t seed) { random = seed ? seed : 1; }
+
+    int getActiveGrainCount() const { return activeCount; }
+    int getPeakGrainCount() const { return peakActive; }
+    long long getGrainsStarted() const { return grainsStarted; }
+    // Grains skipped because the pool was full
+    long long getGrainsDropped() const { return grainsDropped; }
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Granular"; }
+
+private:
+    struct Grain {
+        double start;           // Source frame of the grain's first sample
+        double step;            // Source frames per output sample
+        double windowStep;      // 1 / length
+        double gain;
+        int length;             // Output samples
+        int played;             // Output samples rendered so far
+        int offset;             // Sample of the current block it starts on
+    };
+
+    std::shared_ptr<const SampleFile> sample;
+    const float* source;
+    long long sourceFrames;
+
+    // Live parameters
+    double density = 50.0;         // Grains per second
+    double grainSize = 80.0;       // Milliseconds
+    double position = 50.0;        // Percent of the file
+    double spray = 10.0;           // Percent of the file, either side of position
+    double pitch = 0.0;            // Semitones
+    double rootFrequency = 261.6256;     // SampleOscillator::DefaultRootFrequency
+
+    Grain grains[MaxGrains];
+    int active[MaxGrains];         // Pool indices of the active grains
+    int freeList[MaxGrains];       // Pool indices of the free ones
+    int activeCount = 0;
+    int freeCount = MaxGrains;
+    int peakActive = 0;
+    double untilNextGrain = 0.0;   // Samples until the next onset, from the current block's start
+    uint32_t random = 0x9e3779b9;
+    long long grainsStarted = 0;
+    long long grainsDropped = 0;
+    std::atomic<bool> restartRequested{false};  // Set by noteOn() on the GUI thread
+
+    void render(double* buffer, int numSamples);
+    void renderGrains(double* buffer, int from, int to);
+    void startGrain(int offset, double interval);
+    void reset();
+    double nextRandom();  // Uniform in [-1, 1)
+};
+
+#endif // GRANULAROSCILLATOR_H
@@ -0,0 +1,82 @@
+#include "OversampledOscillator.h"
+#include "../interface/LiveController.h"
+#include "../core/Logger.h"
+
+OversampledOscillator::OversampledOscillator(std::unique_ptr<Oscillator> innerOsc, int factor,
+                                             double sampleRate)
+    : Oscillator(sampleRate), inner(std::move(innerOsc)), oversampler(factor) {
+    amplitude = 1.0;
+    factorSetting = oversampler.getFactor();
+    if (inner) {
+        inner->setUsedAsComponent(true);
+        inner->setSampleRate(sampleRate * oversampler.getFactor());
+        frequency = inner->getFrequency();
+    }
+}
+
+double OversampledOscillator::nextSample() {
+    // Containers that pull sample by sample have no other block boundary
+    applyPendingFactor();
+    return renderSample();
+}
+
+void OversampledOscillator::generateBlock(double* output, int numSamples) {
+    applyPendingFactor();
+    for (int i = 0; i < numSamples; ++i) {
+        output[i] = renderSample();
+    }
+}
+
+double OversampledOscillator::renderSample() {
+    if (!inner) return 0.0;
+
+    int factor = oversampler.getFactor();
+    if (factor == 1) {
+        return inner->nextSample() * amplitude;
+    }
+
+    for (int i = 0; i < factor; ++i) {
+        buffer[i] = inner->nextSample();
+    }
+    return oversampler.downsample(buffer) * amplitude;
+}
+
+void OversampledOscillator::applyPendingFactor() {
+    if (oversampler.applyPendingFactor() && inner) {
+        inner->setSampleRate(sampleRate * oversampler.getFactor());
+    }
+}
+
+void OversampledOscillator::setOversamplingFactor(int factor) {
+    oversampler.setFactor(factor);
+    factorSetting = oversampler.getPendingFactor();
+}
+
+void OversampledOscillator::setFrequency(double freq) {
+    Oscillator::setFrequency(freq);
+    if (inner) inner->setFrequency(freq);
+}
+
+void OversampledOscillator::setSampleRate(double rate) {
+    Oscillator::setSampleRate(rate);
+    if (inner) inner->setSampleRate(rate * oversampler.getFactor());
+}
+
+void OversampledOscillator::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, inner ? inner->getTypeName() : getTypeName());
+}
+
+void OversampledOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering oversampling parameters...", prefix.c_str());
+
+    if (inner) {
+        inner->registerParametersWithPrefix(controller, prefix);
+    }
+
+    addParameterWithPrefix(controller, prefix, "Oversampling", &factorSetting,
+                          1.0, 8.0, 1.0,
+                          [this]() {
+                              setOversamplingFactor(static_cast<int>(factorSetting));
+                          },
+                          {"x", ParameterType::Integer});
+}
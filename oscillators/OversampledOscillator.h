@@ -0,0 +1,45 @@
+#ifndef OVERSAMPLEDOSCILLATOR_H
+#define OVERSAMPLEDOSCILLATOR_H
+
+#include "../core/Oscillator.h"
+#include "../core/Oversampler.h"
+#include <memory>
+
+// Runs any enclosed oscillator graph (e.g. a deep FMSynthesizer) at 2x/4x/8x
+// the host rate and decimates back down, so only this node pays for it.
+class OversampledOscillator : public Oscillator {
+public:
+    OversampledOscillator(std::unique_ptr<Oscillator> inner, int factor = 2,
+                          double sampleRate = 44100.0);
+
+    double nextSample() override;
+    void generateBlock(double* output, int numSamples) override;
+
+    // Oversampling factor (1, 2, 4 or 8), selectable at runtime from any
+    // thread; the audio thread switches over at its next block
+    void setOversamplingFactor(int factor);
+    int getOversamplingFactor() const { return oversampler.getFactor(); }
+
+    // Forward to the enclosed oscillator
+    void setFrequency(double freq) override;
+    void setSampleRate(double rate) override;
+    void noteOn() override { if (inner) inner->noteOn(); }
+    void noteOff() override { if (inner) inner->noteOff(); }
+    Oscillator* getInner() { return inner.get(); }
+
+    // Parameter registration - the enclosed graph keeps its own names
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Oversampled"; }
+
+private:
+    std::unique_ptr<Oscillator> inner;
+    Oversampler oversampler;
+    double factorSetting;  // Parameter value, snapped to a power of two
+    double buffer[Oversampler::MaxFactor];
+
+    void applyPendingFactor();
+    double renderSample();
+};
+
+#endif // OVERSAMPLEDOSCILLATOR_H
@@ -0,0 +1,204 @@
+#include "SampleFile.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint32_t readLittleEndian(const unsigned char* bytes, int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; ++i) value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    return value;
+}
+
+int bytesPerSample(SampleFile::Encoding encoding) {
+    switch (encoding) {
+        case SampleFile::Encoding::Int16: return 2;
+        case SampleFile::Encoding::Int24: return 3;
+        default: return 4;
+    }
+}
+
+// One sample as a float in -1..1
+float decodeSample(const unsigned char* bytes, SampleFile::Encoding encoding) {
+    switch (encoding) {
+        case SampleFile::Encoding::Int16:
+            return static_cast<int16_t>(readLittleEndian(bytes, 2)) * (1.0f / 32768.0f);
+        case SampleFile::Encoding::Int24:
+            return static_cast<int32_t>(readLittleEndian(bytes, 3) << 8) * (1.0f / 2147483648.0f);
+        case SampleFile::Encoding::Int32:
+            return static_cast<int32_t>(readLittleEndian(bytes, 4)) * (1.0f / 2147483648.0f);
+        default: {
+            float value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+    }
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    if (text.size() < suffix.size()) return false;
+    return std::equal(suffix.rbegin(), suffix.rend(), text.rbegin(),
+                      [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+}
+
+} // namespace
+
+std::shared_ptr<SampleFile> SampleFile::open(const std::string& path, int headFrames, const RawFormat& raw) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("❌ Sample: cannot open '%s' (%s)", path.c_str(), std::strerror(errno));
+        return nullptr;
+    }
+    struct stat info {};
+    ::fstat(fd, &info);
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* mapping = bytes > 0 ? ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);  // The mapping keeps the file
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("❌ Sample: cannot map '%s' (%s)", path.c_str(), bytes > 0 ? std::strerror(errno) : "empty file");
+        return nullptr;
+    }
+    // Under mlockall(MCL_FUTURE | MCL_ONFAULT) the pages would stay locked
+    // once read and could never be dropped again
+    ::munlock(mapping, bytes);
+    ::madvise(mapping, bytes, MADV_SEQUENTIAL);
+
+    std::shared_ptr<SampleFile> file(new SampleFile());
+    file->path = path;
+    file->mapping = mapping;
+    file->mappingBytes = bytes;
+    if (endsWith(path, ".wav")) {
+        if (!file->parseWav()) return nullptr;
+    } else {
+        file->sampleRate = raw.sampleRate;
+        file->channels = std::max(1, raw.channels);
+        file->encoding = raw.encoding;
+        file->frameBytes = file->channels * bytesPerSample(raw.encoding);
+        file->data = static_cast<const unsigned char*>(mapping);
+        file->frameCount = static_cast<long long>(bytes / file->frameBytes);
+    }
+
+    file->head.resize(static_cast<size_t>(std::clamp<long long>(headFrames, 0, file->frameCount)));
+    file->decode(0, file->getHeadFrames(), file->head.data());
+    LOG_INFO("🎞️ Sample '%s': %lld frames at %.0f Hz, %d ch, %d-bit%s, %d frames preloaded", path.c_str(),
+             file->frameCount, file->sampleRate, file->channels, 8 * bytesPerSample(file->encoding),
+             file->encoding == Encoding::Float32 ? " float" : "", file->getHeadFrames());
+    return file;
+}
+
+SampleFile::~SampleFile() {
+    if (mapping) ::munmap(mapping, mappingBytes);
+}
+
+bool SampleFile::parseWav() {
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+    if (mappingBytes < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        LOG_ERROR("❌ Sample: '%s' is not a WAV file", path.c_str());
+        return false;
+    }
+    bool haveFormat = false;
+    for (size_t offset = 12; offset + 8 <= mappingBytes;) {
+        const unsigned char* chunk = bytes + offset;
+        size_t size = readLittleEndian(chunk + 4, 4);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16 && offset + 8 + size <= mappingBytes) {
+            uint32_t tag = readLittleEndian(chunk + 8, 2);
+            if (tag == 0xfffe && size >= 40) tag = readLittleEndian(chunk + 32, 2);  // Extensible: the sub-format
+            channels = static_cast<int>(readLittleEndian(chunk + 10, 2));
+            sampleRate = readLittleEndian(chunk + 12, 4);
+            int bits = static_cast<int>(readLittleEndian(chunk + 22, 2));
+            if (tag == 3 && bits == 32) encoding = Encoding::Float32;
+            else if (tag == 1 && bits == 16) encoding = Encoding::Int16;
+            else if (tag == 1 && bits == 24) encoding = Encoding::Int24;
+            else if (tag == 1 && bits == 32) encoding = Encoding::Int32;
+            else {
+                LOG_ERROR("❌ Sample: '%s' has an unsupported format (tag %u, %d bits)", path.c_str(), tag, bits);
+                return false;
+            }
+            haveFormat = channels > 0 && sampleRate > 0.0;
+        } else if (std::memcmp(chunk, "data", 4) == 0 && haveFormat) {
+            // Streamed or >4 GiB files may carry a placeholder size: use what is there
+            frameBytes = channels * bytesPerSample(encoding);
+            size_t available = mappingBytes - offset - 8;
+            data = chunk + 8;
+            frameCount = static_cast<long long>(std::min(size, available) / frameBytes);
+            if (size == 0 || size == 0xffffffff) frameCount = static_cast<long long>(available / frameBytes);
+            return true;
+        }
+        offset += 8 + size + (size & 1);
+    }
+    LOG_ERROR("❌ Sample: '%s' has no usable fmt/data chunks", path.c_str());
+    return false;
+}
+
+const float* SampleFile::getResidentFrames() const {
+    std::call_once(residentOnce, [this]() {
+        if (channels == 1 && encoding == Encoding::Float32 && reinterpret_cast<uintptr_t>(data) % alignof(float) == 0) {
+            // Read in and pin the mapping itself
+            void* start;
+            size_t bytes;
+            pageRange(0, frameCount, false, start, bytes);
+            ::madvise(start, bytes, MADV_WILLNEED);
+            bool locked = ::mlock(start, bytes) == 0;
+            static const size_t pageBytes = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            volatile const unsigned char* pages = static_cast<const unsigned char*>(start);
+            unsigned char touched = 0;
+            for (size_t offset = 0; offset < bytes; offset += pageBytes) touched ^= pages[offset];
+            (void)touched;
+            resident = reinterpret_cast<const float*>(data);
+            LOG_INFO("🎞️ Sample '%s': %zu KiB mapped resident%s", path.c_str(), bytes >> 10, locked ? ", locked" : "");
+        } else {
+            decoded.resize(static_cast<size_t>(frameCount));
+            decode(0, static_cast<int>(std::min<long long>(frameCount, 0x7fffffff)), decoded.data());
+            resident = decoded.data();
+            LOG_INFO("🎞️ Sample '%s': %zu KiB decoded resident", path.c_str(), (decoded.size() * sizeof(float)) >> 10);
+        }
+    });
+    return resident;
+}
+
+void SampleFile::decode(long long first, int count, float* output) const {
+    const long long valid = std::clamp(frameCount - first, 0LL, static_cast<long long>(count));
+    const unsigned char* frame = data + first * frameBytes;
+    const int sampleBytes = frameBytes / channels;
+    const float scale = 1.0f / channels;
+    for (long long n = 0; n < valid; ++n, frame += frameBytes) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels; ++c) sum += decodeSample(frame + c * sampleBytes, encoding);
+        output[n] = sum * scale;
+    }
+    std::fill(output + valid, output + count, 0.0f);
+}
+
+void SampleFile::pageRange(long long first, long long count, bool wholePages, void*& start, size_t& bytes) const {
+    static const size_t pageBytes = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const unsigned char* base = static_cast<const unsigned char*>(mapping);
+    const unsigned char* end = base + mappingBytes;
+    size_t from = std::clamp(data + std::max(0LL, first) * frameBytes, base, end) - base;
+    size_t to = std::clamp(data + std::max(0LL, first + count) * frameBytes, base, end) - base;
+    from = from / pageBytes * pageBytes;
+    if (wholePages) to = to / pageBytes * pageBytes;
+    start = const_cast<unsigned char*>(base + from);
+    bytes = to > from ? to - from : 0;
+}
+
+void SampleFile::willNeed(long long first, long long count) const {
+    void* start;
+    size_t bytes;
+    pageRange(first, count, false, start, bytes);
+    if (bytes > 0) ::madvise(start, bytes, MADV_WILLNEED);
+}
+
+void SampleFile::dontNeed(long long first, long long count) const {
+    void* start;
+    size_t bytes;
+    pageRange(first, count, true, start, bytes);
+    if (bytes > 0) ::madvise(start, bytes, MADV_DONTNEED);  // Clean file pages: re-read on the next touch
+}
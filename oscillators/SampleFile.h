@@ -0,0 +1,96 @@
+#ifndef SAMPLEFILE_H
+#define SAMPLEFILE_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A sample on disk, memory-mapped rather than loaded, so sets far larger
+// than RAM cost address space and page cache only.
+//
+// The first headFrames frames are decoded into memory when the file is
+// opened: a note can start on them at once while SampleStreamer reads the
+// rest of the file ahead of it. Everything past the head is only touched by
+// decode(), which may fault pages in and so belongs on the prefetch thread.
+//
+// Playback is mono: multichannel files are averaged to one channel as they
+// are decoded. Shared between the oscillators playing it (std::shared_ptr);
+// immutable once open.
+class SampleFile {
+public:
+    static constexpr int DefaultHeadFrames = 1 << 16;
+
+    enum class Encoding { Int16, Int24, Int32, Float32 };
+
+    // Layout of a headerless file
+    struct RawFormat {
+        double sampleRate = 44100.0;
+        int channels = 1;
+        Encoding encoding = Encoding::Float32;
+    };
+
+    // A ".wav" file (PCM 16/24/32-bit or 32-bit float, also as
+    // WAVE_FORMAT_EXTENSIBLE) or any other file as raw samples laid out as
+    // given; nullptr (with a log) if it cannot be mapped or parsed
+    static std::shared_ptr<SampleFile> open(const std::string& path, int headFrames, const RawFormat& raw);
+    static std::shared_ptr<SampleFile> open(const std::string& path, int headFrames = DefaultHeadFrames) {
+        return open(path, headFrames, RawFormat());
+    }
+    ~SampleFile();
+    SampleFile(const SampleFile&) = delete;
+    SampleFile& operator=(const SampleFile&) = delete;
+
+    const std::string& getPath() const { return path; }
+    long long getFrameCount() const { return frameCount; }
+    double getSampleRate() const { return sampleRate; }
+    int getChannelCount() const { return channels; }
+    Encoding getEncoding() const { return encoding; }
+    int getFrameBytes() const { return frameBytes; }
+
+    // The preloaded frames, in memory
+    const float* getHead() const { return head.data(); }
+    int getHeadFrames() const { return static_cast<int>(head.size()); }
+
+    // The whole file as mono float in memory, for grains that may read
+    // anywhere on the audio thread: the mapping itself for a mono float
+    // file, otherwise a decoded copy. The first call reads every page in
+    // (and locks them where RLIMIT_MEMLOCK allows), so call it while
+    // building, not on the audio thread.
+    const float* getResidentFrames() const;
+
+    // count mono frames from first; frames past the end are zero. Reads the
+    // mapping, so not real-time safe.
+    void decode(long long first, int count, float* output) const;
+
+    // Page-cache hints over a range of frames: read ahead, or drop the
+    // pages already played from this process' resident set. dontNeed()
+    // keeps the page the range ends in, which may hold later frames.
+    void willNeed(long long first, long long count) const;
+    void dontNeed(long long first, long long count) const;
+
+private:
+    SampleFile() = default;
+
+    std::string path;
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+    const unsigned char* data = nullptr;  // First frame
+    long long frameCount = 0;
+    double sampleRate = 44100.0;
+    int channels = 1;
+    Encoding encoding = Encoding::Float32;
+    int frameBytes = 4;
+    std::vector<float> head;
+    mutable std::once_flag residentOnce;
+    mutable std::vector<float> decoded;   // getResidentFrames() of an encoded file
+    mutable const float* resident = nullptr;
+
+    bool parseWav();
+    // Byte range of frames, clamped to the mapping, from the start of its
+    // first page; wholePages leaves out a partial last page
+    void pageRange(long long first, long long count, bool wholePages, void*& start, size_t& bytes) const;
+};
+
+#endif // SAMPLEFILE_H
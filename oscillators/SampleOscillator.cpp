@@ -0,0 +1,82 @@
+#include "SampleOscillator.h"
+#include "../interface/LiveController.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 4-point, 3rd-order Hermite between y1 (t = 0) and y2 (t = 1)
+inline double hermite(double t, double y0, double y1, double y2, double y3) {
+    double c1 = 0.5 * (y2 - y0);
+    double c2 = y0 - 2.5 * y1 + 2.0 * y2 - 0.5 * y3;
+    double c3 = 0.5 * (y3 - y0) + 1.5 * (y1 - y2);
+    return ((c3 * t + c2) * t + c1) * t + y1;
+}
+
+} // namespace
+
+SampleOscillator::SampleOscillator(std::shared_ptr<const SampleFile> sampleFile, double sampleRate, int ringFrames)
+    : Oscillator(sampleRate), sample(sampleFile), stream(std::move(sampleFile), ringFrames) {
+    amplitude = 1.0;
+    frequency = rootFrequency;
+}
+
+void SampleOscillator::setRootFrequency(double frequency) {
+    rootFrequency = std::max(1.0, frequency);
+}
+
+double SampleOscillator::nextSample() {
+    double sample;
+    render(&sample, 1);
+    return sample;
+}
+
+void SampleOscillator::generateBlock(double* buffer, int numSamples) {
+    render(buffer, numSamples);
+}
+
+void SampleOscillator::noteOn() {
+    restartRequested.store(true, std::memory_order_release);
+}
+
+void SampleOscillator::render(double* buffer, int numSamples) {
+    if (restartRequested.exchange(false, std::memory_order_acq_rel)) {
+        stream.restart();
+        position = 0.0;
+    }
+
+    // What the prefetch thread has decoded so far; anything beyond plays as
+    // silence this block rather than waiting for it
+    const long long frameCount = sample->getFrameCount();
+    const long long available = stream.end();
+    const double step = getSpeed();
+    bool starved = false;
+    int n = 0;
+    for (; n < numSamples && position < frameCount; ++n) {
+        long long index = static_cast<long long>(position);
+        double t = position - index;
+        starved |= index + 2 >= available && index + 2 < frameCount;
+        buffer[n] = amplitude * hermite(t, stream.frameAt(index - 1, available), stream.frameAt(index, available),
+                                        stream.frameAt(index + 1, available), stream.frameAt(index + 2, available));
+        position += step;
+    }
+    std::fill(buffer + n, buffer + numSamples, 0.0);
+
+    stream.release(static_cast<long long>(position) - 1);
+    if (starved) stream.countUnderrun();
+}
+
+void SampleOscillator::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void SampleOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering sample parameters...", prefix.c_str());
+    addParameterWithPrefix(controller, prefix, "Frequency", &frequency,
+                          1, 4000, 20,
+                          []() { }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Root", &rootFrequency,
+                          20, 2000, 10,
+                          []() { }, {"Hz"});
+}
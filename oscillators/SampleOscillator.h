@@ -0,0 +1,59 @@
+#ifndef SAMPLEOSCILLATOR_H
+#define SAMPLEOSCILLATOR_H
+
+#include "../core/Oscillator.h"
+#include "SampleFile.h"
+#include "SampleStreamer.h"
+#include <atomic>
+#include <memory>
+
+// Plays a SampleFile, streamed from disk: the head comes from memory, the
+// rest from a SampleStream the prefetch thread fills ahead of the play
+// position, so memory stays bounded for files of any length.
+//
+// Pitch is varispeed: the file plays at its natural speed when the
+// frequency equals the root frequency, and faster or slower in proportion,
+// read between frames with 4-point Hermite interpolation. Like the other
+// oscillators it can be a carrier or modulator, a filtered layer or an
+// enveloped voice. noteOn() starts the sample over; it plays once and is
+// silent past its end.
+class SampleOscillator : public Oscillator {
+public:
+    static constexpr double DefaultRootFrequency = 261.6256;  // Middle C
+
+    SampleOscillator(std::shared_ptr<const SampleFile> sample, double sampleRate = 44100.0,
+                     int ringFrames = SampleStream::DefaultRingFrames);
+
+    double nextSample() override;
+    void generateBlock(double* buffer, int numSamples) override;
+    void noteOn() override;
+
+    // The frequency at which the sample plays at its recorded pitch
+    void setRootFrequency(double frequency);
+    double getRootFrequency() const { return rootFrequency; }
+    // File frames per output sample at the current frequency and rate
+    double getSpeed() const { return frequency / rootFrequency * sample->getSampleRate() / sampleRate; }
+    // Frames from the start of the file; past the end once it has played out
+    double getPosition() const { return position; }
+
+    // Frames readable without waiting: the head and what the stream has decoded
+    long long getDecodedFrames() const { return stream.end(); }
+    // Blocks that reached past the decoded frames and played silence instead
+    long long getUnderruns() const { return stream.getUnderruns(); }
+    const SampleFile& getSample() const { return *sample; }
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Sample"; }
+
+private:
+    std::shared_ptr<const SampleFile> sample;
+    SampleStream stream;
+    double rootFrequency = DefaultRootFrequency;
+    double position = 0.0;
+    std::atomic<bool> restartRequested{true};  // Set by noteOn() on the GUI thread
+
+    void render(double* buffer, int numSamples);
+};
+
+#endif // SAMPLEOSCILLATOR_H
@@ -0,0 +1,101 @@
+#include "SampleStreamer.h"
+#include <algorithm>
+#include <chrono>
+
+SampleStream::SampleStream(std::shared_ptr<const SampleFile> sampleFile, int ringFrames)
+    : file(std::move(sampleFile)), head(file->getHead()), headFrames(file->getHeadFrames()) {
+    long long frames = 1;
+    while (frames < std::max(ringFrames, 2 * ChunkFrames)) frames <<= 1;
+    ring = std::make_unique<float[]>(static_cast<size_t>(frames));  // Zeroed: touched before the audio thread reads it
+    ringMask = frames - 1;
+    // Faulting a page maps its neighbours too, up to 64 KiB around it: drop
+    // pages only once the reads have moved well past them
+    dropLag = std::max<long long>(ChunkFrames, (256 << 10) / file->getFrameBytes());
+    SampleStreamer::instance().attach(this);
+}
+
+SampleStream::~SampleStream() {
+    SampleStreamer::instance().detach(this);
+}
+
+void SampleStream::restart() {
+    // readFrom first: the prefetch thread sees it no later than the new generation
+    readFrom.store(0, std::memory_order_relaxed);
+    generation = (generation + 1) & GenerationMask;
+    requested.store(generation, std::memory_order_release);
+}
+
+bool SampleStream::service() {
+    const uint64_t wanted = requested.load(std::memory_order_acquire);
+    if (wanted != producerGeneration) {
+        producerGeneration = wanted;
+        producerFrame = headFrames;
+        droppedFrame = 0;
+        published.store(wanted << FrameBits | static_cast<uint64_t>(producerFrame), std::memory_order_release);
+    }
+
+    // Never overwrite frames the audio thread may still read
+    const long long limit = std::min(file->getFrameCount(), readFrom.load(std::memory_order_acquire) + ringMask + 1);
+    if (producerFrame >= limit) return false;
+    const int count = static_cast<int>(std::min<long long>(ChunkFrames, limit - producerFrame));
+
+    // Up to two runs around the end of the ring
+    const long long start = producerFrame & ringMask;
+    const int first = static_cast<int>(std::min<long long>(count, ringMask + 1 - start));
+    file->decode(producerFrame, first, ring.get() + start);
+    file->decode(producerFrame + first, count - first, ring.get());
+
+    // Ask for the next chunk now and let go of what lies well behind
+    producerFrame += count;
+    file->willNeed(producerFrame, ChunkFrames);
+    if (producerFrame - dropLag > droppedFrame) {
+        file->dontNeed(droppedFrame, producerFrame - dropLag - droppedFrame);
+        droppedFrame = producerFrame - dropLag;
+    }
+
+    published.store(producerGeneration << FrameBits | static_cast<uint64_t>(producerFrame), std::memory_order_release);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SampleStreamer
+// -----------------------------------------------------------------------------
+SampleStreamer& SampleStreamer::instance() {
+    static SampleStreamer streamer;
+    return streamer;
+}
+
+SampleStreamer::SampleStreamer() {
+    thread = std::thread(&SampleStreamer::run, this);
+}
+
+SampleStreamer::~SampleStreamer() {
+    stopping.store(true);
+    thread.join();
+}
+
+void SampleStreamer::attach(SampleStream* stream) {
+    std::lock_guard<std::mutex> lock(mutex);
+    streams.push_back(stream);
+}
+
+void SampleStreamer::detach(SampleStream* stream) {
+    std::lock_guard<std::mutex> lock(mutex);
+    streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+}
+
+void SampleStreamer::run() {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        bool busy = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (SampleStream* stream : streams) {
+                if (stream->service()) {
+                    busy = true;
+                    chunksDecoded.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        if (!busy) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
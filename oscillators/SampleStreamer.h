@@ -0,0 +1,111 @@
+#ifndef SAMPLESTREAMER_H
+#define SAMPLESTREAMER_H
+
+#include "SampleFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One playback of a SampleFile: the preloaded head plus a ring of decoded
+// frames the prefetch thread keeps filled ahead of the play position. Memory
+// is bounded by the ring, however long the file.
+//
+// The audio thread owns the play side (restart, end, frameAt, release); the
+// prefetch thread only calls service(). A restart bumps a generation the
+// prefetch thread picks up, so neither side ever waits for the other: frames
+// past the head that are not decoded yet read as silence and count as an
+// underrun.
+class SampleStream {
+public:
+    static constexpr int DefaultRingFrames = 1 << 16;
+    static constexpr int ChunkFrames = 4096;  // Frames decoded per service() call
+
+    SampleStream(std::shared_ptr<const SampleFile> file, int ringFrames = DefaultRingFrames);
+    ~SampleStream();  // Detaches from SampleStreamer; not on the audio thread
+    SampleStream(const SampleStream&) = delete;
+    SampleStream& operator=(const SampleStream&) = delete;
+
+    // Audio thread
+    // Plays from the first frame again; the ring refills behind the head
+    void restart();
+    // Frames below end() are readable this block (the head, then the ring)
+    long long end() const {
+        uint64_t filled = published.load(std::memory_order_acquire);
+        if ((filled >> FrameBits) != (generation & GenerationMask)) return headFrames;
+        return std::max(headFrames, static_cast<long long>(filled & FrameMask));
+    }
+    // frame < end(), or 0 before the start or past the end of the file
+    float frameAt(long long frame, long long available) const {
+        if (frame < 0) return 0.0f;
+        if (frame < headFrames) return head[frame];
+        if (frame < available) return ring[frame & ringMask];
+        return 0.0f;
+    }
+    // Frames below first will not be read again until the next restart
+    void release(long long first) { readFrom.store(first, std::memory_order_release); }
+    void countUnderrun() { underruns.store(underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    // Prefetch thread: decodes up to one chunk ahead; false if there was nothing to do
+    bool service();
+
+    const SampleFile& getFile() const { return *file; }
+    long long getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+    int getRingFrames() const { return static_cast<int>(ringMask + 1); }
+
+private:
+    static constexpr int FrameBits = 48;
+    static constexpr uint64_t FrameMask = (uint64_t(1) << FrameBits) - 1;
+    static constexpr uint64_t GenerationMask = (uint64_t(1) << (64 - FrameBits)) - 1;
+
+    std::shared_ptr<const SampleFile> file;
+    const float* head;
+    long long headFrames;
+    std::unique_ptr<float[]> ring;
+    long long ringMask;
+
+    // Audio thread
+    uint64_t generation = 0;
+    alignas(64) std::atomic<uint64_t> requested{0};  // Generation the audio thread plays
+    alignas(64) std::atomic<long long> readFrom{0};
+    std::atomic<long long> underruns{0};
+
+    // Prefetch thread
+    alignas(64) std::atomic<uint64_t> published{0};  // Generation << FrameBits | frames decoded
+    uint64_t producerGeneration = ~uint64_t(0);
+    long long producerFrame = 0;
+    long long droppedFrame = 0;  // Pages below are out of the resident set
+    long long dropLag;           // Frames kept mapped behind producerFrame
+};
+
+// The prefetch thread shared by every SampleStream. It walks the attached
+// streams round-robin, decoding a chunk for each that has room, and sleeps
+// when all are full. Attaching and detaching lock; the audio thread never
+// does either.
+class SampleStreamer {
+public:
+    static SampleStreamer& instance();
+
+    void attach(SampleStream* stream);
+    // Returns once the prefetch thread is done with the stream
+    void detach(SampleStream* stream);
+
+    long long getChunksDecoded() const { return chunksDecoded.load(std::memory_order_relaxed); }
+
+private:
+    SampleStreamer();
+    ~SampleStreamer();
+
+    std::mutex mutex;
+    std::vector<SampleStream*> streams;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<long long> chunksDecoded{0};
+
+    void run();
+};
+
+#endif // SAMPLESTREAMER_H
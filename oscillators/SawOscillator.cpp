@@ -1,6 +1,6 @@
 #include "SawOscillator.h"
 #include "../interface/LiveController.h"
-#include <iostream>
+#include "../core/Logger.h"
 #include <cmath>
 
 SawOscillator::SawOscillator(double sampleRate) : Oscillator(sampleRate) {
@@ -30,7 +30,7 @@ void SawOscillator::registerParameters(LiveController& controller) {
 }
 
 void SawOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering saw parameters..." << std::endl;
+    LOG_DEBUG("🎛️ %s registering saw parameters...", prefix.c_str());
     
     // Always register the frequency parameter, even when used as a component
     // This ensures each oscillator defines its own parameter ranges
@@ -38,7 +38,8 @@ void SawOscillator::registerParametersWithPrefix(LiveController& controller, con
                           1, 2000, 20,
                           []() { 
                               // No additional update needed
-                          });
+                          },
+                          {"Hz"});
     
     // No amplitude parameter needed - it's now standardized to 1.0
 }
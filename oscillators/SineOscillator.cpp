@@ -1,7 +1,7 @@
 #include "SineOscillator.h"
 #include "../interface/LiveController.h"
-#include <iostream>
-#include <cmath>
+#include "../dsp/FastMath.h"
+#include "../core/Logger.h"
 
 SineOscillator::SineOscillator(double sampleRate) : Oscillator(sampleRate) {
     // Always use standardized amplitude of 1.0
@@ -9,7 +9,7 @@ SineOscillator::SineOscillator(double sampleRate) : Oscillator(sampleRate) {
 }
 
 double SineOscillator::nextSample() {
-    double sample = amplitude * sin(2.0 * M_PI * phase);
+    double sample = amplitude * fastmath::sin2pi(phase);
 
     // Advance phase - use custom increment if provided (for FM synthesis)
     if (useCustomPhaseIncrement) {
@@ -29,9 +29,9 @@ void SineOscillator::registerParameters(LiveController& controller) {
 }
 
 void SineOscillator::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering sine parameters..." << std::endl;
+    LOG_DEBUG("🎛️ %s registering sine parameters...", prefix.c_str());
     addParameterWithPrefix(controller, prefix, "Frequency", &frequency, 
                           1, 2000, 20,
-                          []() { });
+                          []() { }, {"Hz"});
     // Do NOT register envelope parameters here!
 }
\ No newline at end of file
@@ -0,0 +1,494 @@
+#include "CompiledPatch.h"
+#include "../core/Sound.h"
+#include "../interface/LiveController.h"
+#include "../oscillators/SineOscillator.h"
+#include "../oscillators/SawOscillator.h"
+#include "../oscillators/OversampledOscillator.h"
+#include "../oscillators/FilteredOscillator.h"
+#include "../synthesizers/FMSynthesizer.h"
+#include "../synthesizers/AdditiveSynthesizer.h"
+#include "../synthesizers/VoiceLaneSynthesizer.h"
+#include "../filters/LowPassFilter.h"
+#include "../filters/BandPassFilter.h"
+#include "../filters/OversampledFilter.h"
+#include "../envelopes/Envelope.h"
+#include "../core/Logger.h"
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PATCH_USE_MMAP 1
+#endif
+
+namespace {
+
+constexpr uint32_t alignUp(uint32_t value) { return (value + 7u) & ~7u; }
+
+// String table with offset 0 as the empty string
+class StringTable {
+public:
+    StringTable() : bytes(1, '\0') {}
+    uint32_t add(const std::string& text) {
+        if (text.empty()) return 0;
+        auto found = offsets.find(text);
+        if (found != offsets.end()) return found->second;
+        uint32_t offset = static_cast<uint32_t>(bytes.size());
+        bytes.insert(bytes.end(), text.begin(), text.end());
+        bytes.push_back('\0');
+        offsets.emplace(text, offset);
+        return offset;
+    }
+    const std::vector<char>& data() const { return bytes; }
+private:
+    std::vector<char> bytes;
+    std::unordered_map<std::string, uint32_t> offsets;
+};
+
+// Node instantiation. Registration is deferred until the whole graph exists
+// and then runs in pre-order, so containers create their parameter groups
+// before their children (see LiveController::ensureGroup).
+class PatchBuilder {
+public:
+    PatchBuilder(const PatchNodeRecord* nodes, const char* strings, double sampleRate)
+        : nodes(nodes), strings(strings), sampleRate(sampleRate) {}
+
+    std::unique_ptr<Oscillator> oscillator(uint32_t index) {
+        const PatchNodeRecord& node = nodes[index];
+        const double* v = node.values;
+        size_t slot = reserve(node);
+        std::unique_ptr<Oscillator> result;
+
+        switch (static_cast<PatchNodeType>(node.type)) {
+            case PatchNodeType::Sine:
+            case PatchNodeType::Saw: {
+                if (static_cast<PatchNodeType>(node.type) == PatchNodeType::Sine)
+                    result = std::make_unique<SineOscillator>(sampleRate);
+                else
+                    result = std::make_unique<SawOscillator>(sampleRate);
+                result->setFrequency(v[0]);
+                result->setAmplitude(v[1]);
+                break;
+            }
+            case PatchNodeType::FM: {
+                // Frequencies first: attaching a child tunes it to them
+                auto fm = std::make_unique<FMSynthesizer>(sampleRate);
+                fm->setCarrierFrequency(v[0]);
+                fm->setModulatorFrequency(v[1]);
+                fm->setModulationDepth(v[2]);
+                if (node.childCount > 0) fm->setCarrierOscillator(oscillator(node.firstChild));
+                if (node.childCount > 1) fm->setModulatorOscillator(oscillator(node.firstChild + 1));
+                result = std::move(fm);
+                break;
+            }
+            case PatchNodeType::Additive: {
+                auto additive = std::make_unique<AdditiveSynthesizer>(sampleRate);
+                for (uint32_t c = 0; c < node.childCount; ++c) {
+                    additive->addOscillator(oscillator(node.firstChild + c));
+                }
+                result = std::move(additive);
+                break;
+            }
+            case PatchNodeType::Oversampled:
+                result = std::make_unique<OversampledOscillator>(oscillator(node.firstChild),
+                                                                 static_cast<int>(v[0]), sampleRate);
+                break;
+            case PatchNodeType::Unison: {
+                auto waveform = v[0] == 0.0 ? VoiceLaneSynthesizer::Waveform::Sine : VoiceLaneSynthesizer::Waveform::Saw;
+                auto filterType = v[1] == 0.0 ? VoiceLaneSynthesizer::FilterType::LowPass
+                                              : VoiceLaneSynthesizer::FilterType::BandPass;
+                auto unison = std::make_unique<VoiceLaneSynthesizer>(waveform, filterType, sampleRate);
+                unison->setFrequency(v[2]);
+                unison->setVoiceCount(static_cast<int>(v[3]));
+                unison->setDetune(v[4]);
+                unison->setFilter(v[5], v[6]);
+                unison->setADSR(v[7], v[8], v[9], v[10]);
+                unison->setSpread(v[11]);
+                result = std::move(unison);
+                break;
+            }
+            case PatchNodeType::Filtered: {
+                auto filtered = std::make_unique<FilteredOscillator>(oscillator(node.firstChild), sampleRate);
+                for (uint32_t c = 1; c < node.childCount; ++c) {
+                    filtered->addFilter(filter(node.firstChild + c));
+                }
+                result = std::move(filtered);
+                break;
+            }
+            default:
+                break;  // Kinds are checked when the file is loaded
+        }
+        if (slot != NoSlot) registrations[slot].oscillator = result.get();
+        return result;
+    }
+
+    std::unique_ptr<Filter> filter(uint32_t index) {
+        const PatchNodeRecord& node = nodes[index];
+        const double* v = node.values;
+        size_t slot = reserve(node);
+        std::unique_ptr<Filter> result;
+
+        switch (static_cast<PatchNodeType>(node.type)) {
+            case PatchNodeType::LowPass: {
+                auto lowpass = std::make_unique<LowPassFilter>(sampleRate);
+                lowpass->setCutoffFrequency(v[0]);
+                lowpass->setResonance(v[1]);
+                result = std::move(lowpass);
+                break;
+            }
+            case PatchNodeType::BandPass: {
+                auto bandpass = std::make_unique<BandPassFilter>(sampleRate);
+                bandpass->setTargetFrequency(v[0]);
+                bandpass->setBandwidth(v[1]);
+                result = std::move(bandpass);
+                break;
+            }
+            case PatchNodeType::OversampledFilter:
+                result = std::make_unique<OversampledFilter>(filter(node.firstChild),
+                                                             static_cast<int>(v[0]), sampleRate);
+                break;
+            default:
+                break;
+        }
+        if (slot != NoSlot) registrations[slot].filter = result.get();
+        return result;
+    }
+
+    std::unique_ptr<Envelope> envelope(uint32_t index) {
+        const double* v = nodes[index].values;
+        size_t slot = reserve(nodes[index]);
+        auto result = std::make_unique<Envelope>(sampleRate);
+        result->setADSR(v[0], v[1], v[2], v[3]);
+        if (slot != NoSlot) registrations[slot].envelope = result.get();
+        return result;
+    }
+
+    void volume(uint32_t index, Sound* sound) {
+        size_t slot = reserve(nodes[index]);
+        sound->setMasterVolume(nodes[index].values[0]);
+        if (slot != NoSlot) registrations[slot].sound = sound;
+    }
+
+    void registerAll(LiveController& controller) {
+        for (const auto& entry : registrations) {
+            bool prefixed = (entry.node->flags & CompiledPatch::PrefixFlag) != 0;
+            std::string prefix = strings + entry.node->prefix;
+
+            if (entry.oscillator) {
+                if (prefixed) entry.oscillator->registerParametersWithPrefix(controller, prefix);
+                else entry.oscillator->registerParameters(controller);
+            } else if (entry.filter) {
+                if (prefixed) entry.filter->registerParametersWithPrefix(controller, prefix);
+                else entry.filter->registerParameters(controller);
+            } else if (entry.envelope) {
+                registerEnvelope(controller, entry.envelope, prefixed ? prefix : std::string());
+            } else if (entry.sound) {
+                Sound* sound = entry.sound;
+                sound->registerLayerPans(controller, prefixed ? prefix : std::string());
+                double* volumePtr = sound->getMasterVolumePtr();
+                ParameterId volumeId = prefixed
+                    ? controller.addParameterInGroup(prefix, "Volume", volumePtr, 0, 100, 50, {"%"})
+                    : controller.addParameter("Master Volume", volumePtr, 0, 100, 50, {"%"});
+                controller.setParameterCallback(volumeId, [sound]() { sound->updateMasterVolume(); });
+            }
+        }
+    }
+
+private:
+    static constexpr size_t NoSlot = static_cast<size_t>(-1);
+
+    struct Registration {
+        const PatchNodeRecord* node;
+        Oscillator* oscillator = nullptr;
+        Filter* filter = nullptr;
+        Envelope* envelope = nullptr;
+        Sound* sound = nullptr;
+    };
+
+    const PatchNodeRecord* nodes;
+    const char* strings;
+    double sampleRate;
+    std::vector<Registration> registrations;
+
+    size_t reserve(const PatchNodeRecord& node) {
+        if (!(node.flags & (CompiledPatch::RegisterFlag | CompiledPatch::PrefixFlag))) return NoSlot;
+        registrations.push_back({&node});
+        return registrations.size() - 1;
+    }
+
+    static void registerEnvelope(LiveController& controller, Envelope* envelope, const std::string& prefix) {
+        // Same names and ranges as the built-in presets
+        struct Field { const char* name; double* value; double max; double step; const char* unit; };
+        const Field fields[] = {
+            {"Attack", envelope->getAttackPtr(), 2000.0, 10.0, "ms"},
+            {"Decay", envelope->getDecayPtr(), 2000.0, 100.0, "ms"},
+            {"Sustain", envelope->getSustainPtr(), 100.0, 70.0, "%"},
+            {"Release", envelope->getReleasePtr(), 2000.0, 200.0, "ms"},
+        };
+        for (const auto& field : fields) {
+            if (prefix.empty())
+                controller.addParameter(field.name, field.value, 0.0, field.max, field.step, {field.unit});
+            else
+                controller.addParameterInGroup(prefix, field.name, field.value, 0.0, field.max, field.step, {field.unit});
+        }
+    }
+};
+
+} // namespace
+
+CompiledPatch::~CompiledPatch() {
+    release();
+}
+
+void CompiledPatch::release() {
+#ifdef PATCH_USE_MMAP
+    if (mapping) munmap(mapping, size);
+#endif
+    mapping = nullptr;
+    ownedBytes.clear();
+    size = 0;
+    header = nullptr;
+    nodes = nullptr;
+    parameters = nullptr;
+    strings = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Compiling
+// -----------------------------------------------------------------------------
+std::vector<uint8_t> CompiledPatch::compile(const Patch& patch) {
+    // Breadth-first: every node's children end up contiguous and after it
+    std::vector<const PatchNode*> order;
+    for (const auto& node : patch.nodes) order.push_back(&node);
+    std::vector<uint32_t> firstChild;
+    for (size_t i = 0; i < order.size(); ++i) {
+        firstChild.push_back(static_cast<uint32_t>(order.size()));
+        for (const auto& child : order[i]->children) order.push_back(&child);
+    }
+
+    StringTable table;
+    PatchFileHeader header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.headerSize = sizeof(PatchFileHeader);
+    header.nodeCount = static_cast<uint32_t>(order.size());
+    header.rootCount = static_cast<uint32_t>(patch.nodes.size());
+    header.parameterCount = static_cast<uint32_t>(patch.parameters.size());
+    header.name = table.add(patch.name);
+    header.description = table.add(patch.description);
+
+    std::vector<PatchNodeRecord> nodeRecords(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const PatchNode& node = *order[i];
+        PatchNodeRecord& record = nodeRecords[i];
+        std::memset(&record, 0, sizeof(record));
+        record.type = static_cast<uint8_t>(node.type);
+        if (node.registerParameters) record.flags |= RegisterFlag;
+        if (node.hasPrefix) record.flags |= PrefixFlag;
+        record.childCount = static_cast<uint16_t>(node.children.size());
+        record.firstChild = firstChild[i];
+        record.prefix = table.add(node.prefix);
+        std::memcpy(record.values, node.values, sizeof(record.values));
+        record.pan = node.pan;
+    }
+
+    std::vector<PatchParameterRecord> parameterRecords(patch.parameters.size());
+    for (size_t i = 0; i < patch.parameters.size(); ++i) {
+        const PatchParameter& param = patch.parameters[i];
+        PatchParameterRecord& record = parameterRecords[i];
+        std::memset(&record, 0, sizeof(record));
+        record.path = table.add(param.path);
+        if (param.hasRange) record.flags |= RangeFlag;
+        record.value = param.value;
+        record.minValue = param.minValue;
+        record.maxValue = param.maxValue;
+    }
+
+    header.nodeOffset = alignUp(sizeof(PatchFileHeader));
+    header.parameterOffset = alignUp(header.nodeOffset + header.nodeCount * sizeof(PatchNodeRecord));
+    header.stringOffset = alignUp(header.parameterOffset + header.parameterCount * sizeof(PatchParameterRecord));
+    header.stringSize = static_cast<uint32_t>(table.data().size());
+    header.fileSize = header.stringOffset + header.stringSize;
+
+    std::vector<uint8_t> bytes(header.fileSize, 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    if (!nodeRecords.empty())
+        std::memcpy(bytes.data() + header.nodeOffset, nodeRecords.data(), nodeRecords.size() * sizeof(PatchNodeRecord));
+    if (!parameterRecords.empty())
+        std::memcpy(bytes.data() + header.parameterOffset, parameterRecords.data(),
+                    parameterRecords.size() * sizeof(PatchParameterRecord));
+    std::memcpy(bytes.data() + header.stringOffset, table.data().data(), header.stringSize);
+    return bytes;
+}
+
+bool CompiledPatch::writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    // Write aside and rename, so a reader never maps a half-written cache
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// -----------------------------------------------------------------------------
+// Loading
+// -----------------------------------------------------------------------------
+bool CompiledPatch::open(const std::string& path) {
+    release();
+#ifdef PATCH_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(PatchFileHeader));
+    void* mapped = ok ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    mapping = mapped;
+    size = static_cast<size_t>(info.st_size);
+    if (!attach(static_cast<const uint8_t*>(mapped), size)) {
+        release();
+        return false;
+    }
+    return true;
+#else
+    std::string text;
+    if (!PatchFormat::readFile(path, text)) return false;
+    return load(std::vector<uint8_t>(text.begin(), text.end()));
+#endif
+}
+
+bool CompiledPatch::load(std::vector<uint8_t> bytes) {
+    release();
+    ownedBytes = std::move(bytes);
+    if (!attach(ownedBytes.data(), ownedBytes.size())) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledPatch::attach(const uint8_t* bytes, size_t length) {
+    if (length < sizeof(PatchFileHeader) || reinterpret_cast<uintptr_t>(bytes) % alignof(double) != 0) return false;
+
+    const auto* h = reinterpret_cast<const PatchFileHeader*>(bytes);
+    auto fits = [length](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % 8 == 0 && offset + count * recordSize <= length;
+    };
+    bool ok = h->magic == Magic && h->version == Version && h->headerSize == sizeof(PatchFileHeader)
+           && h->fileSize == length && h->rootCount <= h->nodeCount
+           && fits(h->nodeOffset, h->nodeCount, sizeof(PatchNodeRecord))
+           && fits(h->parameterOffset, h->parameterCount, sizeof(PatchParameterRecord))
+           && h->stringSize > 0 && uint64_t(h->stringOffset) + h->stringSize <= length
+           && bytes[h->stringOffset + h->stringSize - 1] == '\0'
+           && h->name < h->stringSize && h->description < h->stringSize;
+    if (!ok) return false;
+
+    const auto* nodeRecords = reinterpret_cast<const PatchNodeRecord*>(bytes + h->nodeOffset);
+    for (uint32_t i = 0; i < h->nodeCount; ++i) {
+        const PatchNodeRecord& node = nodeRecords[i];
+        if (node.type >= static_cast<uint8_t>(PatchNodeType::Count) || node.prefix >= h->stringSize) return false;
+
+        // Children strictly after the parent keeps the graph a tree we can walk without checks
+        const PatchNodeSpec& spec = PatchFormat::getSpec(static_cast<PatchNodeType>(node.type));
+        bool childrenOk = node.childCount >= spec.minChildren
+                       && (spec.maxChildren < 0 || node.childCount <= spec.maxChildren)
+                       && (node.childCount == 0 || (node.firstChild > i && node.firstChild >= h->rootCount
+                           && uint64_t(node.firstChild) + node.childCount <= h->nodeCount));
+        if (!childrenOk) return false;
+        for (uint32_t c = 0; c < node.childCount; ++c) {
+            PatchNodeKind expected = spec.childKind;
+            if (node.type == static_cast<uint8_t>(PatchNodeType::Filtered) && c == 0) expected = PatchNodeKind::Oscillator;
+            uint8_t childType = nodeRecords[node.firstChild + c].type;
+            if (childType >= static_cast<uint8_t>(PatchNodeType::Count)
+                || PatchFormat::getSpec(static_cast<PatchNodeType>(childType)).kind != expected) return false;
+        }
+    }
+    const auto* parameterRecords = reinterpret_cast<const PatchParameterRecord*>(bytes + h->parameterOffset);
+    for (uint32_t i = 0; i < h->parameterCount; ++i) {
+        if (parameterRecords[i].path >= h->stringSize) return false;
+    }
+
+    size = length;
+    header = h;
+    nodes = nodeRecords;
+    parameters = parameterRecords;
+    strings = reinterpret_cast<const char*>(bytes + h->stringOffset);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Instantiation
+// -----------------------------------------------------------------------------
+void CompiledPatch::instantiate(Sound* sound, LiveController& controller) const {
+    if (!isValid()) return;
+
+    PatchBuilder builder(nodes, strings, sound->getSampleRate());
+    for (uint32_t i = 0; i < header->rootCount; ++i) {
+        switch (PatchFormat::getSpec(static_cast<PatchNodeType>(nodes[i].type)).kind) {
+            case PatchNodeKind::Oscillator:
+                sound->addOscillator(builder.oscillator(i));
+                sound->setOscillatorPan(sound->getOscillatorCount() - 1, nodes[i].pan);
+                break;
+            case PatchNodeKind::Filter:     sound->addFilter(builder.filter(i)); break;
+            case PatchNodeKind::Envelope:   sound->addEnvelope(builder.envelope(i)); break;
+            case PatchNodeKind::Volume:     builder.volume(i, sound); break;
+        }
+    }
+    builder.registerAll(controller);
+
+    for (uint32_t i = 0; i < header->parameterCount; ++i) {
+        const PatchParameterRecord& param = parameters[i];
+        ParameterId id = controller.findParameter(string(param.path));
+        if (id == InvalidParameterId) {
+            LOG_WARNING("⚠️ Patch '%s' stores unknown parameter '%s'", string(header->name), string(param.path));
+            continue;
+        }
+        if (param.flags & RangeFlag) controller.setParameterRange(id, param.minValue, param.maxValue);
+        controller.setParameter(id, param.value);
+    }
+}
+
+PatchNode CompiledPatch::decompileNode(uint32_t index) const {
+    const PatchNodeRecord& record = nodes[index];
+    PatchNode node;
+    node.type = static_cast<PatchNodeType>(record.type);
+    std::memcpy(node.values, record.values, sizeof(node.values));
+    node.registerParameters = (record.flags & RegisterFlag) != 0;
+    node.hasPrefix = (record.flags & PrefixFlag) != 0;
+    node.prefix = string(record.prefix);
+    node.pan = record.pan;
+    for (uint32_t c = 0; c < record.childCount; ++c) {
+        node.children.push_back(decompileNode(record.firstChild + c));
+    }
+    return node;
+}
+
+Patch CompiledPatch::decompile() const {
+    Patch patch;
+    if (!isValid()) return patch;
+
+    patch.name = getName();
+    patch.description = getDescription();
+    for (uint32_t i = 0; i < header->rootCount; ++i) {
+        patch.nodes.push_back(decompileNode(i));
+    }
+    for (uint32_t i = 0; i < header->parameterCount; ++i) {
+        const PatchParameterRecord& record = parameters[i];
+        PatchParameter param;
+        param.path = string(record.path);
+        param.value = record.value;
+        param.hasRange = (record.flags & RangeFlag) != 0;
+        param.minValue = record.minValue;
+        param.maxValue = record.maxValue;
+        patch.parameters.push_back(param);
+    }
+    return patch;
+}
@@ -0,0 +1,104 @@
+#ifndef COMPILEDPATCH_H
+#define COMPILEDPATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PatchFormat.h"
+
+class Sound;
+
+// Binary form of a Patch, laid out to be used in place from an mmapped file:
+//
+//   PatchFileHeader | PatchNodeRecord[nodeCount] | PatchParameterRecord[parameterCount] | strings
+//
+// Nodes are in breadth-first order: the top-level nodes come first and the
+// children of every node are contiguous, always after their parent. Strings
+// are NUL-terminated offsets into the string table (offset 0 is ""). Native
+// byte order - the file is a cache, recompiled from the text when stale.
+struct PatchFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t fileSize;
+    uint32_t nodeCount;
+    uint32_t rootCount;
+    uint32_t parameterCount;
+    uint32_t nodeOffset;
+    uint32_t parameterOffset;
+    uint32_t stringOffset;
+    uint32_t stringSize;
+    uint32_t name;
+    uint32_t description;
+};
+
+struct PatchNodeRecord {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t childCount;
+    uint32_t firstChild;
+    uint32_t prefix;
+    uint32_t reserved;
+    double values[PatchMaxValues];
+    double pan;
+};
+
+struct PatchParameterRecord {
+    uint32_t path;
+    uint32_t flags;
+    double value;
+    double minValue;
+    double maxValue;
+};
+
+class CompiledPatch {
+public:
+    static constexpr uint32_t Magic = 0x504E5953;  // "SYNP"
+    static constexpr uint16_t Version = 2;
+
+    enum NodeFlags : uint8_t { RegisterFlag = 1, PrefixFlag = 2 };
+    enum ParameterFlags : uint32_t { RangeFlag = 1 };
+
+    CompiledPatch() = default;
+    ~CompiledPatch();
+    CompiledPatch(const CompiledPatch&) = delete;
+    CompiledPatch& operator=(const CompiledPatch&) = delete;
+
+    static std::vector<uint8_t> compile(const Patch& patch);
+    static bool writeFile(const std::string& path, const std::vector<uint8_t>& bytes);
+
+    // Maps a compiled file read-only (or reads it where mmap is unavailable).
+    // Both validate every offset once, so instantiate() does no checking.
+    bool open(const std::string& path);
+    bool load(std::vector<uint8_t> bytes);
+    bool isValid() const { return header != nullptr; }
+
+    std::string getName() const { return string(header->name); }
+    std::string getDescription() const { return string(header->description); }
+    size_t getSize() const { return size; }
+
+    // Builds the graph into an empty Sound, registers parameters and applies
+    // the stored values. Only constructors and setters run - no parsing.
+    void instantiate(Sound* sound, LiveController& controller) const;
+
+    // Back to the editable form, e.g. to store a user's parameter state
+    Patch decompile() const;
+
+private:
+    size_t size = 0;
+    const PatchFileHeader* header = nullptr;
+    const PatchNodeRecord* nodes = nullptr;
+    const PatchParameterRecord* parameters = nullptr;
+    const char* strings = nullptr;
+
+    std::vector<uint8_t> ownedBytes;
+    void* mapping = nullptr;
+
+    void release();
+    bool attach(const uint8_t* bytes, size_t length);
+    const char* string(uint32_t offset) const { return strings + offset; }
+    PatchNode decompileNode(uint32_t index) const;
+};
+
+#endif // COMPILEDPATCH_H
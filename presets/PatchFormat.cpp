@@ -0,0 +1,367 @@
+#include "PatchFormat.h"
+#include "../interface/LiveController.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+using Kind = PatchNodeKind;
+
+// Indexed by PatchNodeType. Defaults match the constructors of the classes
+// they create, except where a preset-friendly value is more useful.
+const PatchNodeSpec Specs[] = {
+    {"sine", Kind::Oscillator, 2, {{"frequency", 440.0, nullptr}, {"amplitude", 1.0, nullptr}}, 0, 0, Kind::Oscillator},
+    {"saw", Kind::Oscillator, 2, {{"frequency", 440.0, nullptr}, {"amplitude", 1.0, nullptr}}, 0, 0, Kind::Oscillator},
+    // Children are carrier then modulator; their frequencies come from this node
+    {"fm", Kind::Oscillator, 3,
+     {{"carrier", 440.0, nullptr}, {"modulator", 880.0, nullptr}, {"depth", 100.0, nullptr}}, 0, 2, Kind::Oscillator},
+    {"additive", Kind::Oscillator, 0, {}, 0, -1, Kind::Oscillator},
+    {"oversampled", Kind::Oscillator, 1, {{"factor", 2.0, nullptr}}, 1, 1, Kind::Oscillator},
+    {"unison", Kind::Oscillator, 12,
+     {{"waveform", 1.0, "sine|saw"}, {"filter", 0.0, "lowpass|bandpass"}, {"frequency", 440.0, nullptr},
+      {"voices", 4.0, nullptr}, {"detune", 12.0, nullptr}, {"cutoff", 2000.0, nullptr}, {"shape", 0.7071, nullptr},
+      {"attack", 10.0, nullptr}, {"decay", 100.0, nullptr}, {"sustain", 70.0, nullptr}, {"release", 200.0, nullptr},
+      {"spread", 0.0, nullptr}},
+     0, 0, Kind::Oscillator},
+    // First child is the source oscillator, the rest its filter chain
+    {"filtered", Kind::Oscillator, 0, {}, 1, -1, Kind::Filter},
+    {"lowpass", Kind::Filter, 2, {{"cutoff", 1000.0, nullptr}, {"resonance", 0.7071, nullptr}}, 0, 0, Kind::Filter},
+    {"bandpass", Kind::Filter, 2, {{"frequency", 1000.0, nullptr}, {"bandwidth", 200.0, nullptr}}, 0, 0, Kind::Filter},
+    {"oversampled-filter", Kind::Filter, 1, {{"factor", 2.0, nullptr}}, 1, 1, Kind::Filter},
+    {"envelope", Kind::Envelope, 4,
+     {{"attack", 10.0, nullptr}, {"decay", 100.0, nullptr}, {"sustain", 70.0, nullptr}, {"release", 200.0, nullptr}},
+     0, 0, Kind::Oscillator},
+    {"volume", Kind::Volume, 1, {{"level", 0.7, nullptr}}, 0, 0, Kind::Oscillator},
+};
+static_assert(sizeof(Specs) / sizeof(Specs[0]) == static_cast<size_t>(PatchNodeType::Count),
+              "one spec per node type");
+
+struct Token {
+    std::string key;     // Bare word, or the part before '='
+    std::string value;   // After '=', or the string itself for a quoted token
+    bool hasValue = false;
+    bool quoted = false;
+};
+
+bool readQuoted(const std::string& line, size_t& pos, std::string& out) {
+    // pos is on the opening quote
+    ++pos;
+    while (pos < line.size()) {
+        char c = line[pos++];
+        if (c == '"') return true;
+        if (c == '\\' && pos < line.size()) c = line[pos++];
+        out += c;
+    }
+    return false;
+}
+
+bool tokenize(const std::string& line, int& indent, std::vector<Token>& tokens, std::string& error) {
+    size_t pos = 0;
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) ++pos;
+    indent = static_cast<int>(pos);
+
+    while (pos < line.size()) {
+        char c = line[pos];
+        if (c == ' ' || c == '\t') { ++pos; continue; }
+        if (c == '#') break;
+
+        Token token;
+        if (c == '"') {
+            token.quoted = token.hasValue = true;
+            if (!readQuoted(line, pos, token.value)) { error = "unterminated string"; return false; }
+        } else {
+            while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '=') {
+                token.key += line[pos++];
+            }
+            if (pos < line.size() && line[pos] == '=') {
+                ++pos;
+                token.hasValue = true;
+                if (pos < line.size() && line[pos] == '"') {
+                    if (!readQuoted(line, pos, token.value)) { error = "unterminated string"; return false; }
+                } else {
+                    while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t') token.value += line[pos++];
+                }
+            }
+        }
+        tokens.push_back(std::move(token));
+    }
+    return true;
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size();
+}
+
+bool parseChoice(const char* choices, const std::string& word, double& value) {
+    int index = 0;
+    const char* start = choices;
+    for (;;) {
+        const char* bar = std::strchr(start, '|');
+        size_t length = bar ? static_cast<size_t>(bar - start) : std::strlen(start);
+        if (word.size() == length && word.compare(0, length, start, length) == 0) {
+            value = index;
+            return true;
+        }
+        if (!bar) return false;
+        start = bar + 1;
+        ++index;
+    }
+}
+
+std::string choiceName(const char* choices, double value) {
+    int wanted = static_cast<int>(value);
+    const char* start = choices;
+    for (int index = 0; start; ++index) {
+        const char* bar = std::strchr(start, '|');
+        if (index == wanted && static_cast<double>(wanted) == value) {
+            return bar ? std::string(start, bar - start) : std::string(start);
+        }
+        start = bar ? bar + 1 : nullptr;
+    }
+    return std::string();
+}
+
+// Shortest form that reads back to the same double
+std::string formatNumber(double value) {
+    char text[32];
+    for (int precision = 6; precision <= 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+std::string quote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+bool parseNodeLine(const std::vector<Token>& tokens, PatchNode& node, std::string& error) {
+    PatchNodeType type;
+    if (tokens[0].quoted || tokens[0].hasValue || !PatchFormat::findType(tokens[0].key, type)) {
+        error = "unknown node '" + (tokens[0].quoted ? tokens[0].value : tokens[0].key) + "'";
+        return false;
+    }
+    node = PatchFormat::makeNode(type);
+    const PatchNodeSpec& spec = PatchFormat::getSpec(type);
+
+    for (size_t t = 1; t < tokens.size(); ++t) {
+        const Token& token = tokens[t];
+        if (token.quoted) { error = "unexpected string after " + tokens[0].key; return false; }
+        if (token.key == "register" && !token.hasValue) { node.registerParameters = true; continue; }
+        if (token.key == "prefix" && token.hasValue) { node.prefix = token.value; node.hasPrefix = true; continue; }
+        if (token.key == "pan" && token.hasValue && spec.kind == Kind::Oscillator) {
+            if (!parseNumber(token.value, node.pan) || node.pan < -1.0 || node.pan > 1.0) {
+                error = "bad value for pan: " + token.value;
+                return false;
+            }
+            continue;
+        }
+
+        int attribute = 0;
+        while (attribute < spec.attributeCount && token.key != spec.attributes[attribute].key) ++attribute;
+        if (attribute == spec.attributeCount || !token.hasValue) {
+            error = "'" + token.key + "' is not an attribute of " + spec.keyword;
+            return false;
+        }
+        const PatchAttribute& info = spec.attributes[attribute];
+        bool ok = (info.choices && parseChoice(info.choices, token.value, node.values[attribute]))
+               || parseNumber(token.value, node.values[attribute]);
+        if (!ok) { error = "bad value for " + token.key + ": " + token.value; return false; }
+    }
+    return true;
+}
+
+bool parseParameterLine(const std::vector<Token>& tokens, PatchParameter& param, std::string& error) {
+    // param "Path" value [range min max]
+    bool ok = tokens.size() >= 3 && tokens[1].quoted && !tokens[2].quoted && !tokens[2].hasValue;
+    if (ok) {
+        param.path = tokens[1].value;
+        ok = parseNumber(tokens[2].key, param.value);
+    }
+    if (ok && tokens.size() > 3) {
+        ok = tokens.size() == 6 && tokens[3].key == "range"
+          && parseNumber(tokens[4].key, param.minValue) && parseNumber(tokens[5].key, param.maxValue)
+          && param.minValue <= param.maxValue;
+        param.hasRange = ok;
+    }
+    if (!ok) error = "expected: param \"Path\" value [range min max]";
+    return ok;
+}
+
+bool validateNode(const PatchNode& node, std::string& error) {
+    const PatchNodeSpec& spec = PatchFormat::getSpec(node.type);
+    int count = static_cast<int>(node.children.size());
+    if (count < spec.minChildren || (spec.maxChildren >= 0 && count > spec.maxChildren)) {
+        error = std::string(spec.keyword) + " has " + std::to_string(count) + " children";
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        PatchNodeKind expected = spec.childKind;
+        if (node.type == PatchNodeType::Filtered && i == 0) expected = PatchNodeKind::Oscillator;
+        const PatchNode& child = node.children[i];
+        if (PatchFormat::getSpec(child.type).kind != expected) {
+            error = std::string(PatchFormat::getSpec(child.type).keyword) + " cannot be a child of " + spec.keyword;
+            return false;
+        }
+        if (child.pan != 0.0) {
+            error = "only a top-level " + std::string(PatchFormat::getSpec(child.type).keyword) + " has a pan";
+            return false;
+        }
+        if (!validateNode(child, error)) return false;
+    }
+    return true;
+}
+
+void writeNode(std::ostringstream& out, const PatchNode& node, int depth) {
+    const PatchNodeSpec& spec = PatchFormat::getSpec(node.type);
+    out << std::string(depth * 2, ' ') << spec.keyword;
+    for (int a = 0; a < spec.attributeCount; ++a) {
+        const PatchAttribute& info = spec.attributes[a];
+        if (node.values[a] == info.defaultValue) continue;
+        std::string name = info.choices ? choiceName(info.choices, node.values[a]) : std::string();
+        out << ' ' << info.key << '=' << (name.empty() ? formatNumber(node.values[a]) : name);
+    }
+    if (node.pan != 0.0) out << " pan=" << formatNumber(node.pan);
+    if (node.hasPrefix) out << " prefix=" << quote(node.prefix);
+    if (node.registerParameters) out << " register";
+    out << '\n';
+    for (const auto& child : node.children) writeNode(out, child, depth + 1);
+}
+
+} // namespace
+
+const PatchNodeSpec& PatchFormat::getSpec(PatchNodeType type) {
+    return Specs[static_cast<int>(type)];
+}
+
+bool PatchFormat::findType(const std::string& keyword, PatchNodeType& type) {
+    for (int t = 0; t < static_cast<int>(PatchNodeType::Count); ++t) {
+        if (keyword == Specs[t].keyword) {
+            type = static_cast<PatchNodeType>(t);
+            return true;
+        }
+    }
+    return false;
+}
+
+PatchNode PatchFormat::makeNode(PatchNodeType type) {
+    PatchNode node;
+    node.type = type;
+    const PatchNodeSpec& spec = getSpec(type);
+    for (int a = 0; a < spec.attributeCount; ++a) {
+        node.values[a] = spec.attributes[a].defaultValue;
+    }
+    return node;
+}
+
+bool PatchFormat::parse(const std::string& text, Patch& patch, std::string& error) {
+    patch = Patch();
+
+    struct Level { int indent; PatchNode* node; };
+    std::vector<Level> stack;
+
+    std::istringstream lines(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(lines, line); ++lineNumber) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        int indent = 0;
+        std::vector<Token> tokens;
+        std::string reason;
+        bool ok = tokenize(line, indent, tokens, reason);
+        if (ok && tokens.empty()) continue;
+
+        const std::string& keyword = ok ? tokens[0].key : reason;
+        bool header = ok && !tokens[0].quoted && (keyword == "patch" || keyword == "description" || keyword == "param");
+        if (header) {
+            if (indent != 0) {
+                ok = false;
+                reason = keyword + " must not be indented";
+            } else if (keyword == "param") {
+                PatchParameter param;
+                ok = parseParameterLine(tokens, param, reason);
+                if (ok) patch.parameters.push_back(param);
+            } else if (tokens.size() != 2 || !tokens[1].quoted) {
+                ok = false;
+                reason = "expected: " + keyword + " \"text\"";
+            } else {
+                (keyword == "patch" ? patch.name : patch.description) = tokens[1].value;
+            }
+            stack.clear();
+        } else if (ok) {
+            PatchNode node;
+            ok = parseNodeLine(tokens, node, reason);
+            if (ok) {
+                // Children are indented deeper than their parent; siblings are
+                // only appended after the deeper levels are popped, so the
+                // pointers left on the stack stay valid
+                while (!stack.empty() && stack.back().indent >= indent) stack.pop_back();
+                std::vector<PatchNode>& siblings = stack.empty() ? patch.nodes : stack.back().node->children;
+                siblings.push_back(std::move(node));
+                stack.push_back({indent, &siblings.back()});
+            }
+        }
+
+        if (!ok) {
+            error = "line " + std::to_string(lineNumber) + ": " + reason;
+            return false;
+        }
+    }
+    return validate(patch, error);
+}
+
+bool PatchFormat::validate(const Patch& patch, std::string& error) {
+    for (const auto& node : patch.nodes) {
+        if (!validateNode(node, error)) return false;
+    }
+    return true;
+}
+
+std::string PatchFormat::write(const Patch& patch) {
+    std::ostringstream out;
+    if (!patch.name.empty()) out << "patch " << quote(patch.name) << '\n';
+    if (!patch.description.empty()) out << "description " << quote(patch.description) << '\n';
+    for (const auto& node : patch.nodes) writeNode(out, node, 0);
+    for (const auto& param : patch.parameters) {
+        out << "param " << quote(param.path) << ' ' << formatNumber(param.value);
+        if (param.hasRange) out << " range " << formatNumber(param.minValue) << ' ' << formatNumber(param.maxValue);
+        out << '\n';
+    }
+    return out.str();
+}
+
+void PatchFormat::captureParameters(Patch& patch, const LiveController& controller) {
+    patch.parameters.clear();
+    for (ParameterId id = 0; id < controller.getParameterCount(); ++id) {
+        const LiveParameter& live = controller.getParameter(id);
+        if (!live.valuePtr) continue;
+
+        PatchParameter param;
+        param.path = std::string(live.name);
+        param.value = *live.valuePtr;
+        param.hasRange = true;
+        param.minValue = live.minValue;
+        param.maxValue = live.maxValue;
+        patch.parameters.push_back(param);
+    }
+}
+
+bool PatchFormat::readFile(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    text = contents.str();
+    return true;
+}
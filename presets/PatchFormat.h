@@ -0,0 +1,107 @@
+#ifndef PATCHFORMAT_H
+#define PATCHFORMAT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class LiveController;
+
+// Declarative description of a preset: the node graph, its settings, which
+// nodes register live parameters, and stored parameter values/ranges.
+//
+// Text form, one node per line, children indented below their parent:
+//
+//   patch "Soft Sound"
+//   description "Sine and saw through a lowpass"
+//   filtered pan=-0.5
+//     additive
+//       sine frequency=220 amplitude=0.7
+//       saw frequency=220 amplitude=0.3
+//     lowpass cutoff=2000 resonance=0.3 prefix="Lowpass"
+//   envelope attack=10 decay=100 sustain=70 release=200 register
+//   volume register
+//   param "Lowpass Cutoff Freq" 2500 range 20 8000
+//
+// Top-level oscillators become Sound layers, top-level filters Sound
+// filters. A layer may carry `pan=` (-1 to 1, see Sound::setOscillatorPan);
+// a registered volume registers every layer's pan next to it.
+// `register` calls registerParameters(), `prefix="..."` calls
+// registerParametersWithPrefix(); containers register their children
+// themselves, so flag either the container or its children. `param` lines
+// are applied after registration, by full parameter path.
+// '#' starts a comment. CompiledPatch turns this into the binary form.
+
+enum class PatchNodeType : uint8_t {
+    Sine, Saw, FM, Additive, Oversampled, Unison, Filtered,
+    LowPass, BandPass, OversampledFilter, Envelope, Volume,
+    Count
+};
+
+enum class PatchNodeKind { Oscillator, Filter, Envelope, Volume };
+
+constexpr int PatchMaxValues = 12;
+
+struct PatchAttribute {
+    const char* key;
+    double defaultValue;
+    const char* choices;  // "sine|saw": the value is the index of the word, nullptr if numeric
+};
+
+// What a node type accepts - one entry per PatchNodeType
+struct PatchNodeSpec {
+    const char* keyword;
+    PatchNodeKind kind;
+    int attributeCount;
+    PatchAttribute attributes[PatchMaxValues];
+    int minChildren;
+    int maxChildren;         // -1 = any number
+    PatchNodeKind childKind; // For Filtered: the first child is the oscillator, the rest filters
+};
+
+struct PatchNode {
+    PatchNodeType type = PatchNodeType::Sine;
+    double values[PatchMaxValues] = {};  // In attribute order, defaults filled in
+    std::string prefix;
+    bool hasPrefix = false;
+    bool registerParameters = false;
+    double pan = 0.0;                    // Top-level oscillators only
+    std::vector<PatchNode> children;
+};
+
+struct PatchParameter {
+    std::string path;
+    double value = 0.0;
+    bool hasRange = false;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+};
+
+struct Patch {
+    std::string name;
+    std::string description;
+    std::vector<PatchNode> nodes;            // Top level, in Sound order
+    std::vector<PatchParameter> parameters;
+};
+
+class PatchFormat {
+public:
+    static const PatchNodeSpec& getSpec(PatchNodeType type);
+    static bool findType(const std::string& keyword, PatchNodeType& type);
+    static PatchNode makeNode(PatchNodeType type);  // All attributes at their defaults
+
+    // Text form. On failure error holds "line N: reason" and patch is unspecified.
+    static bool parse(const std::string& text, Patch& patch, std::string& error);
+    static std::string write(const Patch& patch);
+
+    // Structure rules (child counts/kinds, top-level kinds) shared with the compiler
+    static bool validate(const Patch& patch, std::string& error);
+
+    // Replaces the stored parameter lines with the controller's current values
+    // and ranges, so the patch reproduces the user's state when loaded
+    static void captureParameters(Patch& patch, const LiveController& controller);
+
+    static bool readFile(const std::string& path, std::string& text);
+};
+
+#endif // PATCHFORMAT_H
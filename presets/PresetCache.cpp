@@ -0,0 +1,260 @@
+#include "PresetCache.h"
+#include "PresetManager.h"
+#include "../core/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+// Footprint: the patch arena (modules and graph scratch buffers) is exact;
+// what the modules keep on the heap and the parameters are estimated
+constexpr size_t NodeHeapBytes = 128;
+constexpr size_t ParameterNameBytes = 64;
+
+size_t estimateFootprint(const PreparedPreset& prepared) {
+    const RenderGraph& graph = prepared.sound->getRenderGraph();
+    size_t bytes = sizeof(PreparedPreset) + sizeof(Sound) + sizeof(LiveController);
+    bytes += prepared.sound->getArena()->getBytesReserved();
+    bytes += static_cast<size_t>(graph.getNodeCount()) * NodeHeapBytes;
+    bytes += static_cast<size_t>(prepared.controller->getParameterCount()) * (sizeof(LiveParameter) + ParameterNameBytes);
+    return bytes;
+}
+
+double microsecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+PresetCache::PresetCache(const PresetManager& presetManager, double sampleRate, size_t memoryBudget)
+    : presetManager(presetManager), sampleRate(sampleRate), memoryBudget(memoryBudget) {
+    stats.memoryBudget = memoryBudget;
+}
+
+PresetCache::~PresetCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    if (builder.joinable()) builder.join();
+}
+
+void PresetCache::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (builder.joinable()) return;
+    for (int i = 0; i < presetManager.getPresetCount(); ++i) {
+        queue(i, JobType::Warm);
+    }
+    builder = std::thread(&PresetCache::builderLoop, this);
+}
+
+std::unique_ptr<PreparedPreset> PresetCache::build(const PresetManager& presetManager, int presetIndex,
+                                                   double sampleRate, int channels) {
+    auto prepared = std::make_unique<PreparedPreset>();
+    prepared->presetIndex = presetIndex;
+    prepared->sound = std::make_unique<Sound>(sampleRate);
+    prepared->sound->setArena(std::make_unique<PatchArena>());
+    prepared->sound->setChannelCount(channels);  // Before the layers, so they build for it
+    prepared->controller = std::make_unique<LiveController>();
+    {
+        // Every module of the preset lands in the Sound's arena, in build order
+        PatchArena::Scope scope(prepared->sound->getArena());
+        presetManager.getPresets()[presetIndex].setupFunction(prepared->sound.get(), *prepared->controller);
+
+        // One block with the envelopes closed: touches every graph buffer and
+        // runs the lazy setup (default FM operators, filter coefficients) now
+        double scratch[Sound::MaxBlockSize];
+        prepared->sound->generateSamples(scratch, Sound::MaxBlockSize);
+    }
+
+    prepared->memoryBytes = estimateFootprint(*prepared);
+    return prepared;
+}
+
+// -----------------------------------------------------------------------------
+// Switching
+// -----------------------------------------------------------------------------
+std::unique_ptr<PreparedPreset> PresetCache::acquire(int presetIndex) {
+    if (presetIndex < 0 || presetIndex >= presetManager.getPresetCount()) return nullptr;
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<PreparedPreset> prepared;
+    double rate;
+    int channels;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        prepared = take(presetIndex);
+        rate = sampleRate;
+        channels = channelCount;
+    }
+    bool hit = prepared != nullptr;
+    if (!hit) prepared = build(presetManager, presetIndex, rate, channels);
+    double elapsedUs = microsecondsSince(start);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (hit) {
+        ++stats.hits;
+        stats.totalHitUs += elapsedUs;
+        stats.maxHitUs = std::max(stats.maxHitUs, elapsedUs);
+    } else {
+        ++stats.misses;
+        stats.totalMissUs += elapsedUs;
+        stats.maxMissUs = std::max(stats.maxMissUs, elapsedUs);
+    }
+    queue(presetIndex, JobType::Refill);  // The one handed out is about to be played and edited
+    return prepared;
+}
+
+bool PresetCache::isReady(int presetIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready.count(presetIndex) != 0;
+}
+
+void PresetCache::setSampleRate(double rate) {
+    std::vector<std::unique_ptr<PreparedPreset>> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (rate == sampleRate) return;
+        sampleRate = rate;
+        stale = rewarm();
+    }
+    LOG_INFO("🔁 Preset cache: rebuilding %zu graphs at %.0f Hz", stale.size(), rate);
+}
+
+double PresetCache::getSampleRate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sampleRate;
+}
+
+void PresetCache::setChannelCount(int channels) {
+    std::vector<std::unique_ptr<PreparedPreset>> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (channels == channelCount) return;
+        channelCount = channels;
+        stale = rewarm();
+    }
+    LOG_INFO("🔁 Preset cache: rebuilding %zu graphs for %d channels", stale.size(), channels);
+}
+
+int PresetCache::getChannelCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return channelCount;
+}
+
+std::vector<std::unique_ptr<PreparedPreset>> PresetCache::rewarm() {
+    std::vector<std::unique_ptr<PreparedPreset>> stale;
+    while (!lru.empty()) stale.push_back(take(lru.back()));
+    if (builder.joinable()) {
+        for (int i = 0; i < presetManager.getPresetCount(); ++i) queue(i, JobType::Warm);
+    }
+    return stale;
+}
+
+// -----------------------------------------------------------------------------
+// Builder thread
+// -----------------------------------------------------------------------------
+void PresetCache::builderLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+        if (stopping) break;
+
+        Job job = jobs.front();
+        jobs.pop_front();
+        bool skip = ready.count(job.presetIndex) != 0
+                 || (job.type == JobType::Warm && memoryUsed >= memoryBudget);
+        if (!skip) {
+            building = true;
+            double rate = sampleRate;
+            int channels = channelCount;
+            lock.unlock();
+            auto prepared = build(presetManager, job.presetIndex, rate, channels);
+            lock.lock();
+            building = false;
+            auto evicted = insert(std::move(prepared), job.type);
+            if (!evicted.empty()) {
+                lock.unlock();  // Free evicted graphs without blocking acquire()
+                evicted.clear();
+                lock.lock();
+            }
+        }
+        if (jobs.empty()) idle.notify_all();
+    }
+    building = false;
+    idle.notify_all();
+}
+
+std::vector<std::unique_ptr<PreparedPreset>> PresetCache::insert(std::unique_ptr<PreparedPreset> prepared,
+                                                                   JobType type) {
+    std::vector<std::unique_ptr<PreparedPreset>> evicted;
+    size_t bytes = prepared->memoryBytes;
+    if (bytes > memoryBudget || ready.count(prepared->presetIndex)) return evicted;
+    // The format changed while it was built
+    if (prepared->sound->getSampleRate() != sampleRate || prepared->sound->getChannelCount() != channelCount) {
+        return evicted;
+    }
+
+    if (type == JobType::Warm) {
+        if (memoryUsed + bytes > memoryBudget) return evicted;
+    } else {
+        while (memoryUsed + bytes > memoryBudget && !lru.empty()) {
+            evicted.push_back(take(lru.back()));
+        }
+    }
+
+    int index = prepared->presetIndex;
+    lru.push_front(index);
+    memoryUsed += bytes;
+    ready.emplace(index, Entry{std::move(prepared), lru.begin()});
+    return evicted;
+}
+
+std::unique_ptr<PreparedPreset> PresetCache::take(int presetIndex) {
+    auto found = ready.find(presetIndex);
+    if (found == ready.end()) return nullptr;
+    std::unique_ptr<PreparedPreset> prepared = std::move(found->second.preset);
+    memoryUsed -= prepared->memoryBytes;
+    lru.erase(found->second.lruPosition);
+    ready.erase(found);
+    return prepared;
+}
+
+void PresetCache::queue(int presetIndex, JobType type) {
+    for (auto& job : jobs) {
+        if (job.presetIndex == presetIndex) {
+            if (type == JobType::Refill) job.type = type;  // Requested presets may evict
+            return;
+        }
+    }
+    jobs.push_back({presetIndex, type});
+    jobAvailable.notify_one();
+}
+
+void PresetCache::waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!builder.joinable()) return;
+    idle.wait(lock, [this]() { return stopping || (jobs.empty() && !building); });
+}
+
+// -----------------------------------------------------------------------------
+// Reporting
+// -----------------------------------------------------------------------------
+PresetCache::Stats PresetCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats snapshot = stats;
+    snapshot.readyCount = static_cast<int>(ready.size());
+    snapshot.memoryUsed = memoryUsed;
+    return snapshot;
+}
+
+void PresetCache::logStats() const {
+    Stats snapshot = getStats();
+    LOG_INFO("⚡ Preset cache: %d hits (avg %.1f us, max %.1f us), %d misses (avg %.1f us, max %.1f us), "
+             "%d ready, %.2f of %.2f MB",
+             snapshot.hits, snapshot.hits ? snapshot.totalHitUs / snapshot.hits : 0.0, snapshot.maxHitUs,
+             snapshot.misses, snapshot.misses ? snapshot.totalMissUs / snapshot.misses : 0.0, snapshot.maxMissUs,
+             snapshot.readyCount, snapshot.memoryUsed / 1048576.0, snapshot.memoryBudget / 1048576.0);
+}
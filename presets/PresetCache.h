@@ -0,0 +1,122 @@
+#ifndef PRESETCACHE_H
+#define PRESETCACHE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../core/Sound.h"
+#include "../interface/LiveController.h"
+
+class PresetManager;
+
+// A preset built into its own Sound and LiveController, with its modules in
+// the Sound's PatchArena, and rendered once so every lazy allocation and
+// first-touch page fault has already happened.
+// Ready to hand to the audio thread as is (see SoundExchange).
+struct PreparedPreset {
+    int presetIndex = -1;
+    std::unique_ptr<Sound> sound;
+    std::unique_ptr<LiveController> controller;  // Callbacks point into sound
+    size_t memoryBytes = 0;                      // Estimated footprint
+};
+
+// Builds prepared presets on a background thread so switching presets is a
+// pointer hand-over instead of graph construction on the GUI thread.
+//
+// At start() every preset is queued for warming; ready graphs are kept in
+// LRU order under a memory budget. acquire() takes the ready graph (a hit)
+// or builds one on the calling thread (a miss), then queues a fresh copy so
+// the next switch to that preset is a hit again. Presets must all be
+// registered before the cache is started.
+class PresetCache {
+public:
+    static constexpr size_t DefaultMemoryBudget = 64 * 1024 * 1024;
+
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+        double totalHitUs = 0.0;
+        double maxHitUs = 0.0;
+        double totalMissUs = 0.0;
+        double maxMissUs = 0.0;
+        int readyCount = 0;
+        size_t memoryUsed = 0;
+        size_t memoryBudget = 0;
+    };
+
+    PresetCache(const PresetManager& presetManager, double sampleRate,
+                size_t memoryBudget = DefaultMemoryBudget);
+    ~PresetCache();
+    PresetCache(const PresetCache&) = delete;
+    PresetCache& operator=(const PresetCache&) = delete;
+
+    // Starts the builder thread and queues every preset
+    void start();
+
+    // The preset as a ready graph; never nullptr for a valid index
+    std::unique_ptr<PreparedPreset> acquire(int presetIndex);
+    bool isReady(int presetIndex) const;
+
+    // Blocks until the builder has nothing left to do
+    void waitUntilIdle();
+
+    // Drops the ready graphs and warms every preset again at the new rate, so
+    // the audio thread never has to convert a Sound it switches to
+    void setSampleRate(double rate);
+    double getSampleRate() const;
+    // Same for the engine's channel count (see Sound::setChannelCount)
+    void setChannelCount(int channels);
+    int getChannelCount() const;
+
+    Stats getStats() const;
+    void logStats() const;
+
+    // Builds and warms one preset on the calling thread
+    static std::unique_ptr<PreparedPreset> build(const PresetManager& presetManager, int presetIndex,
+                                                 double sampleRate, int channels = 1);
+
+private:
+    // Warm-up jobs only fill free budget; refills after a hit are most
+    // recently used and may evict the least recently used graphs
+    enum class JobType { Warm, Refill };
+    struct Job { int presetIndex; JobType type; };
+
+    struct Entry {
+        std::unique_ptr<PreparedPreset> preset;
+        std::list<int>::iterator lruPosition;
+    };
+
+    const PresetManager& presetManager;
+    double sampleRate;
+    int channelCount = 1;
+    size_t memoryBudget;
+
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    std::unordered_map<int, Entry> ready;
+    std::list<int> lru;       // Front is the most recently used
+    size_t memoryUsed = 0;
+    bool building = false;
+    bool stopping = false;
+    Stats stats;
+    std::thread builder;
+
+    void builderLoop();
+    // Caller holds mutex for these four. insert() returns the graphs it
+    // evicted, to be freed after unlocking.
+    std::vector<std::unique_ptr<PreparedPreset>> insert(std::unique_ptr<PreparedPreset> preset, JobType type);
+    std::unique_ptr<PreparedPreset> take(int presetIndex);
+    void queue(int presetIndex, JobType type);
+    // Drops every ready graph and queues all presets again after a format change
+    std::vector<std::unique_ptr<PreparedPreset>> rewarm();
+};
+
+#endif // PRESETCACHE_H
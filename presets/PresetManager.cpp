@@ -5,8 +5,14 @@
 #include "../filters/BandPassFilter.h"
 #include "../filters/LowPassFilter.h"
 #include "../synthesizers/AdditiveSynthesizer.h" // Add this include
+#include "../oscillators/OversampledOscillator.h"
+#include "../oscillators/FilteredOscillator.h"
+#include "../synthesizers/VoiceLaneSynthesizer.h"
 #include "../envelopes/Envelope.h"
-#include <iostream>
+#include "../core/Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 
 PresetManager::PresetManager() {
     // Register all built-in presets
@@ -16,26 +22,99 @@ PresetManager::PresetManager() {
     registerPreset("Nested FM", "Advanced nested FM synthesis for complex timbres", setupNestedFM);
     registerPreset("Triple Bandpass Additive", "Saw wave split into three bandpass filters, summed additively", setupTripleBandpassAdditive);
     registerPreset("Soft Sound", "Gentle blend of sine and saw through lowpass filter and envelope", softSound); // <-- Added
+    registerPreset("Unison Saw Pad", "Eight detuned saw voices with per-voice lowpass and envelope, rendered in SIMD lanes", setupUnisonSawPad);
 }
 
 void PresetManager::registerPreset(const std::string& name, const std::string& description, PresetSetupFunction setupFunc) {
-    presets.push_back({name, description, setupFunc});
+    presets.push_back({name, description, setupFunc, nullptr});
 }
 
 void PresetManager::loadPreset(int index, Sound* sound, LiveController& controller) {
     if (index >= 0 && index < static_cast<int>(presets.size())) {
-        std::cout << "🎵 Loading preset: " << presets[index].name << std::endl;
-        std::cout << "   Description: " << presets[index].description << std::endl;
+        LOG_INFO("🎵 Loading preset: %s", presets[index].name.c_str());
+        LOG_INFO("   Description: %s", presets[index].description.c_str());
         
         sound->clearOscillators();
         controller.clearParameters();
         
         presets[index].setupFunction(sound, controller);
         
-        std::cout << "✨ Loaded with " << controller.getParameterCount() << " parameters" << std::endl;
+        LOG_INFO("✨ Loaded with %d parameters", controller.getParameterCount());
     }
 }
 
+int PresetManager::loadPatchDirectory(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    if (!fs::is_directory(directory, error)) return 0;
+
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".patch") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    int loaded = 0;
+    for (const auto& file : files) {
+        fs::path cachePath = file;
+        cachePath += "bin";
+
+        auto patch = std::make_shared<CompiledPatch>();
+        bool cacheFresh = fs::exists(cachePath, error)
+                       && fs::last_write_time(cachePath, error) >= fs::last_write_time(file, error);
+        if (!cacheFresh || !patch->open(cachePath.string())) {
+            std::string text, reason;
+            Patch source;
+            if (!PatchFormat::readFile(file.string(), text) || !PatchFormat::parse(text, source, reason)) {
+                LOG_WARNING("⚠️ Skipping patch %s: %s", file.string().c_str(),
+                            reason.empty() ? "cannot read file" : reason.c_str());
+                continue;
+            }
+            if (source.name.empty()) source.name = file.stem().string();
+
+            std::vector<uint8_t> bytes = CompiledPatch::compile(source);
+            if (!CompiledPatch::writeFile(cachePath.string(), bytes)) {
+                LOG_WARNING("⚠️ Cannot write patch cache %s", cachePath.string().c_str());
+            }
+            patch->load(std::move(bytes));
+        }
+        registerPatch(std::move(patch));
+        ++loaded;
+    }
+    LOG_INFO("📂 Loaded %d patches from %s", loaded, directory.c_str());
+    return loaded;
+}
+
+void PresetManager::registerPatch(std::shared_ptr<const CompiledPatch> patch) {
+    if (!patch || !patch->isValid()) return;
+
+    const CompiledPatch* compiled = patch.get();
+    presets.push_back({patch->getName(), patch->getDescription(),
+                       [compiled](Sound* sound, LiveController& controller) {
+                           compiled->instantiate(sound, controller);
+                       },
+                       std::move(patch)});
+}
+
+bool PresetManager::savePatchState(int index, const LiveController& controller, const std::string& path) const {
+    if (index < 0 || index >= static_cast<int>(presets.size()) || !presets[index].patch) {
+        LOG_WARNING("⚠️ Only data presets can be saved");
+        return false;
+    }
+
+    Patch patch = presets[index].patch->decompile();
+    PatchFormat::captureParameters(patch, controller);
+
+    std::ofstream file(path, std::ios::trunc);
+    file << PatchFormat::write(patch);
+    if (!file) {
+        LOG_ERROR("❌ Cannot write patch %s", path.c_str());
+        return false;
+    }
+    LOG_INFO("💾 Saved %s to %s", presets[index].name.c_str(), path.c_str());
+    return true;
+}
+
 std::vector<std::string> PresetManager::getPresetNames() const {
     std::vector<std::string> names;
     for (const auto& preset : presets) {
@@ -46,39 +125,42 @@ std::vector<std::string> PresetManager::getPresetNames() const {
 
 // Built-in preset implementations
 void PresetManager::setupSimpleSine(Sound* sound, LiveController& controller) {
-    auto sine = std::make_unique<SineOscillator>(44100.0);
+    const double rate = sound->getSampleRate();
+    auto sine = std::make_unique<SineOscillator>(rate);
     sine->setFrequency(440.0);
     sine->registerParameters(controller);
 
     // Create and register envelope (times in ms, sustain in percent)
-    auto envelope = std::make_unique<Envelope>(44100.0);
+    auto envelope = std::make_unique<Envelope>(rate);
     envelope->setADSR(10.0, 100.0, 70.0, 200.0); // ms, ms, %, ms
 
     // Register envelope parameters (sustain in percent)
-    controller.addParameter("Attack", envelope->getAttackPtr(), 0.0, 2000.0, 10.0);
-    controller.addParameter("Decay", envelope->getDecayPtr(), 0.0, 2000.0, 100.0);
-    controller.addParameter("Sustain", envelope->getSustainPtr(), 0.0, 100.0, 70.0);
-    controller.addParameter("Release", envelope->getReleasePtr(), 0.0, 2000.0, 200.0);
+    controller.addParameter("Attack", envelope->getAttackPtr(), 0.0, 2000.0, 10.0, {"ms"});
+    controller.addParameter("Decay", envelope->getDecayPtr(), 0.0, 2000.0, 100.0, {"ms"});
+    controller.addParameter("Sustain", envelope->getSustainPtr(), 0.0, 100.0, 70.0, {"%"});
+    controller.addParameter("Release", envelope->getReleasePtr(), 0.0, 2000.0, 200.0, {"ms"});
 
     sound->addOscillator(std::move(sine));
     sound->addEnvelope(std::move(envelope));
 
+    sound->registerLayerPans(controller);
     double* masterVolumePtr = sound->getMasterVolumePtr();
-    controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50);
-    controller.setParameterCallback(controller.getParameterCount() - 1, 
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
         [sound]() {
             sound->updateMasterVolume();
         });
 }
 
 void PresetManager::setupSimpleSaw(Sound* sound, LiveController& controller) {
-    auto saw = std::make_unique<SawOscillator>(44100.0);
+    const double rate = sound->getSampleRate();
+    auto saw = std::make_unique<SawOscillator>(rate);
     saw->setFrequency(440.0);
     // amplitude is automatically 1.0
     saw->registerParameters(controller);
     
     // Create a BandPassFilter for the saw wave
-    auto bandpass = std::make_unique<BandPassFilter>(44100.0);
+    auto bandpass = std::make_unique<BandPassFilter>(rate);
     bandpass->setTargetFrequency(1000.0);  // Start with 1kHz center frequency
     bandpass->setBandwidth(300.0);         // 300Hz bandwidth
     bandpass->registerParameters(controller);
@@ -87,59 +169,66 @@ void PresetManager::setupSimpleSaw(Sound* sound, LiveController& controller) {
     sound->addOscillator(std::move(saw));
     sound->addFilter(std::move(bandpass));
     
+    sound->registerLayerPans(controller);
     // Add master volume control with consistent 0-100 range
     double* masterVolumePtr = sound->getMasterVolumePtr();
-    controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50);
-    controller.setParameterCallback(controller.getParameterCount() - 1, 
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
                                    [sound]() {
                                        sound->updateMasterVolume();
                                    });
 }
 
 void PresetManager::setupBasicFM(Sound* sound, LiveController& controller) {
-    auto fmSynth = std::make_unique<FMSynthesizer>(44100.0);
+    const double rate = sound->getSampleRate();
+    auto fmSynth = std::make_unique<FMSynthesizer>(rate);
     
-    auto carrier = std::make_unique<SawOscillator>(44100.0);
+    auto carrier = std::make_unique<SawOscillator>(rate);
     carrier->setFrequency(440.0);
     // amplitude automatically 1.0
     
-    auto modulator = std::make_unique<SawOscillator>(44100.0);
+    auto modulator = std::make_unique<SawOscillator>(rate);
     modulator->setFrequency(880.0);
     // amplitude automatically 1.0
     
     fmSynth->setCarrierOscillator(std::move(carrier));
     fmSynth->setModulatorOscillator(std::move(modulator));
-    fmSynth->registerParameters(controller);
     
-    sound->addOscillator(std::move(fmSynth));
+    // Deep modulation of saws aliases badly at 44.1 kHz - oversample just this node
+    auto oversampledFM = std::make_unique<OversampledOscillator>(std::move(fmSynth), 2, rate);
+    oversampledFM->registerParameters(controller);
+    
+    sound->addOscillator(std::move(oversampledFM));
     
+    sound->registerLayerPans(controller);
     // Add master volume control with consistent 0-100 range
     double* masterVolumePtr = sound->getMasterVolumePtr();
-    controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50);
-    controller.setParameterCallback(controller.getParameterCount() - 1, 
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
                                    [sound]() {
                                        sound->updateMasterVolume();
                                    });
 }
 
 void PresetManager::setupNestedFM(Sound* sound, LiveController& controller) {
+    const double rate = sound->getSampleRate();
     // Create main FM synthesizer
-    auto mainFM = std::make_unique<FMSynthesizer>(44100.0);
+    auto mainFM = std::make_unique<FMSynthesizer>(rate);
     
     // Create simple sine oscillator as carrier
-    auto carrier = std::make_unique<SineOscillator>(44100.0);
+    auto carrier = std::make_unique<SineOscillator>(rate);
     carrier->setFrequency(440.0);
     // amplitude is automatically 1.0
     mainFM->setCarrierOscillator(std::move(carrier));
     
     // Create nested FM as modulator
-    auto nestedFM = std::make_unique<FMSynthesizer>(44100.0);
+    auto nestedFM = std::make_unique<FMSynthesizer>(rate);
     {
-        auto nestedCarrier = std::make_unique<SineOscillator>(44100.0);
+        auto nestedCarrier = std::make_unique<SineOscillator>(rate);
         nestedCarrier->setFrequency(220.0); // Changed frequency for better sound
         // amplitude automatically 1.0
         
-        auto nestedModulator = std::make_unique<SineOscillator>(44100.0);
+        auto nestedModulator = std::make_unique<SineOscillator>(rate);
         nestedModulator->setFrequency(55.0); // Changed frequency for better sound
         // amplitude automatically 1.0
         
@@ -152,81 +241,70 @@ void PresetManager::setupNestedFM(Sound* sound, LiveController& controller) {
     mainFM->setModulatorOscillator(std::move(nestedFM));
     mainFM->setModulationDepth(30.0); // Lower depth for more subtle effect
     
+    // Oversample the whole FM tree; the nested modulator pushes sidebands past Nyquist
+    auto oversampledFM = std::make_unique<OversampledOscillator>(std::move(mainFM), 2, rate);
+    
     // Register parameters in a way that clearly shows the hierarchical structure
-    mainFM->registerParameters(controller);
+    oversampledFM->registerParameters(controller);
     
-    sound->addOscillator(std::move(mainFM));
+    sound->addOscillator(std::move(oversampledFM));
     
+    sound->registerLayerPans(controller);
     // Add master volume control with consistent 0-100 range (was already correct)
     double* masterVolumePtr = sound->getMasterVolumePtr();
-    controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50);
-    controller.setParameterCallback(controller.getParameterCount() - 1, 
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
                                   [sound]() {
                                       sound->updateMasterVolume();
                                   });
 }
 
 void PresetManager::setupTripleBandpassAdditive(Sound* sound, LiveController& controller) {
+    const double rate = sound->getSampleRate();
     // Frequencies and bandwidths for each band
     std::vector<double> centerFreqs = {600.0, 1200.0, 2400.0};
     std::vector<double> bandwidths = {200.0, 300.0, 400.0};
 
     // Prepare additive synth
-    auto additive = std::make_unique<AdditiveSynthesizer>(44100.0);
+    auto additive = std::make_unique<AdditiveSynthesizer>(rate);
 
-    // For each band, create an independent saw oscillator and bandpass filter
+    // Each band is its own saw through its own bandpass filter
     for (int i = 0; i < 3; ++i) {
-        // Create independent saw oscillator
-        auto saw = std::make_unique<SawOscillator>(44100.0);
+        auto saw = std::make_unique<SawOscillator>(rate);
         saw->setFrequency(440.0);
-        saw->registerParametersWithPrefix(controller, "Saw " + std::to_string(i + 1));
 
-        // Create bandpass filter
-        auto filter = std::make_unique<BandPassFilter>(44100.0);
+        auto filter = std::make_unique<BandPassFilter>(rate);
         filter->setTargetFrequency(centerFreqs[i]);
         filter->setBandwidth(bandwidths[i]);
-        filter->registerParametersWithPrefix(controller, "Bandpass " + std::to_string(i + 1));
-
-        // Create a wrapper oscillator that applies the filter to the saw
-        struct FilteredOsc : public Oscillator {
-            std::unique_ptr<SawOscillator> saw;
-            std::unique_ptr<BandPassFilter> filter;
-            FilteredOsc(std::unique_ptr<SawOscillator> s, std::unique_ptr<BandPassFilter> f, double sr)
-                : Oscillator(sr), saw(std::move(s)), filter(std::move(f)) {}
-            double nextSample() override {
-                return filter->processSample(saw->nextSample());
-            }
-            void registerParameters(LiveController&) override {}
-            void registerParametersWithPrefix(LiveController&, const std::string&) override {}
-            std::string getTypeName() const override { return "FilteredOsc"; }
-        };
-
-        // Add the filtered oscillator to the additive synth
-        auto filteredOsc = std::make_unique<FilteredOsc>(std::move(saw), std::move(filter), 44100.0);
-        additive->addOscillator(std::move(filteredOsc));
+
+        auto band = std::make_unique<FilteredOscillator>(std::move(saw), rate);
+        band->addFilter(std::move(filter));
+        additive->addOscillator(std::move(band));
     }
 
-    // Register additive synth parameters
+    // Registers every band's saw and filter under the additive synth's prefix
     additive->registerParameters(controller);
     sound->addOscillator(std::move(additive));
 
+    sound->registerLayerPans(controller);
     // Add master volume control
     double* masterVolumePtr = sound->getMasterVolumePtr();
-    controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50);
-    controller.setParameterCallback(controller.getParameterCount() - 1, 
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
                                    [sound]() {
                                        sound->updateMasterVolume();
                                    });
 }
 
 void PresetManager::softSound(Sound* sound, LiveController& controller) {
-    auto sine = std::make_unique<SineOscillator>(44100.0);
-    auto saw = std::make_unique<SawOscillator>(44100.0);
+    const double rate = sound->getSampleRate();
+    auto sine = std::make_unique<SineOscillator>(rate);
+    auto saw = std::make_unique<SawOscillator>(rate);
 
     sine->setFrequency(220.0);
     saw->setFrequency(220.0);
 
-    auto additive = std::make_unique<AdditiveSynthesizer>(44100.0);
+    auto additive = std::make_unique<AdditiveSynthesizer>(rate);
 
     sine->setAmplitude(0.7);
     saw->setAmplitude(0.3);
@@ -234,7 +312,7 @@ void PresetManager::softSound(Sound* sound, LiveController& controller) {
     additive->addOscillator(std::move(sine));
     additive->addOscillator(std::move(saw));
 
-    auto filter = std::make_unique<LowPassFilter>(44100.0);
+    auto filter = std::make_unique<LowPassFilter>(rate);
     filter->setCutoffFrequency(2000.0);
     filter->setResonance(0.3);
 
@@ -242,40 +320,46 @@ void PresetManager::softSound(Sound* sound, LiveController& controller) {
     // Remove this line if you also call sound->addFilter(filter)
     filter->registerParametersWithPrefix(controller, "Lowpass");
 
-    // Add the filtered additive synth as an oscillator
-    struct FilteredOsc : public Oscillator {
-        std::unique_ptr<AdditiveSynthesizer> additive;
-        std::unique_ptr<LowPassFilter> filter;
-        FilteredOsc(std::unique_ptr<AdditiveSynthesizer> a, std::unique_ptr<LowPassFilter> f, double sr)
-            : Oscillator(sr), additive(std::move(a)), filter(std::move(f)) {}
-        double nextSample() override {
-            return filter->processSample(additive->nextSample());
-        }
-        std::string getTypeName() const override { return "FilteredOsc"; }
-        void registerParametersWithPrefix(LiveController& ctrl, const std::string& prefix) override {
-            additive->registerParametersWithPrefix(ctrl, prefix + " Additive");
-            filter->registerParametersWithPrefix(ctrl, prefix + " Filter");
-        }
-        void registerParameters(LiveController& ctrl) override {
-            registerParametersWithPrefix(ctrl, "");
-        }
-    };
-
-    auto filtered = std::make_unique<FilteredOsc>(std::move(additive), std::move(filter), 44100.0);
+    // The additive synth runs through its own lowpass as one oscillator
+    auto filtered = std::make_unique<FilteredOscillator>(std::move(additive), rate);
+    filtered->addFilter(std::move(filter));
 
     // Create and register envelope (times in ms, sustain in percent)
-    auto envelope = std::make_unique<Envelope>(44100.0);
+    auto envelope = std::make_unique<Envelope>(rate);
     envelope->setADSR(10.0, 100.0, 70.0, 200.0);
 
     // Register envelope parameters explicitly (like setupSimpleSine)
-    controller.addParameter("Attack", envelope->getAttackPtr(), 0.0, 2000.0, 10.0);
-    controller.addParameter("Decay", envelope->getDecayPtr(), 0.0, 2000.0, 100.0);
-    controller.addParameter("Sustain", envelope->getSustainPtr(), 0.0, 100.0, 70.0);
-    controller.addParameter("Release", envelope->getReleasePtr(), 0.0, 2000.0, 200.0);
+    controller.addParameter("Attack", envelope->getAttackPtr(), 0.0, 2000.0, 10.0, {"ms"});
+    controller.addParameter("Decay", envelope->getDecayPtr(), 0.0, 2000.0, 100.0, {"ms"});
+    controller.addParameter("Sustain", envelope->getSustainPtr(), 0.0, 100.0, 70.0, {"%"});
+    controller.addParameter("Release", envelope->getReleasePtr(), 0.0, 2000.0, 200.0, {"ms"});
 
     // Add the filtered oscillator and envelope to the sound, like setupSimpleSine
     sound->addOscillator(std::move(filtered));
     sound->addEnvelope(std::move(envelope));
     // Do NOT call sound->addFilter for this filter, or if you do, do NOT call registerParametersWithPrefix above.
     // ...existing code...
-}
\ No newline at end of file
+}
+
+void PresetManager::setupUnisonSawPad(Sound* sound, LiveController& controller) {
+    const double rate = sound->getSampleRate();
+    auto unison = std::make_unique<VoiceLaneSynthesizer>(VoiceLaneSynthesizer::Waveform::Saw,
+                                                         VoiceLaneSynthesizer::FilterType::LowPass, rate);
+    unison->setFrequency(220.0);
+    unison->setVoiceCount(8);
+    unison->setDetune(15.0);
+    unison->setSpread(60.0);
+    unison->setFilter(1800.0, 0.9);
+    unison->setADSR(250.0, 400.0, 80.0, 600.0);
+    unison->registerParameters(controller);
+
+    sound->addOscillator(std::move(unison));
+
+    sound->registerLayerPans(controller);
+    double* masterVolumePtr = sound->getMasterVolumePtr();
+    ParameterId volumeId = controller.addParameter("Master Volume", masterVolumePtr, 0, 100, 50, {"%"});
+    controller.setParameterCallback(volumeId, 
+                                   [sound]() {
+                                       sound->updateMasterVolume();
+                                   });
+}
@@ -7,6 +7,7 @@
 #include <memory>
 #include "../core/Sound.h"
 #include "../interface/LiveController.h"
+#include "CompiledPatch.h"
 
 class PresetManager {
 public:
@@ -16,6 +17,7 @@ public:
         std::string name;
         std::string description;
         PresetSetupFunction setupFunction;
+        std::shared_ptr<const CompiledPatch> patch;  // Set for presets loaded as data
     };
     
     PresetManager();
@@ -23,6 +25,14 @@ public:
     // Preset management
     void registerPreset(const std::string& name, const std::string& description, PresetSetupFunction setupFunc);
     void loadPreset(int index, Sound* sound, LiveController& controller);
+
+    // Data presets (see PatchFormat.h). loadPatchDirectory registers every
+    // *.patch file, compiled once to a *.patchbin cache next to it that is
+    // reused, mmapped, until the text is newer. Returns the number registered.
+    int loadPatchDirectory(const std::string& directory);
+    void registerPatch(std::shared_ptr<const CompiledPatch> patch);
+    // Writes a data preset with the controller's current parameter values as text
+    bool savePatchState(int index, const LiveController& controller, const std::string& path) const;
     
     // Getters
     const std::vector<Preset>& getPresets() const { return presets; }
@@ -39,6 +49,7 @@ private:
     static void setupNestedFM(Sound* sound, LiveController& controller);
     static void setupTripleBandpassAdditive(Sound* sound, LiveController& controller);
     static void softSound(Sound* sound, LiveController& controller);
+    static void setupUnisonSawPad(Sound* sound, LiveController& controller);
 };
 
 #endif // PRESETMANAGER_H
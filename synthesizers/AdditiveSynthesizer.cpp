@@ -1,7 +1,10 @@
 #include "AdditiveSynthesizer.h"
+#include "../core/RenderGraph.h"
 #include "../interface/LiveController.h"
-#include <iostream>
+#include "../core/Logger.h"
+#include "../dsp/ChannelKernels.h"
 #include <algorithm>
+#include <cmath>
 
 AdditiveSynthesizer::AdditiveSynthesizer(double sampleRate)
     : Oscillator(sampleRate), amplitude(1.0) {}
@@ -11,11 +14,33 @@ void AdditiveSynthesizer::addOscillator(std::unique_ptr<Oscillator> osc) {
         osc->setAmplitude(1.0); // Standardize amplitude
         osc->setUsedAsComponent(true);
         oscillators.push_back(std::move(osc));
+        pans.push_back(0.0);
+        leftGains.push_back(M_SQRT1_2);
+        rightGains.push_back(M_SQRT1_2);
     }
 }
 
 void AdditiveSynthesizer::clearOscillators() {
     oscillators.clear();
+    pans.clear();
+    leftGains.clear();
+    rightGains.clear();
+    stereo = false;
+}
+
+void AdditiveSynthesizer::setPartialPan(int index, double pan) {
+    if (index < 0 || index >= static_cast<int>(pans.size())) return;
+    pans[index] = std::clamp(pan, -1.0, 1.0);
+    double gains[2];
+    channels::constantPowerGains(pans[index], 2, gains);
+    leftGains[index] = gains[0];
+    rightGains[index] = gains[1];
+    stereo = true;
+}
+
+double AdditiveSynthesizer::getPartialPan(int index) const {
+    if (index < 0 || index >= static_cast<int>(pans.size())) return 0.0;
+    return pans[index];
 }
 
 size_t AdditiveSynthesizer::getOscillatorCount() const {
@@ -34,12 +59,91 @@ double AdditiveSynthesizer::nextSample() {
     return normalized * amplitude;
 }
 
+int AdditiveSynthesizer::buildRenderGraph(RenderGraph& graph, double* output) {
+    std::vector<int> partialNodes;
+    partialNodes.reserve(oscillators.size());
+    partialBuffers.clear();
+    partialBuffers.reserve(oscillators.size());
+    for (auto& osc : oscillators) {
+        double* buffer = graph.allocateBuffer();
+        partialNodes.push_back(osc->buildRenderGraph(graph, buffer));
+        partialBuffers.push_back(buffer);
+    }
+
+    // Same summation order and normalization as nextSample()
+    int sumNode = graph.addNode([this, output](int numSamples) {
+        std::fill(output, output + numSamples, 0.0);
+        if (partialBuffers.empty()) return;
+        for (const double* partial : partialBuffers) {
+            for (int n = 0; n < numSamples; ++n) {
+                output[n] += partial[n];
+            }
+        }
+        double count = static_cast<double>(partialBuffers.size());
+        for (int n = 0; n < numSamples; ++n) {
+            output[n] = output[n] / count * amplitude;
+        }
+    });
+    for (int node : partialNodes) {
+        graph.addDependency(sumNode, node);
+    }
+    return sumNode;
+}
+
+int AdditiveSynthesizer::buildStereoRenderGraph(RenderGraph& graph, double* left, double* right) {
+    std::vector<int> partialNodes;
+    partialNodes.reserve(oscillators.size());
+    partialBuffers.clear();
+    partialBuffers.reserve(oscillators.size());
+    for (auto& osc : oscillators) {
+        double* buffer = graph.allocateBuffer();
+        partialNodes.push_back(osc->buildRenderGraph(graph, buffer));
+        partialBuffers.push_back(buffer);
+    }
+
+    // Same order and normalization as the mono sum, each partial panned
+    int sumNode = graph.addNode([this, left, right](int numSamples) {
+        std::fill(left, left + numSamples, 0.0);
+        std::fill(right, right + numSamples, 0.0);
+        if (partialBuffers.empty()) return;
+        double scale = amplitude / static_cast<double>(partialBuffers.size());
+        for (size_t i = 0; i < partialBuffers.size(); ++i) {
+            const double* partial = partialBuffers[i];
+            double leftGain = leftGains[i] * scale;
+            double rightGain = rightGains[i] * scale;
+            for (int n = 0; n < numSamples; ++n) {
+                left[n] += partial[n] * leftGain;
+                right[n] += partial[n] * rightGain;
+            }
+        }
+    });
+    for (int node : partialNodes) {
+        graph.addDependency(sumNode, node);
+    }
+    return sumNode;
+}
+
+void AdditiveSynthesizer::setSampleRate(double rate) {
+    Oscillator::setSampleRate(rate);
+    for (auto& osc : oscillators) {
+        osc->setSampleRate(rate);
+    }
+}
+
+void AdditiveSynthesizer::noteOn() {
+    for (auto& osc : oscillators) osc->noteOn();
+}
+
+void AdditiveSynthesizer::noteOff() {
+    for (auto& osc : oscillators) osc->noteOff();
+}
+
 void AdditiveSynthesizer::registerParameters(LiveController& controller) {
     registerParametersWithPrefix(controller, getTypeName());
 }
 
 void AdditiveSynthesizer::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering additive synth parameters..." << std::endl;
+    LOG_DEBUG("🎛️ %s registering additive synth parameters...", prefix.c_str());
 
     // Register amplitude parameter for output normalization
     addParameterWithPrefix(controller, prefix, "Amplitude", &amplitude,
@@ -52,5 +156,10 @@ void AdditiveSynthesizer::registerParametersWithPrefix(LiveController& controlle
     for (size_t i = 0; i < oscillators.size(); ++i) {
         std::string oscPrefix = prefix + " Osc " + std::to_string(i + 1);
         oscillators[i]->registerParametersWithPrefix(controller, oscPrefix);
+        if (stereo) {
+            addParameterWithPrefix(controller, oscPrefix, "Pan", &pans[i],
+                                  -1.0, 1.0, 0.05,
+                                  [this, i]() { setPartialPan(static_cast<int>(i), pans[i]); });
+        }
     }
 }
@@ -21,6 +21,22 @@ public:
     // Main sample generation
     double nextSample() override;
 
+    // Partials render as independent graph nodes, summed by a final node
+    int buildRenderGraph(RenderGraph& graph, double* output) override;
+
+    // Places a partial in the stereo field (-1 left .. +1 right, constant
+    // power). Once any partial has a pan the synth renders as a stereo
+    // layer in multichannel Sounds; set pans before the graph is built.
+    void setPartialPan(int index, double pan);
+    double getPartialPan(int index) const;
+    bool isStereo() const override { return stereo; }
+    int buildStereoRenderGraph(RenderGraph& graph, double* left, double* right) override;
+
+    // Forward sample rate to all partials
+    void setSampleRate(double rate) override;
+    void noteOn() override;
+    void noteOff() override;
+
     // Parameter registration
     void registerParameters(LiveController& controller) override;
     void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
@@ -28,6 +44,11 @@ public:
 
 private:
     std::vector<std::unique_ptr<Oscillator>> oscillators;
+    std::vector<const double*> partialBuffers;  // Graph outputs of the partials, set by buildRenderGraph()
+    std::vector<double> pans;                   // Per partial
+    std::vector<double> leftGains;              // Per partial, from pans
+    std::vector<double> rightGains;
+    bool stereo = false;
     double amplitude; // Output amplitude normalization
 };
 
@@ -1,7 +1,8 @@
 #include "FMSynthesizer.h"
 #include "../oscillators/SineOscillator.h"
+#include "../core/RenderGraph.h"
 #include "../interface/LiveController.h"
-#include <iostream>
+#include "../core/Logger.h"
 #include <cmath>
 
 FMSynthesizer::FMSynthesizer(double sampleRate)
@@ -10,53 +11,49 @@ FMSynthesizer::FMSynthesizer(double sampleRate)
     
     // Standardized amplitude
     amplitude = 1.0;
-    carrier = nullptr;
-    modulator = nullptr;
+
+    // Sine operators until others are set. Created here rather than on first
+    // use, so rendering never allocates.
+    setCarrierOscillator(nullptr);
+    setModulatorOscillator(nullptr);
     
     // Important: Frequency is no longer used directly by FM synthesizer
     // It just forwards to the carrier oscillator
 }
 
 void FMSynthesizer::setCarrierOscillator(std::unique_ptr<Oscillator> carrierOsc) {
-    carrier = std::move(carrierOsc);
-    if (carrier) {
-        carrier->setFrequency(carrierFreq);
-        carrier->setAmplitude(1.0);
-        carrier->setUsedAsComponent(true);
-    }
+    carrier = carrierOsc ? std::move(carrierOsc) : std::make_unique<SineOscillator>(sampleRate);
+    carrier->setFrequency(carrierFreq);
+    carrier->setAmplitude(1.0);
+    carrier->setUsedAsComponent(true);
 }
 
 void FMSynthesizer::setModulatorOscillator(std::unique_ptr<Oscillator> modulatorOsc) {
-    modulator = std::move(modulatorOsc);
-    if (modulator) {
-        modulator->setFrequency(modulatorFreq);
-        modulator->setAmplitude(1.0);
-        modulator->setUsedAsComponent(true);
-    }
-}
-
-void FMSynthesizer::ensureOscillatorsExist() {
-    if (!carrier) {
-        carrier = std::make_unique<SineOscillator>(sampleRate);
-        carrier->setFrequency(carrierFreq);
-        carrier->setAmplitude(1.0);
-        carrier->setUsedAsComponent(true);
-    }
-    
-    if (!modulator) {
-        modulator = std::make_unique<SineOscillator>(sampleRate);
-        modulator->setFrequency(modulatorFreq);
-        modulator->setAmplitude(1.0);
-        modulator->setUsedAsComponent(true);
-    }
+    modulator = modulatorOsc ? std::move(modulatorOsc) : std::make_unique<SineOscillator>(sampleRate);
+    modulator->setFrequency(modulatorFreq);
+    modulator->setAmplitude(1.0);
+    modulator->setUsedAsComponent(true);
 }
 
 double FMSynthesizer::nextSample() {
-    ensureOscillatorsExist();
-    
     // Get the modulator's output sample
     double modulatorOutput = modulator->nextSample();
-    
+    return renderCarrier(modulatorOutput);
+}
+
+int FMSynthesizer::buildRenderGraph(RenderGraph& graph, double* output) {
+    double* modulatorBuffer = graph.allocateBuffer();
+    int modulatorNode = modulator->buildRenderGraph(graph, modulatorBuffer);
+    int carrierNode = graph.addNode([this, modulatorBuffer, output](int numSamples) {
+        for (int n = 0; n < numSamples; ++n) {
+            output[n] = renderCarrier(modulatorBuffer[n]);
+        }
+    });
+    graph.addDependency(carrierNode, modulatorNode);
+    return carrierNode;
+}
+
+double FMSynthesizer::renderCarrier(double modulatorOutput) {
     // Calculate the instantaneous frequency offset from modulation
     double frequencyOffset = modulatorOutput * modulationDepth;
     
@@ -93,6 +90,22 @@ void FMSynthesizer::setFrequency(double freq) {
     setCarrierFrequency(freq);
 }
 
+void FMSynthesizer::setSampleRate(double rate) {
+    Oscillator::setSampleRate(rate);
+    if (carrier) carrier->setSampleRate(rate);
+    if (modulator) modulator->setSampleRate(rate);
+}
+
+void FMSynthesizer::noteOn() {
+    if (carrier) carrier->noteOn();
+    if (modulator) modulator->noteOn();
+}
+
+void FMSynthesizer::noteOff() {
+    if (carrier) carrier->noteOff();
+    if (modulator) modulator->noteOff();
+}
+
 void FMSynthesizer::setCarrierFrequency(double freq) {
     // Update our internal tracking value
     carrierFreq = freq;
@@ -123,25 +136,24 @@ void FMSynthesizer::setModulatorAmplitude(double amp) {
 }
 
 void FMSynthesizer::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
-    std::cout << "🎛️ " << prefix << " registering parameters..." << std::endl;
-    
-    ensureOscillatorsExist();
+    LOG_DEBUG("🎛️ %s registering parameters...", prefix.c_str());
     
     // Only register modulation depth - this is the FM synthesizer's only real parameter
     addParameterWithPrefix(controller, prefix, "Mod Depth", &modulationDepth, 
                           0.0, 1000.0, 20.0,
                           [this]() {
                               if (modulationDepth < 0.0) modulationDepth = 0.0;
-                          });
+                          },
+                          {"Hz"});
     
     // Register carrier oscillator's parameters with proper prefix
     if (carrier) {
         std::string carrierPrefix = prefix + " Carrier";
         if (auto* fmCarrier = dynamic_cast<FMSynthesizer*>(carrier.get())) {
-            std::cout << "🔍 Carrier is nested FM synthesizer - registering its parameters..." << std::endl;
+            LOG_DEBUG("🔍 Carrier is nested FM synthesizer - registering its parameters...");
             fmCarrier->registerParametersWithPrefix(controller, carrierPrefix);
         } else {
-            std::cout << "🔍 Registering carrier oscillator parameters..." << std::endl;
+            LOG_DEBUG("🔍 Registering carrier oscillator parameters...");
             carrier->registerParametersWithPrefix(controller, carrierPrefix);
         }
     }
@@ -150,10 +162,10 @@ void FMSynthesizer::registerParametersWithPrefix(LiveController& controller, con
     if (modulator) {
         std::string modPrefix = prefix + " Modulator";
         if (auto* fmModulator = dynamic_cast<FMSynthesizer*>(modulator.get())) {
-            std::cout << "🔍 Modulator is nested FM synthesizer - registering its parameters..." << std::endl;
+            LOG_DEBUG("🔍 Modulator is nested FM synthesizer - registering its parameters...");
             fmModulator->registerParametersWithPrefix(controller, modPrefix);
         } else {
-            std::cout << "🔍 Registering modulator oscillator parameters..." << std::endl;
+            LOG_DEBUG("🔍 Registering modulator oscillator parameters...");
             modulator->registerParametersWithPrefix(controller, modPrefix);
         }
     }
@@ -9,7 +9,8 @@ public:
     FMSynthesizer(double sampleRate = 44100.0);
     double nextSample() override;
     
-    // Modular oscillator injection - accept ANY oscillator type as carrier/modulator
+    // Modular oscillator injection - accept ANY oscillator type as carrier/modulator.
+    // nullptr restores the default sine operator.
     void setCarrierOscillator(std::unique_ptr<Oscillator> carrierOsc);
     void setModulatorOscillator(std::unique_ptr<Oscillator> modulatorOsc);
     
@@ -27,6 +28,12 @@ public:
     
     // Override base setters to affect carrier
     void setFrequency(double freq) override; // Now just passes through to carrier
+    void setSampleRate(double rate) override; // Forwards to carrier and modulator
+    void noteOn() override;
+    void noteOff() override;
+
+    // The modulator chain renders as its own subgraph ahead of the carrier node
+    int buildRenderGraph(RenderGraph& graph, double* output) override;
     
     // Automatic parameter registration
     void registerParameters(LiveController& controller) override;
@@ -39,9 +46,9 @@ private:
     double modulationDepth;
     double carrierFreq;    // Only stored for parameter initialization
     double modulatorFreq;  // Only stored for parameter initialization
-    
-    // Helper to create default oscillators if none provided
-    void ensureOscillatorsExist();
+
+    // One carrier sample for a given modulator sample
+    double renderCarrier(double modulatorOutput);
 };
 
 #endif // FMSYNTHESIZER_H
@@ -0,0 +1,218 @@
+#include "VoiceLaneSynthesizer.h"
+#include "../interface/LiveController.h"
+#include "../dsp/FastMath.h"
+#include "../dsp/ChannelKernels.h"
+#include "../core/RenderGraph.h"
+#include "../core/Logger.h"
+#include <algorithm>
+
+using namespace voicelanes;
+
+VoiceLaneSynthesizer::VoiceLaneSynthesizer(Waveform waveform, FilterType filterType, double sampleRate)
+    : Oscillator(sampleRate), waveform(waveform), filterType(filterType),
+      voiceCount(4.0), detuneCents(12.0), spreadPercent(0.0),
+      filterFrequency(filterType == FilterType::LowPass ? 2000.0 : 1000.0),
+      filterShape(filterType == FilterType::LowPass ? 0.7071 : 300.0),
+      stereo(false), chunkPosition(ChunkSize) {
+    amplitude = 1.0;
+    envelopes.sampleRate = sampleRate;
+    for (int l = 0; l < MaxLanes; ++l) {
+        envelopes.enterStage(l, EnvelopeLanes::Idle);
+    }
+    updateFrequencies();
+    updateFilters();
+}
+
+double VoiceLaneSynthesizer::nextSample() {
+    if (chunkPosition >= ChunkSize) {
+        renderChunk();
+        chunkPosition = 0;
+    }
+    return mixBuffer[chunkPosition++];
+}
+
+int VoiceLaneSynthesizer::buildRenderGraph(RenderGraph& graph, double* output) {
+    stereo = false;
+    return Oscillator::buildRenderGraph(graph, output);
+}
+
+int VoiceLaneSynthesizer::buildStereoRenderGraph(RenderGraph& graph, double* left, double* right) {
+    stereo = true;
+    return graph.addNode([this, left, right](int numSamples) {
+        generateStereoBlock(left, right, numSamples);
+    });
+}
+
+void VoiceLaneSynthesizer::generateStereoBlock(double* left, double* right, int numSamples) {
+    for (int offset = 0; offset < numSamples;) {
+        if (chunkPosition >= ChunkSize) {
+            renderChunk();
+            chunkPosition = 0;
+        }
+        int count = std::min(numSamples - offset, ChunkSize - chunkPosition);
+        std::copy(mixBuffer + chunkPosition, mixBuffer + chunkPosition + count, left + offset);
+        std::copy(rightBuffer + chunkPosition, rightBuffer + chunkPosition + count, right + offset);
+        chunkPosition += count;
+        offset += count;
+    }
+}
+
+void VoiceLaneSynthesizer::renderChunk() {
+    int voices = static_cast<int>(voiceCount);
+    double gain = amplitude / std::max(1, voices);
+
+    // Half-width vectors when the unison fits, so few voices cost less
+    if (voices <= 4) {
+        if (waveform == Waveform::Sine) renderSine<4>(oscillators, laneBuffer, ChunkSize);
+        else                            renderSaw<4>(oscillators, laneBuffer, ChunkSize);
+        processBiquad<4>(filters, laneBuffer, ChunkSize);
+        applyEnvelope<4>(envelopes, laneBuffer, ChunkSize);
+        if (stereo) mixLanesStereo<4>(laneBuffer, leftGains, rightGains, mixBuffer, rightBuffer, ChunkSize, gain);
+        else        mixLanes<4>(laneBuffer, mixBuffer, ChunkSize, gain);
+    } else {
+        if (waveform == Waveform::Sine) renderSine<8>(oscillators, laneBuffer, ChunkSize);
+        else                            renderSaw<8>(oscillators, laneBuffer, ChunkSize);
+        processBiquad<8>(filters, laneBuffer, ChunkSize);
+        applyEnvelope<8>(envelopes, laneBuffer, ChunkSize);
+        if (stereo) mixLanesStereo<8>(laneBuffer, leftGains, rightGains, mixBuffer, rightBuffer, ChunkSize, gain);
+        else        mixLanes<8>(laneBuffer, mixBuffer, ChunkSize, gain);
+    }
+}
+
+void VoiceLaneSynthesizer::noteOn() {
+    int voices = static_cast<int>(voiceCount);
+    for (int l = 0; l < MaxLanes; ++l) {
+        if (l < voices) {
+            envelopes.noteOn(l);
+        } else {
+            envelopes.enterStage(l, EnvelopeLanes::Idle);
+        }
+    }
+}
+
+void VoiceLaneSynthesizer::noteOff() {
+    for (int l = 0; l < MaxLanes; ++l) {
+        if (envelopes.isActive(l)) envelopes.noteOff(l);
+    }
+}
+
+void VoiceLaneSynthesizer::setVoiceCount(int voices) {
+    voiceCount = std::clamp(voices, 1, MaxLanes);
+    updateFrequencies();
+}
+
+void VoiceLaneSynthesizer::setDetune(double cents) {
+    detuneCents = std::clamp(cents, 0.0, 100.0);
+    updateFrequencies();
+}
+
+void VoiceLaneSynthesizer::setSpread(double percent) {
+    spreadPercent = std::clamp(percent, 0.0, 100.0);
+    updatePans();
+}
+
+void VoiceLaneSynthesizer::setFilter(double frequency, double shape) {
+    filterFrequency = frequency;
+    filterShape = shape;
+    updateFilters();
+}
+
+void VoiceLaneSynthesizer::setADSR(double attack, double decay, double sustain, double release) {
+    envelopes.attack = std::max(0.0, attack);
+    envelopes.decay = std::max(0.0, decay);
+    envelopes.sustain = std::clamp(sustain, 0.0, 100.0);
+    envelopes.release = std::max(0.0, release);
+    envelopes.refreshSustain();
+}
+
+void VoiceLaneSynthesizer::setFrequency(double freq) {
+    Oscillator::setFrequency(freq);
+    updateFrequencies();
+}
+
+void VoiceLaneSynthesizer::setSampleRate(double rate) {
+    Oscillator::setSampleRate(rate);
+    envelopes.setSampleRate(rate);
+    updateFrequencies();
+    updateFilters();
+}
+
+void VoiceLaneSynthesizer::updateFrequencies() {
+    // Voices spread evenly across +/- detune, centred on the base frequency
+    int voices = static_cast<int>(voiceCount);
+    for (int l = 0; l < MaxLanes; ++l) {
+        double spread = (voices > 1) ? (2.0 * l / (voices - 1) - 1.0) : 0.0;
+        double ratio = fastmath::semitonesToRatio(spread * detuneCents / 100.0);
+        oscillators.setFrequency(l, frequency * ratio, sampleRate);
+    }
+    updatePans();
+}
+
+void VoiceLaneSynthesizer::updatePans() {
+    // Same positions as the detune, scaled by the spread
+    int voices = static_cast<int>(voiceCount);
+    for (int l = 0; l < MaxLanes; ++l) {
+        double position = (voices > 1) ? (2.0 * l / (voices - 1) - 1.0) : 0.0;
+        double gains[2];
+        channels::constantPowerGains(position * spreadPercent / 100.0, 2, gains);
+        leftGains[l] = gains[0];
+        rightGains[l] = gains[1];
+    }
+}
+
+void VoiceLaneSynthesizer::updateFilters() {
+    for (int l = 0; l < MaxLanes; ++l) {
+        if (filterType == FilterType::LowPass) {
+            filters.setLowPass(l, filterFrequency, filterShape, sampleRate);
+        } else {
+            filters.setBandPass(l, filterFrequency, filterShape, sampleRate);
+        }
+    }
+}
+
+void VoiceLaneSynthesizer::registerParameters(LiveController& controller) {
+    registerParametersWithPrefix(controller, getTypeName());
+}
+
+void VoiceLaneSynthesizer::registerParametersWithPrefix(LiveController& controller, const std::string& prefix) {
+    LOG_DEBUG("🎛️ %s registering unison parameters...", prefix.c_str());
+
+    addParameterWithPrefix(controller, prefix, "Frequency", &frequency,
+                          1, 2000, 20,
+                          [this]() { updateFrequencies(); }, {"Hz"});
+    addParameterWithPrefix(controller, prefix, "Voices", &voiceCount,
+                          1.0, 8.0, 1.0,
+                          [this]() { setVoiceCount(static_cast<int>(voiceCount)); },
+                          {"", ParameterType::Integer});
+    addParameterWithPrefix(controller, prefix, "Detune", &detuneCents,
+                          0.0, 100.0, 1.0,
+                          [this]() { setDetune(detuneCents); }, {"cents"});
+    addParameterWithPrefix(controller, prefix, "Spread", &spreadPercent,
+                          0.0, 100.0, 1.0,
+                          [this]() { setSpread(spreadPercent); }, {"%"});
+
+    if (filterType == FilterType::LowPass) {
+        addParameterWithPrefix(controller, prefix, "Cutoff Freq", &filterFrequency,
+                              20.0, 8000.0, 1000.0,
+                              [this]() { updateFilters(); }, {"Hz"});
+        addParameterWithPrefix(controller, prefix, "Resonance", &filterShape,
+                              0.1, 10.0, 0.7071,
+                              [this]() { updateFilters(); });
+    } else {
+        addParameterWithPrefix(controller, prefix, "Target Freq", &filterFrequency,
+                              20.0, 8000.0, 50.0,
+                              [this]() { updateFilters(); }, {"Hz"});
+        addParameterWithPrefix(controller, prefix, "Bandwidth", &filterShape,
+                              10.0, 2000.0, 200.0,
+                              [this]() { updateFilters(); }, {"Hz"});
+    }
+
+    addParameterWithPrefix(controller, prefix, "Attack", &envelopes.attack, 0.0, 2000.0, 10.0,
+                          nullptr, {"ms"});
+    addParameterWithPrefix(controller, prefix, "Decay", &envelopes.decay, 0.0, 2000.0, 100.0,
+                          nullptr, {"ms"});
+    addParameterWithPrefix(controller, prefix, "Sustain", &envelopes.sustain, 0.0, 100.0, 70.0,
+                          [this]() { envelopes.refreshSustain(); }, {"%"});
+    addParameterWithPrefix(controller, prefix, "Release", &envelopes.release, 0.0, 2000.0, 200.0,
+                          nullptr, {"ms"});
+}
@@ -0,0 +1,83 @@
+#ifndef VOICELANESYNTHESIZER_H
+#define VOICELANESYNTHESIZER_H
+
+#include "../core/Oscillator.h"
+#include "../dsp/VoiceLanes.h"
+
+// Up to 8 voices of one oscillator -> biquad -> ADSR patch, rendered
+// together in SIMD lanes (see dsp/VoiceLanes.h). Voices are spread as a
+// detuned unison around the base frequency and gated by noteOn/noteOff.
+// Cost depends on the lane width (4 or 8), not on the number of voices.
+// Rendering runs ahead in 32-sample chunks, so gate events take effect at the
+// next chunk boundary (under 1 ms at 44.1 kHz).
+//
+// In a multichannel Sound the unison renders as a stereo pair: each voice is
+// panned with constant power by its detune position times the spread, so the
+// lowest voice sits left and the highest right. The mono render ignores it.
+class VoiceLaneSynthesizer : public Oscillator {
+public:
+    enum class Waveform { Sine, Saw };
+    enum class FilterType { LowPass, BandPass };
+
+    VoiceLaneSynthesizer(Waveform waveform = Waveform::Saw,
+                         FilterType filterType = FilterType::LowPass,
+                         double sampleRate = 44100.0);
+
+    double nextSample() override;
+
+    bool isStereo() const override { return true; }
+    int buildRenderGraph(RenderGraph& graph, double* output) override;
+    int buildStereoRenderGraph(RenderGraph& graph, double* left, double* right) override;
+
+    void noteOn() override;
+    void noteOff() override;
+
+    // Voice layout
+    void setVoiceCount(int voices);
+    int getVoiceCount() const { return static_cast<int>(voiceCount); }
+    void setDetune(double cents);
+    void setSpread(double percent);  // Stereo width of the unison, 0-100%
+    double getSpread() const { return spreadPercent; }
+
+    // Shared filter and envelope settings
+    void setFilter(double frequency, double shape);  // shape = Q (LowPass) or bandwidth in Hz (BandPass)
+    void setADSR(double attack, double decay, double sustain, double release);
+
+    void setFrequency(double freq) override;
+    void setSampleRate(double rate) override;
+
+    void registerParameters(LiveController& controller) override;
+    void registerParametersWithPrefix(LiveController& controller, const std::string& prefix) override;
+    std::string getTypeName() const override { return "Unison"; }
+
+private:
+    Waveform waveform;
+    FilterType filterType;
+
+    // Parameter values
+    double voiceCount;
+    double detuneCents;
+    double spreadPercent;
+    double filterFrequency;
+    double filterShape;
+
+    voicelanes::OscillatorLanes oscillators;
+    voicelanes::BiquadLanes filters;
+    voicelanes::EnvelopeLanes envelopes;
+
+    voicelanes::LaneBlock laneBuffer;
+    double mixBuffer[voicelanes::ChunkSize];   // Mono, or left when stereo
+    double rightBuffer[voicelanes::ChunkSize];
+    alignas(64) double leftGains[voicelanes::MaxLanes];
+    alignas(64) double rightGains[voicelanes::MaxLanes];
+    bool stereo;  // Set by the last graph build
+    int chunkPosition;
+
+    void renderChunk();
+    void generateStereoBlock(double* left, double* right, int numSamples);
+    void updateFrequencies();
+    void updatePans();
+    void updateFilters();
+};
+
+#endif // VOICELANESYNTHESIZER_H